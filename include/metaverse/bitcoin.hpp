@@ -105,6 +105,7 @@
 #include <metaverse/bitcoin/utility/assert.hpp>
 #include <metaverse/bitcoin/utility/atomic.hpp>
 #include <metaverse/bitcoin/utility/binary.hpp>
+#include <metaverse/bitcoin/utility/block_trace.hpp>
 #include <metaverse/bitcoin/utility/collection.hpp>
 #include <metaverse/bitcoin/utility/color.hpp>
 #include <metaverse/bitcoin/utility/conditional_lock.hpp>
@@ -122,6 +123,7 @@
 #include <metaverse/bitcoin/utility/istream_reader.hpp>
 #include <metaverse/bitcoin/utility/log.hpp>
 #include <metaverse/bitcoin/utility/logging.hpp>
+#include <metaverse/bitcoin/utility/metrics.hpp>
 #include <metaverse/bitcoin/utility/monitor.hpp>
 #include <metaverse/bitcoin/utility/notifier.hpp>
 #include <metaverse/bitcoin/utility/ostream_writer.hpp>
@@ -130,6 +132,7 @@
 #include <metaverse/bitcoin/utility/reader.hpp>
 #include <metaverse/bitcoin/utility/resource_lock.hpp>
 #include <metaverse/bitcoin/utility/resubscriber.hpp>
+#include <metaverse/bitcoin/utility/ring_buffer.hpp>
 #include <metaverse/bitcoin/utility/scope_lock.hpp>
 #include <metaverse/bitcoin/utility/serializer.hpp>
 #include <metaverse/bitcoin/utility/string.hpp>
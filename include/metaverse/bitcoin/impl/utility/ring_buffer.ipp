@@ -0,0 +1,129 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_RING_BUFFER_IPP
+#define MVS_RING_BUFFER_IPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace libbitcoin {
+
+template <typename Item>
+ring_buffer<Item>::ring_buffer(size_t capacity)
+  : mask_(round_up(capacity) - 1),
+    slots_(new slot[mask_ + 1]),
+    enqueue_(0),
+    dequeue_(0)
+{
+    for (size_t index = 0; index <= mask_; ++index)
+        slots_[index].sequence.store(index, std::memory_order_relaxed);
+}
+
+template <typename Item>
+size_t ring_buffer<Item>::round_up(size_t capacity)
+{
+    size_t result = 2;
+    while (result < capacity)
+        result <<= 1;
+
+    return result;
+}
+
+template <typename Item>
+size_t ring_buffer<Item>::capacity() const
+{
+    return mask_ + 1;
+}
+
+template <typename Item>
+bool ring_buffer<Item>::push(Item&& item)
+{
+    auto position = enqueue_.load(std::memory_order_relaxed);
+
+    while (true)
+    {
+        auto& cell = slots_[position & mask_];
+        const auto sequence = cell.sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<intptr_t>(sequence) -
+            static_cast<intptr_t>(position);
+
+        if (difference == 0)
+        {
+            // The slot is free, claim it by advancing the cursor.
+            if (enqueue_.compare_exchange_weak(position, position + 1,
+                std::memory_order_relaxed))
+            {
+                cell.item = std::move(item);
+                cell.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (difference < 0)
+        {
+            // The consumer has not released this slot yet, buffer is full.
+            return false;
+        }
+        else
+        {
+            position = enqueue_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template <typename Item>
+bool ring_buffer<Item>::pop(Item& out_item)
+{
+    auto position = dequeue_.load(std::memory_order_relaxed);
+
+    while (true)
+    {
+        auto& cell = slots_[position & mask_];
+        const auto sequence = cell.sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<intptr_t>(sequence) -
+            static_cast<intptr_t>(position + 1);
+
+        if (difference == 0)
+        {
+            if (dequeue_.compare_exchange_weak(position, position + 1,
+                std::memory_order_relaxed))
+            {
+                out_item = std::move(cell.item);
+                cell.sequence.store(position + mask_ + 1,
+                    std::memory_order_release);
+                return true;
+            }
+        }
+        else if (difference < 0)
+        {
+            // The producer has not published this slot yet, buffer is empty.
+            return false;
+        }
+        else
+        {
+            position = dequeue_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+} // namespace libbitcoin
+
+#endif
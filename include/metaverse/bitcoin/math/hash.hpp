@@ -182,6 +182,38 @@ BC_API long_hash pkcs5_pbkdf2_hmac_sha512(data_slice passphrase,
  */
 BC_API hash_digest bitcoin_hash(data_slice data);
 
+/**
+ * Generate the bitcoin hash of each adjacent pair of hashes, replacing the
+ * list with the results, half as many. The list size must be even. Pairs
+ * are hashed several at a time where the cpu allows, for merkle trees.
+ *
+ * sha256(sha256(hashes[2n] + hashes[2n + 1]))
+ */
+BC_API void bitcoin_hash_pairs(hash_list& hashes);
+
+/**
+ * The sha256 implementations, chosen at runtime by cpu support.
+ */
+enum class sha256_implementation
+{
+    scalar = 0,
+    sse41 = 1,
+    avx2 = 2,
+    shani = 3
+};
+
+/**
+ * True if the implementation can run on this cpu.
+ */
+BC_API bool sha256_available(sha256_implementation implementation);
+
+/**
+ * Use only the given implementation from now on, false if unavailable.
+ * The fastest are chosen at startup, this is for tests and benchmarks and
+ * must not be called while other threads hash.
+ */
+BC_API bool sha256_select(sha256_implementation implementation);
+
 /**
  * Generate a bitcoin short hash. This hash function is used in a
  * few specific cases where short hashes are desired.
@@ -0,0 +1,145 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_BLOCK_TRACE_HPP
+#define MVS_BLOCK_TRACE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin/define.hpp>
+#include <metaverse/bitcoin/math/hash.hpp>
+
+namespace libbitcoin {
+
+/// Opt-in recorder of nested timing spans along a block's way from parse to
+/// storage. When a block finishes and its stages took longer than the
+/// threshold, the spans are written as a Chrome trace-event JSON file
+/// (chrome://tracing, ui.perfetto.dev). Disabled, every call is one relaxed
+/// atomic load.
+class BC_API block_trace
+{
+public:
+    typedef std::chrono::steady_clock clock;
+
+    /// Span argument meaning "no index".
+    static const uint64_t no_index;
+
+    /// Traces kept for blocks that never finish (orphans, stale forks).
+    static const size_t max_pending;
+
+    static block_trace& instance();
+
+    /// A zero threshold disables tracing.
+    void configure(const boost::filesystem::path& directory,
+        uint32_t threshold_milliseconds);
+
+    bool enabled() const
+    {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    /// Record a stage span for a block identified only once the work is
+    /// done, such as message parse.
+    void record(const hash_digest& block, const char* name,
+        clock::time_point start);
+
+    /// Dump the trace of the block if it was slow, then forget it.
+    void finish(const hash_digest& block, uint64_t height);
+
+    /// A stage of the block's processing. Binds the block to the calling
+    /// thread so spans opened below it are attributed to the block.
+    class BC_API scope
+    {
+    public:
+        scope(const hash_digest& block, const char* name);
+        ~scope();
+
+        scope(const scope&) = delete;
+        void operator=(const scope&) = delete;
+
+    private:
+        const bool active_;
+        const char* name_;
+        const hash_digest* previous_;
+        const hash_digest block_;
+        const clock::time_point start_;
+    };
+
+    /// A nested span, recorded against the block bound to this thread.
+    /// The index (e.g. a transaction position) is shown as a span argument.
+    class BC_API span
+    {
+    public:
+        span(const char* name, uint64_t index=no_index);
+        ~span();
+
+        span(const span&) = delete;
+        void operator=(const span&) = delete;
+
+    private:
+        const hash_digest* block_;
+        const char* name_;
+        const uint64_t index_;
+        clock::time_point start_;
+    };
+
+private:
+    struct event
+    {
+        const char* name;
+        uint64_t index;
+        bool stage;
+        clock::time_point start;
+        clock::duration duration;
+        std::thread::id thread;
+    };
+
+    struct trace
+    {
+        uint64_t sequence;
+        std::vector<event> events;
+    };
+
+    block_trace();
+
+    void add(const hash_digest& block, event&& item);
+    void write(const hash_digest& block, uint64_t height,
+        const trace& spans) const;
+
+    std::atomic<bool> enabled_;
+    clock::duration threshold_;
+    boost::filesystem::path directory_;
+
+    mutable std::mutex mutex_;
+    uint64_t sequence_;
+    std::map<hash_digest, trace> traces_;
+
+    static thread_local const hash_digest* current_;
+};
+
+} // namespace libbitcoin
+
+#endif
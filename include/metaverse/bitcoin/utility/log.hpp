@@ -21,6 +21,8 @@
 #ifndef MVS_LOG_HPP
 #define MVS_LOG_HPP
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <sstream>
@@ -56,6 +58,9 @@ public:
     /// Convert the log level value to English text.
     static std::string to_text(level value);
 
+    /// True if records of this level reach an output function.
+    static bool enabled(level value);
+
     // Stream to these functions.
     static log trace(const std::string& domain);
     static log debug(const std::string& domain);
@@ -64,21 +69,26 @@ public:
     static log error(const std::string& domain);
     static log fatal(const std::string& domain);
 
+    /// Values streamed to a disabled level are never formatted.
     template <typename Type>
     log& operator<<(Type const& value)
     {
-        stream_ << value;
+        if (enabled_)
+            stream_ << value;
+
         return *this;
     }
 
-    /// Set the output functor for this log instance.
+    /// Set the output functor for this log instance's level.
+    /// An empty functor disables the level.
     void set_output_function(functor value);
 
 private:
     typedef std::map<level, functor> destinations;
 
-    static void output_ignore(level value, const std::string& domain,
-        const std::string& body);
+    static uint32_t mask(level value);
+    static uint32_t mask(const destinations& values);
+
     static void output_cout(level value, const std::string& domain,
         const std::string& body);
     static void output_cerr(level value, const std::string& domain,
@@ -88,8 +98,10 @@ private:
         const std::string& domain, const std::string& body);
 
     static destinations destinations_;
+    static std::atomic<uint32_t> enabled_levels_;
 
     level level_;
+    bool enabled_;
     std::string domain_;
     std::ostringstream stream_;
 };
@@ -32,6 +32,10 @@ namespace libbitcoin {
 BCT_API void initialize_logging(bc::ofstream& debug, bc::ofstream& error,
     std::ostream& output_stream, std::ostream& error_stream, std::string level = "DEBUG");
 
+/// Stop global logging, writing out buffered records before returning.
+/// Call before the streams passed to initialize_logging are closed.
+BCT_API void finalize_logging();
+
 /// Class Logger
 class Logger{
 #define self Logger
@@ -47,7 +51,7 @@ public:
 
     ~self() noexcept
     {
-        log::clear();
+        finalize_logging();
         debug_log_.close();
         error_log_.close();
     }
@@ -0,0 +1,148 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_METRICS_HPP
+#define MVS_METRICS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <metaverse/bitcoin/define.hpp>
+
+namespace libbitcoin {
+
+/// Process wide registry of counters, gauges and latency histograms,
+/// rendered in the Prometheus text exposition format.
+/// Registration takes a lock, updates are lock free. Call sites keep the
+/// returned reference (e.g. in a function local static) so the hot path
+/// never touches the registry.
+class BC_API metrics
+{
+public:
+    /// Monotonically increasing value.
+    class BC_API counter
+    {
+    public:
+        void increment(uint64_t value=1);
+        uint64_t value() const;
+
+    private:
+        std::atomic<uint64_t> value_{0};
+    };
+
+    /// Value that may go up and down.
+    class BC_API gauge
+    {
+    public:
+        void set(int64_t value);
+        void add(int64_t value);
+        int64_t value() const;
+
+    private:
+        std::atomic<int64_t> value_{0};
+    };
+
+    /// Distribution of durations over fixed upper bounds, in seconds.
+    class BC_API histogram
+    {
+    public:
+        typedef std::vector<double> bounds;
+
+        /// 100us to 10s, suits everything from a query to a block connect.
+        static const bounds default_bounds;
+
+        histogram(const bounds& upper_bounds);
+
+        void observe(double seconds);
+
+        template <typename Duration>
+        void observe(Duration duration)
+        {
+            observe(std::chrono::duration<double>(duration).count());
+        }
+
+        const bounds& upper_bounds() const;
+
+        /// Per bucket counts, the last one is the overflow (+Inf) bucket.
+        std::vector<uint64_t> counts() const;
+        uint64_t count() const;
+        double sum() const;
+
+    private:
+        const bounds bounds_;
+        std::unique_ptr<std::atomic<uint64_t>[]> counts_;
+        std::atomic<uint64_t> count_{0};
+
+        // Microseconds, so the sum can be kept in an integer atomic.
+        std::atomic<uint64_t> sum_{0};
+    };
+
+    /// Observes the lifetime of the scope into a histogram.
+    class BC_API stopwatch
+    {
+    public:
+        stopwatch(histogram& target);
+        ~stopwatch();
+
+        /// This class is not copyable.
+        stopwatch(const stopwatch&) = delete;
+        void operator=(const stopwatch&) = delete;
+
+    private:
+        histogram& target_;
+        const std::chrono::steady_clock::time_point start_;
+    };
+
+    static metrics& instance();
+
+    /// Returns the existing metric if the name is already registered.
+    counter& make_counter(const std::string& name, const std::string& help);
+    gauge& make_gauge(const std::string& name, const std::string& help);
+    histogram& make_histogram(const std::string& name,
+        const std::string& help,
+        const histogram::bounds& upper_bounds=histogram::default_bounds);
+
+    /// Render all metrics, ordered by name.
+    std::string to_text() const;
+
+private:
+    template <typename Metric>
+    struct entry
+    {
+        std::string help;
+        std::unique_ptr<Metric> metric;
+    };
+
+    metrics() = default;
+
+    mutable std::mutex mutex_;
+    std::map<std::string, entry<counter>> counters_;
+    std::map<std::string, entry<gauge>> gauges_;
+    std::map<std::string, entry<histogram>> histograms_;
+};
+
+} // namespace libbitcoin
+
+#endif
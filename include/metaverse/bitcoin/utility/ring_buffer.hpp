@@ -0,0 +1,72 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_RING_BUFFER_HPP
+#define MVS_RING_BUFFER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace libbitcoin {
+
+/// Bounded lock-free multiple producer, multiple consumer queue.
+/// Each slot carries a sequence number that tells producers and consumers
+/// whether it is free, so neither side ever takes a lock.
+template <typename Item>
+class ring_buffer
+{
+public:
+    /// The capacity is rounded up to a power of two.
+    ring_buffer(size_t capacity);
+
+    /// This class is not copyable.
+    ring_buffer(const ring_buffer&) = delete;
+    void operator=(const ring_buffer&) = delete;
+
+    /// Move the item in if a slot is free, the item is untouched otherwise.
+    bool push(Item&& item);
+
+    /// Move the oldest item out, false if the buffer is empty.
+    bool pop(Item& out_item);
+
+    size_t capacity() const;
+
+private:
+    struct slot
+    {
+        std::atomic<size_t> sequence;
+        Item item;
+    };
+
+    static size_t round_up(size_t capacity);
+
+    const size_t mask_;
+    std::unique_ptr<slot[]> slots_;
+
+    // Keep the cursors on separate cache lines to avoid false sharing.
+    alignas(64) std::atomic<size_t> enqueue_;
+    alignas(64) std::atomic<size_t> dequeue_;
+};
+
+} // namespace libbitcoin
+
+#include <metaverse/bitcoin/impl/utility/ring_buffer.ipp>
+
+#endif
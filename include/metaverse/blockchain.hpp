@@ -26,6 +26,8 @@
 #include <metaverse/blockchain/block_detail.hpp>
 #include <metaverse/blockchain/block_fetcher.hpp>
 #include <metaverse/blockchain/define.hpp>
+#include <metaverse/blockchain/fee_estimator.hpp>
+#include <metaverse/blockchain/fee_rate_index.hpp>
 #include <metaverse/blockchain/organizer.hpp>
 #include <metaverse/blockchain/orphan_pool.hpp>
 #include <metaverse/blockchain/settings.hpp>
@@ -0,0 +1,102 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_BLOCKCHAIN_ACCOUNT_SESSION_HPP
+#define MVS_BLOCKCHAIN_ACCOUNT_SESSION_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// Decrypted address keys of accounts unlocked for a bounded time, so that
+/// signing commands skip the per address aes decryption. The keys of one
+/// account share a buffer that is locked in ram where the os allows and is
+/// zeroized on lock, expiry, replacement and destruction.
+/// This class is thread safe.
+class BCB_API account_session
+{
+public:
+    typedef std::pair<std::string, ec_secret> address_key;
+    typedef std::vector<address_key> address_key_list;
+
+    /// The longest an account may stay unlocked.
+    static const uint32_t max_unlock_seconds;
+
+    account_session();
+    ~account_session();
+
+    account_session(const account_session&) = delete;
+    void operator=(const account_session&) = delete;
+
+    /// Unlock an account for seconds (at most max_unlock_seconds),
+    /// replacing an earlier session. passwd is the stored password hash,
+    /// lookups must present it again.
+    void unlock(const std::string& name, const hash_digest& passwd,
+        const address_key_list& keys, uint32_t seconds);
+
+    /// End the session of an account, if any.
+    void lock(const std::string& name);
+
+    /// Seconds left in the session of an account, zero if locked.
+    uint32_t remaining(const std::string& name);
+
+    /// The key of an address of an unlocked account.
+    bool find(ec_secret& out_key, const std::string& name,
+        const hash_digest& passwd, const std::string& address);
+
+private:
+    typedef std::chrono::steady_clock clock;
+
+    struct session
+    {
+        session(size_t count);
+        ~session();
+
+        hash_digest passwd;
+        clock::time_point expiry;
+        std::unordered_map<std::string, size_t> slots;
+        uint8_t* keys;
+        size_t size;
+    };
+
+    typedef std::unique_ptr<session> session_ptr;
+
+    /// Drop expired sessions, call with mutex_ held. There is no timer,
+    /// every call purges, so keys outlive expiry only until the next call.
+    void purge_expired();
+
+    std::map<std::string, session_ptr> sessions_;
+    shared_mutex mutex_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
@@ -28,6 +28,7 @@
 #include <functional>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/database.hpp>
+#include <metaverse/blockchain/account_session.hpp>
 #include <metaverse/blockchain/block_chain.hpp>
 #include <metaverse/blockchain/define.hpp>
 #include <metaverse/blockchain/organizer.hpp>
@@ -48,12 +49,15 @@ typedef console_result operation_result;
 class block_chain_impl;
 
 // encap to safer write database
+// Holds the exclusive chain mutex for the commit only, validation that
+// precedes it runs under the organize mutex and does not block the mutex.
 class block_chain_writer {
 public:
     block_chain_writer(block_chain_impl& chain);
     ~block_chain_writer();
 private:
     block_chain_impl& chain_;
+    unique_lock lock_;
 };
 
 /// The simple_chain interface portion of this class is not thread safe.
@@ -94,6 +98,11 @@ public:
     /// Close the blockchain, threads must first be joined, can be restarted.
     virtual bool close() override;
 
+    /// Write a snapshot archive of the running chain at its top block, block
+    /// and account writes wait until it is complete.
+    bool export_snapshot(const boost::filesystem::path& file,
+        uint64_t& out_height);
+
     // simple_chain (NOT THREAD SAFE).
     // ------------------------------------------------------------------------
 
@@ -108,9 +117,18 @@ public:
 
     /// Get the header of the block at the given height.
     bool get_header(chain::header& out_header, uint64_t height) const override;
+
+    /// Get the headers in [from_height, to_height), stopping at a gap.
+    chain::header::list get_headers(uint64_t from_height,
+        uint64_t to_height) const;
+
     uint64_t get_transaction_count(uint64_t block_height) const;
     uint32_t get_block_timestamp(uint64_t height) const;
 
+    /// Get the signers (dpos slot number and public key) of blocks in [from_height, to_height).
+    database::witness_signer::list get_witness_signers(
+        uint64_t from_height, uint64_t to_height) const;
+
     bool get_signature(ec_signature& blocksig, uint64_t height) const override;
     bool get_public_key(ec_compressed& public_key, uint64_t height) const override;
     bool get_signature_and_public_key(ec_signature& blocksig, ec_compressed& public_key, uint64_t height) const override;
@@ -121,6 +139,9 @@ public:
     /// Get height of latest block.
     bool get_last_height(uint64_t& out_height) const override;
 
+    /// Get the height at and below which spent transactions may be pruned.
+    uint64_t get_pruned_height() const;
+
     /// Get the hash digest of the transaction of the outpoint.
     bool get_outpoint_transaction(hash_digest& out_transaction,
         const chain::output_point& outpoint) const override;
@@ -300,6 +321,14 @@ public:
     operation_result delete_account(const std::string& name);
     operation_result delete_account_address(const std::string& name);
 
+    // unlocked account sessions, signing reuses the decrypted address keys
+    uint32_t unlock_account(const std::string& name, const std::string& passwd,
+        uint32_t seconds);
+    void lock_account(const std::string& name);
+    uint32_t get_account_unlock_remaining(const std::string& name);
+    std::string get_account_prv_key(const std::string& name,
+        const std::string& passwd, const chain::account_address& address);
+
     std::shared_ptr<chain::business_history::list> get_address_business_history(
         const std::string& addr, chain::business_kind kind, uint8_t confirmed);
     std::shared_ptr<chain::business_history::list> get_address_business_history(
@@ -327,6 +356,9 @@ public:
     std::shared_ptr<chain::asset_detail::list> get_local_assets();
     std::shared_ptr<chain::asset_detail::list> get_issued_assets(
         const std::string& symbol="", const std::string& address="");
+    std::shared_ptr<chain::asset_detail::list> get_issued_assets(
+        const std::string& prefix, uint64_t offset, uint64_t limit);
+    uint64_t get_issued_asset_count(const std::string& prefix="");
     std::shared_ptr<chain::asset_detail> get_issued_asset(const std::string& symbol);
     std::shared_ptr<chain::blockchain_asset> get_issued_blockchain_asset(const std::string& symbol);
     std::shared_ptr<chain::business_address_asset::list> get_account_assets();
@@ -353,6 +385,9 @@ public:
     uint64_t get_asset_mit_height(const std::string& mit_symbol)const;
     std::shared_ptr<chain::asset_mit_info> get_registered_mit(const std::string& symbol);
     std::shared_ptr<chain::asset_mit_info::list> get_registered_mits();
+    std::shared_ptr<chain::asset_mit_info::list> get_registered_mits(
+        const std::string& prefix, uint64_t offset, uint64_t limit);
+    uint64_t get_registered_mit_count(const std::string& prefix="");
     std::shared_ptr<chain::asset_mit_info::list> get_mit_history(const std::string& symbol,
         uint64_t limit = 0, uint64_t page_number = 0);
     std::shared_ptr<chain::asset_mit::list> get_account_mits(
@@ -366,6 +401,9 @@ public:
     std::string get_did_from_address(const std::string& address, uint64_t fork_index = max_uint64);
     std::shared_ptr<chain::did_detail> get_registered_did(const std::string& symbol) const;
     std::shared_ptr<chain::did_detail::list> get_registered_dids();
+    std::shared_ptr<chain::did_detail::list> get_registered_dids(
+        const std::string& prefix, uint64_t offset, uint64_t limit);
+    uint64_t get_registered_did_count(const std::string& prefix="");
     std::shared_ptr<chain::did_detail::list> get_account_dids(const std::string& account);
 
     //get history addresses from did symbol
@@ -391,6 +429,7 @@ public:
     operation_result store_account_address(std::shared_ptr<chain::account_address> address);
     std::shared_ptr<chain::account_address> get_account_address(const std::string& name, const std::string& address);
     std::shared_ptr<chain::account_address::list> get_account_addresses(const std::string& name);
+    std::vector<std::string> get_address_owners(const std::string& address);
     void uppercase_symbol(std::string& symbol);
 
     static bool is_valid_address(const std::string& address);
@@ -410,7 +449,13 @@ public:
     bool get_tx_inputs_etp_value (chain::transaction& tx, uint64_t& etp_val);
     void safe_store_account(chain::account& acc, std::vector<std::shared_ptr<chain::account_address>>& addresses);
 
+    /// Exclusive for chain commits and local account writes.
     shared_mutex& get_mutex();
+
+    /// Exclusive for a whole organize pass, validation and commit. Take it
+    /// before get_mutex() to keep the chain from moving under an organize.
+    shared_mutex& get_organize_mutex();
+
     bool is_sync_disabled() const;
     void set_sync_disabled(bool b);
 
@@ -510,6 +555,8 @@ private:
 
     void stop_write();
     void start_write();
+    void start_prune();
+    void do_prune();
     void do_store(message::block_message::ptr block,
         block_store_handler handler);
 
@@ -523,17 +570,25 @@ private:
 private:
     std::atomic<bool> stopped_;
     std::atomic<bool> sync_disabled_;
+    std::atomic<bool> pruning_;
     const settings& settings_;
 
     // These are thread safe.
+    threadpool& pool_;
     organizer organizer_;
     ////dispatcher read_dispatch_;
     ////dispatcher write_dispatch_;
     blockchain::transaction_pool transaction_pool_;
 
+    // This is thread safe.
+    account_session account_sessions_;
+
     // This is protected by mutex.
     database::data_base database_;
     shared_mutex mutex_;
+
+    // Serializes organize passes, the organizer is not thread safe.
+    shared_mutex organize_mutex_;
 };
 
 } // namespace blockchain
@@ -0,0 +1,91 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_BLOCKCHAIN_FEE_ESTIMATOR_HPP
+#define MVS_BLOCKCHAIN_FEE_ESTIMATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// Estimates the fee rate needed to confirm within a number of blocks from
+/// how long pool transactions of each fee rate bucket took to be mined.
+/// Transactions are tracked from pool entry, counted in their bucket when a
+/// connected block confirms them, and history decays with every block so the
+/// estimate follows current demand. Fee rates are satoshi per kilobyte.
+/// This class is thread safe.
+class BCB_API fee_estimator
+{
+public:
+    /// The longest confirmation target estimated, in blocks.
+    static const size_t max_target;
+
+    fee_estimator();
+
+    /// Set the height of the chain top, before transactions are tracked.
+    void set_height(uint64_t height);
+
+    /// Start tracking a transaction entering the pool.
+    void track(const hash_digest& hash, uint64_t fee_rate);
+
+    /// Stop tracking a transaction that left the pool unconfirmed.
+    void untrack(const hash_digest& hash);
+    void untrack_all();
+
+    /// Record the tracked transactions a connected block confirms.
+    void confirm(const chain::block& block, uint64_t height);
+
+    /// The lowest fee rate that confirmed within target blocks for
+    /// nearly all transactions paying it, false without enough history.
+    bool estimate(uint64_t& out_fee_rate, size_t target) const;
+
+private:
+    struct tracked
+    {
+        size_t bucket;
+        uint64_t height;
+    };
+
+    struct bucket
+    {
+        /// Decayed count of transactions confirmed, and of those confirmed
+        /// within each target (index target - 1).
+        double total;
+        std::vector<double> confirmed;
+    };
+
+    size_t bucket_of(uint64_t fee_rate) const;
+
+    std::vector<uint64_t> bounds_;
+    std::vector<bucket> buckets_;
+    std::unordered_map<hash_digest, tracked> tracked_;
+    uint64_t height_;
+    mutable shared_mutex mutex_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_BLOCKCHAIN_FEE_RATE_INDEX_HPP
+#define MVS_BLOCKCHAIN_FEE_RATE_INDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <unordered_map>
+#include <vector>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// Pool transactions ordered by the fee rate of their ancestor package, the
+/// transaction together with every unconfirmed transaction it spends from.
+/// A package only holds ancestors, so a high fee child ranks its whole
+/// package and a low fee parent keeps its own rate.
+/// Fee rates are in satoshi per kilobyte of serialized transaction.
+/// This class is not thread safe.
+class BCB_API fee_rate_index
+{
+public:
+    /// Add a transaction paying fee, false if it is already indexed.
+    /// Inputs that spend indexed transactions link it to them as parents.
+    bool add(const chain::transaction& tx, uint64_t fee);
+
+    /// Remove a transaction, its descendants lose it from their packages.
+    bool remove(const hash_digest& hash);
+
+    void clear();
+    bool contains(const hash_digest& hash) const;
+    size_t size() const;
+
+    /// The fee rate of the transaction alone and of its package.
+    bool fee_rate(uint64_t& out_rate, const hash_digest& hash) const;
+    bool package_fee_rate(uint64_t& out_rate, const hash_digest& hash) const;
+
+    /// Hashes from the highest package fee rate down, at most limit (0 all).
+    /// Each package is emitted parents first, ahead of its own rank where
+    /// a child pulls it forward, so any prefix is a valid block order.
+    hash_list ranked(size_t limit=0) const;
+
+    static uint64_t to_fee_rate(uint64_t fee, uint64_t size);
+
+private:
+    struct rank
+    {
+        double rate;
+        hash_digest hash;
+
+        bool operator<(const rank& other) const;
+    };
+
+    struct entry
+    {
+        uint64_t fee;
+        uint64_t size;
+        uint64_t package_fee;
+        uint64_t package_size;
+        double package_rate;
+        hash_list parents;
+        hash_list children;
+    };
+
+    typedef std::unordered_map<hash_digest, entry> entry_map;
+
+    /// All transitive relatives of an entry, excluding itself.
+    hash_list relatives(const hash_digest& hash, bool ancestors) const;
+
+    void rerank(const hash_digest& hash, entry& entry, double rate);
+
+    entry_map entries_;
+    std::set<rank> ranks_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
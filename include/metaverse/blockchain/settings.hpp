@@ -43,6 +43,8 @@ public:
     bool use_testnet_rules;
     bool collect_split_stake;
     bool disable_account_operations;
+    uint32_t block_trace_threshold_ms;
+    boost::filesystem::path block_trace_directory;
     config::checkpoint::list checkpoints;
     config::checkpoint::list basic_checkpoints;
 };
@@ -28,6 +28,8 @@
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/blockchain/define.hpp>
 #include <metaverse/blockchain/block_chain.hpp>
+#include <metaverse/blockchain/fee_estimator.hpp>
+#include <metaverse/blockchain/fee_rate_index.hpp>
 #include <metaverse/blockchain/settings.hpp>
 #include <metaverse/blockchain/transaction_pool_index.hpp>
 
@@ -77,6 +79,15 @@ public:
     void inventory(message::inventory::ptr inventory);
     void fetch(const hash_digest& tx_hash, fetch_handler handler);
     void fetch(fetch_all_handler handler);
+
+    /// Fetch pool transactions from the highest ancestor package fee rate
+    /// down, at most limit (0 for all). Parents precede their children.
+    void fetch_by_fee_rate(size_t limit, fetch_all_handler handler);
+
+    /// The fee rate (satoshi per kilobyte) that has recently confirmed
+    /// within target blocks, false without enough history.
+    bool estimate_fee_rate(uint64_t& out_fee_rate, size_t target) const;
+
     void delete_tx(const hash_digest& tx_hash);
     void fetch_history(const wallet::payment_address& address, size_t limit,
         size_t from_height, block_chain::history_fetch_handler handler);
@@ -101,6 +112,8 @@ protected:
     typedef buffer::const_iterator const_iterator;
 
     typedef std::function<bool(const chain::input&)> input_compare;
+    typedef std::function<void(const code&, transaction_ptr, const indexes&,
+        uint64_t)> fee_handler;
     typedef message::block_message::ptr_list block_list;
 
     bool stopped();
@@ -109,18 +122,18 @@ protected:
     bool handle_reorganized(const code& ec, size_t fork_point,
         const block_list& new_blocks, const block_list& replaced_blocks);
     void handle_validated(const code& ec, transaction_ptr tx,
-        const indexes& unconfirmed, validate_handler handler);
+        const indexes& unconfirmed, uint64_t fee, fee_handler handler);
 
-    void do_validate(transaction_ptr tx, validate_handler handler);
+    void do_validate(transaction_ptr tx, fee_handler handler);
     void do_store(const code& ec, transaction_ptr tx,
-        const indexes& unconfirmed, confirm_handler handle_confirm,
-        validate_handler handle_validate);
+        const indexes& unconfirmed, uint64_t fee,
+        confirm_handler handle_confirm, validate_handler handle_validate);
 
     void notify_transaction(const chain::point::indexes& unconfirmed,
         transaction_ptr tx);
 
-    void add(transaction_ptr tx, confirm_handler handler);
-    void remove(const block_list& blocks);
+    void add(transaction_ptr tx, uint64_t fee, confirm_handler handler);
+    void remove(size_t fork_point, const block_list& blocks);
     void clear(const code& ec);
 
     code check_symbol_repeat(transaction_ptr tx);
@@ -134,9 +147,11 @@ protected:
     void delete_package(const code& ec);
     void delete_package(transaction_ptr tx, const code& ec);
     bool delete_single(const hash_digest& tx_hash, const code& ec);
+    void unindex(const hash_digest& tx_hash);
 
-    // The buffer is protected by non-concurrent dispatch.
+    // The buffer and its fee index are protected by non-concurrent dispatch.
     buffer buffer_;
+    fee_rate_index fee_index_;
     std::atomic<bool> stopped_;
 
 private:
@@ -155,6 +170,7 @@ private:
     dispatcher dispatch_;
     block_chain& blockchain_;
     transaction_pool_index index_;
+    fee_estimator fee_estimator_;
     transaction_subscriber::ptr subscriber_;
     const bool maintain_consistency_;
 };
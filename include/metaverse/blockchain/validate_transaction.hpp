@@ -55,10 +55,26 @@ public:
 
     void start(validate_handler handler);
 
+    /// Verify the input script against the previous output script, using
+    /// check_standard when it recognizes the scripts and the interpreter
+    /// otherwise.
     static bool check_consensus(const chain::script& prevout_script,
         const chain::transaction& current_tx, uint64_t input_index,
         uint32_t flags);
 
+    /// Verify the input script with the generic script interpreter.
+    static bool check_interpreter(const chain::script& prevout_script,
+        const chain::transaction& current_tx, uint64_t input_index,
+        uint32_t flags);
+
+    /// Verify pay-key-hash and pay-key-hash-with-lock-height inputs directly,
+    /// with one hash160 comparison and one signature verification.
+    /// Returns false if the scripts do not match those templates exactly,
+    /// otherwise sets out_valid to the result the interpreter would give.
+    static bool check_standard(const chain::script& prevout_script,
+        const chain::transaction& current_tx, uint64_t input_index,
+        uint32_t flags, bool& out_valid);
+
     code check_transaction_version() const;
     code check_transaction_connect_input(uint64_t last_height);
     code check_transaction() const;
@@ -102,6 +118,10 @@ public:
     const validate_block* get_validate_block() const;
     uint64_t get_height() const;
 
+    /// The value spent by the inputs connected so far, all of them once
+    /// the handler reports success.
+    uint64_t get_value_in() const;
+
 private:
     code basic_checks() const;
     bool is_standard() const;
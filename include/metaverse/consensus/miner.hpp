@@ -51,12 +51,6 @@ public:
     typedef std::shared_ptr<message::block_message> block_ptr;
     typedef message::transaction_message::ptr transaction_ptr;
 
-    // prev_output_point -> (prev_block_height, prev_output)
-    typedef std::unordered_map<chain::point, std::pair<uint64_t, chain::output>> previous_out_map_t;
-
-    // tx_hash -> tx_fee
-    typedef std::unordered_map<hash_digest, uint64_t> tx_fee_map_t;
-
     miner(node::p2p_node& node);
     ~miner();
 
@@ -70,10 +64,6 @@ public:
     bool start(const wallet::payment_address& pay_address, uint16_t number = 0);
     bool stop();
     static block_ptr create_genesis_block(bool is_mainnet);
-    bool script_hash_signature_operations_count(uint64_t &count, const chain::input::list& inputs,
-        std::vector<transaction_ptr>& transactions);
-    bool script_hash_signature_operations_count(uint64_t &count, const chain::input& input,
-        std::vector<transaction_ptr>& transactions);
 
     block_ptr get_block(bool is_force_create_block = false);
     bool get_work(std::string& seed_hash, std::string& header_hash, std::string& boundary);
@@ -135,13 +125,12 @@ private:
     ec_secret& get_private_key();
 
     uint32_t get_adjust_time(uint64_t height) const;
-    bool get_transaction(uint64_t last_height, std::vector<transaction_ptr>&, previous_out_map_t&, tx_fee_map_t&) const;
+    void update_template(uint64_t last_height);
     bool get_block_transactions(
         uint64_t last_height, std::vector<transaction_ptr>& txs, std::vector<transaction_ptr>& reward_txs,
         uint64_t& total_fee, uint32_t& total_tx_sig_length);
     uint64_t store_block(block_ptr block);
     uint64_t get_height() const;
-    bool get_input_etp(const chain::transaction&, const std::vector<transaction_ptr>&, uint64_t&, previous_out_map_t&) const ;
     bool is_stop_miner(uint64_t block_height, block_ptr block) const;
     uint32_t get_tx_sign_length(transaction_ptr tx);
     void sleep_for_mseconds(uint32_t interval, bool force = false);
@@ -168,6 +157,33 @@ private:
         const std::string& to_did,
         const wallet::payment_address& pay_address);
 
+    // A pool transaction with what block assembly needs from it, resolved
+    // once when it enters the template instead of for every new block.
+    struct template_entry
+    {
+        transaction_ptr tx;
+        uint64_t fee;
+        uint64_t size;
+        uint64_t block_size;
+        uint32_t sigops;
+        uint64_t script_hash_sigops;
+        bool script_hash_counted;
+        bool lock_height_output;
+
+        // Position in the pool's package fee rate ranking, parents first.
+        size_t rank;
+
+        // (previous height, value) per input, max_uint64 for a pool parent.
+        std::vector<std::pair<uint64_t, uint64_t>> inputs;
+        std::vector<hash_digest> pool_parents;
+    };
+
+    typedef std::unordered_map<hash_digest, transaction_ptr> pool_map;
+    typedef std::unordered_map<hash_digest, template_entry> template_map;
+
+    bool resolve_template_entry(template_entry& entry, const pool_map& pool) const;
+    bool check_template_spends(const template_entry& entry) const;
+
 private:
     node::p2p_node& node_;
     std::shared_ptr<boost::thread> thread_;
@@ -187,6 +203,11 @@ private:
     };
     mining_context pool_context, solo_context;
     bool is_solo_mining_;
+
+    // The block template, kept in step with the pool and the chain height.
+    boost::mutex template_mutex_;
+    template_map template_;
+    uint64_t template_height_;
 };
 
 }
@@ -28,6 +28,7 @@
 #include <metaverse/database/memory/allocator.hpp>
 #include <metaverse/database/memory/memory.hpp>
 #include <metaverse/database/memory/memory_map.hpp>
+#include <metaverse/database/primitives/fixed_rows.hpp>
 #include <metaverse/database/primitives/hash_table_header.hpp>
 #include <metaverse/database/primitives/record_hash_table.hpp>
 #include <metaverse/database/primitives/record_list.hpp>
@@ -37,6 +38,7 @@
 #include <metaverse/database/primitives/record_multimap_iterator.hpp>
 #include <metaverse/database/primitives/slab_hash_table.hpp>
 #include <metaverse/database/primitives/slab_manager.hpp>
+#include <metaverse/database/primitives/symbol_index.hpp>
 #include <metaverse/database/result/block_result.hpp>
 #include <metaverse/database/result/transaction_result.hpp>
 
@@ -22,8 +22,10 @@
 #define MVS_DATABASE_DATA_BASE_HPP
 
 #include <atomic>
+#include <condition_variable>
 #include <cstddef>
 #include <memory>
+#include <mutex>
 #include <boost/filesystem.hpp>
 #include <boost/interprocess/sync/file_lock.hpp>
 #include <metaverse/bitcoin.hpp>
@@ -59,6 +61,7 @@
 #include <metaverse/database/databases/address_mit_database.hpp>
 #include <metaverse/database/databases/mit_history_database.hpp>
 #include <metaverse/database/databases/blockchain_witness_profile_database.hpp>
+#include <metaverse/database/databases/blockchain_witness_signer_database.hpp>
 
 namespace libbitcoin {
 namespace database {
@@ -85,6 +88,8 @@ public:
         bool mits_exist() const;
         bool touch_witness_profiles() const;
         bool witness_profiles_exist() const;
+        bool touch_witness_signers() const;
+        bool witness_signers_exist() const;
 
         path database_lock;
         path blocks_lookup;
@@ -101,11 +106,14 @@ public:
         path witness_certs_lookup;
         path address_assets_lookup;
         path address_assets_rows;
+        path address_assets_payload;
         path account_assets_lookup;
         path account_assets_rows;
+        path account_assets_payload;
         path dids_lookup;
         path address_dids_lookup;
         path address_dids_rows;
+        path address_dids_payload;
         path account_addresses_lookup;
         path account_addresses_rows;
         /* end database for account, asset, address_asset, did ,address_did relationship */
@@ -115,6 +123,8 @@ public:
         path mit_history_lookup;
         path mit_history_rows;
         path witness_profiles_lookup;
+        path witness_signers_index;
+        path pruned_height;
     };
 
     class db_metadata
@@ -151,6 +161,17 @@ public:
     /// If database exists then upgrades to version 64.
     static bool upgrade_version_64(const path& prefix);
 
+    /// If database exists then upgrades to version 65.
+    static bool upgrade_version_65(const path& prefix);
+
+    /// If database exists then upgrades to version 66.
+    static bool upgrade_version_66(const path& prefix);
+
+    /// Create a database from a snapshot archive in the (empty) prefix
+    /// directory, verifying the archive and the blocks at the checkpoints.
+    static bool import_snapshot(const path& file, const path& prefix,
+        const config::checkpoint::list& checkpoints);
+
     static bool touch_file(const path& file_path);
     static void write_metadata(const path& metadata_path, data_base::db_metadata& metadata);
     static void read_metadata(const path& metadata_path, data_base::db_metadata& metadata);
@@ -169,6 +190,7 @@ public:
     bool create_witness_certs();
     bool create_mits();
     bool create_witness_profiles();
+    bool create_witness_signers();
 
     /// Start all databases.
     bool start();
@@ -179,10 +201,19 @@ public:
     /// Stop all databases (threads must be joined).
     bool close();
 
+    /// Write a snapshot archive of the chain state at the top block.
+    /// Local account tables are not exported. The caller holds off writers
+    /// until it returns, readers are not held.
+    bool export_snapshot(const path& file);
+
     // Locking.
     // ------------------------------------------------------------------------
 
     handle begin_read();
+
+    /// Block while a write is in progress, the writer wakes us as it ends.
+    handle wait_read();
+
     bool begin_write();
     bool end_write();
     bool is_read_valid(handle handle);
@@ -201,6 +232,25 @@ public:
     /// Throws if the chain is empty.
     bool pop(chain::block& block);
 
+    /// Pop every block at and above height, top first, as one batch synced
+    /// once at the end. Given a pool and more than one block, the databases
+    /// are rolled back in parallel on it, otherwise on the calling thread.
+    /// Fails without change if any block of the range cannot be read.
+    bool pop_from(chain::block::list& out_blocks, size_t height,
+        threadpool* pool=nullptr);
+
+    /// Prune up to count of the blocks that left the retention depth and
+    /// give back the space pruned at least reclaim_delay ago. Returns true if
+    /// more blocks are waiting. The caller holds the write lock, as for push.
+    bool prune(size_t count);
+
+    /// Height at and below which spent history and transactions have been
+    /// pruned, zero if nothing was pruned.
+    size_t pruned_height() const;
+
+    /// The retention depth in blocks, zero if pruning is disabled.
+    size_t prune_depth() const;
+
     /* begin store asset info into  database */
 
     void push_attachment(const chain::attachment& attach, const wallet::payment_address& address,
@@ -314,9 +364,18 @@ public:
     void set_blackhole_did();
    /* begin store asset info into  database */
 
+    /// Pruning keeps at least two witness epoch cycles for reorganization.
+    static const size_t minimum_prune_depth;
+
+    /// Pruned rows read as zeros once their space is given back, readers
+    /// that do not take the sequential lock are done with them long before.
+    static const asio::duration reclaim_delay;
+
 protected:
-    data_base(const store& paths, size_t history_height, size_t stealth_height);
-    data_base(const path& prefix, size_t history_height, size_t stealth_height);
+    data_base(const store& paths, size_t history_height, size_t stealth_height,
+        size_t prune_depth=0);
+    data_base(const path& prefix, size_t history_height, size_t stealth_height,
+        size_t prune_depth=0);
 
 private:
     typedef chain::input::list inputs;
@@ -329,6 +388,7 @@ private:
     static bool initialize_witness_certs(const path& prefix);
     static bool initialize_mits(const path& prefix);
     static bool initialize_witness_profiles(const path& prefix);
+    static bool initialize_witness_signers(const path& prefix);
 
     static void uninitialize_lock(const path& lock);
     static file_lock initialize_lock(const path& lock);
@@ -339,6 +399,7 @@ private:
     void synchronize_witness_certs();
     void synchronize_mits();
     void synchronize_witness_profiles();
+    void synchronize_witness_signers();
 
     void push_inputs(const hash_digest& tx_hash, size_t height,
         const inputs& inputs);
@@ -346,16 +407,35 @@ private:
         const outputs& outputs);
     void push_stealth(const hash_digest& tx_hash, size_t height,
         const outputs& outputs);
-    void pop_inputs(const inputs& inputs, size_t height);
-    void pop_outputs(const outputs& outputs, size_t height);
+    bool read_block(chain::block& block, size_t height) const;
+
+    // Rollbacks of pop_from, one per independent set of databases.
+    void pop_transactions(const chain::block::list& popped, size_t top);
+    void pop_spends(const chain::block::list& popped, size_t top);
+    void pop_history(const chain::block::list& popped, size_t top);
+    void pop_address_assets(const chain::block::list& popped, size_t top);
+    void pop_assets(const chain::block::list& popped, size_t top);
+    void pop_dids(const chain::block::list& popped, size_t top);
+    void pop_certs(const chain::block::list& popped, size_t top);
+    void pop_mits(const chain::block::list& popped, size_t top);
+    void prune_block(size_t height);
+    bool prune_transaction(const hash_digest& tx_hash, size_t height);
+    void write_pruned_height(size_t height);
 
     const path lock_file_path_;
+    const path pruned_height_path_;
     const size_t history_height_;
     const size_t stealth_height_;
+    const size_t prune_depth_;
+    std::atomic<size_t> pruned_height_;
 
     // Atomic counter for implementing the sequential lock pattern.
     sequential_lock sequential_lock_;
 
+    // Readers waiting out a write sleep here until end_write.
+    std::mutex write_mutex_;
+    std::condition_variable write_ended_;
+
     // Allows us to restrict database access to our process (or fail).
     std::shared_ptr<file_lock> file_lock_;
 
@@ -388,6 +468,7 @@ public:
     address_mit_database address_mits;
     mit_history_database mit_history;
     blockchain_witness_profile_database witness_profiles;
+    blockchain_witness_signer_database witness_signers;
 };
 
 } // namespace database
@@ -22,6 +22,9 @@
 #define MVS_DATABASE_ACCOUNT_ADDRESS_DATABASE_HPP
 
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include <boost/filesystem.hpp>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/database/define.hpp>
@@ -47,6 +50,8 @@ struct BCD_API account_address_statinfo
 
 /// This is a multimap where the key is the Bitcoin address hash,
 /// which returns several rows giving the account_address for that address.
+/// The rows are indexed in memory by (key, address) and by address, so a
+/// single address is found without reading the rest of the account.
 class BCD_API account_address_database
 {
 public:
@@ -84,6 +89,9 @@ public:
 
     void safe_store(const short_hash& key, const chain::account_address& address);
 
+    /// get the names of the accounts holding address
+    std::vector<std::string> get_address_owners(const std::string& address) const;
+
     /// Synchonise with disk.
     void sync();
 
@@ -93,6 +101,14 @@ public:
 private:
     typedef record_hash_table<short_hash> record_map;
     typedef record_multimap<short_hash> record_multiple_map;
+    typedef std::unordered_map<std::string, array_index> address_rows;
+
+    chain::account_address read_row(array_index row) const;
+    void load_index();
+    void index_row(const short_hash& key, const chain::account_address& address,
+        array_index row);
+    void unindex_row(const short_hash& key, const std::string& address,
+        array_index row);
 
     /// Hash table used for start index lookup for linked list by address hash.
     memory_map lookup_file_;
@@ -105,6 +121,11 @@ private:
     record_manager rows_manager_;
     record_list rows_list_;
     record_multiple_map rows_multimap_;
+
+    /// Row of each address by key, and the accounts holding each address.
+    std::unordered_map<short_hash, address_rows> index_;
+    std::unordered_map<std::string, std::vector<std::string>> owners_;
+    mutable shared_mutex index_mutex_;
 };
 
 } // namespace database
@@ -26,6 +26,7 @@
 #include <metaverse/database/define.hpp>
 #include <metaverse/database/memory/memory_map.hpp>
 #include <metaverse/database/primitives/record_multimap.hpp>
+#include <metaverse/database/primitives/slab_manager.hpp>
 #include <metaverse/bitcoin/chain/attachment/asset/asset_detail.hpp>
 #include <metaverse/bitcoin/chain/business_data.hpp>
 
@@ -53,6 +54,7 @@ public:
     /// Construct the database.
     account_asset_database(const boost::filesystem::path& lookup_filename,
         const boost::filesystem::path& rows_filename,
+        const boost::filesystem::path& payload_filename,
         std::shared_ptr<shared_mutex> mutex=nullptr);
 
     /// Close the database (all threads must first be stopped).
@@ -74,6 +76,10 @@ public:
 
     void delete_last_row(const short_hash& key);
 
+    /// Convert a rows file of the fixed size layout (database version
+    /// 0.6.5 and before) into the rows and payload files of this database.
+    bool upgrade_rows(const boost::filesystem::path& fixed_rows_filename);
+
     chain::asset_detail::list get(const short_hash& key) const;
 
     std::shared_ptr<chain::asset_detail> get(const short_hash& key, const std::string& address) const;
@@ -91,6 +97,9 @@ private:
     typedef record_hash_table<short_hash> record_map;
     typedef record_multimap<short_hash> record_multiple_map;
 
+    /// Read a row and its asset detail from the payload file.
+    chain::asset_detail read_row(uint8_t* data) const;
+
     /// Hash table used for start index lookup for linked list by address hash.
     memory_map lookup_file_;
     record_hash_table_header lookup_header_;
@@ -102,6 +111,10 @@ private:
     record_manager rows_manager_;
     record_list rows_list_;
     record_multiple_map rows_multimap_;
+
+    /// Variable size asset details of the rows.
+    memory_map payload_file_;
+    slab_manager payload_manager_;
 };
 
 } // namespace database
@@ -27,6 +27,7 @@
 #include <metaverse/database/define.hpp>
 #include <metaverse/database/memory/memory_map.hpp>
 #include <metaverse/database/primitives/record_multimap.hpp>
+#include <metaverse/database/primitives/slab_manager.hpp>
 #include <metaverse/bitcoin/chain/attachment/asset/asset_transfer.hpp>
 #include <metaverse/bitcoin/chain/business_data.hpp>
 
@@ -54,6 +55,7 @@ public:
     /// Construct the database.
     address_asset_database(const boost::filesystem::path& lookup_filename,
         const boost::filesystem::path& rows_filename,
+        const boost::filesystem::path& payload_filename,
         std::shared_ptr<shared_mutex> mutex=nullptr);
 
     /// Close the database (all threads must first be stopped).
@@ -76,6 +78,8 @@ public:
         uint32_t output_height, uint64_t value, uint16_t business_kd,
         uint32_t timestamp, BusinessDataType& business_data)
     {
+        const auto payload = store_payload(business_kd, timestamp,
+            business_data.to_data());
         auto write = [&](memory_ptr data)
         {
             auto serial = make_serializer(REMAP_ADDRESS(data));
@@ -83,9 +87,7 @@ public:
             serial.write_data(outpoint.to_data()); // 36
             serial.write_4_bytes_little_endian(output_height); // 4
             serial.write_8_bytes_little_endian(value);  // 8
-            serial.write_2_bytes_little_endian(business_kd); // 2
-            serial.write_4_bytes_little_endian(timestamp); // 4
-            serial.write_data(business_data.to_data());
+            serial.write_8_bytes_little_endian(payload); // 8
         };
         rows_multimap_.add_row(key, write);
     }
@@ -126,6 +128,18 @@ public:
     /// Delete the last row that was added to key.
     void delete_last_row(const short_hash& key);
 
+    /// Delete the spend row of inpoint and the output row it spends.
+    void prune_spend(const short_hash& key, const chain::input_point& inpoint,
+        const chain::output_point& previous);
+
+    /// Give the space of pruned rows back to the file system, see
+    /// memory_map::reclaim.
+    size_t reclaim(const asio::time_point& before);
+
+    /// Convert a rows file of the fixed size layout (database version
+    /// 0.6.5 and before) into the rows and payload files of this database.
+    bool upgrade_rows(const boost::filesystem::path& fixed_rows_filename);
+
     /// Synchonise with disk.
     void sync();
 
@@ -136,6 +150,16 @@ private:
     typedef record_hash_table<short_hash> record_map;
     typedef record_multimap<short_hash> record_multiple_map;
 
+    /// Write business data to the payload file, returns its position.
+    file_offset store_payload(uint16_t business_kd, uint32_t timestamp,
+        const data_chunk& business_data);
+
+    /// Read a row and its business data from the payload file.
+    chain::business_record read_row(uint8_t* data) const;
+
+    /// Size of the payload of a row, for giving it back on delete.
+    size_t payload_size(file_offset position, chain::point_kind kind) const;
+
     /// Hash table used for start index lookup for linked list by address hash.
     memory_map lookup_file_;
     record_hash_table_header lookup_header_;
@@ -147,6 +171,10 @@ private:
     record_manager rows_manager_;
     record_list rows_list_;
     record_multiple_map rows_multimap_;
+
+    /// Variable size business data of the rows.
+    memory_map payload_file_;
+    slab_manager payload_manager_;
 };
 
 } // namespace database
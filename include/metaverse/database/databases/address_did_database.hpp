@@ -27,6 +27,7 @@
 #include <metaverse/database/define.hpp>
 #include <metaverse/database/memory/memory_map.hpp>
 #include <metaverse/database/primitives/record_multimap.hpp>
+#include <metaverse/database/primitives/slab_manager.hpp>
 #include <metaverse/bitcoin/chain/business_data.hpp>
 
 namespace libbitcoin {
@@ -53,6 +54,7 @@ public:
     /// Construct the database.
     address_did_database(const boost::filesystem::path& lookup_filename,
         const boost::filesystem::path& rows_filename,
+        const boost::filesystem::path& payload_filename,
         std::shared_ptr<shared_mutex> mutex=nullptr);
 
     /// Close the database (all threads must first be stopped).
@@ -75,6 +77,8 @@ public:
         uint32_t output_height, uint64_t value, uint16_t business_kd, uint32_t timestamp, BusinessDataType& business_data)
     {
         //delete_last_row(key);
+        const auto payload = store_payload(business_kd, timestamp,
+            business_data.to_data());
         auto write = [&](memory_ptr data)
         {
             auto serial = make_serializer(REMAP_ADDRESS(data));
@@ -82,9 +86,7 @@ public:
             serial.write_data(outpoint.to_data()); // 36
             serial.write_4_bytes_little_endian(output_height); // 4
             serial.write_8_bytes_little_endian(value);  // 8
-            serial.write_2_bytes_little_endian(business_kd); // 2
-            serial.write_4_bytes_little_endian(timestamp); // 4
-            serial.write_data(business_data.to_data());
+            serial.write_8_bytes_little_endian(payload); // 8
         };
         rows_multimap_.add_row(key, write);
     }
@@ -120,6 +122,10 @@ public:
     /// Delete the last row that was added to key.
     void delete_last_row(const short_hash& key);
 
+    /// Convert a rows file of the fixed size layout (database version
+    /// 0.6.5 and before) into the rows and payload files of this database.
+    bool upgrade_rows(const boost::filesystem::path& fixed_rows_filename);
+
     /// Synchonise with disk.
     void sync();
 
@@ -130,6 +136,16 @@ private:
     typedef record_hash_table<short_hash> record_map;
     typedef record_multimap<short_hash> record_multiple_map;
 
+    /// Write business data to the payload file, returns its position.
+    file_offset store_payload(uint16_t business_kd, uint32_t timestamp,
+        const data_chunk& business_data);
+
+    /// Read a row and its business data from the payload file.
+    chain::business_record read_row(uint8_t* data) const;
+
+    /// Size of the payload of a row, for giving it back on delete.
+    size_t payload_size(file_offset position, chain::point_kind kind) const;
+
     /// Hash table used for start index lookup for linked list by address hash.
     memory_map lookup_file_;
     record_hash_table_header lookup_header_;
@@ -141,6 +157,10 @@ private:
     record_manager rows_manager_;
     record_list rows_list_;
     record_multiple_map rows_multimap_;
+
+    /// Variable size business data of the rows.
+    memory_map payload_file_;
+    slab_manager payload_manager_;
 };
 
 } // namespace database
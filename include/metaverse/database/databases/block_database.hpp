@@ -23,7 +23,9 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <memory>
+#include <unordered_map>
 #include <boost/filesystem.hpp>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/database/define.hpp>
@@ -68,6 +70,25 @@ public:
     /// Fetch block by hash using the hashtable.
     block_result get(const hash_digest& hash) const;
 
+    /// Fetch a block header by height, recent headers are read from memory.
+    bool get_header(chain::header& out_header, size_t height,
+        bool with_transaction_count=false) const;
+
+    /// Fetch a block header by hash, recent headers are read from memory.
+    bool get_header(chain::header& out_header, const hash_digest& hash,
+        bool with_transaction_count=false) const;
+
+    /// Fetch headers in [from_height, to_height), stopping at a gap.
+    chain::header::list get_headers(size_t from_height,
+        size_t to_height) const;
+
+    /// Fetch the height of a block by hash.
+    bool get_height(size_t& out_height, const hash_digest& hash) const;
+
+    /// Fetch the public key of a dpos block, false for other blocks.
+    bool get_public_key(ec_compressed& out_key, size_t height) const;
+    bool get_public_key(ec_compressed& out_key, const hash_digest& hash) const;
+
     /// Store a block in the database.
     void store(const chain::block& block);
 
@@ -96,6 +117,28 @@ public:
 private:
     typedef slab_hash_table<hash_digest> slab_map;
 
+    /// What the header accessors need of a block, kept for recent heights.
+    /// Every block has a coinbase, so a zero transaction count marks a gap.
+    struct recent_header
+    {
+        byte_array<148> header;
+        hash_digest hash;
+        ec_compressed public_key;
+        uint32_t transaction_count;
+    };
+
+    /// Cache the header of a block stored at height.
+    void cache_header(const recent_header& entry, size_t height);
+
+    /// Drop cached headers from (and including) from_height.
+    void uncache_headers(size_t from_height);
+
+    /// Fill the cache from the top of the index.
+    void load_recent_headers();
+
+    /// The cached entry at height or nullptr, call with recent_mutex_ held.
+    const recent_header* find_recent(size_t height) const;
+
     /// Zeroize the specfied index positions.
     void zeroize(array_index first, array_index count);
 
@@ -118,6 +161,13 @@ private:
 
     // Guard against concurrent update of a range of block indexes.
     upgrade_mutex mutex_;
+
+    /// Headers of the most recent blocks, recent_[i] is at height
+    /// recent_first_ + i, so epoch scans avoid the hash table and the map.
+    std::deque<recent_header> recent_;
+    size_t recent_first_;
+    std::unordered_map<hash_digest, size_t> recent_heights_;
+    mutable shared_mutex recent_mutex_;
 };
 
 } // namespace database
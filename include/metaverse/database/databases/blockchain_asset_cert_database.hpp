@@ -21,6 +21,9 @@
 #pragma once
 
 #include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
 #include <boost/filesystem.hpp>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/database/define.hpp>
@@ -64,6 +67,11 @@ public:
     /// Get all asset certs
     std::shared_ptr<std::vector<chain::asset_cert>> get_blockchain_asset_certs() const;
 
+    /// Get the asset certs issued to address (any if empty) of cert_type
+    /// (any if none), read through the in-memory address and type indexes.
+    std::shared_ptr<std::vector<chain::asset_cert>> get_blockchain_asset_certs(
+        const std::string& address, chain::asset_cert_type cert_type) const;
+
     void store(const chain::asset_cert& sp_cert);
 
     /// Delete a transaction from database.
@@ -75,12 +83,22 @@ public:
 
 private:
     typedef slab_hash_table<hash_digest> slab_map;
+    typedef std::set<hash_digest> key_set;
+
+    void load_index();
+    void index(const hash_digest& key, const chain::asset_cert& cert);
+    void unindex(const hash_digest& key, const chain::asset_cert& cert);
 
     // Hash table used for looking up txs by hash.
     memory_map lookup_file_;
     slab_hash_table_header lookup_header_;
     slab_manager lookup_manager_;
     slab_map lookup_map_;
+
+    // Keys of the stored certs by address and by type, built on start.
+    std::unordered_map<std::string, key_set> address_index_;
+    std::unordered_map<uint32_t, key_set> type_index_;
+    mutable shared_mutex index_mutex_;
 };
 
 } // namespace database
@@ -21,6 +21,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <boost/filesystem.hpp>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/database/define.hpp>
@@ -28,6 +29,7 @@
 #include <metaverse/database/result/transaction_result.hpp>
 #include <metaverse/database/primitives/slab_hash_table.hpp>
 #include <metaverse/database/primitives/slab_manager.hpp>
+#include <metaverse/database/primitives/symbol_index.hpp>
 #include <metaverse/bitcoin/chain/attachment/asset/blockchain_asset.hpp>
 
 namespace libbitcoin {
@@ -65,6 +67,15 @@ public:
     ///
     std::shared_ptr<std::vector<chain::blockchain_asset>> get_blockchain_assets(const std::string& asset_symbol="") const;
 
+    /// Get the issue record of up to limit (all if zero) symbols that start
+    /// with prefix, in symbol order, skipping the first offset symbols.
+    std::shared_ptr<std::vector<chain::blockchain_asset>> get_blockchain_assets(const std::string& prefix,
+        size_t offset, size_t limit) const;
+
+    /// The ordered symbols, for counts, prefix search and cursor paging.
+    /// Forbidden symbols are not indexed.
+    const symbol_index& get_symbol_index() const;
+
     uint64_t get_asset_volume(const std::string& name) const;
 
     ///
@@ -85,11 +96,17 @@ public:
 private:
     typedef slab_hash_table<hash_digest> slab_map;
 
+    /// False for symbols that are kept out of the symbol index.
+    static bool listed(const std::string& symbol);
+
     // Hash table used for looking up txs by hash.
     memory_map lookup_file_;
     slab_hash_table_header lookup_header_;
     slab_manager lookup_manager_;
     slab_map lookup_map_;
+
+    // Symbols of the stored records, loaded on start.
+    symbol_index symbols_;
 };
 
 } // namespace database
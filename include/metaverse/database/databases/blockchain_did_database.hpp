@@ -21,6 +21,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <boost/filesystem.hpp>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/database/define.hpp>
@@ -28,6 +29,7 @@
 #include <metaverse/database/result/transaction_result.hpp>
 #include <metaverse/database/primitives/slab_hash_table.hpp>
 #include <metaverse/database/primitives/slab_manager.hpp>
+#include <metaverse/database/primitives/symbol_index.hpp>
 #include <metaverse/bitcoin/chain/attachment/did/blockchain_did.hpp>
 
 namespace libbitcoin {
@@ -67,6 +69,15 @@ public:
     ///
     std::shared_ptr<std::vector<chain::blockchain_did> > get_blockchain_dids() const;
 
+    /// Get the current record of up to limit (all if zero) symbols that start
+    /// with prefix, in symbol order, skipping the first offset symbols.
+    std::shared_ptr<std::vector<chain::blockchain_did>> get_blockchain_dids(const std::string& prefix,
+        size_t offset, size_t limit) const;
+
+    /// The ordered symbols whose latest record is current, for counts,
+    /// prefix search and cursor paging.
+    const symbol_index& get_symbol_index() const;
+
     /// 
     std::shared_ptr<chain::blockchain_did> get_register_history(const std::string & did_symbol) const;
     ///
@@ -98,6 +109,9 @@ private:
     slab_hash_table_header lookup_header_;
     slab_manager lookup_manager_;
     slab_map lookup_map_;
+
+    // Symbols of the stored records, loaded on start.
+    symbol_index symbols_;
 };
 
 } // namespace database
@@ -20,12 +20,14 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <boost/filesystem.hpp>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/database/define.hpp>
 #include <metaverse/database/memory/memory_map.hpp>
 #include <metaverse/database/primitives/slab_hash_table.hpp>
 #include <metaverse/database/primitives/slab_manager.hpp>
+#include <metaverse/database/primitives/symbol_index.hpp>
 
 namespace libbitcoin {
 namespace database {
@@ -57,6 +59,14 @@ public:
     /// Get all asset certs
     std::shared_ptr<chain::asset_mit_info::list> get_blockchain_mits() const;
 
+    /// Get the current record of up to limit (all if zero) symbols that start
+    /// with prefix, in symbol order, skipping the first offset symbols.
+    std::shared_ptr<chain::asset_mit_info::list> get_blockchain_mits(const std::string& prefix,
+        size_t offset, size_t limit) const;
+
+    /// The ordered symbols, for counts, prefix search and cursor paging.
+    const symbol_index& get_symbol_index() const;
+
     /// 
     std::shared_ptr<chain::asset_mit_info> get_register_history(const std::string & mit_symbol) const;
     ///
@@ -79,6 +89,9 @@ private:
     slab_hash_table_header lookup_header_;
     slab_manager lookup_manager_;
     slab_map lookup_map_;
+
+    // Symbols of the stored records, loaded on start.
+    symbol_index symbols_;
 };
 
 } // namespace database
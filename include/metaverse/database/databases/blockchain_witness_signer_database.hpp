@@ -0,0 +1,111 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/define.hpp>
+#include <metaverse/database/memory/memory_map.hpp>
+#include <metaverse/database/primitives/record_manager.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+/// The signer of a block, as recorded in the witness signer index.
+/// Non-dpos blocks are recorded with an empty slot and a null public key.
+struct BCD_API witness_signer
+{
+    typedef std::vector<witness_signer> list;
+
+    static const uint32_t empty_slot;
+
+    uint32_t slot_num;
+    ec_compressed public_key;
+
+    bool is_dpos() const { return slot_num != empty_slot; }
+};
+
+/// Stores the dpos slot number and signer public key of every block,
+/// indexed by height, so that epoch statistics (mined/missed blocks and
+/// votes per witness) can be computed without reading block headers.
+class BCD_API blockchain_witness_signer_database
+{
+public:
+    /// Construct the database.
+    blockchain_witness_signer_database(const boost::filesystem::path& index_filename,
+        std::shared_ptr<shared_mutex> mutex=nullptr);
+
+    /// Close the database (all threads must first be stopped).
+    ~blockchain_witness_signer_database();
+
+    /// Initialize a new database.
+    bool create();
+
+    /// Call before using the database.
+    bool start();
+
+    /// Call to signal a stop of current operations.
+    bool stop();
+
+    /// Call to unload the memory map.
+    bool close();
+
+    /// Fetch the signer of the block at the given height.
+    bool get(witness_signer& out_signer, size_t height) const;
+
+    /// Fetch the signers of blocks in [from_height, to_height).
+    /// Stops at the top of the index, the result may be shorter than the range.
+    witness_signer::list get(size_t from_height, size_t to_height) const;
+
+    /// Store the signer of a block at the given height.
+    void store(const chain::block& block, size_t height);
+
+    /// Store the signer of a block at the given height.
+    void store(const chain::header& header, const ec_compressed& public_key,
+        size_t height);
+
+    /// Unlink all signers upwards from (and including) from_height.
+    void unlink(size_t from_height);
+
+    /// The number of heights in the index.
+    size_t count() const;
+
+    /// Synchronise storage with disk so things are consistent.
+    /// Should be done at the end of every block write.
+    void sync();
+
+private:
+    /// Write an empty signer to the specified index positions.
+    void zeroize(array_index first, array_index count);
+
+    /// Table used for looking up signers by height.
+    memory_map index_file_;
+    record_manager index_manager_;
+
+    // Guard against concurrent update of a range of signer indexes.
+    upgrade_mutex mutex_;
+};
+
+} // namespace database
+} // namespace libbitcoin
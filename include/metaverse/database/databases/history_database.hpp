@@ -80,6 +80,14 @@ public:
     /// Delete the last row that was added to key.
     void delete_last_row(const short_hash& key);
 
+    /// Delete the spend row of inpoint and the output row it spends.
+    void prune_spend(const short_hash& key, const chain::input_point& inpoint,
+        const chain::output_point& previous);
+
+    /// Give the space of pruned rows back to the file system, see
+    /// memory_map::reclaim.
+    size_t reclaim(const asio::time_point& before);
+
     /// Get the output and input points associated with the address hash.
     chain::history_compact::list get(const short_hash& key, size_t limit,
         size_t from_height) const;
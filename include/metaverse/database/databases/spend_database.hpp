@@ -76,6 +76,13 @@ public:
     /// Delete outpoint spend item from database.
     void remove(const chain::output_point& outpoint);
 
+    /// Delete a pruned spend item, its space is given back by reclaim.
+    void prune(const chain::output_point& outpoint);
+
+    /// Give the space of pruned items back to the file system, see
+    /// memory_map::reclaim.
+    size_t reclaim(const asio::time_point& before);
+
     /// Synchronise storage with disk so things are consistent.
     /// Should be done at the end of every block write.
     void sync();
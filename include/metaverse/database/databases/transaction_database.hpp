@@ -70,6 +70,13 @@ public:
     /// Delete a transaction from database.
     void remove(const hash_digest& hash);
 
+    /// Delete a pruned transaction, its space is given back by reclaim.
+    void prune(const hash_digest& hash);
+
+    /// Give the space of pruned transactions back to the file system, see
+    /// memory_map::reclaim.
+    size_t reclaim(const asio::time_point& before);
+
     /// Synchronise storage with disk so things are consistent.
     /// Should be done at the end of every block write.
     void sync();
@@ -119,6 +119,24 @@ std::shared_ptr<std::vector<memory_ptr>> record_hash_table<KeyType>::find(array_
 // This is limited to unlinking the first of multiple matching key values.
 template <typename KeyType>
 bool record_hash_table<KeyType>::unlink(const KeyType& key)
+{
+    return unlink_record(key) != header_.empty;
+}
+
+// This is limited to discarding the first of multiple matching key values.
+template <typename KeyType>
+bool record_hash_table<KeyType>::discard(const KeyType& key)
+{
+    const auto record = unlink_record(key);
+    if (record == header_.empty)
+        return false;
+
+    manager_.discard_record(record);
+    return true;
+}
+
+template <typename KeyType>
+array_index record_hash_table<KeyType>::unlink_record(const KeyType& key)
 {
     // Find start item...
     const auto begin = read_bucket_value(key);
@@ -128,7 +146,7 @@ bool record_hash_table<KeyType>::unlink(const KeyType& key)
     if (begin_item.compare(key))
     {
         link(key, begin_item.next_index());
-        return true;
+        return begin;
     }
 
     // Continue on...
@@ -144,7 +162,7 @@ bool record_hash_table<KeyType>::unlink(const KeyType& key)
         if (item.compare(key))
         {
             release(item, previous);
-            return true;
+            return current;
         }
 
         previous = current;
@@ -154,10 +172,10 @@ bool record_hash_table<KeyType>::unlink(const KeyType& key)
         // It indicates that a write operation has interceded.
         // So we must return gracefully vs. looping forever.
         if (previous == current)
-            return false;
+            return header_.empty;
     }
 
-    return false;
+    return header_.empty;
 }
 
 template <typename KeyType>
@@ -151,6 +151,74 @@ void record_multimap<KeyType>::delete_last_row(const KeyType& key)
     ///////////////////////////////////////////////////////////////////////////
 }
 
+template <typename KeyType>
+size_t record_multimap<KeyType>::delete_rows(const KeyType& key,
+    filter_function filter, size_t limit)
+{
+    const auto start_info = map_.find(key);
+    if (!start_info)
+        return 0;
+
+    auto address = REMAP_ADDRESS(start_info);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_shared();
+    const auto old_begin = from_little_endian_unsafe<array_index>(address);
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Deleted rows keep their next value, so readers positioned on a deleted
+    // row continue on the remaining rows of the list.
+    size_t deleted = 0;
+    auto new_begin = old_begin;
+    auto previous = records_.empty;
+    for (auto index = old_begin; index != records_.empty &&
+        (limit == 0 || deleted < limit);)
+    {
+        const auto next = records_.next(index);
+
+        if (!filter(records_.get(index)))
+        {
+            previous = index;
+        }
+        else
+        {
+            if (previous == records_.empty)
+                new_begin = next;
+            else
+                records_.link(previous, next);
+
+            records_.discard(index);
+            ++deleted;
+        }
+
+        index = next;
+    }
+
+    if (new_begin == old_begin)
+        return deleted;
+
+    if (new_begin == records_.empty)
+    {
+        // Free existing remap pointer to prevent deadlock in map_.discard.
+        address = nullptr;
+
+        DEBUG_ONLY(bool success =) map_.discard(key);
+        BITCOIN_ASSERT(success);
+        return deleted;
+    }
+
+    auto serial = make_serializer(address);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+    serial.template write_little_endian<array_index>(new_begin);
+    ///////////////////////////////////////////////////////////////////////////
+    return deleted;
+}
+
 template <typename KeyType>
 void record_multimap<KeyType>::create_new(const KeyType& key,
     write_function write)
@@ -219,19 +219,38 @@ std::shared_ptr<std::vector<memory_ptr>> slab_hash_table<KeyType>::find(uint64_t
 // This is limited to unlinking the first of multiple matching key values.
 template <typename KeyType>
 bool slab_hash_table<KeyType>::unlink(const KeyType& key)
+{
+    return unlink_slab(key) != header_.empty;
+}
+
+// This is limited to discarding the first of multiple matching key values.
+template <typename KeyType>
+bool slab_hash_table<KeyType>::discard(const KeyType& key, size_t value_size)
+{
+    const auto position = unlink_slab(key);
+    if (position == header_.empty)
+        return false;
+
+    const auto slab_size = slab_row<KeyType>::value_begin + value_size;
+    manager_.discard_slab(position, slab_size);
+    return true;
+}
+
+template <typename KeyType>
+file_offset slab_hash_table<KeyType>::unlink_slab(const KeyType& key)
 {
     // Find start item...
     const auto begin = read_bucket_value(key);
     const slab_row<KeyType> begin_item(manager_, begin);
 
     if (begin_item.out_of_memory())
-        return false;
+        return header_.empty;
 
     // If start item has the key then unlink from buckets.
     if (begin_item.compare(key))
     {
         link(key, begin_item.next_position());
-        return true;
+        return begin;
     }
 
     // Continue on...
@@ -244,13 +263,13 @@ bool slab_hash_table<KeyType>::unlink(const KeyType& key)
         const slab_row<KeyType> item(manager_, current);
 
         if (item.out_of_memory())
-            return false;
+            return header_.empty;
 
         // Found, unlink current item from previous.
         if (item.compare(key))
         {
             release(item, previous);
-            return true;
+            return current;
         }
 
         previous = current;
@@ -260,10 +279,10 @@ bool slab_hash_table<KeyType>::unlink(const KeyType& key)
         // It indicates that a write operation has interceded.
         // So we must return gracefully vs. looping forever.
         if (previous == current)
-            return false;
+            return header_.empty;
     }
 
-    return false;
+    return header_.empty;
 }
 
 template <typename KeyType>
@@ -28,7 +28,10 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <deque>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <boost/filesystem.hpp>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/database/define.hpp>
@@ -73,6 +76,14 @@ public:
     memory_ptr reserve(size_t size);
     memory_ptr reserve(size_t size, size_t growth_ratio);
 
+    /// Mark a range as no longer read. Pages of which every byte has been
+    /// discarded can be given back to the file system, the file keeps its size.
+    void discard(file_offset position, size_t size);
+
+    /// Punch out the pages of which the last byte was discarded before the
+    /// given time, returns the number of bytes given back.
+    size_t reclaim(const asio::time_point& before);
+
 private:
     static size_t file_size(int file_handle);
     static int open_file(const boost::filesystem::path& filename);
@@ -86,6 +97,7 @@ private:
     bool truncate(size_t size);
     bool truncate_mapped(size_t size);
     bool validate(size_t size);
+    bool punch(size_t position, size_t size);
 
     void log_mapping();
     void log_resizing(size_t size);
@@ -105,6 +117,11 @@ private:
     std::atomic<bool> closed_;
     std::atomic<bool> stopped_;
     mutable upgrade_mutex mutex_;
+
+    // Protected by discard mutex, pages are queued in discard order.
+    std::unordered_map<size_t, size_t> discarded_;
+    std::deque<std::pair<asio::time_point, size_t>> discarded_pages_;
+    shared_mutex discard_mutex_;
 };
 
 } // namespace database
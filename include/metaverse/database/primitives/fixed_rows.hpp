@@ -0,0 +1,54 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_DATABASE_FIXED_ROWS_HPP
+#define MVS_DATABASE_FIXED_ROWS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/define.hpp>
+#include <metaverse/database/primitives/record_manager.hpp>
+#include <metaverse/database/primitives/slab_manager.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+/// Reads the padded payload of a fixed size row and returns it serialized
+/// as it is written to the payload file.
+typedef std::function<data_chunk(deserializer<uint8_t*, false>&)>
+    payload_serializer;
+
+/// Convert the fixed size rows (database version 0.6.5 and before) of the
+/// file into rows that link their payload by position in the payload file.
+/// The next link and the first fields_size bytes of each row are copied,
+/// then the payload is read with serialize. Row indexes are preserved so a
+/// lookup table and the next links of the rows remain valid. The rows and
+/// payload managers must be started and empty, sync them after.
+BCD_API bool convert_fixed_rows(const boost::filesystem::path& fixed_filename,
+    size_t fixed_record_size, size_t fields_size, record_manager& rows,
+    slab_manager& payload, payload_serializer serialize);
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
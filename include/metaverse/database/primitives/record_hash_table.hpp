@@ -78,7 +78,13 @@ public:
     /// Delete a key-value pair from the hashtable by unlinking the node.
     bool unlink(const KeyType& key);
 
+    /// Unlink the node and give its space back (see memory_map::discard).
+    bool discard(const KeyType& key);
+
 private:
+    // Unlink the node, returns its index or empty if not found.
+    array_index unlink_record(const KeyType& key);
+
     // What is the bucket given a hash.
     array_index bucket_index(const KeyType& key) const;
 
@@ -51,9 +51,15 @@ public:
     /// Read next index for record in list.
     array_index next(array_index index) const;
 
+    /// Write next index for record in list, dropping the records between.
+    void link(array_index index, array_index next);
+
     /// Get underlying record data.
     const memory_ptr get(array_index index) const;
 
+    /// The record has been dropped from every list and is no longer read.
+    void discard(array_index index);
+
 private:
     record_manager& manager_;
 };
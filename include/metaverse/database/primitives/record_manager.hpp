@@ -69,6 +69,10 @@ public:
     /// Return memory object for the record at the specified index.
     const memory_ptr get(array_index record) const;
 
+    /// The record is no longer read, its space may be given back to the
+    /// file system (see memory_map::discard).
+    void discard_record(array_index record);
+
 private:
 
     // The record index of a disk position.
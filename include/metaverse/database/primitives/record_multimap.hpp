@@ -52,6 +52,7 @@ class record_multimap
 public:
     typedef record_hash_table<KeyType> record_hash_table_type;
     typedef std::function<void(memory_ptr)> write_function;
+    typedef std::function<bool(memory_ptr)> filter_function;
 
     record_multimap(record_hash_table_type& map, record_list& records);
 
@@ -66,6 +67,12 @@ public:
     /// blocks we must walk backwards and delete in reverse order.
     void delete_last_row(const KeyType& key);
 
+    /// Delete the rows of key for which filter returns true, stopping after
+    /// limit rows (if nonzero) are deleted, and give their space back (see
+    /// memory_map::discard). Returns the number deleted.
+    size_t delete_rows(const KeyType& key, filter_function filter,
+        size_t limit=0);
+
 private:
     // Add new value to existing key.
     void add_to_list(memory_ptr start_info, write_function write);
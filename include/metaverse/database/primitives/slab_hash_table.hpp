@@ -76,7 +76,13 @@ public:
     /// Delete a key-value pair from the hashtable by unlinking the node.
     bool unlink(const KeyType& key);
 
+    /// Unlink the node and give its space back (see memory_map::discard),
+    /// value_size is the size the value was stored with.
+    bool discard(const KeyType& key, size_t value_size);
+
 private:
+    // Unlink the node, returns its position or empty if not found.
+    file_offset unlink_slab(const KeyType& key);
 
     // What is the bucket given a hash.
     array_index bucket_index(const KeyType& key) const;
@@ -56,6 +56,15 @@ public:
     /// Allocate a slab and return its position, sync() after writing.
     file_offset new_slab(size_t size);
 
+    /// Give back the slab at position if no slab was allocated after it,
+    /// sync() after. Slabs freed in the reverse order of their allocation
+    /// are all given back, any other slab is kept and false returned.
+    bool release_slab(file_offset position, size_t size);
+
+    /// The slab is no longer read, its space may be given back to the file
+    /// system (see memory_map::discard). It is not reused for new slabs.
+    void discard_slab(file_offset position, size_t size);
+
     /// Return memory object for the slab at the specified position.
     const memory_ptr get(file_offset position) const;
 
@@ -0,0 +1,82 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_DATABASE_SYMBOL_INDEX_HPP
+#define MVS_DATABASE_SYMBOL_INDEX_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/define.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+/// An in-memory, lexicographically ordered set of the symbols held by a
+/// symbol keyed table, thread safe. It answers counts, prefix searches and
+/// pages without reading the table, the records are then read by symbol.
+class BCD_API symbol_index
+{
+public:
+    typedef std::vector<std::string> list;
+
+    /// Replace the content, symbols need not be sorted or unique.
+    void assign(list&& symbols);
+
+    /// Remove all symbols.
+    void clear();
+
+    /// Add a symbol, false if it is already present.
+    bool insert(const std::string& symbol);
+
+    /// Remove a symbol, false if it is not present.
+    bool erase(const std::string& symbol);
+
+    /// True if the symbol is present.
+    bool contains(const std::string& symbol) const;
+
+    /// The number of symbols that start with prefix (all if empty).
+    size_t count(const std::string& prefix="") const;
+
+    /// Up to limit (all if zero) symbols that start with prefix, in order,
+    /// skipping the first offset of them.
+    list page(const std::string& prefix, size_t offset, size_t limit) const;
+
+    /// Up to limit (all if zero) symbols that start with prefix and sort
+    /// after cursor (from the first if empty), in order.
+    list after(const std::string& prefix, const std::string& cursor,
+        size_t limit) const;
+
+private:
+    typedef list::const_iterator iterator;
+
+    // The symbols that start with prefix, the caller holds the lock.
+    std::pair<iterator, iterator> range(const std::string& prefix) const;
+    static list copy(iterator begin, iterator end, size_t limit);
+
+    list symbols_;
+    mutable shared_mutex mutex_;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,66 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/define.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+/// A chain-state snapshot archive of the files of a database directory.
+///
+/// The archive is a stream of files, each split in chunks that are run length
+/// compressed (database files are mostly empty hash table buckets and
+/// preallocated space) and hashed. The name and size of each file and its
+/// chunk hashes are chained into the archive checksum that closes the stream.
+class BCD_API snapshot
+{
+public:
+    typedef boost::filesystem::path path;
+
+    struct BCD_API info
+    {
+        std::string version;
+        uint64_t height;
+        hash_digest block_hash;
+    };
+
+    /// Write the named files of the prefix directory into the archive.
+    static bool write(const path& file, const path& prefix,
+        const std::vector<std::string>& names, const info& state);
+
+    /// Read the files of the archive into the (empty) prefix directory,
+    /// verifying chunk hashes and the archive checksum.
+    static bool read(const path& file, const path& prefix, info& out_state);
+
+private:
+    static data_chunk compress(const data_chunk& data);
+    static bool decompress(data_chunk& out, const data_chunk& data,
+        size_t size);
+};
+
+} // namespace database
+} // namespace libbitcoin
@@ -24,12 +24,21 @@
  * 1. for DID (Digital IDentities) support, adding some new tables.
  *    these tables can be created automatically if not exist.
  *    this way only soft fork is needed when user upgrade.
+ *
+ * 0.6.5
+ * 1. add witness signer index (dpos slot number and signer public key by height).
+ *    the index is rebuilt from the local block database if not exist.
+ *
+ * 0.6.6
+ * 1. address_asset, account_asset and address_did rows keep their business
+ *    data in a separate payload file instead of padding every row to the
+ *    biggest business data. existing rows files are converted on startup.
  */
-#define MVS_DATABASE_VERSION "0.6.4"
+#define MVS_DATABASE_VERSION "0.6.6"
 
 #define MVS_DATABASE_MAJOR_VERSION 0
 #define MVS_DATABASE_MINOR_VERSION 6
-#define MVS_DATABASE_PATCH_VERSION 4
+#define MVS_DATABASE_PATCH_VERSION 6
 
 #define MVS_DATABASE_VERSION_NUMBER (((MVS_DATABASE_MAJOR_VERSION)*100) + ((MVS_DATABASE_MINOR_VERSION)*10) + (MVS_DATABASE_PATCH_VERSION))
 
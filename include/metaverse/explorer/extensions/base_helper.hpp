@@ -276,6 +276,8 @@ void check_mit_symbol(const std::string& symbol, bool check_sensitive=false);
 void check_did_symbol(const std::string& symbol, bool check_sensitive=false);
 void check_message(const std::string& message, bool check_sensitive=false);
 void check_mining_subsidy_param(const std::string& param);
+// the number of records before the page, limit of zero lists all from the first
+uint64_t get_page_offset(uint64_t limit, uint64_t index);
 chain::asset_cert_type check_issue_cert(bc::blockchain::block_chain_impl& blockchain,
     const std::string& account, const std::string& symbol, const std::string& cert_name);
 chain::asset_cert_type check_cert_type_name(const std::string& cert_type_name, bool all=false);
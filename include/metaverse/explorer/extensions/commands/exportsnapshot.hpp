@@ -0,0 +1,109 @@
+/**
+ * Copyright (c) 2016-2018 mvs developers
+ *
+ * This file is part of metaverse-explorer.
+ *
+ * metaverse-explorer is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <boost/filesystem.hpp>
+#include <metaverse/explorer/define.hpp>
+#include <metaverse/explorer/extensions/command_extension.hpp>
+#include <metaverse/explorer/extensions/command_extension_func.hpp>
+
+namespace libbitcoin {
+namespace explorer {
+namespace commands {
+
+/************************ exportsnapshot *************************/
+
+class exportsnapshot: public command_extension
+{
+public:
+    static const char* symbol(){ return "exportsnapshot";}
+    const char* name() override { return symbol();}
+    bool category(int bs) override { return (ctgy_extension & bs ) == bs; }
+    const char* description() override { return "write a snapshot archive of the running chain to a file on the node."; }
+
+    arguments_metadata& load_arguments() override
+    {
+        return get_argument_metadata()
+            .add("ADMINNAME", 1)
+            .add("ADMINAUTH", 1)
+            .add("FILE", 1);
+    }
+
+    void load_fallbacks (std::istream& input,
+        po::variables_map& variables) override
+    {
+        const auto raw = requires_raw_input();
+        load_input(auth_.name, "ADMINNAME", variables, input, raw);
+        load_input(auth_.auth, "ADMINAUTH", variables, input, raw);
+        load_input(argument_.file, "FILE", variables, input, raw);
+    }
+
+    options_metadata& load_options() override
+    {
+        using namespace po;
+        options_description& options = get_option_metadata();
+        options.add_options()
+        (
+            BX_HELP_VARIABLE ",h",
+            value<bool>()->zero_tokens(),
+            "Get a description and instructions for this command."
+        )
+        (
+            "ADMINNAME",
+            value<std::string>(&auth_.name),
+            "admin name."
+        )
+        (
+            "ADMINAUTH",
+            value<std::string>(&auth_.auth),
+            "admin password/authorization."
+        )
+        (
+            "FILE",
+            value<boost::filesystem::path>(&argument_.file)->required(),
+            "snapshot archive path on the node, must not exist."
+        );
+
+        return options;
+    }
+
+    void set_defaults_from_config (po::variables_map& variables) override
+    {
+    }
+
+    console_result invoke (Json::Value& jv_output,
+         libbitcoin::server::server_node& node) override;
+
+    struct argument
+    {
+        boost::filesystem::path file;
+    } argument_;
+
+    struct option
+    {
+    } option_;
+
+};
+
+
+} // namespace commands
+} // namespace explorer
+} // namespace libbitcoin
+
@@ -85,6 +85,16 @@ public:
             value<std::string>(&option_.cert_type)->default_value(""),
             "If specified, then only get related type of cert. Default is not specified."
         )
+        (
+            "limit,l",
+            value<uint64_t>(&option_.limit)->default_value(0),
+            "Asset count per page when no account is specified, at most 100. Default is 0, list all."
+        )
+        (
+            "index,i",
+            value<uint64_t>(&option_.index)->default_value(1),
+            "Page index. Default is 1."
+        )
         ;
 
         return options;
@@ -103,8 +113,12 @@ public:
 
     struct option
     {
+        option():is_cert(false), limit(0), index(1)
+        {};
         bool is_cert;
         std::string cert_type;
+        uint64_t limit;
+        uint64_t index;
     } option_;
 
 };
@@ -74,6 +74,16 @@ public:
             "ACCOUNTAUTH",
             value<std::string>(&auth_.auth),
             BX_ACCOUNT_AUTH
+        )
+        (
+            "limit,l",
+            value<uint64_t>(&option_.limit)->default_value(0),
+            "MIT count per page when no account is specified, at most 100. Default is 0, list all."
+        )
+        (
+            "index,i",
+            value<uint64_t>(&option_.index)->default_value(1),
+            "Page index. Default is 1."
         );
 
         return options;
@@ -90,6 +100,14 @@ public:
     {
     } argument_;
 
+    struct option
+    {
+        option():limit(0), index(1)
+        {};
+        uint64_t limit;
+        uint64_t index;
+    } option_;
+
 };
 
 
@@ -1,4 +1,9 @@
 
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include <metaverse/mgbubble/Mongoose.hpp>
 #include <metaverse/mgbubble/MgServer.hpp>
 #include <metaverse/mgbubble/utility/Stream_buf.hpp>
@@ -22,12 +27,17 @@ class HttpServ : public MgServer
     typedef MgServer base;
 public:
     explicit HttpServ(const char* webroot, libbitcoin::server::server_node &node, const std::string& srv_addr)
-        : node_(node), MgServer(srv_addr)
+        : node_(node), MgServer(srv_addr), batch_pool_(1)
     {
         document_root_ = webroot;
         set_document_root(document_root_.c_str());
     }
-    ~HttpServ() noexcept { stop(); };
+    ~HttpServ() noexcept
+    {
+        stop();
+        batch_pool_.shutdown();
+        batch_pool_.join();
+    };
 
     // Copy.
     HttpServ(const HttpServ& rhs) = delete;
@@ -40,6 +50,12 @@ public:
     void rpc_request(mg_connection& nc, HttpMessage data, uint8_t rpc_version = 1);
     void ws_request(mg_connection& nc, WebsocketMessage ws);
 
+    /// Serve the metrics registry in the Prometheus text format.
+    void metrics_request(mg_connection& nc, HttpMessage data);
+
+    /// Largest json-rpc batch accepted in a single request.
+    static constexpr size_t max_batch_requests{1000};
+
 public:
     void reset(HttpMessage& data) noexcept;
 
@@ -52,12 +68,25 @@ protected:
 
     void on_http_req_handler(struct mg_connection& nc, struct http_message& msg) override;
     void on_notify_handler(struct mg_connection& nc, struct mg_event& ev) override;
+    void on_close_handler(struct mg_connection& nc) override;
     void on_ws_handshake_done_handler(struct mg_connection& nc) override;
     void on_ws_frame_handler(struct mg_connection& nc, struct websocket_message& msg) override;
 
     void check_rpc_client_addresses(struct mg_connection& nc);
 
 private:
+    libbitcoin::console_result dispatch(int argc, const char* argv[], Json::Value& jv_output,
+        uint8_t api_version);
+    void rpc_request_v1(mg_connection& nc, HttpMessage& data);
+    Json::Value parse_request(mg_connection& nc, HttpMessage& data, Json::Value& out_root);
+    Json::Value rpc_call(const Json::Value& request, uint8_t rpc_version);
+    void rpc_batch(mg_connection& nc, Json::Value&& requests, uint8_t rpc_version,
+        bool persistent);
+    void rpc_respond(mg_connection& nc, const Json::Value& response, bool persistent);
+    void resume(mg_connection& nc, std::deque<std::string>&& held);
+
+    static bool keep_alive(const HttpMessage& data);
+
     enum : int {
       // Method values are represented as powers of two for simplicity.
       MethodGet = 1 << 0,
@@ -83,6 +112,23 @@ private:
     const char* const servername_{"Metaverse " MVS_VERSION};
     libbitcoin::server::server_node &node_;
     std::string document_root_;
+
+    // Commands run one at a time, as they did on the event loop alone.
+    std::mutex dispatch_mutex_;
+
+    // Runs json-rpc batches off the event loop, one batch after another.
+    libbitcoin::threadpool batch_pool_;
+
+    // Batch running for a connection and the requests held behind it.
+    struct pending_batch
+    {
+        uint64_t id;
+        std::deque<std::string> held;
+    };
+
+    // Mongoose thread only.
+    std::unordered_map<mg_connection*, pending_batch> pending_batches_;
+    uint64_t batch_id_{0};
 };
 
 } // mgbubble
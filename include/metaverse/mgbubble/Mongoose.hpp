@@ -52,10 +52,16 @@ public:
 
     void add_arg(std::string&& outside);
 
+    const std::vector<std::string>& args() const noexcept { return vargv_; }
+
     static const int max_paramters{208};
 protected:
 
     virtual void data_to_arg(uint8_t api_version) = 0;
+
+    // convert to char** argv
+    void vargv_to_argv();
+
     const char* argv_[max_paramters]{nullptr};
     int argc_{0};
 
@@ -90,6 +96,9 @@ public:
 
     const int64_t jsonrpc_id() const noexcept { return jsonrpc_id_; }
 
+    /// Parse the body as json, the root may be an object or a batch array.
+    Json::Value parse_body() const;
+
     void data_to_arg(uint8_t rpc_version) override;
 
 private:
@@ -97,6 +106,24 @@ private:
     http_message* impl_;
 };
 
+/// A single json-rpc call, either a whole request body or one batch entry.
+class JsonRpcMessage : public ToCommandArg {
+public:
+    explicit JsonRpcMessage(const Json::Value& root) : root_(root), jsonrpc_id_(-1){}
+
+    // argv_ points into vargv_, so converted messages must not be copied.
+    JsonRpcMessage(const JsonRpcMessage&) = delete;
+    JsonRpcMessage& operator=(const JsonRpcMessage&) = delete;
+
+    const int64_t jsonrpc_id() const noexcept { return jsonrpc_id_; }
+
+    void data_to_arg(uint8_t rpc_version) override;
+
+private:
+    const Json::Value& root_;
+    int64_t jsonrpc_id_;
+};
+
 class WebsocketMessage:public ToCommandArg { // connect to bx command-tool
 public:
     WebsocketMessage(websocket_message* impl) noexcept : impl_{impl} {}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS).
+ * Copyright (C) 2013, 2016 Swirly Cloud Limited.
+ *
+ * This program is free software; you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if
+ * not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+#ifndef MVSD_JSONRPC_BATCH_HPP
+#define MVSD_JSONRPC_BATCH_HPP
+
+#include <cstdint>
+#include <exception>
+#include <string>
+#include <jsoncpp/json/json.h>
+#include <metaverse/explorer/extensions/exception.hpp>
+
+/**
+ * @addtogroup App
+ * @{
+ */
+
+namespace mgbubble {
+
+/// A json-rpc 2.0 error response.
+inline Json::Value jsonrpc_error(int64_t id, int32_t code, const std::string& message)
+{
+    Json::Value root;
+    root["jsonrpc"] = "2.0";
+    root["id"] = id;
+    root["error"]["code"] = code;
+    root["error"]["message"] = message;
+    return root;
+}
+
+/// The single error that answers a batch as a whole, null if the batch may run.
+inline Json::Value jsonrpc_batch_error(const Json::Value& requests, size_t max_requests)
+{
+    const libbitcoin::explorer::jsonrpc_invalid_request e;
+    if (requests.empty()) {
+        return jsonrpc_error(-1, e.code(), e.what());
+    }
+
+    if (requests.size() > max_requests) {
+        return jsonrpc_error(-1, e.code(), std::string(e.what()) + ", batch exceeds "
+            + std::to_string(max_requests) + " requests");
+    }
+
+    return Json::Value();
+}
+
+/// Answer the entries of a batch one after the other, in request order.
+/// An entry that fails gets its own error, the others still run. Entries
+/// answered with null (no output) are left out of the array.
+template <typename Call>
+Json::Value jsonrpc_batch(const Json::Value& requests, Call&& call)
+{
+    Json::Value responses(Json::arrayValue);
+    for (const auto& request : requests) {
+        Json::Value response;
+        if (!request.isObject()) {
+            const libbitcoin::explorer::jsonrpc_invalid_request e;
+            response = jsonrpc_error(-1, e.code(), e.what());
+        }
+        else {
+            try {
+                response = call(request);
+            }
+            catch (const std::exception& e) {
+                const auto id = request["id"].isIntegral() ? request["id"].asInt64() : -1;
+                response = jsonrpc_error(id, 1000, e.what());
+            }
+        }
+
+        if (!response.isNull()) {
+            responses.append(response);
+        }
+    }
+
+    return responses;
+}
+
+} // mgbubble
+
+/** @} */
+
+#endif // MVSD_JSONRPC_BATCH_HPP
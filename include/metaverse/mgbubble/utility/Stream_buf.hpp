@@ -53,6 +53,7 @@ class StreamBuf : public std::streambuf {
 
  private:
   mbuf& buf_;
+  const size_t begin_;
 };
 
 class OStream : public std::ostream {
@@ -75,7 +76,7 @@ class OStream : public std::ostream {
   {
     return static_cast<StreamBuf*>(std::ostream::rdbuf(sb));
   }
-  void reset(int status, const char* reason,const char *content_type = "text/plain",const char *charset = "utf-8") noexcept;
+  void reset(int status, const char* reason,const char *content_type = "text/plain",const char *charset = "utf-8", bool keep_alive = true) noexcept;
   void setContentLength() noexcept;
 
  private:
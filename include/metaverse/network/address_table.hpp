@@ -0,0 +1,127 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_NETWORK_ADDRESS_TABLE_HPP
+#define MVS_NETWORK_ADDRESS_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/network/define.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+/// Hashed, bucketed set of peer addresses, not thread safe.
+/// Insert, lookup, removal and random selection are constant time.
+/// Addresses are spread over buckets by network group (/16 for IPv4, /32
+/// otherwise) with a per process salt, and a full bucket evicts one of its
+/// own entries. A single operator can therefore fill one bucket at most.
+class BCT_API address_table
+{
+public:
+    typedef message::network_address address;
+    typedef std::function<bool(const address&)> filter;
+
+    /// Connection outcome tracked for each address.
+    struct entry
+    {
+        address host;
+
+        /// Connection attempts since the last success.
+        uint32_t attempts;
+        uint32_t last_attempt;
+        uint32_t last_success;
+    };
+
+    typedef std::vector<entry> list;
+
+    /// Addresses kept per bucket.
+    static const size_t bucket_size;
+
+    address_table(size_t capacity);
+
+    /// This class is not copyable.
+    address_table(const address_table&) = delete;
+    void operator=(const address_table&) = delete;
+
+    size_t size() const;
+    size_t capacity() const;
+    bool empty() const;
+    bool full() const;
+
+    bool contains(const address& host) const;
+
+    /// The tracked entry of the address, nullptr if absent.
+    entry* find(const address& host);
+
+    /// False if already present, evicts a random entry of the bucket if it
+    /// is full.
+    bool insert(const entry& item);
+    bool insert(const address& host);
+
+    bool remove(const address& host);
+    void clear();
+
+    /// Pick a random entry the filter accepts, preferring entries that did
+    /// not fail recently. Returns nullptr if none is found after a bounded
+    /// number of draws.
+    entry* select(filter accept);
+
+    /// Visit all entries in storage order.
+    void for_each(std::function<void(const entry&)> visit) const;
+
+private:
+    struct key
+    {
+        message::ip_address ip;
+        uint16_t port;
+
+        bool operator==(const key& other) const;
+    };
+
+    struct key_hash
+    {
+        size_t operator()(const key& value) const;
+    };
+
+    struct position
+    {
+        size_t bucket;
+        size_t slot;
+    };
+
+    static key to_key(const address& host);
+    size_t bucket_of(const address& host) const;
+    void erase(const position& at);
+
+    const size_t capacity_;
+    const uint64_t salt_;
+    size_t size_;
+    std::vector<list> buckets_;
+    std::unordered_map<key, position, key_hash> index_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
@@ -29,6 +29,7 @@
 #include <string>
 #include <vector>
 #include <metaverse/bitcoin.hpp>
+#include <metaverse/network/address_table.hpp>
 #include <metaverse/network/define.hpp>
 #include <metaverse/network/settings.hpp>
 
@@ -38,17 +39,11 @@ namespace network {
 /// This class is thread safe.
 /// The hosts class manages a thread-safe dynamic store of network addresses.
 /// The store can be loaded and saved from/to the specified file path.
-/// The file is a line-oriented set of config::authority serializations.
+/// The file is a binary list of addresses with their connection outcomes,
+/// the former line-oriented config::authority format is still read.
 /// Duplicate addresses and those with zero-valued ports are disacarded.
-
-struct address_compare{
-    bool operator()(const libbitcoin::message::network_address& lhs, const libbitcoin::message::network_address& rhs) const
-    {
-        typedef std::tuple<message::ip_address, uint16_t> tup_cmp;
-        return tup_cmp(lhs.ip, lhs.port) < tup_cmp(rhs.ip, rhs.port);
-    }
-};
-
+/// Each fetch counts as a connection attempt, a store of a connected
+/// address clears the count and records the success.
 class BCT_API hosts
   : public enable_shared_from_base<hosts>
 {
@@ -83,31 +78,27 @@ public:
     virtual code remove_seed(const address& host);
     virtual code remove(const address& host);
     virtual code store(const address& host);
+    virtual code store_connected(const address& host);
     virtual void store(const address::list& hosts, result_handler handler);
     address::list copy();
     address::list copy_seeds();
 
 private:
-    typedef boost::circular_buffer<address> list;
-    typedef list::iterator iterator;
-
-    iterator find(const address& host);
-    iterator find(list& buffer, const address& host);
     void handle_timer(const code& ec);
+    code do_store(const address& host, bool connected);
 
     bool store_cache(bool succeed_clear_buffer = false);
-
-    template <typename T>
-    code fetch(T& buffer, address& out, const config::authority::list& excluded_list);
+    bool load_cache();
+    bool load_text_cache();
 
     // record the seed count
     const size_t seed_count;
     const size_t host_pool_capacity_;
 
     // These are protected by a mutex.
-    list buffer_;
-    list backup_;
-    list inactive_;
+    address_table buffer_;
+    address_table backup_;
+    address_table inactive_;
     address::list seeds_;
     std::atomic<bool> stopped_;
     mutable upgrade_mutex mutex_;
@@ -186,6 +186,9 @@ public:
     /// Store an address.
     virtual void store(const address& address, result_handler handler);
 
+    /// Store an address a connection to has just been completed.
+    virtual void store_connected(const address& address, result_handler handler);
+
     /// Store a collection of addresses.
     virtual void store(const address::list& addresses, result_handler handler);
 
@@ -24,11 +24,13 @@
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <set>
 #include <string>
 #include <utility>
+#include <vector>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/network/const_buffer.hpp>
 #include <metaverse/network/define.hpp>
@@ -51,7 +53,6 @@ public:
     typedef subscriber<const code&> stop_subscriber;
     typedef resubscriber<const code&, const std::string&, const_buffer,
         result_handler> send_subscriber;
-    using request_callback = std::function<void()>;
 
     /// Construct an instance.
     proxy(threadpool& pool, socket::ptr socket, uint32_t protocol_magic,
@@ -121,6 +122,19 @@ private:
     typedef byte_source<data_chunk> payload_source;
     typedef boost::iostreams::stream<payload_source> payload_stream;
 
+    // A serialized message waiting for the socket.
+    struct pending_send
+    {
+        const_buffer buffer;
+        result_handler handler;
+    };
+
+    typedef std::deque<pending_send> send_lane;
+    typedef std::vector<pending_send> send_batch;
+    typedef std::shared_ptr<send_batch> send_batch_ptr;
+
+    static bool is_priority(const std::string& command);
+
     static config::authority authority_factory(socket::ptr socket);
 
     void do_close();
@@ -135,8 +149,8 @@ private:
 
     void do_send(const std::string& command, const_buffer buffer,
         result_handler handler);
-    void handle_send(const boost_code& ec, const_buffer buffer,
-        result_handler handler);
+    void write_batch(locked_socket::ptr socket);
+    void handle_send(const boost_code& ec, size_t bytes, send_batch_ptr batch);
 
     void handle_request(data_chunk payload_buffer, uint32_t protocol_version_, message::heading head, size_t payload_size);
 
@@ -157,8 +171,11 @@ private:
     bc::atomic<message::version::ptr> peer_version_message_;
     message_subscriber message_subscriber_;
     stop_subscriber::ptr stop_subscriber_;
-    std::queue<request_callback> outbound_queue_;
-    std::atomic_bool has_sent_;
+
+    // These are protected by the socket lock.
+    send_lane priority_lane_;
+    send_lane bulk_lane_;
+    bool sending_;
 
     std::atomic_int misbehaving_;
     static boost::detail::spinlock spinlock_;
@@ -146,6 +146,7 @@ protected:
 
     void remove(const message::network_address& address, result_handler handler);
 
+    /// Record a completed connection to the address in the host pool.
     void store(const message::network_address& address);
 
     /// Socket creators.
@@ -201,6 +202,7 @@ private:
         result_handler handle_started);
     void handle_start(const code& ec, channel::ptr channel,
         result_handler handle_started, result_handler handle_stopped);
+    void handle_channel_stop(const code& ec, result_handler handle_stopped);
     void do_unpend(const code& ec, channel::ptr channel,
         result_handler handle_started);
     void do_remove(const code& ec, channel::ptr channel,
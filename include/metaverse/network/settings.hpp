@@ -52,6 +52,7 @@ public:
     uint32_t channel_expiration_minutes;
     uint32_t channel_germination_seconds;
     uint32_t host_pool_capacity;
+    uint64_t services;
     bool relay_transactions;
     bool enable_re_seeding;
     bool upnp_map_port;
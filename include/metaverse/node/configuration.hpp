@@ -66,6 +66,8 @@ public:
     /// Options and environment vars.
     boost::filesystem::path file;
     boost::filesystem::path data_dir;
+    boost::filesystem::path export_snapshot;
+    boost::filesystem::path import_snapshot;
 
     /// Settings.
     node::settings node;
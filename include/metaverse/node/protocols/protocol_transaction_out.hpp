@@ -24,6 +24,7 @@
 #include <atomic>
 #include <cstdint>
 #include <memory>
+#include <unordered_set>
 #include <metaverse/blockchain.hpp>
 #include <metaverse/network.hpp>
 #include <metaverse/node/define.hpp>
@@ -31,8 +32,11 @@
 namespace libbitcoin {
 namespace node {
 
+/// Transactions are announced in batches, queued per peer and flushed on a
+/// timer whose period is randomized per peer, so that the announcements of a
+/// burst share messages and their timing does not reveal the originator.
 class BCN_API protocol_transaction_out
-  : public network::protocol_events, track<protocol_transaction_out>
+  : public network::protocol_timer, track<protocol_transaction_out>
 {
 public:
     typedef std::shared_ptr<protocol_transaction_out> ptr;
@@ -53,16 +57,24 @@ private:
     typedef message::fee_filter::ptr fee_filter_ptr;
     typedef message::memory_pool::ptr memory_pool_ptr;
     typedef message::get_data::ptr get_data_ptr;
+    typedef message::inventory::ptr inventory_ptr;
     typedef chain::point::indexes index_list;
+    typedef std::unordered_set<hash_digest> hash_set;
 
     void send_transaction(const code& ec,
         const chain::transaction& transaction, const hash_digest& hash);
 
+    void send_inventory(const code& ec);
+
+    // These are not thread safe, call with mutex_ held.
+    void add_known(const hash_digest& hash);
+    bool is_known(const hash_digest& hash) const;
+
     bool handle_receive_get_data(const code& ec, get_data_ptr message);
+    bool handle_receive_inventory(const code& ec, inventory_ptr message);
     bool handle_receive_fee_filter(const code& ec, fee_filter_ptr message);
     bool handle_receive_memory_pool(const code& ec, memory_pool_ptr message);
 
-    void handle_stop(const code&);
     bool handle_floated(const code& ec, const index_list& unconfirmed,
         transaction_ptr message);
 
@@ -70,6 +82,14 @@ private:
     blockchain::transaction_pool& pool_;
     std::atomic<uint64_t> minimum_fee_;
     const bool relay_to_peer_;
+
+    // Announcements waiting for the trickle timer, and the hashes the peer
+    // announced to us or we announced to it, in two generations so the
+    // older half can be dropped at once when the newer one fills.
+    hash_list queue_;
+    hash_set known_;
+    hash_set previous_known_;
+    upgrade_mutex mutex_;
 };
 
 } // namespace node
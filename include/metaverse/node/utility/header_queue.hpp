@@ -85,8 +85,17 @@ private:
     // Roll back the list to the last checkpoint.
     void rollback();
 
-    // Merge a list of block hashes to the list, validating linkage.
-    bool merge(const chain::header::list& headers);
+    // Hash the headers and validate their linkage to each other, hashing
+    // stops at the first break. This needs no lock.
+    static bool link(hash_list& out_hashes,
+        const chain::header::list& headers);
+
+    // Merge the hashes of linked headers to the list, validating the
+    // linkage of the first and the checkpoints.
+    bool merge(const chain::header::list& headers, const hash_list& hashes);
+
+    // Drop dequeued hashes from the front once they are half of the list.
+    void compact();
 
     // Determine if the hash violates a checkpoint.
     bool check(const hash_digest& hash, size_t height) const;
@@ -98,9 +107,11 @@ private:
     const config::checkpoint::list& checkpoints_;
 
     // protected by mutex.
+    // Dequeued hashes stay in front of head_ until compacted, so dequeuing
+    // does not move the hashes that remain.
     size_t height_;
     hash_list list_;
-    hash_list::iterator head_;
+    size_t head_;
     mutable upgrade_mutex mutex_;
 };
 
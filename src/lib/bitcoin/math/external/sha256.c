@@ -141,6 +141,12 @@ void SHA256Pad(SHA256CTX* context)
 
 void SHA256Transform(uint32_t state[SHA256_STATE_LENGTH],
     const uint8_t block[SHA256_BLOCK_LENGTH])
+{
+    SHA256TransformBlocks(state, block, 1);
+}
+
+void SHA256TransformScalar(uint32_t state[SHA256_STATE_LENGTH],
+    const uint8_t block[SHA256_BLOCK_LENGTH])
 {
     int i;
     uint32_t W[64];
@@ -259,11 +265,11 @@ void SHA256Update(SHA256CTX* context, const uint8_t* input, size_t length)
     input += 64 - r;
     length -= 64 - r;
 
-    while (length >= 64)
+    if (length >= 64)
     {
-        SHA256Transform(context->state, input);
-        input += 64;
-        length -= 64;
+        SHA256TransformBlocks(context->state, input, length / 64);
+        input += length & ~(size_t)63;
+        length &= 63;
     }
 
     memcpy(context->buf, input, length);
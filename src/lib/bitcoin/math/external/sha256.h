@@ -60,6 +60,34 @@ void SHA256Transform(uint32_t state[SHA256_STATE_LENGTH],
 
 void SHA256Update(SHA256CTX* context, const uint8_t* input, size_t length);
 
+/* Runtime selected implementations, see sha256_simd.c. */
+#define SHA256_IMPL_SCALAR 0
+#define SHA256_IMPL_SSE41 1
+#define SHA256_IMPL_AVX2 2
+#define SHA256_IMPL_SHANI 3
+
+/* The portable transform, used as the reference for the others. */
+void SHA256TransformScalar(uint32_t state[SHA256_STATE_LENGTH],
+    const uint8_t block[SHA256_BLOCK_LENGTH]);
+
+/* Transform count consecutive blocks with the selected implementation. */
+void SHA256TransformBlocks(uint32_t state[SHA256_STATE_LENGTH],
+    const uint8_t* blocks, size_t count);
+
+/* Write sha256(sha256(x)) of count independent 64 byte inputs as count
+ * consecutive digests. Inputs are hashed several at a time where the
+ * selected implementation has lanes. output may alias input if it does
+ * not start after it. */
+void SHA256D64(uint8_t* output, const uint8_t* input, size_t count);
+
+/* Nonzero if the implementation can run on this cpu. */
+int SHA256Available(int implementation);
+
+/* Use only this implementation from now on, returns zero if it is
+ * unavailable. The fastest paths are selected at startup; this is for tests
+ * and benchmarks and must not race with hashing. */
+int SHA256Select(int implementation);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,536 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "sha256.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/* Runtime selection between the portable transform and the x86 paths.
+ * SSE4.1 and AVX2 hash four and eight independent inputs in the lanes of
+ * one vector, so they only serve SHA256D64 (merkle tree levels); SHA-NI
+ * accelerates a single stream, so it also serves SHA256TransformBlocks and
+ * with it every sha256 in the process. The target attributes keep the
+ * instructions out of the rest of the build, which stays baseline x86. */
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define SHA256_X86
+#include <cpuid.h>
+#include <immintrin.h>
+#define TARGET_SSE41 __attribute__((target("sse4.1")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#define TARGET_SHANI __attribute__((target("sha,sse4.1")))
+#endif
+
+static const uint32_t K[64] =
+{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+    0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+    0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+    0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+    0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+    0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static const uint32_t IV[SHA256_STATE_LENGTH] =
+{
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+/* Message words of the padding block after a 64 byte input. */
+static const uint32_t PAD64[16] =
+{
+    0x80000000, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 512
+};
+
+/* Message words 8..15 of the block holding a 32 byte digest. */
+static const uint32_t PAD32[8] =
+{
+    0x80000000, 0, 0, 0, 0, 0, 0, 256
+};
+
+static uint32_t be32dec(const uint8_t* p)
+{
+    return ((uint32_t)(p[3]) + ((uint32_t)(p[2]) << 8) +
+        ((uint32_t)(p[1]) << 16) + ((uint32_t)(p[0]) << 24));
+}
+
+static void be32enc(uint8_t* p, uint32_t x)
+{
+    p[3] = x & 0xff;
+    p[2] = (x >> 8) & 0xff;
+    p[1] = (x >> 16) & 0xff;
+    p[0] = (x >> 24) & 0xff;
+}
+
+typedef void (*transform_function)(uint32_t* state, const uint8_t* blocks,
+    size_t count);
+
+static void transform_scalar(uint32_t* state, const uint8_t* blocks,
+    size_t count)
+{
+    for (; count > 0; --count, blocks += SHA256_BLOCK_LENGTH)
+    {
+        SHA256TransformScalar(state, blocks);
+    }
+}
+
+/* One input at a time through a single stream transform. */
+static void d64_single(transform_function transform, uint8_t* output,
+    const uint8_t* input)
+{
+    uint32_t state[SHA256_STATE_LENGTH];
+    uint8_t block[SHA256_BLOCK_LENGTH];
+    size_t i;
+
+    memcpy(state, IV, sizeof state);
+    transform(state, input, 1);
+
+    for (i = 0; i < 16; i++)
+    {
+        be32enc(block + 4 * i, PAD64[i]);
+    }
+
+    transform(state, block, 1);
+
+    for (i = 0; i < 8; i++)
+    {
+        be32enc(block + 4 * i, state[i]);
+        be32enc(block + 32 + 4 * i, PAD32[i]);
+    }
+
+    memcpy(state, IV, sizeof state);
+    transform(state, block, 1);
+
+    for (i = 0; i < 8; i++)
+    {
+        be32enc(output + 4 * i, state[i]);
+    }
+}
+
+#ifdef SHA256_X86
+
+/* 4 way, one input per 32 bit lane. */
+
+#define ADD4(x, y)   _mm_add_epi32(x, y)
+#define ROR4(x, n)   _mm_or_si128(_mm_srli_epi32(x, n), _mm_slli_epi32(x, 32 - (n)))
+#define XOR4(x, y, z) _mm_xor_si128(_mm_xor_si128(x, y), z)
+#define CH4(x, y, z) _mm_xor_si128(_mm_and_si128(x, _mm_xor_si128(y, z)), z)
+#define MAJ4(x, y, z) _mm_or_si128(_mm_and_si128(x, _mm_or_si128(y, z)), \
+    _mm_and_si128(y, z))
+#define BS04(x) XOR4(ROR4(x, 2), ROR4(x, 13), ROR4(x, 22))
+#define BS14(x) XOR4(ROR4(x, 6), ROR4(x, 11), ROR4(x, 25))
+#define SS04(x) XOR4(ROR4(x, 7), ROR4(x, 18), _mm_srli_epi32(x, 3))
+#define SS14(x) XOR4(ROR4(x, 17), ROR4(x, 19), _mm_srli_epi32(x, 10))
+
+TARGET_SSE41
+static void transform_4way(__m128i state[8], const __m128i block[16])
+{
+    __m128i w[16];
+    __m128i a = state[0], b = state[1], c = state[2], d = state[3];
+    __m128i e = state[4], f = state[5], g = state[6], h = state[7];
+    __m128i t0, t1;
+    int i;
+
+    for (i = 0; i < 16; i++)
+    {
+        w[i] = block[i];
+    }
+
+    for (i = 0; i < 64; i++)
+    {
+        if (i >= 16)
+        {
+            w[i & 15] = ADD4(ADD4(SS14(w[(i - 2) & 15]), w[(i - 7) & 15]),
+                ADD4(SS04(w[(i - 15) & 15]), w[i & 15]));
+        }
+
+        t0 = ADD4(ADD4(h, BS14(e)), ADD4(CH4(e, f, g),
+            ADD4(_mm_set1_epi32((int)K[i]), w[i & 15])));
+        t1 = ADD4(BS04(a), MAJ4(a, b, c));
+        h = g; g = f; f = e; e = ADD4(d, t0);
+        d = c; c = b; b = a; a = ADD4(t0, t1);
+    }
+
+    state[0] = ADD4(state[0], a); state[1] = ADD4(state[1], b);
+    state[2] = ADD4(state[2], c); state[3] = ADD4(state[3], d);
+    state[4] = ADD4(state[4], e); state[5] = ADD4(state[5], f);
+    state[6] = ADD4(state[6], g); state[7] = ADD4(state[7], h);
+}
+
+TARGET_SSE41
+static void d64_4way(uint8_t* output, const uint8_t* input)
+{
+    __m128i state[8], block[16];
+    uint32_t lanes[4];
+    int i, lane;
+
+    for (i = 0; i < 16; i++)
+    {
+        block[i] = _mm_set_epi32((int)be32dec(input + 192 + 4 * i),
+            (int)be32dec(input + 128 + 4 * i), (int)be32dec(input + 64 + 4 * i),
+            (int)be32dec(input + 4 * i));
+    }
+
+    for (i = 0; i < 8; i++)
+    {
+        state[i] = _mm_set1_epi32((int)IV[i]);
+    }
+
+    transform_4way(state, block);
+
+    for (i = 0; i < 16; i++)
+    {
+        block[i] = _mm_set1_epi32((int)PAD64[i]);
+    }
+
+    transform_4way(state, block);
+
+    for (i = 0; i < 8; i++)
+    {
+        block[i] = state[i];
+        block[8 + i] = _mm_set1_epi32((int)PAD32[i]);
+        state[i] = _mm_set1_epi32((int)IV[i]);
+    }
+
+    transform_4way(state, block);
+
+    for (i = 0; i < 8; i++)
+    {
+        _mm_storeu_si128((__m128i*)lanes, state[i]);
+        for (lane = 0; lane < 4; lane++)
+        {
+            be32enc(output + 32 * lane + 4 * i, lanes[lane]);
+        }
+    }
+}
+
+/* 8 way, one input per 32 bit lane. */
+
+#define ADD8(x, y)   _mm256_add_epi32(x, y)
+#define ROR8(x, n)   _mm256_or_si256(_mm256_srli_epi32(x, n), \
+    _mm256_slli_epi32(x, 32 - (n)))
+#define XOR8(x, y, z) _mm256_xor_si256(_mm256_xor_si256(x, y), z)
+#define CH8(x, y, z) _mm256_xor_si256(_mm256_and_si256(x, \
+    _mm256_xor_si256(y, z)), z)
+#define MAJ8(x, y, z) _mm256_or_si256(_mm256_and_si256(x, \
+    _mm256_or_si256(y, z)), _mm256_and_si256(y, z))
+#define BS08(x) XOR8(ROR8(x, 2), ROR8(x, 13), ROR8(x, 22))
+#define BS18(x) XOR8(ROR8(x, 6), ROR8(x, 11), ROR8(x, 25))
+#define SS08(x) XOR8(ROR8(x, 7), ROR8(x, 18), _mm256_srli_epi32(x, 3))
+#define SS18(x) XOR8(ROR8(x, 17), ROR8(x, 19), _mm256_srli_epi32(x, 10))
+
+TARGET_AVX2
+static void transform_8way(__m256i state[8], const __m256i block[16])
+{
+    __m256i w[16];
+    __m256i a = state[0], b = state[1], c = state[2], d = state[3];
+    __m256i e = state[4], f = state[5], g = state[6], h = state[7];
+    __m256i t0, t1;
+    int i;
+
+    for (i = 0; i < 16; i++)
+    {
+        w[i] = block[i];
+    }
+
+    for (i = 0; i < 64; i++)
+    {
+        if (i >= 16)
+        {
+            w[i & 15] = ADD8(ADD8(SS18(w[(i - 2) & 15]), w[(i - 7) & 15]),
+                ADD8(SS08(w[(i - 15) & 15]), w[i & 15]));
+        }
+
+        t0 = ADD8(ADD8(h, BS18(e)), ADD8(CH8(e, f, g),
+            ADD8(_mm256_set1_epi32((int)K[i]), w[i & 15])));
+        t1 = ADD8(BS08(a), MAJ8(a, b, c));
+        h = g; g = f; f = e; e = ADD8(d, t0);
+        d = c; c = b; b = a; a = ADD8(t0, t1);
+    }
+
+    state[0] = ADD8(state[0], a); state[1] = ADD8(state[1], b);
+    state[2] = ADD8(state[2], c); state[3] = ADD8(state[3], d);
+    state[4] = ADD8(state[4], e); state[5] = ADD8(state[5], f);
+    state[6] = ADD8(state[6], g); state[7] = ADD8(state[7], h);
+}
+
+TARGET_AVX2
+static void d64_8way(uint8_t* output, const uint8_t* input)
+{
+    __m256i state[8], block[16];
+    uint32_t lanes[8];
+    int i, lane;
+
+    for (i = 0; i < 16; i++)
+    {
+        block[i] = _mm256_set_epi32((int)be32dec(input + 448 + 4 * i),
+            (int)be32dec(input + 384 + 4 * i), (int)be32dec(input + 320 + 4 * i),
+            (int)be32dec(input + 256 + 4 * i), (int)be32dec(input + 192 + 4 * i),
+            (int)be32dec(input + 128 + 4 * i), (int)be32dec(input + 64 + 4 * i),
+            (int)be32dec(input + 4 * i));
+    }
+
+    for (i = 0; i < 8; i++)
+    {
+        state[i] = _mm256_set1_epi32((int)IV[i]);
+    }
+
+    transform_8way(state, block);
+
+    for (i = 0; i < 16; i++)
+    {
+        block[i] = _mm256_set1_epi32((int)PAD64[i]);
+    }
+
+    transform_8way(state, block);
+
+    for (i = 0; i < 8; i++)
+    {
+        block[i] = state[i];
+        block[8 + i] = _mm256_set1_epi32((int)PAD32[i]);
+        state[i] = _mm256_set1_epi32((int)IV[i]);
+    }
+
+    transform_8way(state, block);
+
+    for (i = 0; i < 8; i++)
+    {
+        _mm256_storeu_si256((__m256i*)lanes, state[i]);
+        for (lane = 0; lane < 8; lane++)
+        {
+            be32enc(output + 32 * lane + 4 * i, lanes[lane]);
+        }
+    }
+}
+
+/* SHA-NI, single stream. The state is kept as ABEF/CDGH as the round
+ * instructions expect; each sha256rnds2 does two rounds. */
+
+TARGET_SHANI
+static void transform_shani(uint32_t* state, const uint8_t* blocks,
+    size_t count)
+{
+    const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL,
+        0x0405060700010203ULL);
+    __m128i abef, cdgh, abef_save, cdgh_save, msg, tmp;
+    __m128i w[4];
+    int i;
+
+    tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&state[0]), 0xB1);
+    cdgh = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&state[4]), 0x1B);
+    abef = _mm_alignr_epi8(tmp, cdgh, 8);
+    cdgh = _mm_blend_epi16(cdgh, tmp, 0xF0);
+
+    for (; count > 0; --count, blocks += SHA256_BLOCK_LENGTH)
+    {
+        abef_save = abef;
+        cdgh_save = cdgh;
+
+        for (i = 0; i < 4; i++)
+        {
+            w[i] = _mm_shuffle_epi8(_mm_loadu_si128(
+                (const __m128i*)(blocks + 16 * i)), mask);
+        }
+
+        /* Group i runs rounds 4i..4i+3 on w[i % 4], finishing the schedule
+         * of the group three ahead and starting the one four ahead. */
+        for (i = 0; i < 16; i++)
+        {
+            const int now = i & 3, next = (i + 1) & 3, prev = (i + 3) & 3;
+
+            msg = _mm_add_epi32(w[now],
+                _mm_loadu_si128((const __m128i*)&K[4 * i]));
+            cdgh = _mm_sha256rnds2_epu32(cdgh, abef, msg);
+
+            if (i >= 3 && i <= 14)
+            {
+                tmp = _mm_alignr_epi8(w[now], w[prev], 4);
+                w[next] = _mm_sha256msg2_epu32(_mm_add_epi32(w[next], tmp),
+                    w[now]);
+            }
+
+            msg = _mm_shuffle_epi32(msg, 0x0E);
+            abef = _mm_sha256rnds2_epu32(abef, cdgh, msg);
+
+            if (i >= 1 && i <= 12)
+            {
+                w[prev] = _mm_sha256msg1_epu32(w[prev], w[now]);
+            }
+        }
+
+        abef = _mm_add_epi32(abef, abef_save);
+        cdgh = _mm_add_epi32(cdgh, cdgh_save);
+    }
+
+    tmp = _mm_shuffle_epi32(abef, 0x1B);
+    cdgh = _mm_shuffle_epi32(cdgh, 0xB1);
+    _mm_storeu_si128((__m128i*)&state[0], _mm_blend_epi16(tmp, cdgh, 0xF0));
+    _mm_storeu_si128((__m128i*)&state[4], _mm_alignr_epi8(cdgh, tmp, 8));
+}
+
+static int cpu_supports(int implementation)
+{
+    unsigned int eax, ebx, ecx, edx;
+    unsigned int xcr0_low = 0, xcr0_high = 0;
+    int sse41, avx, avx2, sha;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    {
+        return 0;
+    }
+
+    sse41 = (ecx >> 19) & 1;
+    avx = ((ecx >> 27) & 1) && ((ecx >> 28) & 1);
+
+    if (avx)
+    {
+        /* The OS must save the ymm registers (xgetbv, XCR0 bits 1-2). */
+        __asm__("xgetbv" : "=a"(xcr0_low), "=d"(xcr0_high) : "c"(0));
+        avx = (xcr0_low & 6) == 6;
+    }
+
+    avx2 = sha = 0;
+    if (__get_cpuid_max(0, NULL) >= 7)
+    {
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        avx2 = avx && ((ebx >> 5) & 1);
+        sha = (ebx >> 29) & 1;
+    }
+
+    switch (implementation)
+    {
+        case SHA256_IMPL_SSE41:
+            return sse41;
+        case SHA256_IMPL_AVX2:
+            return sse41 && avx2;
+        case SHA256_IMPL_SHANI:
+            return sse41 && sha;
+        default:
+            return 0;
+    }
+}
+
+#endif /* SHA256_X86 */
+
+/* The single stream transform and the implementation SHA256D64 takes its
+ * lanes from. They differ only by default, see select_fastest. */
+static transform_function transform = transform_scalar;
+static int multi_buffer = SHA256_IMPL_SCALAR;
+
+int SHA256Available(int implementation)
+{
+    if (implementation == SHA256_IMPL_SCALAR)
+    {
+        return 1;
+    }
+
+#ifdef SHA256_X86
+    return cpu_supports(implementation);
+#else
+    return 0;
+#endif
+}
+
+int SHA256Select(int implementation)
+{
+    if (!SHA256Available(implementation))
+    {
+        return 0;
+    }
+
+    multi_buffer = implementation;
+    transform = transform_scalar;
+
+#ifdef SHA256_X86
+    if (implementation == SHA256_IMPL_SHANI)
+    {
+        transform = transform_shani;
+    }
+#endif
+
+    return 1;
+}
+
+#ifdef SHA256_X86
+/* SHA-NI is the fastest single stream, but eight AVX2 lanes still beat it
+ * on batches of inputs, so each path gets its own best. */
+__attribute__((constructor))
+static void select_fastest(void)
+{
+    if (SHA256Available(SHA256_IMPL_AVX2))
+    {
+        multi_buffer = SHA256_IMPL_AVX2;
+    }
+    else if (SHA256Available(SHA256_IMPL_SSE41))
+    {
+        multi_buffer = SHA256_IMPL_SSE41;
+    }
+
+    if (SHA256Available(SHA256_IMPL_SHANI))
+    {
+        transform = transform_shani;
+    }
+}
+#endif
+
+void SHA256TransformBlocks(uint32_t state[SHA256_STATE_LENGTH],
+    const uint8_t* blocks, size_t count)
+{
+    transform(state, blocks, count);
+}
+
+void SHA256D64(uint8_t* output, const uint8_t* input, size_t count)
+{
+#ifdef SHA256_X86
+    if (multi_buffer == SHA256_IMPL_AVX2)
+    {
+        for (; count >= 8; count -= 8, output += 256, input += 512)
+        {
+            d64_8way(output, input);
+        }
+    }
+
+    if (multi_buffer == SHA256_IMPL_AVX2 ||
+        multi_buffer == SHA256_IMPL_SSE41)
+    {
+        for (; count >= 4; count -= 4, output += 128, input += 256)
+        {
+            d64_4way(output, input);
+        }
+    }
+#endif
+
+    for (; count > 0; --count, output += 32, input += 64)
+    {
+        d64_single(transform, output, input);
+    }
+}
@@ -110,6 +110,30 @@ hash_digest bitcoin_hash(data_slice data)
     return sha256_hash(sha256_hash(data));
 }
 
+void bitcoin_hash_pairs(hash_list& hashes)
+{
+    BITCOIN_ASSERT(hashes.size() % 2 == 0);
+    if (hashes.empty())
+        return;
+
+    // hash_list is contiguous, so each pair is one 64 byte input and the
+    // results can be written over the front half.
+    static_assert(sizeof(hash_digest) == hash_size, "unpadded hash");
+    const auto pairs = hashes.size() / 2;
+    SHA256D64(hashes.front().data(), hashes.front().data(), pairs);
+    hashes.resize(pairs);
+}
+
+bool sha256_available(sha256_implementation implementation)
+{
+    return SHA256Available(static_cast<int>(implementation)) != 0;
+}
+
+bool sha256_select(sha256_implementation implementation)
+{
+    return SHA256Select(static_cast<int>(implementation)) != 0;
+}
+
 short_hash bitcoin_short_hash(data_slice data)
 {
     return ripemd160_hash(sha256_hash(data));
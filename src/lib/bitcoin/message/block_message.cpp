@@ -27,6 +27,7 @@
 #include <metaverse/bitcoin/message/version.hpp>
 #include <metaverse/bitcoin/chain/header.hpp>
 #include <metaverse/bitcoin/chain/transaction.hpp>
+#include <metaverse/bitcoin/utility/block_trace.hpp>
 #include <metaverse/bitcoin/utility/data.hpp>
 #include <metaverse/bitcoin/utility/reader.hpp>
 
@@ -122,7 +123,14 @@ bool block_message::from_data(uint32_t version, std::istream& stream,
     bool with_transaction_count)
 {
     originator_ = version;
-    return block::from_data(stream, with_transaction_count);
+    const auto start = block_trace::clock::now();
+    const auto result = block::from_data(stream, with_transaction_count);
+
+    // This is the network path, the block is known only once parsed.
+    if (result && block_trace::instance().enabled())
+        block_trace::instance().record(header.hash(), "parse", start);
+
+    return result;
 }
 
 bool block_message::from_data(uint32_t version, reader& source,
@@ -0,0 +1,236 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/bitcoin/utility/block_trace.hpp>
+
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <metaverse/bitcoin/constants.hpp>
+#include <metaverse/bitcoin/formats/base_16.hpp>
+#include <metaverse/bitcoin/utility/log.hpp>
+
+namespace libbitcoin {
+
+using namespace std::chrono;
+using namespace boost::filesystem;
+
+const uint64_t block_trace::no_index = max_uint64;
+const size_t block_trace::max_pending = 256;
+
+thread_local const hash_digest* block_trace::current_ = nullptr;
+
+block_trace::block_trace()
+  : enabled_(false), threshold_(clock::duration::zero()), sequence_(0)
+{
+}
+
+block_trace& block_trace::instance()
+{
+    static block_trace instance;
+    return instance;
+}
+
+void block_trace::configure(const path& directory,
+    uint32_t threshold_milliseconds)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    directory_ = directory;
+    threshold_ = milliseconds(threshold_milliseconds);
+    traces_.clear();
+    enabled_.store(threshold_milliseconds != 0, std::memory_order_relaxed);
+}
+
+void block_trace::record(const hash_digest& block, const char* name,
+    clock::time_point start)
+{
+    if (!enabled())
+        return;
+
+    add(block, { name, no_index, true, start, clock::now() - start,
+        std::this_thread::get_id() });
+}
+
+void block_trace::add(const hash_digest& block, event&& item)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = traces_.find(block);
+    if (it == traces_.end())
+    {
+        // Evict the oldest trace, its block is not coming back.
+        if (traces_.size() >= max_pending)
+        {
+            const auto older = [](const std::pair<const hash_digest, trace>& left,
+                const std::pair<const hash_digest, trace>& right)
+            {
+                return left.second.sequence < right.second.sequence;
+            };
+
+            traces_.erase(std::min_element(traces_.begin(), traces_.end(),
+                older));
+        }
+
+        it = traces_.emplace(block, trace{ sequence_++, {} }).first;
+    }
+
+    it->second.events.push_back(std::move(item));
+}
+
+void block_trace::finish(const hash_digest& block, uint64_t height)
+{
+    if (!enabled())
+        return;
+
+    trace spans;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = traces_.find(block);
+        if (it == traces_.end())
+            return;
+
+        spans = std::move(it->second);
+        traces_.erase(it);
+    }
+
+    // Only stage time counts, queueing between stages does not.
+    auto busy = clock::duration::zero();
+    for (const auto& item: spans.events)
+        if (item.stage)
+            busy += item.duration;
+
+    if (busy < threshold_)
+        return;
+
+    log::warning(LOG_SYSTEM)
+        << "Block [" << height << "] took "
+        << duration_cast<milliseconds>(busy).count()
+        << " ms, writing trace to " << directory_.string();
+
+    try
+    {
+        write(block, height, spans);
+    }
+    catch (const std::exception& ex)
+    {
+        log::error(LOG_SYSTEM)
+            << "Failed to write block trace: " << ex.what();
+    }
+}
+
+void block_trace::write(const hash_digest& block, uint64_t height,
+    const trace& spans) const
+{
+    create_directories(directory_);
+    const auto file = directory_ /
+        (std::to_string(height) + "-" + encode_hash(block) + ".json");
+
+    std::ofstream out(file.string(), std::ofstream::trunc);
+    if (!out)
+        throw std::runtime_error("cannot open " + file.string());
+
+    const auto origin = std::min_element(spans.events.begin(),
+        spans.events.end(), [](const event& left, const event& right)
+        {
+            return left.start < right.start;
+        })->start;
+
+    // Chrome wants small thread numbers, number them by first appearance.
+    std::vector<std::thread::id> threads;
+    const auto thread_number = [&threads](std::thread::id id)
+    {
+        const auto it = std::find(threads.begin(), threads.end(), id);
+        if (it != threads.end())
+            return static_cast<size_t>(std::distance(threads.begin(), it));
+
+        threads.push_back(id);
+        return threads.size() - 1;
+    };
+
+    out << "{\"traceEvents\":[";
+    auto first = true;
+    for (const auto& item: spans.events)
+    {
+        const auto start = duration_cast<microseconds>(item.start - origin);
+        const auto length = duration_cast<microseconds>(item.duration);
+
+        out << (first ? "\n" : ",\n")
+            << "{\"name\":\"" << item.name << "\","
+            << "\"cat\":\"" << (item.stage ? "stage" : "span") << "\","
+            << "\"ph\":\"X\",\"pid\":1,"
+            << "\"tid\":" << thread_number(item.thread) << ","
+            << "\"ts\":" << start.count() << ","
+            << "\"dur\":" << length.count();
+
+        if (item.index != no_index)
+            out << ",\"args\":{\"index\":" << item.index << "}";
+
+        out << "}";
+        first = false;
+    }
+
+    out << "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{"
+        << "\"height\":" << height << ","
+        << "\"hash\":\"" << encode_hash(block) << "\"}}\n";
+}
+
+// scope
+// ----------------------------------------------------------------------------
+
+block_trace::scope::scope(const hash_digest& block, const char* name)
+  : active_(block_trace::instance().enabled()),
+    name_(name),
+    previous_(current_),
+    block_(block),
+    start_(active_ ? clock::now() : clock::time_point())
+{
+    if (active_)
+        current_ = &block_;
+}
+
+block_trace::scope::~scope()
+{
+    if (!active_)
+        return;
+
+    current_ = previous_;
+    block_trace::instance().add(block_, { name_, no_index, true, start_,
+        clock::now() - start_, std::this_thread::get_id() });
+}
+
+// span
+// ----------------------------------------------------------------------------
+
+block_trace::span::span(const char* name, uint64_t index)
+  : block_(current_), name_(name), index_(index)
+{
+    if (block_ != nullptr)
+        start_ = clock::now();
+}
+
+block_trace::span::~span()
+{
+    if (block_ == nullptr)
+        return;
+
+    block_trace::instance().add(*block_, { name_, index_, false, start_,
+        clock::now() - start_, std::this_thread::get_id() });
+}
+
+} // namespace libbitcoin
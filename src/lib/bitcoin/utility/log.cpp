@@ -31,7 +31,7 @@
 namespace libbitcoin {
 
 log::log(level value, const std::string& domain)
-  : level_(value), domain_(domain)
+  : level_(value), enabled_(enabled(value)), domain_(domain)
 {
 }
 
@@ -40,6 +40,7 @@ log::log(level value, const std::string& domain)
 // gcc.gnu.org/bugzilla/show_bug.cgi?id=54316
 log::log(log&& other)
   : level_(other.level_),
+    enabled_(other.enabled_),
     domain_(std::move(other.domain_)),
     stream_(other.stream_.str())
 {
@@ -47,20 +48,50 @@ log::log(log&& other)
 
 log::~log()
 {
-    if (destinations_.count(level_) != 0)
-        destinations_[level_](level_, domain_, stream_.str());
+    if (!enabled_ || !enabled(level_))
+        return;
+
+    const auto destination = destinations_.find(level_);
+    if (destination != destinations_.end() && destination->second)
+        destination->second(level_, domain_, stream_.str());
 }
 
 void log::set_output_function(functor value)
 {
+    if (value)
+        enabled_levels_ |= mask(level_);
+    else
+        enabled_levels_ &= ~mask(level_);
+
     destinations_[level_] = value;
 }
 
 void log::clear()
 {
+    enabled_levels_ = 0;
     destinations_.clear();
 }
 
+bool log::enabled(level value)
+{
+    return (enabled_levels_.load(std::memory_order_relaxed) & mask(value)) != 0;
+}
+
+uint32_t log::mask(level value)
+{
+    return uint32_t(1) << static_cast<uint32_t>(value);
+}
+
+uint32_t log::mask(const destinations& values)
+{
+    uint32_t result = 0;
+    for (const auto& destination: values)
+        if (destination.second)
+            result |= mask(destination.first);
+
+    return result;
+}
+
 log log::trace(const std::string& domain)
 {
     return log(level::trace, domain);
@@ -129,10 +160,6 @@ void log::to_stream(std::ostream& out, level value, const std::string& domain,
     out.flush();
 }
 
-void log::output_ignore(level, const std::string&, const std::string&)
-{
-}
-
 void log::output_cout(level value, const std::string& domain,
     const std::string& body)
 {
@@ -147,10 +174,7 @@ void log::output_cerr(level value, const std::string& domain,
 
 log::destinations log::destinations_
 {
-#ifdef NDEBUG
-    std::make_pair(level::trace, output_ignore),
-    std::make_pair(level::debug, output_ignore),
-#else
+#ifndef NDEBUG
     std::make_pair(level::trace, output_cout),
     std::make_pair(level::debug, output_cout),
 #endif
@@ -160,4 +184,7 @@ log::destinations log::destinations_
     std::make_pair(level::fatal, output_cerr)
 };
 
+// Defined after destinations_ so that it is initialized from them.
+std::atomic<uint32_t> log::enabled_levels_(log::mask(log::destinations_));
+
 } // namespace libbitcoin
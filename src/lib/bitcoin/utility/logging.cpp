@@ -19,102 +19,207 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <functional>
 #include <iostream>
 #include <utility>
+#include <set>
 #include <sstream>
 #include <string>
-#include <type_traits>
+#include <thread>
 #include <mutex>
 #include <boost/date_time.hpp>
 #include <metaverse/bitcoin.hpp>
+#include <metaverse/bitcoin/utility/ring_buffer.hpp>
 #include <metaverse/network/define.hpp>
 
 namespace libbitcoin {
 
-    // Guard against concurrent console writes.
-    static std::mutex console_mutex;
+namespace ptime = boost::posix_time;
 
-    // Guard against concurrent file writes.
-    static std::mutex file_mutex;
+// A record captured on the logging thread, formatted by the writer.
+struct log_record
+{
+    log::level level;
+    std::string domain;
+    std::string body;
+    ptime::ptime time;
+    bc::ofstream* file;
+    std::ostream* console;
+};
+
+// Drains log records from a lock-free ring buffer on a background thread.
+// Producers of trace to info records never format, lock or flush; the writer
+// formats a batch and flushes each stream once per batch. Error and fatal
+// records are written and flushed before post returns, a crash that follows
+// does not lose them.
+class log_writer
+{
+public:
+    static BC_CONSTEXPR size_t buffer_capacity = 8192;
+    static BC_CONSTEXPR size_t batch_size = 256;
 
-    template<class T>
-    // TODO:limit template type of instance
-    // class = typename std::enable_if<std::is_base_of<std::basic_ostream&, T>::value>::type>
-    static inline void do_logging(T& ofs, log::level level, const std::string& domain,
-        const std::string& body)
+    log_writer()
+      : buffer_(buffer_capacity), stopped_(true)
     {
-        if (body.empty())
-        {
+    }
+
+    ~log_writer()
+    {
+        stop();
+    }
+
+    void start()
+    {
+        std::lock_guard<std::mutex> lock(control_mutex_);
+        if (!stopped_)
+            return;
+
+        stopped_ = false;
+        thread_ = std::thread(&log_writer::run, this);
+    }
+
+    // Stop the writer after draining every record already posted.
+    void stop()
+    {
+        std::lock_guard<std::mutex> lock(control_mutex_);
+        if (stopped_)
             return;
+
+        stopped_ = true;
+        wake_.notify_one();
+        thread_.join();
+    }
+
+    void post(log_record&& record)
+    {
+        const auto level = record.level;
+
+        // The buffer is full, let the writer catch up rather than drop.
+        while (!buffer_.push(std::move(record)))
+        {
+            wake_.notify_one();
+            std::this_thread::yield();
+        }
+
+        // Drain on this thread until the buffer has been seen empty, the
+        // record and everything posted before it are then on disk.
+        if (level >= log::level::error)
+        {
+            std::lock_guard<std::mutex> lock(drain_mutex_);
+            while (drain() == batch_size);
+        }
+        else if (level == log::level::warning)
+            wake_.notify_one();
+    }
+
+private:
+    void run()
+    {
+        while (true)
+        {
+            const auto stopping = stopped_.load();
+            size_t drained;
+            {
+                std::lock_guard<std::mutex> lock(drain_mutex_);
+                drained = drain();
+            }
+
+            if (drained == 0)
+            {
+                if (stopping)
+                    return;
+
+                std::unique_lock<std::mutex> lock(wake_mutex_);
+                wake_.wait_for(lock, std::chrono::milliseconds(100));
+            }
         }
+    }
 
-        namespace ptime = boost::posix_time;
+    // The caller must hold drain_mutex_, records have one consumer.
+    size_t drain()
+    {
+        std::set<std::ostream*> touched;
+        log_record record;
+        size_t count = 0;
+
+        while (count < batch_size && buffer_.pop(record))
+        {
+            write(record, touched);
+            ++count;
+        }
+
+        for (const auto stream: touched)
+            stream->flush();
+
+        return count;
+    }
+
+    static void write(const log_record& record, std::set<std::ostream*>& touched)
+    {
+        if (record.body.empty())
+            return;
 
         static const auto form = "%1% %2% [%3%] %4%\n";
-        const auto message = boost::format(form) %
-            ptime::to_iso_string(ptime::second_clock::local_time()) %
-            log::to_text(level) %
-            domain %
-            body;
+        const auto message = (boost::format(form) %
+            ptime::to_iso_string(record.time) %
+            log::to_text(record.level) %
+            record.domain %
+            record.body).str();
 
+        if (record.file != nullptr)
         {
-            // Critical Section
-            ///////////////////////////////////////////////////////////////////////
-            std::unique_lock<std::mutex> lock_file(file_mutex);
-            ofs << message;
+            auto& file = *record.file;
+            file << message;
+            touched.insert(&file);
 
             // Cut up log file if over max_size
-            if (std::is_same<T, bc::ofstream>::value)
+            auto& current_size = file.current_size();
+            current_size += message.size();
+            if (current_size > file.max_size())
             {
-                bc::ofstream& bo = dynamic_cast<bc::ofstream&>(ofs);
-                auto& current_size = bo.current_size();
-                current_size += message.size();
-                if (bo.current_size() > bo.max_size())
-                {
-                    bo.close();
-                    bo.open(bo.path(), std::ios::trunc | std::ios::out);
-                    current_size = 0;
-                }
+                file.close();
+                file.open(file.path(), std::ios::trunc | std::ios::out);
+                current_size = 0;
             }
+        }
 
-            ofs.flush();
-            ///////////////////////////////////////////////////////////////////////
-
+        if (record.console != nullptr)
+        {
+            *record.console << message;
+            touched.insert(record.console);
         }
+    }
 
-}
+    ring_buffer<log_record> buffer_;
+    std::atomic<bool> stopped_;
+    std::thread thread_;
+    std::mutex control_mutex_;
+    std::mutex drain_mutex_;
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+};
 
-static void output_ignore(bc::ofstream& file, log::level level,
-    const std::string& domain, const std::string& body)
+static log_writer& writer()
 {
-
+    static log_writer instance;
+    return instance;
 }
 
 static void output_file(bc::ofstream& file, log::level level,
     const std::string& domain, const std::string& body)
 {
-    do_logging(file, level, domain, body);
+    writer().post({ level, domain, body, ptime::second_clock::local_time(),
+        &file, nullptr });
 }
 
 static void output_both(bc::ofstream& file, std::ostream& output,
     log::level level, const std::string& domain, const std::string& body)
 {
-    do_logging(file, level, domain, body);
-    do_logging(output, level, domain, body);
-}
-
-static void error_file(bc::ofstream& file, log::level level,
-    const std::string& domain, const std::string& body)
-{
-    do_logging(file, level, domain, body);
-}
-
-static void error_both(bc::ofstream& file, std::ostream& error,
-    log::level level, const std::string& domain, const std::string& body)
-{
-    do_logging(file, level, domain, body);
-    do_logging(error, level, domain, body);
+    writer().post({ level, domain, body, ptime::second_clock::local_time(),
+        &file, &output });
 }
 
 void initialize_logging(bc::ofstream& debug, bc::ofstream& error,
@@ -123,6 +228,8 @@ void initialize_logging(bc::ofstream& debug, bc::ofstream& error,
 {
     using namespace std::placeholders;
 
+    writer().start();
+
     auto debug_log_level = log::level::debug;
     if (level == "INFO" || level == "info")
         debug_log_level = log::level::info;
@@ -140,8 +247,7 @@ void initialize_logging(bc::ofstream& debug, bc::ofstream& error,
     }
     else if (debug_log_level < log::level::info)
     {
-        log::trace("").set_output_function(std::bind(output_ignore,
-            std::ref(debug), _1, _2, _3));
+        log::trace("").set_output_function(nullptr);
         // debug|info => debug_log
         log::debug("").set_output_function(std::bind(output_file,
             std::ref(debug), _1, _2, _3));
@@ -149,10 +255,8 @@ void initialize_logging(bc::ofstream& debug, bc::ofstream& error,
     else if (debug_log_level < log::level::warning)
     {
         // info => debug_log
-        log::trace("").set_output_function(std::bind(output_ignore,
-            std::ref(debug), _1, _2, _3));
-        log::debug("").set_output_function(std::bind(output_ignore,
-            std::ref(debug), _1, _2, _3));
+        log::trace("").set_output_function(nullptr);
+        log::debug("").set_output_function(nullptr);
     }
 
     // info => debug_log + console
@@ -160,12 +264,19 @@ void initialize_logging(bc::ofstream& debug, bc::ofstream& error,
         std::ref(debug), std::ref(output_stream), _1, _2, _3));
 
     // warning|error|fatal => error_log + console
-    log::warning("").set_output_function(std::bind(error_both,
+    log::warning("").set_output_function(std::bind(output_both,
         std::ref(error),std::ref(error_stream), _1, _2, _3));
-    log::error("").set_output_function(std::bind(error_both,
+    log::error("").set_output_function(std::bind(output_both,
         std::ref(error), std::ref(error_stream), _1, _2, _3));
-    log::fatal("").set_output_function(std::bind(error_both,
+    log::fatal("").set_output_function(std::bind(output_both,
         std::ref(error), std::ref(error_stream), _1, _2, _3));
 }
 
+void finalize_logging()
+{
+    // Stop producing before the writer drains and the streams close.
+    log::clear();
+    writer().stop();
+}
+
 } // namespace libbitcoin
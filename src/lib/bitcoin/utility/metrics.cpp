@@ -0,0 +1,230 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/bitcoin/utility/metrics.hpp>
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace libbitcoin {
+
+using namespace std::chrono;
+
+// counter
+// ----------------------------------------------------------------------------
+
+void metrics::counter::increment(uint64_t value)
+{
+    value_.fetch_add(value, std::memory_order_relaxed);
+}
+
+uint64_t metrics::counter::value() const
+{
+    return value_.load(std::memory_order_relaxed);
+}
+
+// gauge
+// ----------------------------------------------------------------------------
+
+void metrics::gauge::set(int64_t value)
+{
+    value_.store(value, std::memory_order_relaxed);
+}
+
+void metrics::gauge::add(int64_t value)
+{
+    value_.fetch_add(value, std::memory_order_relaxed);
+}
+
+int64_t metrics::gauge::value() const
+{
+    return value_.load(std::memory_order_relaxed);
+}
+
+// histogram
+// ----------------------------------------------------------------------------
+
+const metrics::histogram::bounds metrics::histogram::default_bounds
+{
+    0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1,
+    0.25, 0.5, 1, 2.5, 5, 10
+};
+
+metrics::histogram::histogram(const bounds& upper_bounds)
+  : bounds_(upper_bounds),
+    counts_(new std::atomic<uint64_t>[upper_bounds.size() + 1])
+{
+    for (size_t index = 0; index <= bounds_.size(); ++index)
+        counts_[index].store(0, std::memory_order_relaxed);
+}
+
+void metrics::histogram::observe(double seconds)
+{
+    const auto it = std::lower_bound(bounds_.begin(), bounds_.end(), seconds);
+    const auto bucket = static_cast<size_t>(std::distance(bounds_.begin(), it));
+    const auto micro = static_cast<uint64_t>(std::max(seconds, 0.0) * 1e6);
+
+    counts_[bucket].fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(micro, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+const metrics::histogram::bounds& metrics::histogram::upper_bounds() const
+{
+    return bounds_;
+}
+
+std::vector<uint64_t> metrics::histogram::counts() const
+{
+    std::vector<uint64_t> out(bounds_.size() + 1);
+    for (size_t index = 0; index < out.size(); ++index)
+        out[index] = counts_[index].load(std::memory_order_relaxed);
+
+    return out;
+}
+
+uint64_t metrics::histogram::count() const
+{
+    return count_.load(std::memory_order_relaxed);
+}
+
+double metrics::histogram::sum() const
+{
+    return sum_.load(std::memory_order_relaxed) / 1e6;
+}
+
+// stopwatch
+// ----------------------------------------------------------------------------
+
+metrics::stopwatch::stopwatch(histogram& target)
+  : target_(target), start_(steady_clock::now())
+{
+}
+
+metrics::stopwatch::~stopwatch()
+{
+    target_.observe(steady_clock::now() - start_);
+}
+
+// registry
+// ----------------------------------------------------------------------------
+
+metrics& metrics::instance()
+{
+    static metrics instance;
+    return instance;
+}
+
+metrics::counter& metrics::make_counter(const std::string& name,
+    const std::string& help)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& entry = counters_[name];
+    if (!entry.metric)
+    {
+        entry.help = help;
+        entry.metric.reset(new counter);
+    }
+
+    return *entry.metric;
+}
+
+metrics::gauge& metrics::make_gauge(const std::string& name,
+    const std::string& help)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& entry = gauges_[name];
+    if (!entry.metric)
+    {
+        entry.help = help;
+        entry.metric.reset(new gauge);
+    }
+
+    return *entry.metric;
+}
+
+metrics::histogram& metrics::make_histogram(const std::string& name,
+    const std::string& help, const histogram::bounds& upper_bounds)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& entry = histograms_[name];
+    if (!entry.metric)
+    {
+        entry.help = help;
+        entry.metric.reset(new histogram(upper_bounds));
+    }
+
+    return *entry.metric;
+}
+
+static void write_header(std::ostream& out, const std::string& name,
+    const std::string& help, const char* type)
+{
+    out << "# HELP " << name << " " << help << "\n";
+    out << "# TYPE " << name << " " << type << "\n";
+}
+
+std::string metrics::to_text() const
+{
+    std::ostringstream out;
+    out << std::setprecision(10);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (const auto& item: counters_)
+    {
+        write_header(out, item.first, item.second.help, "counter");
+        out << item.first << " " << item.second.metric->value() << "\n";
+    }
+
+    for (const auto& item: gauges_)
+    {
+        write_header(out, item.first, item.second.help, "gauge");
+        out << item.first << " " << item.second.metric->value() << "\n";
+    }
+
+    for (const auto& item: histograms_)
+    {
+        const auto& name = item.first;
+        const auto& metric = *item.second.metric;
+        const auto& bounds = metric.upper_bounds();
+        const auto counts = metric.counts();
+
+        write_header(out, name, item.second.help, "histogram");
+
+        // Buckets are cumulative in the exposition format.
+        uint64_t total = 0;
+        for (size_t index = 0; index < bounds.size(); ++index)
+        {
+            total += counts[index];
+            out << name << "_bucket{le=\"" << bounds[index] << "\"} "
+                << total << "\n";
+        }
+
+        total += counts.back();
+        out << name << "_bucket{le=\"+Inf\"} " << total << "\n";
+        out << name << "_sum " << metric.sum() << "\n";
+        out << name << "_count " << total << "\n";
+    }
+
+    return out.str();
+}
+
+} // namespace libbitcoin
@@ -0,0 +1,183 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/blockchain/account_session.hpp>
+
+#include <algorithm>
+#include <new>
+#include <metaverse/bitcoin.hpp>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace libbitcoin {
+namespace blockchain {
+
+const uint32_t account_session::max_unlock_seconds = 24 * 60 * 60;
+
+// Page granular, so locking and unlocking never touches other allocations.
+// Locking is best effort, RLIMIT_MEMLOCK may refuse it; the keys are still
+// zeroized before the pages are returned.
+static uint8_t* allocate_locked(size_t size)
+{
+#ifdef _WIN32
+    const auto data = VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE,
+        PAGE_READWRITE);
+    if (data == nullptr)
+        throw std::bad_alloc();
+
+    VirtualLock(data, size);
+#else
+    const auto data = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (data == MAP_FAILED)
+        throw std::bad_alloc();
+
+    mlock(data, size);
+#ifdef MADV_DONTDUMP
+    madvise(data, size, MADV_DONTDUMP);
+#endif
+#endif
+    return static_cast<uint8_t*>(data);
+}
+
+static void release_locked(uint8_t* data, size_t size)
+{
+    // volatile so the wipe is not elided as a dead store.
+    volatile uint8_t* wipe = data;
+    for (size_t i = 0; i < size; ++i)
+        wipe[i] = 0;
+
+#ifdef _WIN32
+    VirtualUnlock(data, size);
+    VirtualFree(data, 0, MEM_RELEASE);
+#else
+    munlock(data, size);
+    munmap(data, size);
+#endif
+}
+
+account_session::session::session(size_t count)
+  : passwd(null_hash), keys(nullptr), size(0)
+{
+    // At least one byte, an account without keys still gets a buffer.
+    size = std::max<size_t>(count * ec_secret_size, 1);
+    keys = allocate_locked(size);
+}
+
+account_session::session::~session()
+{
+    release_locked(keys, size);
+}
+
+account_session::account_session()
+{
+}
+
+account_session::~account_session()
+{
+    unique_lock lock(mutex_);
+    sessions_.clear();
+}
+
+void account_session::unlock(const std::string& name,
+    const hash_digest& passwd, const address_key_list& keys,
+    uint32_t seconds)
+{
+    seconds = std::min(seconds, max_unlock_seconds);
+
+    session_ptr entry(new session(keys.size()));
+    entry->passwd = passwd;
+    entry->expiry = clock::now() + std::chrono::seconds(seconds);
+
+    for (size_t slot = 0; slot < keys.size(); ++slot)
+    {
+        const auto& key = keys[slot].second;
+        std::copy(key.begin(), key.end(), entry->keys + slot * ec_secret_size);
+        entry->slots[keys[slot].first] = slot;
+    }
+
+    unique_lock lock(mutex_);
+    purge_expired();
+    sessions_[name] = std::move(entry);
+}
+
+void account_session::lock(const std::string& name)
+{
+    unique_lock lock(mutex_);
+    sessions_.erase(name);
+    purge_expired();
+}
+
+uint32_t account_session::remaining(const std::string& name)
+{
+    using namespace std::chrono;
+
+    unique_lock lock(mutex_);
+    purge_expired();
+
+    const auto it = sessions_.find(name);
+    if (it == sessions_.end())
+        return 0;
+
+    const auto left = duration_cast<seconds>(it->second->expiry - clock::now());
+    return static_cast<uint32_t>(std::max<int64_t>(left.count(), 0));
+}
+
+bool account_session::find(ec_secret& out_key, const std::string& name,
+    const hash_digest& passwd, const std::string& address)
+{
+    // Exclusive, every access also wipes whatever has expired since.
+    unique_lock lock(mutex_);
+    purge_expired();
+
+    const auto it = sessions_.find(name);
+    if (it == sessions_.end())
+        return false;
+
+    const auto& entry = *it->second;
+    if (entry.passwd != passwd)
+        return false;
+
+    const auto slot = entry.slots.find(address);
+    if (slot == entry.slots.end())
+        return false;
+
+    const auto key = entry.keys + slot->second * ec_secret_size;
+    std::copy(key, key + ec_secret_size, out_key.begin());
+    return true;
+}
+
+void account_session::purge_expired()
+{
+    const auto now = clock::now();
+    for (auto it = sessions_.begin(); it != sessions_.end();)
+    {
+        if (it->second->expiry <= now)
+            it = sessions_.erase(it);
+        else
+            ++it;
+    }
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
@@ -58,13 +58,18 @@ using namespace std::placeholders;
 using boost::filesystem::path;
 using string = std::string;
 
+// Blocks pruned per pass, the pass holds the chain like a block commit.
+BC_CONSTEXPR size_t blocks_per_prune = 100;
+
 
 block_chain_impl::block_chain_impl(threadpool& pool,
     const blockchain::settings& chain_settings,
     const database::settings& database_settings)
   : stopped_(true),
     sync_disabled_(false),
+    pruning_(false),
     settings_(chain_settings),
+    pool_(pool),
     organizer_(pool, *this, chain_settings),
     ////read_dispatch_(pool, NAME),
     ////write_dispatch_(pool, NAME),
@@ -117,12 +122,16 @@ bool block_chain_impl::start()
         return false;
 
     stopped_ = false;
+    block_trace::instance().configure(settings_.block_trace_directory,
+        settings_.block_trace_threshold_ms);
     organizer_.start();
     transaction_pool_.start();
 
     //init the single instance here, to avoid multi-thread init confilict
     auto* temp = account_security_strategy::get_instance();
 
+    // Catch up with blocks that left the retention depth while stopped.
+    start_prune();
     return true;
 }
 
@@ -141,6 +150,24 @@ bool block_chain_impl::close()
     return database_.close();
 }
 
+bool block_chain_impl::export_snapshot(const boost::filesystem::path& file,
+    uint64_t& out_height)
+{
+    if (stopped())
+        return false;
+
+    // Writers, pruning included, commit under the exclusive mutex. Holding
+    // it quiesces the files, readers go on during the copy.
+    unique_lock lock(mutex_);
+
+    size_t top;
+    if (!database_.blocks.top(top))
+        return false;
+
+    out_height = top;
+    return database_.export_snapshot(file);
+}
+
 // private
 bool block_chain_impl::stopped() const
 {
@@ -361,12 +388,16 @@ bool block_chain_impl::get_header(header& out_header, uint64_t height) const
     if (stopped())
         return false;
 
-    auto result = database_.blocks.get(height);
-    if (!result)
-        return false;
+    return database_.blocks.get_header(out_header, height);
+}
 
-    out_header = result.header();
-    return true;
+header::list block_chain_impl::get_headers(uint64_t from_height,
+    uint64_t to_height) const
+{
+    if (stopped())
+        return {};
+
+    return database_.blocks.get_headers(from_height, to_height);
 }
 
 uint32_t block_chain_impl::get_block_timestamp(uint64_t height) const
@@ -378,6 +409,15 @@ uint32_t block_chain_impl::get_block_timestamp(uint64_t height) const
     return out_header.timestamp;
 }
 
+database::witness_signer::list block_chain_impl::get_witness_signers(
+    uint64_t from_height, uint64_t to_height) const
+{
+    if (stopped())
+        return {};
+
+    return database_.witness_signers.get(from_height, to_height);
+}
+
 uint64_t block_chain_impl::get_transaction_count(uint64_t block_height) const
 {
     auto result = database_.blocks.get(block_height);
@@ -398,6 +438,14 @@ bool block_chain_impl::get_height(uint64_t& out_height,
     return true;
 }
 
+uint64_t block_chain_impl::get_pruned_height() const
+{
+    if (stopped())
+        return 0;
+
+    return database_.pruned_height();
+}
+
 bool block_chain_impl::get_last_height(uint64_t& out_height) const
 {
     if (stopped())
@@ -450,6 +498,7 @@ bool block_chain_impl::import(block::ptr block, uint64_t height)
 bool block_chain_impl::push(block_detail::ptr block)
 {
     database_.push(*block->actual());
+    start_prune();
     return true;
 }
 
@@ -473,17 +522,14 @@ bool block_chain_impl::pop_from(block_detail::list& out_blocks,
         return false;
 
     // If the fork is at the top there is one block to pop, and so on.
-    out_blocks.reserve(top - height + 1);
+    // The range is rolled back as one batch, top block first.
+    chain::block::list blocks;
+    if (!database_.pop_from(blocks, height, &pool_))
+        return false;
 
-    for (uint64_t index = top; index >= height; --index)
-    {
-        chain::block block;
-        if (!database_.pop(block)) {
-            return false;
-        }
-        const auto sp_block = std::make_shared<block_detail>(std::move(block));
-        out_blocks.push_back(sp_block);
-    }
+    out_blocks.reserve(blocks.size());
+    for (auto& block : blocks)
+        out_blocks.push_back(std::make_shared<block_detail>(std::move(block)));
 
     return true;
 }
@@ -503,8 +549,36 @@ void block_chain_impl::stop_write()
     BITCOIN_ASSERT(result);
 }
 
+// Pruning runs on the pool, off the block commit that triggers it. One pass
+// runs at a time and posts the next while blocks are waiting to be pruned.
+void block_chain_impl::start_prune()
+{
+    if (database_.prune_depth() == 0 || pruning_.exchange(true))
+        return;
+
+    pool_.service().post(std::bind(&block_chain_impl::do_prune, this));
+}
+
+void block_chain_impl::do_prune()
+{
+    auto more = false;
+    if (!stopped())
+    {
+        block_chain_writer locked_write(*this);
+        more = database_.prune(blocks_per_prune);
+    }
+
+    if (more && !stopped())
+    {
+        pool_.service().post(std::bind(&block_chain_impl::do_prune, this));
+        return;
+    }
+
+    pruning_ = false;
+}
+
 block_chain_writer::block_chain_writer(block_chain_impl& chain)
-    : chain_(chain)
+    : chain_(chain), lock_(chain.mutex_)
 {
     chain_.start_write();
 }
@@ -541,7 +615,10 @@ void block_chain_impl::store(message::block_message::ptr block,
 
     ///////////////////////////////////////////////////////////////////////////
     // Critical Section.
-    unique_lock lock(mutex_);
+    // Validation reads the chain without the exclusive mutex, so queries and
+    // account writes continue while a block verifies. The organizer takes
+    // the exclusive mutex (block_chain_writer) only to commit.
+    unique_lock lock(organize_mutex_);
 
     do_store(block, handler);
     ///////////////////////////////////////////////////////////////////////////
@@ -584,21 +661,9 @@ void block_chain_impl::fetch_serial(perform_read_functor perform_read)
 {
     // Post IBD writes are ordered on the strand, so never concurrent.
     // Reads are unordered and concurrent, but effectively blocked by writes.
-    const auto try_read = [this, perform_read]()
-    {
-        const auto handle = database_.begin_read();
-        return (!database_.is_write_locked(handle) && perform_read(handle));
-    };
-
-    const auto do_read = [try_read]()
-    {
-        // Sleep while waiting for write to complete.
-        while (!try_read())
-            std::this_thread::sleep_for(asio::milliseconds(10));
-    };
-
-    // Initiate serial read operation.
-    do_read();
+    // A read that overlaps a write fails validation and is retried as soon
+    // as the write ends, end_write wakes the waiting readers.
+    while (!perform_read(database_.wait_read()));
 }
 
 ////void block_chain_impl::fetch_parallel(perform_read_functor perform_read)
@@ -912,16 +977,7 @@ void block_chain_impl::fetch_block_header(uint64_t height,
     const auto do_fetch = [this, height, handler](size_t slock)
     {
         chain::header header;
-        auto found = false;
-        {
-            const auto result = database_.blocks.get(height);
-            if(result)
-            {
-                header = result.header();
-                header.transaction_count = result.transaction_count();
-                found = true;
-            }
-        }
+        const auto found = database_.blocks.get_header(header, height, true);
         return found ?
             finish_fetch(slock, handler, error::success, header) :
             finish_fetch(slock, handler, error::not_found, chain::header());
@@ -941,16 +997,7 @@ void block_chain_impl::fetch_block_header(const hash_digest& hash,
     const auto do_fetch = [this, hash, handler](size_t slock)
     {
         chain::header header;
-        auto found = false;
-        {
-            const auto result = database_.blocks.get(hash);
-            if(result)
-            {
-                header = result.header();
-                header.transaction_count = result.transaction_count();
-                found = true;
-            }
-        }
+        const auto found = database_.blocks.get_header(header, hash, true);
         return found ?
             finish_fetch(slock, handler, error::success, header) :
             finish_fetch(slock, handler, error::not_found, chain::header());
@@ -1106,16 +1153,7 @@ void block_chain_impl::fetch_block_public_key(uint64_t height, block_public_key_
     const auto do_fetch = [this, height, handler](size_t slock)
     {
         ec_compressed pubkey{};
-        auto found = false;
-        {
-            const auto result = database_.blocks.get(height);
-            if (result) {
-                if (result.header().is_proof_of_dpos()) {
-                    pubkey = result.public_key();
-                    found = true;
-                }
-            }
-        }
+        const auto found = database_.blocks.get_public_key(pubkey, height);
 
         return found ?
                finish_fetch(slock, handler, error::success, pubkey) :
@@ -1134,16 +1172,7 @@ void block_chain_impl::fetch_block_public_key(const hash_digest& hash, block_pub
     const auto do_fetch = [this, hash, handler](size_t slock)
     {
         ec_compressed pubkey{};
-        auto found = false;
-        {
-            const auto result = database_.blocks.get(hash);
-            if (result) {
-                if (result.header().is_proof_of_dpos()) {
-                    pubkey = result.public_key();
-                    found = true;
-                }
-            }
-        }
+        const auto found = database_.blocks.get_public_key(pubkey, hash);
 
         return found ?
                finish_fetch(slock, handler, error::success, pubkey) :
@@ -1164,15 +1193,7 @@ void block_chain_impl::fetch_block_height(const hash_digest& hash,
     const auto do_fetch = [this, hash, handler](size_t slock)
     {
         std::size_t h{0};
-        auto found = false;
-        {
-            const auto result = database_.blocks.get(hash);
-            if(result)
-            {
-                h = result.height();
-                found = true;
-            }
-        }
+        const auto found = database_.blocks.get_height(h, hash);
 
         return found ?
             finish_fetch(slock, handler, error::success, h) :
@@ -1394,6 +1415,7 @@ void block_chain_impl::set_account_passwd(const std::string& name, const std::st
 {
     auto account = get_account(name);
     if (account) {
+        account_sessions_.lock(name);
         account->set_passwd(passwd);
         store_account(account);
     }
@@ -1402,6 +1424,67 @@ void block_chain_impl::set_account_passwd(const std::string& name, const std::st
     }
 }
 
+uint32_t block_chain_impl::unlock_account(const std::string& name,
+    const std::string& passwd, uint32_t seconds)
+{
+    auto account = is_account_passwd_valid(name, passwd);
+
+    auto addresses = get_account_addresses(name);
+    if (!addresses) {
+        throw std::logic_error{"nullptr for address list"};
+    }
+
+    account_session::address_key_list keys;
+    keys.reserve(addresses->size());
+    for (const auto& each : *addresses) {
+        std::string pass(passwd);
+        auto prv_key = each.get_prv_key(pass);
+
+        // multisig and imported rows may hold other encodings, those keep
+        // being decrypted on use.
+        data_chunk secret;
+        if (decode_base16(secret, prv_key) && secret.size() == ec_secret_size) {
+            keys.emplace_back(each.get_address(), to_array<ec_secret_size>(secret));
+        }
+
+        std::fill(prv_key.begin(), prv_key.end(), 0);
+        std::fill(secret.begin(), secret.end(), 0);
+    }
+
+    seconds = std::min(seconds, account_session::max_unlock_seconds);
+    account_sessions_.unlock(name, account->get_passwd(), keys, seconds);
+
+    for (auto& each : keys) {
+        each.second.fill(0);
+    }
+
+    return seconds;
+}
+
+void block_chain_impl::lock_account(const std::string& name)
+{
+    account_sessions_.lock(name);
+}
+
+uint32_t block_chain_impl::get_account_unlock_remaining(const std::string& name)
+{
+    return account_sessions_.remaining(name);
+}
+
+std::string block_chain_impl::get_account_prv_key(const std::string& name,
+    const std::string& passwd, const chain::account_address& address)
+{
+    ec_secret secret;
+    if (account_sessions_.find(secret, name, get_hash(passwd), address.get_address())) {
+        const auto prv_key = encode_base16(secret);
+        secret.fill(0);
+        return prv_key;
+    }
+
+    std::string pass(passwd);
+    return address.get_prv_key(pass);
+}
+
 bool block_chain_impl::is_admin_account(const std::string& name)
 {
     auto account = get_account(name);
@@ -1454,6 +1537,8 @@ operation_result block_chain_impl::delete_account(const std::string& name)
         return operation_result::failure;
     }
 
+    account_sessions_.lock(name);
+
     ///////////////////////////////////////////////////////////////////////////
     // Critical Section.
     unique_lock lock(mutex_);
@@ -1527,6 +1612,12 @@ std::shared_ptr<account_address::list> block_chain_impl::get_account_addresses(
     return sp_addr;
 }
 
+// names of the local accounts holding address
+std::vector<std::string> block_chain_impl::get_address_owners(const std::string& address)
+{
+    return database_.account_addresses.get_address_owners(address);
+}
+
 operation_result block_chain_impl::store_account_asset(
     const asset_detail& detail,
     const string& name)
@@ -1760,28 +1851,16 @@ std::shared_ptr<asset_cert> block_chain_impl::get_account_asset_cert(
     if (!pvaddr)
         return nullptr;
 
-    chain::transaction tx_temp;
-    uint64_t tx_height;
-
+    // The address asset rows already carry the certs, filtered by symbol
+    // and type, so no transaction has to be read.
     for (auto& each : *pvaddr){
-        wallet::payment_address payment_address(each.get_address());
-        auto&& rows = get_address_history(payment_address);
+        auto&& rows = database_.address_assets.get_asset_certs_history(
+            each.get_address(), symbol, cert_type, 0);
 
         for (auto& row: rows) {
             // spend unconfirmed (or no spend attempted)
-            if ((row.spend.hash == null_hash)
-                    && get_transaction(tx_temp, tx_height, row.output.hash))
-            {
-                BITCOIN_ASSERT(row.output.index < tx_temp.outputs.size());
-                const auto& output = tx_temp.outputs.at(row.output.index);
-                if (output.is_asset_cert()) {
-                    auto cert = output.get_asset_cert();
-                    if (symbol != cert.get_symbol() || cert_type != cert.get_type()) {
-                        continue;
-                    }
-
-                    return std::make_shared<asset_cert>(cert);
-                }
+            if (row.spend.hash == null_hash) {
+                return std::make_shared<asset_cert>(boost::get<asset_cert>(row.data.get_data()));
             }
         }
     }
@@ -1820,20 +1899,7 @@ block_chain_impl::get_account_asset_certs(const std::string& account, const std:
 std::shared_ptr<asset_cert::list> block_chain_impl::get_issued_asset_certs(
     const std::string& address, asset_cert_type cert_type)
 {
-    auto sp_vec = std::make_shared<asset_cert::list>();
-    auto sp_asset_certs_vec = database_.certs.get_blockchain_asset_certs();
-    for (const auto& each : *sp_asset_certs_vec) {
-        if (!address.empty() && address != each.get_address()) {
-            continue;
-        }
-
-        if (cert_type != asset_cert_ns::none && cert_type != each.get_type()) {
-            continue;
-        }
-
-        sp_vec->emplace_back(std::move(each));
-    }
-    return sp_vec;
+    return database_.certs.get_blockchain_asset_certs(address, cert_type);
 }
 
 std::shared_ptr<asset_cert> block_chain_impl::get_asset_cert(const std::string& symbol, asset_cert_type cert_type) const
@@ -1868,6 +1934,18 @@ std::shared_ptr<asset_mit_info::list> block_chain_impl::get_registered_mits()
     return database_.mits.get_blockchain_mits();
 }
 
+// offset and limit count symbols in symbol order
+std::shared_ptr<asset_mit_info::list> block_chain_impl::get_registered_mits(
+    const std::string& prefix, uint64_t offset, uint64_t limit)
+{
+    return database_.mits.get_blockchain_mits(prefix, offset, limit);
+}
+
+uint64_t block_chain_impl::get_registered_mit_count(const std::string& prefix)
+{
+    return database_.mits.get_symbol_index().count(prefix);
+}
+
 std::shared_ptr<asset_mit_info::list> block_chain_impl::get_mit_history(
     const std::string& symbol, uint64_t limit, uint64_t page_number)
 {
@@ -2249,6 +2327,24 @@ std::shared_ptr<asset_detail::list> block_chain_impl::get_issued_assets(
     return sp_vec;
 }
 
+// offset and limit count symbols in symbol order, forbidden symbols are
+// not in the index and so neither paged nor counted.
+std::shared_ptr<asset_detail::list> block_chain_impl::get_issued_assets(
+    const std::string& prefix, uint64_t offset, uint64_t limit)
+{
+    auto sp_vec = std::make_shared<asset_detail::list>();
+    auto sp_blockchain_vec = database_.assets.get_blockchain_assets(prefix, offset, limit);
+    for (auto& each : *sp_blockchain_vec) {
+        sp_vec->push_back(each.get_asset());
+    }
+    return sp_vec;
+}
+
+uint64_t block_chain_impl::get_issued_asset_count(const std::string& prefix)
+{
+    return database_.assets.get_symbol_index().count(prefix);
+}
+
 std::shared_ptr<blockchain_asset::list> block_chain_impl::get_asset_register_output(const std::string& symbol)
 {
     return database_.assets.get_asset_history(symbol);
@@ -2378,6 +2474,26 @@ std::shared_ptr<did_detail::list> block_chain_impl::get_registered_dids()
     return sp_vec;
 }
 
+// offset and limit count symbols in symbol order
+std::shared_ptr<did_detail::list> block_chain_impl::get_registered_dids(
+    const std::string& prefix, uint64_t offset, uint64_t limit)
+{
+    auto sp_vec = std::make_shared<did_detail::list>();
+    auto sp_blockchain_vec = database_.dids.get_blockchain_dids(prefix, offset, limit);
+    for (const auto &each : *sp_blockchain_vec){
+        if (each.get_status() == blockchain_did::address_current){
+            sp_vec->emplace_back(each.get_did());
+        }
+    }
+
+    return sp_vec;
+}
+
+uint64_t block_chain_impl::get_registered_did_count(const std::string& prefix)
+{
+    return database_.dids.get_symbol_index().count(prefix);
+}
+
 std::shared_ptr<asset_detail> block_chain_impl::get_issued_asset(const std::string& symbol)
 {
     std::shared_ptr<asset_detail> sp_asset(nullptr);
@@ -2742,6 +2858,11 @@ shared_mutex& block_chain_impl::get_mutex()
     return mutex_;
 }
 
+shared_mutex& block_chain_impl::get_organize_mutex()
+{
+    return organize_mutex_;
+}
+
 bool block_chain_impl::is_sync_disabled() const
 {
     return sync_disabled_;
@@ -3321,13 +3442,13 @@ uint32_t block_chain_impl::get_median_time_past(uint64_t height) const
     constexpr uint64_t median_time_span = 11;
     const auto count = std::min(height, median_time_span);
 
-    chain::header header;
-    std::vector<uint32_t> times;
+    const auto headers = get_headers(height - count + 1, height + 1);
+    if (headers.size() != count) {
+        return max_uint32;
+    }
 
-    for (uint64_t i = 1; i <= count; ++i) {
-        if (!get_header(header, height - count + i)) {
-            return max_uint32;
-        }
+    std::vector<uint32_t> times;
+    for (const auto& header : headers) {
         times.push_back(header.timestamp);
     }
 
@@ -0,0 +1,158 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/blockchain/fee_estimator.hpp>
+
+#include <algorithm>
+#include <metaverse/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+const size_t fee_estimator::max_target = 48;
+
+// Buckets grow geometrically from the lowest rate worth telling apart.
+static constexpr uint64_t minimum_bucket_rate = 1000;
+static constexpr uint64_t maximum_bucket_rate = 10000000000;
+static constexpr double bucket_spacing = 1.25;
+
+// History halves in about 350 blocks.
+static constexpr double decay = 0.998;
+
+// A group of buckets passes when this share confirmed within the target,
+// judged only once it holds this many (decayed) transactions.
+static constexpr double success_threshold = 0.85;
+static constexpr double sufficient_transactions = 4.0;
+
+fee_estimator::fee_estimator()
+  : height_(0)
+{
+    for (double bound = minimum_bucket_rate; bound <= maximum_bucket_rate;
+        bound *= bucket_spacing)
+        bounds_.push_back(static_cast<uint64_t>(bound));
+
+    buckets_.resize(bounds_.size(), { 0.0, std::vector<double>(max_target) });
+}
+
+size_t fee_estimator::bucket_of(uint64_t fee_rate) const
+{
+    const auto it = std::upper_bound(bounds_.begin(), bounds_.end(), fee_rate);
+    return it == bounds_.begin() ? 0 : std::distance(bounds_.begin(), it) - 1;
+}
+
+void fee_estimator::set_height(uint64_t height)
+{
+    unique_lock lock(mutex_);
+    height_ = height;
+}
+
+void fee_estimator::track(const hash_digest& hash, uint64_t fee_rate)
+{
+    unique_lock lock(mutex_);
+
+    // Entry heights are meaningless until the chain top is known.
+    if (height_ != 0)
+        tracked_[hash] = { bucket_of(fee_rate), height_ };
+}
+
+void fee_estimator::untrack(const hash_digest& hash)
+{
+    unique_lock lock(mutex_);
+    tracked_.erase(hash);
+}
+
+void fee_estimator::untrack_all()
+{
+    unique_lock lock(mutex_);
+    tracked_.clear();
+}
+
+void fee_estimator::confirm(const chain::block& block, uint64_t height)
+{
+    unique_lock lock(mutex_);
+    height_ = height;
+
+    for (auto& bucket : buckets_)
+    {
+        bucket.total *= decay;
+        for (auto& count : bucket.confirmed)
+            count *= decay;
+    }
+
+    for (const auto& tx : block.transactions)
+    {
+        const auto it = tracked_.find(tx.hash());
+        if (it == tracked_.end())
+            continue;
+
+        // Mined in the block after entry is one block to confirm.
+        const auto waited = height > it->second.height ?
+            height - it->second.height : 1;
+
+        auto& bucket = buckets_[it->second.bucket];
+        bucket.total += 1.0;
+        for (auto target = waited; target <= max_target; ++target)
+            bucket.confirmed[target - 1] += 1.0;
+
+        tracked_.erase(it);
+    }
+}
+
+bool fee_estimator::estimate(uint64_t& out_fee_rate, size_t target) const
+{
+    if (target == 0 || target > max_target)
+        return false;
+
+    shared_lock lock(mutex_);
+
+    // Transactions still waiting past the target have failed it already.
+    std::vector<double> overdue(buckets_.size(), 0.0);
+    for (const auto& item : tracked_)
+        if (height_ >= item.second.height + target)
+            overdue[item.second.bucket] += 1.0;
+
+    auto found = false;
+    double total = 0.0;
+    double confirmed = 0.0;
+
+    // Extend a group down from the highest bucket until it is large enough
+    // to judge, and stop at the first group that misses the threshold.
+    for (auto index = buckets_.size(); index-- > 0;)
+    {
+        const auto& bucket = buckets_[index];
+        total += bucket.total + overdue[index];
+        confirmed += bucket.confirmed[target - 1];
+
+        if (total < sufficient_transactions)
+            continue;
+
+        if (confirmed / total < success_threshold)
+            break;
+
+        found = true;
+        out_fee_rate = bounds_[index];
+        total = 0.0;
+        confirmed = 0.0;
+    }
+
+    return found;
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
@@ -0,0 +1,240 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/blockchain/fee_rate_index.hpp>
+
+#include <algorithm>
+#include <unordered_set>
+#include <metaverse/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+// Highest rate first, ties in hash order so the ranking is deterministic.
+bool fee_rate_index::rank::operator<(const rank& other) const
+{
+    if (rate != other.rate)
+        return rate > other.rate;
+
+    return hash < other.hash;
+}
+
+uint64_t fee_rate_index::to_fee_rate(uint64_t fee, uint64_t size)
+{
+    return size == 0 ? 0 : static_cast<uint64_t>(fee * 1000.0 / size);
+}
+
+bool fee_rate_index::add(const chain::transaction& tx, uint64_t fee)
+{
+    const auto hash = tx.hash();
+    if (entries_.count(hash) != 0)
+        return false;
+
+    entry item;
+    item.fee = fee;
+    item.size = tx.serialized_size();
+
+    for (const auto& input : tx.inputs)
+    {
+        const auto& parent = input.previous_output.hash;
+        if (entries_.count(parent) != 0 &&
+            std::find(item.parents.begin(), item.parents.end(), parent) ==
+                item.parents.end())
+            item.parents.push_back(parent);
+    }
+
+    for (const auto& parent : item.parents)
+        entries_[parent].children.push_back(hash);
+
+    const auto inserted = entries_.emplace(hash, std::move(item)).first;
+    auto& added = inserted->second;
+    added.package_fee = added.fee;
+    added.package_size = added.size;
+
+    // Each ancestor counts once however many paths lead to it.
+    for (const auto& ancestor : relatives(hash, true))
+    {
+        const auto& relative = entries_.at(ancestor);
+        added.package_fee += relative.fee;
+        added.package_size += relative.size;
+    }
+
+    added.package_rate = added.package_size == 0 ? 0.0 :
+        added.package_fee * 1000.0 / added.package_size;
+    ranks_.insert({ added.package_rate, hash });
+    return true;
+}
+
+bool fee_rate_index::remove(const hash_digest& hash)
+{
+    const auto it = entries_.find(hash);
+    if (it == entries_.end())
+        return false;
+
+    const auto removed = it->second;
+
+    for (const auto& descendant : relatives(hash, false))
+    {
+        auto& relative = entries_.at(descendant);
+        relative.package_fee -= removed.fee;
+        relative.package_size -= removed.size;
+        rerank(descendant, relative, relative.package_size == 0 ? 0.0 :
+            relative.package_fee * 1000.0 / relative.package_size);
+    }
+
+    for (const auto& parent : removed.parents)
+    {
+        auto& children = entries_.at(parent).children;
+        children.erase(std::remove(children.begin(), children.end(), hash),
+            children.end());
+    }
+
+    for (const auto& child : removed.children)
+    {
+        auto& parents = entries_.at(child).parents;
+        parents.erase(std::remove(parents.begin(), parents.end(), hash),
+            parents.end());
+    }
+
+    ranks_.erase({ removed.package_rate, hash });
+    entries_.erase(it);
+    return true;
+}
+
+void fee_rate_index::clear()
+{
+    entries_.clear();
+    ranks_.clear();
+}
+
+bool fee_rate_index::contains(const hash_digest& hash) const
+{
+    return entries_.count(hash) != 0;
+}
+
+size_t fee_rate_index::size() const
+{
+    return entries_.size();
+}
+
+bool fee_rate_index::fee_rate(uint64_t& out_rate,
+    const hash_digest& hash) const
+{
+    const auto it = entries_.find(hash);
+    if (it == entries_.end())
+        return false;
+
+    out_rate = to_fee_rate(it->second.fee, it->second.size);
+    return true;
+}
+
+bool fee_rate_index::package_fee_rate(uint64_t& out_rate,
+    const hash_digest& hash) const
+{
+    const auto it = entries_.find(hash);
+    if (it == entries_.end())
+        return false;
+
+    out_rate = to_fee_rate(it->second.package_fee, it->second.package_size);
+    return true;
+}
+
+hash_list fee_rate_index::ranked(size_t limit) const
+{
+    const auto count = limit == 0 ? ranks_.size() :
+        std::min(limit, ranks_.size());
+
+    hash_list hashes;
+    hashes.reserve(count);
+    std::unordered_set<hash_digest> emitted;
+
+    // Walk each package depth first through parents not yet emitted and
+    // emit on the way back, so ancestors always precede their children.
+    typedef std::pair<hash_digest, size_t> step;
+    std::vector<step> path;
+
+    for (const auto& rank : ranks_)
+    {
+        if (hashes.size() == count)
+            break;
+
+        if (emitted.count(rank.hash) != 0)
+            continue;
+
+        path.push_back({ rank.hash, 0 });
+        while (!path.empty() && hashes.size() < count)
+        {
+            const auto current = path.back().first;
+            const auto& parents = entries_.at(current).parents;
+            const auto next = path.back().second++;
+
+            if (next < parents.size())
+            {
+                if (emitted.count(parents[next]) == 0)
+                    path.push_back({ parents[next], 0 });
+
+                continue;
+            }
+
+            emitted.insert(current);
+            hashes.push_back(current);
+            path.pop_back();
+        }
+
+        path.clear();
+    }
+
+    return hashes;
+}
+
+hash_list fee_rate_index::relatives(const hash_digest& hash,
+    bool ancestors) const
+{
+    hash_list found;
+    std::unordered_set<hash_digest> visited{ hash };
+    hash_list pending{ hash };
+
+    while (!pending.empty())
+    {
+        const auto current = pending.back();
+        pending.pop_back();
+
+        const auto& entry = entries_.at(current);
+        for (const auto& next : ancestors ? entry.parents : entry.children)
+        {
+            if (!visited.insert(next).second)
+                continue;
+
+            found.push_back(next);
+            pending.push_back(next);
+        }
+    }
+
+    return found;
+}
+
+void fee_rate_index::rerank(const hash_digest& hash, entry& entry, double rate)
+{
+    ranks_.erase({ entry.package_rate, hash });
+    entry.package_rate = rate;
+    ranks_.insert({ rate, hash });
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
@@ -109,12 +109,19 @@ code organizer::verify(uint64_t fork_point,
         return stopped();
     };
 
+    const block_trace::scope trace(current_block->header.hash(), "verify");
+
     // Validates current_block
     validate_block_impl validate(chain_, fork_point, orphan_chain, orphan_index, height,
         *current_block, use_testnet_rules_, checkpoints_, callback);
 
     // Checks that are independent of the chain.
-    auto ec = validate.check_block(chain_);
+    code ec;
+    {
+        const block_trace::span span("check_block");
+        ec = validate.check_block(chain_);
+    }
+
     if (error::success != ec.value()) {
         log::warning(LOG_BLOCKCHAIN) << "organizer: check_block failed! error:"
             << std::to_string(ec.value()) << ", fork_point: "
@@ -123,7 +130,11 @@ code organizer::verify(uint64_t fork_point,
     }
 
     // Checks that are dependent on height and preceding blocks.
-    ec = validate.accept_block();
+    {
+        const block_trace::span span("accept_block");
+        ec = validate.accept_block();
+    }
+
     if (error::success != ec.value()) {
         log::warning(LOG_BLOCKCHAIN) << "organizer: accept_block failed! error:"
             << std::to_string(ec.value()) << ", fork_point: "
@@ -152,6 +163,7 @@ code organizer::verify(uint64_t fork_point,
     const auto timed = [this, &ec, &validate]()
     {
         hash_digest err_tx;
+        const block_trace::span span("connect_block");
         // Checks that include input->output traversal.
         ec = validate.connect_block(err_tx, chain_);
         if(ec && err_tx != null_hash) {
@@ -163,6 +175,19 @@ code organizer::verify(uint64_t fork_point,
     // Execute the timed validation.
     const auto elapsed = timer<std::chrono::milliseconds>::duration(timed);
     const auto ms_per_block = static_cast<float>(elapsed.count());
+
+    static auto& connect_seconds = metrics::instance().make_histogram(
+        "mvs_block_connect_seconds", "Time to connect a block's inputs.");
+    static auto& inputs_verified = metrics::instance().make_counter(
+        "mvs_block_inputs_verified_total", "Inputs verified by block connect.");
+    static auto& blocks_rejected = metrics::instance().make_counter(
+        "mvs_blocks_rejected_total", "Blocks that failed to connect.");
+
+    connect_seconds.observe(elapsed);
+    inputs_verified.increment(total_inputs);
+    if (ec)
+        blocks_rejected.increment();
+
     const auto ms_per_input = ms_per_block / total_inputs;
     const auto seconds_per_block = ms_per_block / 1000;
     const auto verified = ec ? "unverified" : "verified";
@@ -346,6 +371,11 @@ organizer::replace_chain(uint64_t fork_index, block_detail::list& orphan_chain)
                     if (ec.value() != error::service_stopped)
                     {
                         const auto& header = orphan_chain[orphan]->actual()->header;
+
+                        // A rejected block never reaches push, its trace ends here.
+                        block_trace::instance().finish(header.hash(),
+                            fork_index + orphan + 1);
+
                         const auto block_hash = encode_hash(header.hash());
 
                         if (exception_blocks.count(std::make_pair(header.number, block_hash)))
@@ -463,8 +493,18 @@ organizer::replace_chain(uint64_t fork_index, block_detail::list& orphan_chain)
         // Indicates the block is not an orphan.
         arrival_block->set_height(++arrival_index);
 
-        // THIS IS THE DATABASE BLOCK WRITE AND INDEX OPERATION.
-        if(chain_.push(arrival_block) == false)
+        const auto arrival_hash = arrival_block->actual()->header.hash();
+        bool pushed;
+        {
+            const block_trace::scope trace(arrival_hash, "push");
+
+            // THIS IS THE DATABASE BLOCK WRITE AND INDEX OPERATION.
+            pushed = chain_.push(arrival_block);
+        }
+
+        block_trace::instance().finish(arrival_hash, arrival_index);
+
+        if(pushed == false)
         {
             log::warning(LOG_BLOCKCHAIN)
                 << " push block height:" << arrival_block->actual()->header.number
@@ -122,23 +122,23 @@ profile::ptr witness_profile::get_profile(const profile_context& context)
         }
     }
 
-    uint32_t mined_block_count = 0;
-    uint32_t missed_block_count = 0;
     uint32_t total_dpos_block_count = 0;
-    chain::header header;
+
+    // read signers from the witness signer index instead of block headers.
+    const auto signers = chain.get_witness_signers(range.first, range.second);
+    if (signers.size() != range.second - range.first) {
+        return nullptr;
+    }
 
     uint32_t prev_slot_num = max_uint32;
     uint32_t curr_slot_num = 0;
-    for (auto height = range.first; height < range.second; ++height) {
-        if (!chain.get_header(header, height)) {
-            return nullptr;
-        }
-        if (!header.is_proof_of_dpos()) {
+    for (const auto& signer : signers) {
+        if (!signer.is_dpos()) {
             continue;
         }
         ++total_dpos_block_count;
 
-        curr_slot_num = static_cast<uint32_t>(header.nonce);
+        curr_slot_num = signer.slot_num;
         if (mining_stat_vec[curr_slot_num] != nullptr) {
             ++mining_stat_vec[curr_slot_num]->mined_block_count; // mined_block_count
         }
@@ -37,6 +37,8 @@ settings::settings()
     use_testnet_rules(false),
     collect_split_stake(true),
     disable_account_operations(false),
+    block_trace_threshold_ms(0),
+    block_trace_directory("block-trace"),
     checkpoints(),
     basic_checkpoints()
 {
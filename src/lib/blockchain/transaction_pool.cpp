@@ -40,6 +40,13 @@ using namespace std::placeholders;
 
 using string = std::string;
 
+static metrics::gauge& pool_size()
+{
+    static auto& gauge = metrics::instance().make_gauge(
+        "mvs_txpool_transactions", "Transactions held in the memory pool.");
+    return gauge;
+}
+
 transaction_pool::transaction_pool(threadpool& pool, block_chain& chain,
                                    const settings& settings)
     : stopped_(true),
@@ -63,6 +70,14 @@ void transaction_pool::start()
     index_.start();
     subscriber_->start();
 
+    // The estimator measures waits from the height a transaction arrived at.
+    blockchain_.fetch_last_height(
+        [this](const code& ec, uint64_t height)
+        {
+            if (!ec)
+                fee_estimator_.set_height(height);
+        });
+
     // Subscribe to blockchain (organizer) reorg notifications.
     blockchain_.subscribe_reorganize(
         std::bind(&transaction_pool::handle_reorganized,
@@ -97,64 +112,97 @@ void transaction_pool::inventory(message::inventory::ptr inventory)
 
 void transaction_pool::validate(transaction_ptr tx, validate_handler handler)
 {
+    // Validation alone has no use for the fee.
+    const fee_handler drop_fee = [handler](const code& ec, transaction_ptr tx,
+        const indexes& unconfirmed, uint64_t)
+    {
+        handler(ec, tx, unconfirmed);
+    };
+
     dispatch_.ordered(&transaction_pool::do_validate,
-                      this, tx, handler);
+                      this, tx, drop_fee);
 }
 
-void transaction_pool::do_validate(transaction_ptr tx,
-                                   validate_handler handler)
+void transaction_pool::do_validate(transaction_ptr tx, fee_handler handler)
 {
     if (stopped())
     {
-        handler(error::service_stopped, tx, {});
+        handler(error::service_stopped, tx, {}, 0);
         return;
     }
 
+    static auto& validate_seconds = metrics::instance().make_histogram(
+        "mvs_txpool_validate_seconds", "Time to validate a pool transaction.");
+    static auto& rejected = metrics::instance().make_counter(
+        "mvs_txpool_rejected_total", "Transactions refused by the pool.");
+
+    const auto start = std::chrono::steady_clock::now();
+    const fee_handler timed_handler = [handler, start](const code& ec,
+        transaction_ptr tx, const indexes& unconfirmed, uint64_t fee)
+    {
+        validate_seconds.observe(std::chrono::steady_clock::now() - start);
+        if (ec)
+            rejected.increment();
+
+        handler(ec, tx, unconfirmed, fee);
+    };
+
     const auto validate = std::make_shared<validate_transaction>(
                               blockchain_, *tx, *this, dispatch_);
 
+    // The validator is alive while it calls back, so read the value its
+    // inputs spent then and carry the fee into the pool.
+    const auto validator = validate.get();
     validate->start(
-        dispatch_.ordered_delegate(&transaction_pool::handle_validated,
-                                   this, _1, _2, _3, handler));
+        [this, validator, timed_handler](const code& ec, transaction_ptr tx,
+            const indexes& unconfirmed)
+        {
+            const auto value_in = validator->get_value_in();
+            const auto value_out = tx->total_output_value();
+            const auto fee = value_in > value_out ? value_in - value_out : 0;
+
+            dispatch_.ordered(&transaction_pool::handle_validated,
+                this, ec, tx, unconfirmed, fee, timed_handler);
+        });
 }
 
 void transaction_pool::handle_validated(const code& ec, transaction_ptr tx,
-                                        const indexes& unconfirmed, validate_handler handler)
+                                        const indexes& unconfirmed, uint64_t fee, fee_handler handler)
 {
     if (stopped())
     {
-        handler(error::service_stopped, tx, {});
+        handler(error::service_stopped, tx, {}, 0);
         return;
     }
 
     if (ec.value() == error::input_not_found || ec.value() == error::validate_inputs_failed)
     {
         BITCOIN_ASSERT(unconfirmed.size() == 1);
-        handler(ec, tx, unconfirmed);
+        handler(ec, tx, unconfirmed, 0);
         return;
     }
 
     if (ec)
     {
         BITCOIN_ASSERT(unconfirmed.empty());
-        handler(ec, tx, {});
+        handler(ec, tx, {}, 0);
         return;
     }
 
     // Recheck the memory pool, as a duplicate may have been added.
     if (is_in_pool(tx->hash()))
     {
-        handler(error::duplicate, tx, {});
+        handler(error::duplicate, tx, {}, 0);
         return;
     }
 
     code error = check_symbol_repeat(tx);
     if (error) {
-        handler(error, tx, {});
+        handler(error, tx, {}, 0);
         return;
     }
 
-    handler(error::success, tx, unconfirmed);
+    handler(error::success, tx, unconfirmed, fee);
 }
 
 code transaction_pool::check_symbol_repeat(transaction_ptr tx)
@@ -293,15 +341,15 @@ void transaction_pool::store(transaction_ptr tx,
         return;
     }
 
-    validate(tx,
-             std::bind(&transaction_pool::do_store,
-                       this, _1, _2, _3, handle_confirm, handle_validate));
+    dispatch_.ordered(&transaction_pool::do_validate, this, tx,
+                      fee_handler(std::bind(&transaction_pool::do_store,
+                          this, _1, _2, _3, _4, handle_confirm, handle_validate)));
 }
 
 // This is overly complex due to the transaction pool and index split.
 void transaction_pool::do_store(const code& ec, transaction_ptr tx,
-                                const indexes& unconfirmed, confirm_handler handle_confirm,
-                                validate_handler handle_validate)
+                                const indexes& unconfirmed, uint64_t fee,
+                                confirm_handler handle_confirm, validate_handler handle_validate)
 {
     if (ec)
     {
@@ -322,8 +370,12 @@ void transaction_pool::do_store(const code& ec, transaction_ptr tx,
         index_.remove(*tx, do_confirm);
     };
 
+    static auto& accepted = metrics::instance().make_counter(
+        "mvs_txpool_accepted_total", "Transactions admitted to the pool.");
+
     // Add to pool, save confirmation handler.
-    add(tx, do_deindex);
+    add(tx, fee, do_deindex);
+    accepted.increment();
 
     const auto handle_indexed = [this, handle_validate, tx, unconfirmed](
                                     const code ec)
@@ -364,6 +416,37 @@ void transaction_pool::fetch(fetch_all_handler handler)
     dispatch_.ordered(tx_fetcher);
 }
 
+void transaction_pool::fetch_by_fee_rate(size_t limit,
+    fetch_all_handler handler)
+{
+    if (stopped())
+    {
+        handler(error::service_stopped, {});
+        return;
+    }
+
+    const auto tx_fetcher = [this, limit, handler]()
+    {
+        std::vector<transaction_ptr> transactions;
+        for (const auto& hash : fee_index_.ranked(limit))
+        {
+            const auto it = find(hash);
+            if (it != buffer_.end())
+                transactions.push_back(it->tx);
+        }
+
+        handler(error::success, transactions);
+    };
+
+    dispatch_.ordered(tx_fetcher);
+}
+
+bool transaction_pool::estimate_fee_rate(uint64_t& out_fee_rate,
+    size_t target) const
+{
+    return fee_estimator_.estimate(out_fee_rate, target);
+}
+
 void transaction_pool::delete_tx(const hash_digest& tx_hash)
 {
     if (stopped())
@@ -380,6 +463,8 @@ void transaction_pool::delete_tx(const hash_digest& tx_hash)
             {
                 log::debug(LOG_BLOCKCHAIN) << " delete_tx hash:" << libbitcoin::encode_hash(tx_hash) << " success";
                 buffer_.erase(item);
+                unindex(tx_hash);
+                pool_size().set(buffer_.size());
                 break;
             }
         }
@@ -487,7 +572,7 @@ bool transaction_pool::handle_reorganized(const code& ec, size_t fork_point,
         // Remove memory pool transactions that also exist in new blocks.
         dispatch_.ordered(
             std::bind(&transaction_pool::remove,
-                      this, new_blocks));
+                      this, fork_point, new_blocks));
     }
     else
     {
@@ -524,13 +609,24 @@ void transaction_pool::notify_transaction(const point::indexes& unconfirmed,
 // ----------------------------------------------------------------------------
 
 // A new transaction has been received, add it to the memory pool.
-void transaction_pool::add(transaction_ptr tx, confirm_handler handler)
+void transaction_pool::add(transaction_ptr tx, uint64_t fee,
+                           confirm_handler handler)
 {
     // When a new tx is added to the buffer drop the oldest.
     if (maintain_consistency_ && buffer_.size() == buffer_.capacity())
         delete_package(error::pool_filled);
 
+    // Otherwise the full buffer overwrites its oldest entry.
+    if (buffer_.full())
+        unindex(buffer_.front().tx->hash());
+
+    const auto hash = tx->hash();
     buffer_.push_back({ tx, handler });
+    pool_size().set(buffer_.size());
+
+    uint64_t fee_rate;
+    if (fee_index_.add(*tx, fee) && fee_index_.fee_rate(fee_rate, hash))
+        fee_estimator_.track(hash, fee_rate);
 }
 
 // There has been a reorg, clear the memory pool using the given reason code.
@@ -540,11 +636,18 @@ void transaction_pool::clear(const code& ec)
         entry.handle_confirm(ec, entry.tx);
 
     buffer_.clear();
+    pool_size().set(0);
+    fee_index_.clear();
+    fee_estimator_.untrack_all();
 }
 
 // Delete memory pool txs that are obsoleted by a new block acceptance.
-void transaction_pool::remove(const block_list& blocks)
+void transaction_pool::remove(size_t fork_point, const block_list& blocks)
 {
+    // Confirmations feed the estimator before the transactions are deleted.
+    for (size_t index = 0; index < blocks.size(); ++index)
+        fee_estimator_.confirm(*blocks[index], fork_point + index + 1);
+
     // Delete by hash sets a success code.
     delete_confirmed_in_blocks(blocks);
 
@@ -659,6 +762,8 @@ bool transaction_pool::delete_single(const hash_digest& tx_hash, const code& ec)
 
     it->handle_confirm(ec, it->tx);
     buffer_.erase(it);
+    pool_size().set(buffer_.size());
+    unindex(tx_hash);
 
     if (ec) {
         log::debug(LOG_BLOCKCHAIN)
@@ -674,11 +779,20 @@ bool transaction_pool::delete_single(const hash_digest& tx_hash, const code& ec)
 
         it->handle_confirm(ec, it->tx);
         buffer_.erase(it);
+        pool_size().set(buffer_.size());
     }
 
     return true;
 }
 
+// Drop a transaction that left the buffer from the fee index and estimator,
+// a confirmed one has already been counted and is no longer tracked.
+void transaction_pool::unindex(const hash_digest& tx_hash)
+{
+    fee_index_.remove(tx_hash);
+    fee_estimator_.untrack(tx_hash);
+}
+
 bool transaction_pool::find(transaction_ptr& out_tx,
                             const hash_digest& tx_hash) const
 {
@@ -479,6 +479,7 @@ code validate_block::connect_block(hash_digest& err_tx, blockchain::block_chain_
 
         uint64_t value_in = 0;
         const auto& tx = transactions[tx_index];
+        const block_trace::span trace("connect_tx", tx_index);
 
         RETURN_IF_STOPPED();
 
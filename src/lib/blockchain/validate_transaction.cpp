@@ -1423,6 +1423,11 @@ code validate_transaction::check_transaction() const
     return ret;
 }
 
+uint64_t validate_transaction::get_value_in() const
+{
+    return value_in_;
+}
+
 uint64_t validate_transaction::get_height() const
 {
     uint64_t height = 0;
@@ -1713,11 +1718,163 @@ code validate_transaction::check_transaction_basic() const
 }
 
 // Validate script consensus conformance based on flags provided.
+// Strict DER encoding of an endorsement (signature plus sighash byte), as
+// enforced by the consensus interpreter once bip66 is active.
+static bool is_valid_signature_encoding(const endorsement& sig)
+{
+    // Format: 0x30 [total-length] 0x02 [R-length] [R] 0x02 [S-length] [S] [sighash]
+    if (sig.size() < 9 || sig.size() > 73)
+        return false;
+
+    if (sig[0] != 0x30 || sig[1] != sig.size() - 3)
+        return false;
+
+    const size_t size_r = sig[3];
+    if (5 + size_r >= sig.size())
+        return false;
+
+    const size_t size_s = sig[5 + size_r];
+    if (size_r + size_s + 7 != sig.size())
+        return false;
+
+    if (sig[2] != 0x02 || size_r == 0 || (sig[4] & 0x80) != 0)
+        return false;
+
+    if (size_r > 1 && sig[4] == 0x00 && (sig[5] & 0x80) == 0)
+        return false;
+
+    if (sig[size_r + 4] != 0x02 || size_s == 0 || (sig[size_r + 6] & 0x80) != 0)
+        return false;
+
+    if (size_s > 1 && sig[size_r + 6] == 0x00 && (sig[size_r + 7] & 0x80) == 0)
+        return false;
+
+    return true;
+}
+
+// Script numbers are at most four bytes, little endian, sign and magnitude.
+static bool decode_script_number(const data_chunk& data, int64_t& out)
+{
+    static constexpr size_t max_script_number_size = 4;
+    if (data.size() > max_script_number_size)
+        return false;
+
+    out = 0;
+    if (data.empty())
+        return true;
+
+    for (size_t index = 0; index < data.size(); ++index)
+        out |= static_cast<int64_t>(data[index]) << (8 * index);
+
+    if ((data.back() & 0x80) != 0)
+        out = -(out & ~(static_cast<int64_t>(0x80) << (8 * (data.size() - 1))));
+
+    return true;
+}
+
+static bool is_data_push(const operation& op)
+{
+    static constexpr size_t max_push_data_size = 520;
+    return (op.code == opcode::zero || op.code == opcode::special ||
+        op.code == opcode::pushdata1 || op.code == opcode::pushdata2 ||
+        op.code == opcode::pushdata4) && op.data.size() <= max_push_data_size;
+}
+
+bool validate_transaction::check_standard(const script& prevout_script,
+        const transaction& current_tx, uint64_t input_index, uint32_t flags,
+        bool& out_valid)
+{
+    BITCOIN_ASSERT(input_index < current_tx.inputs.size());
+    const auto& output_ops = prevout_script.operations;
+    const auto& input_ops = current_tx.inputs[input_index].script.operations;
+
+    const auto is_key_hash = operation::is_pay_key_hash_pattern(output_ops);
+    const auto is_lock_height = !is_key_hash &&
+        operation::is_pay_key_hash_with_lock_height_pattern(output_ops);
+
+    if (!is_key_hash && !is_lock_height)
+        return false;
+
+    // The input must be nothing but the pushes the template consumes.
+    const size_t pushes = is_key_hash ? 2 : 3;
+    if (input_ops.size() != pushes)
+        return false;
+
+    for (const auto& op: input_ops)
+        if (!is_data_push(op))
+            return false;
+
+    const auto& endorse = input_ops[0].data;
+    const auto& public_key = input_ops[1].data;
+
+    // Signature hashing deletes pushes of the signature from the script
+    // code, leave that corner to the interpreter.
+    for (const auto& op: output_ops)
+        if (!op.data.empty() && op.data == endorse)
+            return false;
+
+    out_valid = false;
+
+    if (is_lock_height)
+    {
+        int64_t expected;
+        int64_t provided;
+        if (!decode_script_number(output_ops[0].data, expected) ||
+            !decode_script_number(input_ops[2].data, provided) ||
+            expected != provided)
+            return true;
+    }
+
+    const auto& key_hash = output_ops[is_key_hash ? 2 : 4].data;
+    const auto hash = bitcoin_short_hash(public_key);
+    if (!std::equal(hash.begin(), hash.end(), key_hash.begin()))
+        return true;
+
+    // An empty signature is allowed by the encoding rules, but never valid.
+    if (endorse.empty())
+        return true;
+
+    const auto strict = (flags & script_context::bip66_enabled) != 0;
+    if (strict && !is_valid_signature_encoding(endorse))
+        return true;
+
+    ec_signature signature;
+    const der_signature distinguished(endorse.begin(), endorse.end() - 1);
+    if (!parse_signature(signature, distinguished, false))
+        return true;
+
+    const auto sighash = script::generate_signature_hash(current_tx,
+        static_cast<uint32_t>(input_index), prevout_script, endorse.back());
+
+    out_valid = verify_signature(public_key, sighash, signature);
+    return true;
+}
+
 bool validate_transaction::check_consensus(const script& prevout_script,
         const transaction& current_tx, uint64_t input_index, uint32_t flags)
 {
     BITCOIN_ASSERT(input_index <= max_uint32);
     BITCOIN_ASSERT(input_index < current_tx.inputs.size());
+
+    bool valid;
+    if (!check_standard(prevout_script, current_tx, input_index, flags, valid))
+        return check_interpreter(prevout_script, current_tx, input_index, flags);
+
+    if (!valid) {
+        log::warning(LOG_BLOCKCHAIN)
+                << "Invalid transaction ["
+                << encode_hash(current_tx.hash()) << "] standard input "
+                << input_index << " failed verification";
+    }
+
+    return valid;
+}
+
+bool validate_transaction::check_interpreter(const script& prevout_script,
+        const transaction& current_tx, uint64_t input_index, uint32_t flags)
+{
+    BITCOIN_ASSERT(input_index <= max_uint32);
+    BITCOIN_ASSERT(input_index < current_tx.inputs.size());
     const auto input_index32 = static_cast<uint32_t>(input_index);
 
 #ifdef WITH_CONSENSUS
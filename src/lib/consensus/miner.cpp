@@ -48,15 +48,13 @@ namespace consensus {
 static BC_CONSTEXPR uint32_t min_tx_fee     = 10000;
 
 // tuples: (priority, fee_per_kb, fee, transaction_ptr)
-typedef boost::tuple<double, double, uint64_t, miner::transaction_ptr> transaction_priority;
+typedef boost::tuple<double, double, uint64_t, miner::transaction_ptr, size_t> transaction_priority;
 
 namespace {
-// fee : per kb
-bool sort_by_fee_per_kb(const transaction_priority& a, const transaction_priority& b)
+// fee : the pool's ancestor package fee rate ranking, lowest rank first out
+bool sort_by_package_rank(const transaction_priority& a, const transaction_priority& b)
 {
-    if (a.get<1>() == b.get<1>())
-        return a.get<0>() < b.get<0>();
-    return a.get<1>() < b.get<1>();
+    return a.get<4>() > b.get<4>();
 };
 
 // priority : coin age
@@ -99,6 +97,7 @@ miner::miner(node::p2p_node& node)
     , accept_block_version_(chain::block_version_pow)
     , setting_(node_.chain_impl().chain_settings())
     , is_solo_mining_(false)
+    , template_height_(0)
 {
     if (setting_.use_testnet_rules) {
         HeaderAux::set_as_testnet();
@@ -110,51 +109,93 @@ miner::~miner()
     stop();
 }
 
-bool miner::get_input_etp(const chain::transaction& tx, const std::vector<transaction_ptr>& transactions,
-                          uint64_t& total_inputs, previous_out_map_t& previous_out_map) const
+bool miner::resolve_template_entry(template_entry& entry, const pool_map& pool) const
 {
-    total_inputs = 0;
     blockchain::block_chain_impl& block_chain = node_.chain_impl();
-    for (auto& input : tx.inputs) {
+    const auto& tx = *entry.tx;
+
+    uint64_t total_input_value = 0;
+    entry.inputs.clear();
+    entry.pool_parents.clear();
+    entry.script_hash_sigops = 0;
+    entry.script_hash_counted = true;
+
+    for (const auto& input : tx.inputs) {
+        const auto& previous_output = input.previous_output;
         chain::transaction prev_tx;
         uint64_t prev_height = 0;
-        uint64_t input_value = 0;
-        if (block_chain.get_transaction(prev_tx, prev_height, input.previous_output.hash)) {
-            input_value = prev_tx.outputs[input.previous_output.index].value;
-            previous_out_map[input.previous_output] =
-                std::make_pair(prev_height, prev_tx.outputs[input.previous_output.index]);
-        }
-        else {
-            const hash_digest& hash = input.previous_output.hash;
-            const auto found = [&hash](const transaction_ptr & entry)
-            {
-                return entry->hash() == hash;
-            };
-            auto it = std::find_if(transactions.begin(), transactions.end(), found);
-            if (it != transactions.end()) {
-                input_value = (*it)->outputs[input.previous_output.index].value;
-                previous_out_map[input.previous_output] =
-                    std::make_pair(max_uint64, (*it)->outputs[input.previous_output.index]);
-            }
-            else {
+        transaction_ptr parent;
+
+        if (!block_chain.get_transaction(prev_tx, prev_height, previous_output.hash)) {
+            const auto it = pool.find(previous_output.hash);
+            if (it == pool.end()) {
 #ifdef MVS_DEBUG
-                log::debug(LOG_HEADER) << "previous transaction not ready: " << encode_hash(hash);
+                log::debug(LOG_HEADER) << "previous transaction not ready: "
+                    << encode_hash(previous_output.hash);
 #endif
                 return false;
             }
+
+            parent = it->second;
+            prev_height = max_uint64;
+            entry.pool_parents.push_back(previous_output.hash);
+        }
+
+        const auto& outputs = parent ? parent->outputs : prev_tx.outputs;
+        if (previous_output.index >= outputs.size()) {
+            return false;
         }
 
-        total_inputs += input_value;
+        const auto& prev_output = outputs[previous_output.index];
+        total_input_value += prev_output.value;
+        entry.inputs.emplace_back(prev_height, prev_output.value);
+
+        uint64_t count = 0;
+        if (entry.script_hash_counted) {
+            entry.script_hash_counted = blockchain::validate_block::script_hash_signature_operations_count(
+                count, prev_output.script, input.script);
+            if (entry.script_hash_counted) {
+                entry.script_hash_sigops += count;
+            }
+        }
     }
 
+    entry.fee = total_input_value - tx.total_output_value();
+    entry.size = tx.serialized_size(0);
+    entry.block_size = tx.serialized_size(1);
+    entry.sigops = tx.legacy_sigops_count();
+    entry.lock_height_output = std::any_of(tx.outputs.begin(), tx.outputs.end(),
+        [](const chain::output& output) {
+            return chain::operation::is_pay_key_hash_with_lock_height_pattern(
+                output.script.operations);
+        });
+
     return true;
 }
 
-bool miner::get_transaction(
-    uint64_t last_height,
-    std::vector<transaction_ptr>& transactions,
-    previous_out_map_t& previous_out_map, tx_fee_map_t& tx_fee_map) const
+bool miner::check_template_spends(const template_entry& entry) const
 {
+    if (setting_.transaction_pool_consistency) {
+        return true;
+    }
+
+    // check double spending
+    for (const auto& input : entry.tx->inputs) {
+        if (node_.chain_impl().get_spends_output(input.previous_output)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Bring the template in step with the pool and the chain. Only transactions
+// new to the pool are resolved against the chain, the rest are kept as long
+// as they and their pool parents stay in the pool.
+void miner::update_template(uint64_t last_height)
+{
+    std::vector<transaction_ptr> transactions;
+
     boost::mutex mutex;
     mutex.lock();
     auto f = [&transactions, &mutex](const code&, const std::vector<transaction_ptr>& transactions_) -> void
@@ -162,125 +203,103 @@ bool miner::get_transaction(
         transactions = transactions_;
         mutex.unlock();
     };
-    node_.pool().fetch(f);
+    node_.pool().fetch_by_fee_rate(0, f);
 
     boost::unique_lock<boost::mutex> lock(mutex);
 
-    if (transactions.empty() == false) {
-        std::set<hash_digest> sets;
-        for (auto i = transactions.begin(); i != transactions.end(); ) {
-            auto& tx = **i;
-            auto hash = tx.hash();
+    // The pool ranks by ancestor package fee rate with parents first.
+    pool_map pool;
+    std::unordered_map<hash_digest, size_t> ranks;
+    for (size_t rank = 0; rank < transactions.size(); ++rank) {
+        const auto hash = transactions[rank]->hash();
+        pool.emplace(hash, transactions[rank]);
+        ranks.emplace(hash, rank);
+    }
 
-            if (sets.count(hash)) {
-                // already exist, keep unique
-                i = transactions.erase(i);
-                continue;
-            }
+    // A lower height is a reorganization, confirmed heights may be stale.
+    if (last_height < template_height_) {
+        template_.clear();
+    }
 
-            uint64_t total_input_value = 0;
-            bool ready = get_input_etp(tx, transactions, total_input_value, previous_out_map);
-            if (!ready) {
-                // erase tx but not delete it from pool if parent tx is not ready
-                i = transactions.erase(i);
-                continue;
-            }
+    const auto height_changed = last_height != template_height_;
+    const auto filter_lock_height = last_height + 1 >= pos_enabled_height;
+    template_height_ = last_height;
 
-            uint64_t total_output_value = tx.total_output_value();
-            uint64_t fee = total_input_value - total_output_value;
+    const auto in_pool = [&pool](const hash_digest& hash) {
+        return pool.count(hash) != 0;
+    };
 
-            // check fees
-            if (fee < min_tx_fee || !blockchain::validate_transaction::check_special_fees(setting_.use_testnet_rules, tx, fee)) {
-#ifdef MVS_DEBUG
-                log::debug(LOG_HEADER) << "check fees failed, delete_tx " << encode_hash(hash);
-#endif
-                i = transactions.erase(i);
-                // delete it from pool if not enough fee
-                node_.pool().delete_tx(hash);
-                continue;
-            }
+    for (auto it = template_.begin(); it != template_.end(); ) {
+        const auto& entry = it->second;
 
-            if (!setting_.transaction_pool_consistency) {
-                auto transaction_is_ok = true;
-                // check double spending
-                for (const auto& input : tx.inputs) {
-                    if (node_.chain_impl().get_spends_output(input.previous_output)) {
+        // A pool parent that left the pool was either confirmed or dropped,
+        // and a confirmed parent back in the pool was reorganized out.
+        auto stale = !in_pool(it->first)
+            || !std::all_of(entry.pool_parents.begin(), entry.pool_parents.end(), in_pool);
+
+        for (size_t index = 0; !stale && index < entry.inputs.size(); ++index) {
+            stale = entry.inputs[index].first != max_uint64
+                && in_pool(entry.tx->inputs[index].previous_output.hash);
+        }
+
+        if (stale) {
+            it = template_.erase(it);
+            continue;
+        }
+
+        if ((height_changed && !check_template_spends(entry))
+            || (filter_lock_height && entry.lock_height_output)) {
 #ifdef MVS_DEBUG
-                        log::debug(LOG_HEADER) << "check double spending failed, delete_tx " << encode_hash(hash);
+            log::debug(LOG_HEADER) << "template entry no longer valid, delete_tx " << encode_hash(it->first);
 #endif
-                        i = transactions.erase(i);
-                        node_.pool().delete_tx(hash);
-                        transaction_is_ok = false;
-                        break;
-                    }
-                }
+            node_.pool().delete_tx(it->first);
+            it = template_.erase(it);
+            continue;
+        }
 
-                if (!transaction_is_ok) {
-                    continue;
-                }
-            }
+        ++it;
+    }
 
-            // filter deposit tx after pos_enabled_height
-            if (last_height + 1 >= pos_enabled_height) {
-                auto transaction_is_ok = true;
-                for (const auto& output : tx.outputs) {
-                    if (chain::operation::is_pay_key_hash_with_lock_height_pattern(output.script.operations)) {
-                        i = transactions.erase(i);
-                        node_.pool().delete_tx(hash);
-                        transaction_is_ok = false;
-                        break;
-                    }
-                }
+    for (const auto& item : pool) {
+        const auto& hash = item.first;
+        if (template_.count(hash)) {
+            continue;
+        }
 
-                if (!transaction_is_ok) {
-                    continue;
-                }
-            }
+        template_entry entry;
+        entry.tx = item.second;
 
-            tx_fee_map[hash] = fee;
-            sets.insert(hash);
-            ++i;
+        if (!resolve_template_entry(entry, pool)) {
+            // erase tx but not delete it from pool if parent tx is not ready
+            continue;
         }
-    }
-    return transactions.empty() == false;
-}
 
-bool miner::script_hash_signature_operations_count(uint64_t &count, const chain::input& input, std::vector<transaction_ptr>& transactions)
-{
-    const auto& previous_output = input.previous_output;
-    chain::transaction previous_tx;
-    boost::uint64_t h;
-    if (node_.chain_impl().get_transaction(previous_tx, h, previous_output.hash) == false) {
-        bool found = false;
-        for (auto& tx : transactions) {
-            if (previous_output.hash == tx->hash()) {
-                previous_tx = *tx;
-                found = true;
-                break;
-            }
+        // check fees
+        if (entry.fee < min_tx_fee || !blockchain::validate_transaction::check_special_fees(
+                setting_.use_testnet_rules, *entry.tx, entry.fee)) {
+#ifdef MVS_DEBUG
+            log::debug(LOG_HEADER) << "check fees failed, delete_tx " << encode_hash(hash);
+#endif
+            // delete it from pool if not enough fee
+            node_.pool().delete_tx(hash);
+            continue;
         }
 
-        if (found == false)
-            return false;
-    }
+        // filter deposit tx after pos_enabled_height
+        if (!check_template_spends(entry) || (filter_lock_height && entry.lock_height_output)) {
+#ifdef MVS_DEBUG
+            log::debug(LOG_HEADER) << "check double spending failed, delete_tx " << encode_hash(hash);
+#endif
+            node_.pool().delete_tx(hash);
+            continue;
+        }
 
-    const auto& previous_tx_out = previous_tx.outputs[previous_output.index];
-    return blockchain::validate_block::script_hash_signature_operations_count(
-        count, previous_tx_out.script, input.script);
-}
+        template_.emplace(hash, std::move(entry));
+    }
 
-bool miner::script_hash_signature_operations_count(
-    uint64_t &count, const chain::input::list& inputs, std::vector<transaction_ptr>& transactions)
-{
-    count = 0;
-    for (const auto& input : inputs)
-    {
-        uint64_t c = 0;
-        if (script_hash_signature_operations_count(c, input, transactions) == false)
-            return false;
-        count += c;
+    for (auto& item : template_) {
+        item.second.rank = ranks.at(item.first);
     }
-    return true;
 }
 
 miner::block_ptr miner::create_genesis_block(bool is_mainnet)
@@ -531,14 +550,19 @@ bool miner::get_block_transactions(
     blockchain::block_chain_impl& block_chain = node_.chain_impl();
     uint64_t current_height = last_height + 1;
 
-    std::vector<transaction_ptr> transactions;
     std::vector<transaction_priority> transaction_prioritys;
     std::map<hash_digest, transaction_dependent> transaction_dependents;
-    previous_out_map_t previous_out_map;
-    tx_fee_map_t tx_fee_map;
 
-    if (!witness::is_begin_of_epoch(current_height)) {
-        get_transaction(last_height, transactions, previous_out_map, tx_fee_map);
+    // The template stays locked while its entries are read below.
+    boost::unique_lock<boost::mutex> template_lock(template_mutex_);
+
+    // No pool transactions go into the first block of an epoch.
+    const template_map none;
+    const auto begin_of_epoch = witness::is_begin_of_epoch(current_height);
+    const auto& candidates = begin_of_epoch ? none : template_;
+
+    if (!begin_of_epoch) {
+        update_template(last_height);
     }
 
     // Largest block you're willing to create:
@@ -557,27 +581,27 @@ bool miner::get_block_transactions(
     block_min_size = std::min(block_max_size, block_min_size);
 
     uint32_t block_size = 0;
-    for (auto tx : transactions)
+    for (const auto& item : candidates)
     {
-        auto tx_hash = tx->hash();
+        const auto& tx_hash = item.first;
+        const auto& entry = item.second;
         double priority = 0;
-        for (const auto& input : tx->inputs)
+        for (size_t index = 0; index < entry.inputs.size(); ++index)
         {
-            auto prev_pair = previous_out_map[input.previous_output];
-            uint64_t prev_height = prev_pair.first;
-            const auto& prev_output = prev_pair.second;
+            uint64_t prev_height = entry.inputs[index].first;
 
             if (prev_height != max_uint64) {
-                uint64_t input_value = prev_output.value;
+                uint64_t input_value = entry.inputs[index].second;
                 priority += (double)input_value * (last_height - prev_height + 1);
             }
             else {
-                transaction_dependents[input.previous_output.hash].hash = std::make_shared<hash_digest>(tx_hash);
+                const auto& parent = entry.tx->inputs[index].previous_output.hash;
+                transaction_dependents[parent].hash = std::make_shared<hash_digest>(tx_hash);
                 transaction_dependents[tx_hash].dpendens++;
             }
         }
 
-        uint64_t serialized_size = tx->serialized_size(0);
+        uint64_t serialized_size = entry.size;
 
         // Priority is sum(valuein * age) / txsize
         priority /= serialized_size;
@@ -585,12 +609,12 @@ bool miner::get_block_transactions(
         // This is a more accurate fee-per-kilobyte than is used by the client code, because the
         // client code rounds up the size to the nearest 1K. That's good, because it gives an
         // incentive to create smaller transactions.
-        auto tx_fee = tx_fee_map[tx_hash];
+        auto tx_fee = entry.fee;
         double fee_per_kb = double(tx_fee) / (double(serialized_size) / 1000.0);
-        transaction_prioritys.push_back(transaction_priority(priority, fee_per_kb, tx_fee, tx));
+        transaction_prioritys.push_back(transaction_priority(priority, fee_per_kb, tx_fee, entry.tx, entry.rank));
     }
 
-    auto sort_func = sort_by_fee_per_kb;
+    auto sort_func = sort_by_package_rank;
     bool is_resort = false;
     make_heap(transaction_prioritys.begin(), transaction_prioritys.end(), sort_func);
 
@@ -618,6 +642,7 @@ bool miner::get_block_transactions(
         }
 
         hash_digest h = ptx->hash();
+        const auto& entry = template_.at(h);
         if (transaction_dependents[h].dpendens != 0) {
             transaction_dependents[h].transaction = temp_priority;
             transaction_dependents[h].is_need_process = true;
@@ -625,7 +650,7 @@ bool miner::get_block_transactions(
         }
 
         // Size limits
-        uint64_t serialized_size = ptx->serialized_size(1);
+        uint64_t serialized_size = entry.block_size;
 
         // add coinage reward coinbase
         std::vector<transaction_ptr> coinage_reward_coinbases;
@@ -653,7 +678,7 @@ bool miner::get_block_transactions(
             continue;
 
         // Legacy limits on sigOps:
-        uint32_t tx_sig_length = get_tx_sign_length(ptx);
+        uint32_t tx_sig_length = entry.sigops;
         if (total_tx_sig_length + tx_sig_length >= blockchain::max_block_script_sigops)
             continue;
 
@@ -671,8 +696,8 @@ bool miner::get_block_transactions(
             make_heap(transaction_prioritys.begin(), transaction_prioritys.end(), sort_func);
         }
 
-        uint64_t c;
-        if (!miner::script_hash_signature_operations_count(c, ptx->inputs, transactions)
+        uint64_t c = entry.script_hash_sigops;
+        if (!entry.script_hash_counted
                 && total_tx_sig_length + tx_sig_length + c >= blockchain::max_block_script_sigops)
             continue;
         tx_sig_length += c;
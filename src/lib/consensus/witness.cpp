@@ -398,21 +398,13 @@ std::shared_ptr<std::vector<std::string>> witness::get_inactive_witnesses(uint64
     auto start = epoch_height + vote_maturity;
     auto end = epoch_height + epoch_cycle_height - vote_maturity;
     uint32_t total_vote = 0;
-    for (auto h = start; h < end; ++h) {
-        ec_compressed public_key(null_compressed_point);
-        node_.chain_impl().fetch_block_public_key(h,
-            [&public_key](const code& ec, const ec_compressed& pubkey) {
-                if (ec) {
-                    return;
-                }
-                public_key = pubkey;
-            });
-
-        if (!is_public_key(public_key)) {
+    const auto signers = node_.chain_impl().get_witness_signers(start, end);
+    for (const auto& signer : signers) {
+        if (!signer.is_dpos() || !is_public_key(signer.public_key)) {
             continue;
         }
 
-        auto address = witness_to_address(to_chunk(encode_base16(public_key)));
+        auto address = witness_to_address(to_chunk(encode_base16(signer.public_key)));
 
         if (votes.find(address) != votes.end()) {
             votes[address] += 1;
@@ -547,6 +539,7 @@ bool witness::init_witness_list()
 
     auto& chain = node_.chain_impl();
     chain.set_sync_disabled(true);
+    unique_lock organize_lock(chain.get_organize_mutex());
     unique_lock lock(chain.get_mutex());
 
     uint64_t height = 0;
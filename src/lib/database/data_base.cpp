@@ -22,15 +22,21 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <functional>
 #include <memory>
 #include <stdexcept>
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
 #include <boost/filesystem.hpp>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/bitcoin/utility/path.hpp>
 #include <metaverse/bitcoin/config/base16.hpp>  // used by db_metadata and push_attachment
 #include <metaverse/database/memory/memory_map.hpp>
 #include <metaverse/database/settings.hpp>
+#include <metaverse/database/snapshot.hpp>
 #include <metaverse/database/version.hpp>
 
 namespace libbitcoin {
@@ -171,6 +177,24 @@ bool data_base::initialize_witness_profiles(const path& prefix)
     return instance.stop();
 }
 
+bool data_base::initialize_witness_signers(const path& prefix)
+{
+    const store paths(prefix);
+    if (paths.witness_signers_exist())
+        return true;
+    if (!paths.touch_witness_signers())
+        return false;
+
+    data_base instance(prefix, 0, 0);
+    if (!instance.create_witness_signers())
+        return false;
+
+    log::info(LOG_DATABASE)
+        << "Upgrading witness signer table is complete.";
+
+    return instance.stop();
+}
+
 bool data_base::upgrade_version_63(const path& prefix)
 {
     auto metadata_path = prefix / db_metadata::file_name;
@@ -243,6 +267,178 @@ bool data_base::upgrade_version_64(const path& prefix)
     return true;
 }
 
+bool data_base::upgrade_version_65(const path& prefix)
+{
+    auto metadata_path = prefix / db_metadata::file_name;
+    if (!boost::filesystem::exists(metadata_path))
+        return false;
+
+    data_base::db_metadata metadata;
+    data_base::read_metadata(metadata_path, metadata);
+    if (metadata.version_.empty()) {
+        return false; // no version before, initialize all instead of upgrade.
+    }
+
+    if (!initialize_witness_signers(prefix)) {
+        log::error(LOG_DATABASE)
+            << "Failed to upgrade witness signer database.";
+        return false;
+    }
+
+    if (metadata.version_ != db_metadata::current_version) {
+        // write new db version to metadata
+        metadata = db_metadata(db_metadata::current_version);
+        data_base::write_metadata(metadata_path, metadata);
+    }
+
+    return true;
+}
+
+// Move the fixed size rows file aside and convert it into the rows and payload
+// files. The fixed rows file is removed only once the conversion is complete,
+// so an interrupted upgrade is restarted from it on the next run.
+template <typename Database>
+static bool upgrade_fixed_rows(const path& lookup_filename,
+    const path& rows_filename, const path& payload_filename)
+{
+    const path fixed_rows_filename = rows_filename.string() + ".fixed";
+    const auto upgrading = boost::filesystem::exists(fixed_rows_filename);
+    if (!upgrading && (boost::filesystem::exists(payload_filename) ||
+        !boost::filesystem::exists(rows_filename)))
+        return true;
+
+    if (!upgrading)
+        boost::filesystem::rename(rows_filename, fixed_rows_filename);
+
+    if (!data_base::touch_file(rows_filename) ||
+        !data_base::touch_file(payload_filename))
+        return false;
+
+    Database database(lookup_filename, rows_filename, payload_filename);
+    if (!database.upgrade_rows(fixed_rows_filename) ||
+        !database.close())
+        return false;
+
+    log::info(LOG_DATABASE)
+        << "Upgrading " << rows_filename.filename() << " is complete.";
+
+    return boost::filesystem::remove(fixed_rows_filename);
+}
+
+bool data_base::upgrade_version_66(const path& prefix)
+{
+    auto metadata_path = prefix / db_metadata::file_name;
+    if (!boost::filesystem::exists(metadata_path))
+        return false;
+
+    data_base::db_metadata metadata;
+    data_base::read_metadata(metadata_path, metadata);
+    if (metadata.version_.empty()) {
+        return false; // no version before, initialize all instead of upgrade.
+    }
+
+    const store paths(prefix);
+
+    if (!upgrade_fixed_rows<address_asset_database>(paths.address_assets_lookup,
+        paths.address_assets_rows, paths.address_assets_payload)) {
+        log::error(LOG_DATABASE)
+            << "Failed to upgrade address asset database.";
+        return false;
+    }
+
+    if (!upgrade_fixed_rows<account_asset_database>(paths.account_assets_lookup,
+        paths.account_assets_rows, paths.account_assets_payload)) {
+        log::error(LOG_DATABASE)
+            << "Failed to upgrade account asset database.";
+        return false;
+    }
+
+    if (!upgrade_fixed_rows<address_did_database>(paths.address_dids_lookup,
+        paths.address_dids_rows, paths.address_dids_payload)) {
+        log::error(LOG_DATABASE)
+            << "Failed to upgrade address did database.";
+        return false;
+    }
+
+    if (metadata.version_ != db_metadata::current_version) {
+        // write new db version to metadata
+        metadata = db_metadata(db_metadata::current_version);
+        data_base::write_metadata(metadata_path, metadata);
+    }
+
+    return true;
+}
+
+bool data_base::import_snapshot(const path& file, const path& prefix,
+    const config::checkpoint::list& checkpoints)
+{
+    snapshot::info state;
+    if (!snapshot::read(file, prefix, state))
+        return false;
+
+    if (state.version != MVS_DATABASE_VERSION)
+    {
+        log::error(LOG_DATABASE)
+            << "Snapshot database version " << state.version
+            << " does not match " << MVS_DATABASE_VERSION << ".";
+        return false;
+    }
+
+    // Local account tables are not part of a snapshot.
+    const store paths(prefix);
+    if (!touch_file(paths.accounts_lookup) ||
+        !touch_file(paths.account_assets_lookup) ||
+        !touch_file(paths.account_assets_rows) ||
+        !touch_file(paths.account_assets_payload) ||
+        !touch_file(paths.account_addresses_lookup) ||
+        !touch_file(paths.account_addresses_rows))
+        return false;
+
+    data_base instance(prefix, 0, 0);
+    if (!instance.accounts.create() ||
+        !instance.account_assets.create() ||
+        !instance.account_addresses.create() ||
+        !instance.blocks.start())
+        return false;
+
+    // A block result holds the map, it must be released before the stop.
+    const auto block_hash = [&instance](size_t height)
+    {
+        const auto result = instance.blocks.get(height);
+        return result ? result.header().hash() : null_hash;
+    };
+
+    size_t top;
+    if (!instance.blocks.top(top) || top != state.height ||
+        block_hash(state.height) != state.block_hash)
+    {
+        log::error(LOG_DATABASE)
+            << "Snapshot block at height " << state.height
+            << " does not match the archive.";
+        return false;
+    }
+
+    for (const auto& checkpoint: checkpoints)
+    {
+        if (checkpoint.height() > state.height)
+            continue;
+
+        if (block_hash(checkpoint.height()) != checkpoint.hash())
+        {
+            log::error(LOG_DATABASE)
+                << "Snapshot block does not match checkpoint "
+                << checkpoint.to_string() << ".";
+            return false;
+        }
+    }
+
+    log::info(LOG_DATABASE)
+        << "Imported snapshot at height " << state.height << " ("
+        << encode_hash(state.block_hash) << ").";
+
+    return instance.stop();
+}
+
 void data_base::set_admin(const std::string& name, const std::string& passwd)
 {
     accounts.set_admin(name, passwd);
@@ -279,11 +475,14 @@ data_base::store::store(const path& prefix)
     witness_certs_lookup = prefix / "witness_cert_table";   // for blockchain witness certs
     address_assets_lookup = prefix / "address_asset_table"; // for blockchain
     address_assets_rows = prefix / "address_asset_row"; // for blockchain
+    address_assets_payload = prefix / "address_asset_payload"; // for blockchain
     account_assets_lookup = prefix / "account_asset_table";
     account_assets_rows = prefix / "account_asset_row";
+    account_assets_payload = prefix / "account_asset_payload";
     dids_lookup = prefix / "did_table";
     address_dids_lookup = prefix / "address_did_table"; // for blockchain
     address_dids_rows = prefix / "address_did_row"; // for blockchain
+    address_dids_payload = prefix / "address_did_payload"; // for blockchain
     account_addresses_lookup = prefix / "account_address_table";
     account_addresses_rows = prefix / "account_address_rows";
     /* end database for account, asset, address_asset relationship */
@@ -296,6 +495,10 @@ data_base::store::store(const path& prefix)
 
     // Height-based (reverse) lookup.
     blocks_index = prefix / "block_index";
+    witness_signers_index = prefix / "witness_signer_index";   // for dpos block signers
+
+    // Height of the last block pruned.
+    pruned_height = prefix / "pruned_height";
 
     // One (address) to many (rows).
     history_rows = prefix / "history_rows";
@@ -323,11 +526,14 @@ bool data_base::store::touch_all() const
         touch_file(witness_certs_lookup) &&
         touch_file(address_assets_lookup) &&
         touch_file(address_assets_rows) &&
+        touch_file(address_assets_payload) &&
         touch_file(account_assets_lookup) &&
         touch_file(account_assets_rows) &&
+        touch_file(account_assets_payload) &&
         touch_file(dids_lookup) &&
         touch_file(address_dids_lookup) &&
         touch_file(address_dids_rows) &&
+        touch_file(address_dids_payload) &&
         touch_file(account_addresses_lookup) &&
         touch_file(account_addresses_rows) &&
         /* end database for account, asset, address_asset relationship */
@@ -336,7 +542,8 @@ bool data_base::store::touch_all() const
         touch_file(address_mits_rows) &&
         touch_file(mit_history_lookup) &&
         touch_file(mit_history_rows) &&
-        touch_file(witness_profiles_lookup);
+        touch_file(witness_profiles_lookup) &&
+        touch_file(witness_signers_index);
 }
 
 bool data_base::store::dids_exist() const
@@ -352,7 +559,8 @@ bool data_base::store::touch_dids() const
     return
         touch_file(dids_lookup) &&
         touch_file(address_dids_lookup) &&
-        touch_file(address_dids_rows);
+        touch_file(address_dids_rows) &&
+        touch_file(address_dids_payload);
 }
 
 bool data_base::store::certs_exist() const
@@ -405,6 +613,16 @@ bool data_base::store::touch_witness_profiles() const
     return touch_file(witness_profiles_lookup);
 }
 
+bool data_base::store::witness_signers_exist() const
+{
+    return boost::filesystem::exists(witness_signers_index);
+}
+
+bool data_base::store::touch_witness_signers() const
+{
+    return touch_file(witness_signers_index);
+}
+
 data_base::db_metadata::db_metadata():version_("")
 {
 }
@@ -528,23 +746,33 @@ void data_base::uninitialize_lock(const path& lock)
     boost::filesystem::remove(lock);
 }
 
+// Two mainnet witness epoch cycles.
+const size_t data_base::minimum_prune_depth = 20000;
+
+const asio::duration data_base::reclaim_delay = std::chrono::minutes(10);
+
+// A configured depth is raised to the minimum.
 data_base::data_base(const settings& settings)
   : data_base(settings.directory, settings.history_start_height,
-        settings.stealth_start_height)
+        settings.stealth_start_height, settings.prune_depth == 0 ? 0 :
+            std::max<size_t>(settings.prune_depth, minimum_prune_depth))
 {
 }
 
 data_base::data_base(const path& prefix, size_t history_height,
-    size_t stealth_height)
-  : data_base(store(prefix), history_height, stealth_height)
+    size_t stealth_height, size_t prune_depth)
+  : data_base(store(prefix), history_height, stealth_height, prune_depth)
 {
 }
 
 data_base::data_base(const store& paths, size_t history_height,
-    size_t stealth_height)
+    size_t stealth_height, size_t prune_depth)
   : lock_file_path_(paths.database_lock),
+    pruned_height_path_(paths.pruned_height),
     history_height_(history_height),
     stealth_height_(stealth_height),
+    prune_depth_(prune_depth),
+    pruned_height_(0),
     sequential_lock_(0),
     mutex_(std::make_shared<shared_mutex>()),
     blocks(paths.blocks_lookup, paths.blocks_index, mutex_),
@@ -555,18 +783,22 @@ data_base::data_base(const store& paths, size_t history_height,
     /* begin database for account, asset, address_asset, did relationship */
     accounts(paths.accounts_lookup, mutex_),
     assets(paths.assets_lookup, mutex_),
-    address_assets(paths.address_assets_lookup, paths.address_assets_rows, mutex_),
-    account_assets(paths.account_assets_lookup, paths.account_assets_rows, mutex_),
+    address_assets(paths.address_assets_lookup, paths.address_assets_rows,
+        paths.address_assets_payload, mutex_),
+    account_assets(paths.account_assets_lookup, paths.account_assets_rows,
+        paths.account_assets_payload, mutex_),
     certs(paths.certs_lookup, mutex_),
     witness_certs(paths.witness_certs_lookup, mutex_),
     dids(paths.dids_lookup, mutex_),
-    address_dids(paths.address_dids_lookup, paths.address_dids_rows, mutex_),
+    address_dids(paths.address_dids_lookup, paths.address_dids_rows,
+        paths.address_dids_payload, mutex_),
     account_addresses(paths.account_addresses_lookup, paths.account_addresses_rows, mutex_),
     /* end database for account, asset, address_asset, did relationship */
     mits(paths.mits_lookup, mutex_),
     address_mits(paths.address_mits_lookup, paths.address_mits_rows, mutex_),
     mit_history(paths.mit_history_lookup, paths.mit_history_rows, mutex_),
-    witness_profiles(paths.witness_profiles_lookup, mutex_)
+    witness_profiles(paths.witness_profiles_lookup, mutex_),
+    witness_signers(paths.witness_signers_index, mutex_)
 {
 }
 
@@ -628,7 +860,8 @@ bool data_base::create()
         mits.create() &&
         address_mits.create() &&
         mit_history.create() &&
-        witness_profiles.create()
+        witness_profiles.create() &&
+        witness_signers.create()
         ;
 }
 
@@ -665,6 +898,90 @@ bool data_base::create_witness_profiles()
         witness_profiles.create();
 }
 
+bool data_base::create_witness_signers()
+{
+    if (!witness_signers.create() || !blocks.start())
+        return false;
+
+    // Index the signers of blocks that are already in the chain.
+    size_t top;
+    if (!blocks.top(top))
+        return true;
+
+    for (size_t height = 0; height <= top; ++height)
+    {
+        const auto result = blocks.get(height);
+        if (!result)
+            continue;
+
+        const auto header = result.header();
+        const auto public_key = header.is_proof_of_dpos() ?
+            result.public_key() : null_compressed_point;
+        witness_signers.store(header, public_key, height);
+    }
+
+    witness_signers.sync();
+    return true;
+}
+
+bool data_base::export_snapshot(const path& file)
+{
+    size_t height;
+    if (!blocks.top(height))
+        return false;
+
+    hash_digest block_hash;
+    {
+        // The result holds the map, release it before the copy.
+        const auto result = blocks.get(height);
+        if (!result)
+            return false;
+
+        block_hash = result.header().hash();
+    }
+
+    const auto prefix = lock_file_path_.parent_path();
+    const store paths(prefix);
+    const std::vector<path> excluded
+    {
+        paths.database_lock,
+        paths.accounts_lookup,
+        paths.account_assets_lookup,
+        paths.account_assets_rows,
+        paths.account_assets_payload,
+        paths.account_addresses_lookup,
+        paths.account_addresses_rows
+    };
+
+    std::vector<std::string> names;
+    for (directory_iterator it(prefix), end; it != end; ++it)
+    {
+        const auto& entry = it->path();
+        if (!is_regular_file(entry) || entry.extension() == ".fixed" ||
+            std::find(excluded.begin(), excluded.end(), entry) != excluded.end())
+            continue;
+
+        names.push_back(entry.filename().string());
+    }
+
+    std::sort(names.begin(), names.end());
+    const snapshot::info state
+    {
+        MVS_DATABASE_VERSION, height, block_hash
+    };
+
+    // The caller holds writers off, readers go on during the copy.
+    synchronize();
+    if (!snapshot::write(file, prefix, names, state))
+        return false;
+
+    log::info(LOG_DATABASE)
+        << "Exported snapshot at height " << height << " ("
+        << encode_hash(state.block_hash) << ") to " << file;
+
+    return true;
+}
+
 // Start must be called before performing queries.
 // Start may be called after stop and/or after close in order to restart.
 bool data_base::start()
@@ -704,10 +1021,17 @@ bool data_base::start()
         mits.start() &&
         address_mits.start() &&
         mit_history.start() &&
-        witness_profiles.start()
+        witness_profiles.start() &&
+        witness_signers.start()
         ;
     const auto end_exclusive = end_write();
 
+    // The height pruned up to by a previous run, if any.
+    size_t pruned_height = 0;
+    bc::ifstream file(pruned_height_path_.string());
+    if (file >> pruned_height)
+        pruned_height_ = pruned_height;
+
     // Return the result of the database start.
     return start_exclusive && start_result && end_exclusive;
 }
@@ -736,6 +1060,7 @@ bool data_base::stop()
     const auto address_mits_stop = address_mits.stop();
     const auto mit_history_stop = mit_history.stop();
     const auto witness_profiles_stop = witness_profiles.stop();
+    const auto witness_signers_stop = witness_signers.stop();
     const auto end_exclusive = end_write();
 
     // This should remove the lock file. This is not important for locking
@@ -766,6 +1091,7 @@ bool data_base::stop()
         address_mits_stop &&
         mit_history_stop &&
         witness_profiles_stop &&
+        witness_signers_stop &&
         end_exclusive;
 }
 
@@ -792,6 +1118,7 @@ bool data_base::close()
     const auto address_mits_close = address_mits.close();
     const auto mit_history_close = mit_history.close();
     const auto witness_profiles_close = witness_profiles.close();
+    const auto witness_signers_close = witness_signers.close();
 
     // Return the cumulative result of the database closes.
     return
@@ -814,7 +1141,8 @@ bool data_base::close()
         mits_close &&
         address_mits_close &&
         mit_history_close &&
-        witness_profiles_close
+        witness_profiles_close &&
+        witness_signers_close
         ;
 }
 
@@ -826,6 +1154,22 @@ handle data_base::begin_read()
     return sequential_lock_.load();
 }
 
+handle data_base::wait_read()
+{
+    auto value = sequential_lock_.load();
+    if (!is_write_locked(value))
+        return value;
+
+    std::unique_lock<std::mutex> lock(write_mutex_);
+    write_ended_.wait(lock, [this, &value]()
+    {
+        value = sequential_lock_.load();
+        return !is_write_locked(value);
+    });
+
+    return value;
+}
+
 bool data_base::is_read_valid(handle value)
 {
     return value == sequential_lock_.load();
@@ -848,8 +1192,19 @@ bool data_base::begin_write()
 // TODO: clear the write sentinel.
 bool data_base::end_write()
 {
-    // slock_ is now even again.
-    return !is_write_locked(++sequential_lock_);
+    handle value;
+
+    // Change the lock under the mutex so a reader cannot miss the wakeup
+    // between its check and its wait.
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+
+        // slock_ is now even again.
+        value = ++sequential_lock_;
+    }
+
+    write_ended_.notify_all();
+    return !is_write_locked(value);
 }
 
 // Query engines.
@@ -891,6 +1246,7 @@ void data_base::synchronize()
     mit_history.sync();
     blocks.sync();
     witness_profiles.sync();
+    witness_signers.sync();
 }
 
 void data_base::synchronize_dids()
@@ -921,6 +1277,11 @@ void data_base::synchronize_witness_profiles()
     witness_profiles.sync();
 }
 
+void data_base::synchronize_witness_signers()
+{
+    witness_signers.sync();
+}
+
 void data_base::push(const block& block)
 {
     // Height is unsafe unless database locked.
@@ -929,6 +1290,14 @@ void data_base::push(const block& block)
 
 void data_base::push(const block& block, uint64_t height)
 {
+    static auto& push_seconds = metrics::instance().make_histogram(
+        "mvs_database_push_seconds", "Time to store a block and its indexes.");
+    static auto& top_height = metrics::instance().make_gauge(
+        "mvs_database_height", "Height of the top stored block.");
+
+    const metrics::stopwatch timer(push_seconds);
+    top_height.set(height);
+
     for (size_t index = 0; index < block.transactions.size(); ++index)
     {
         // Skip BIP30 allowed duplicates (coinbase txs of excepted blocks).
@@ -938,30 +1307,181 @@ void data_base::push(const block& block, uint64_t height)
 
         const auto& tx = block.transactions[index];
         const auto tx_hash = tx.hash();
+        const block_trace::span trace("store_tx", index);
 
         timestamp_ = block.header.timestamp; // for address_asset_database store_input/store_output used only
 
         // Add inputs
         if (!tx.is_coinbase())
+        {
+            const block_trace::span span("inputs");
             push_inputs(tx_hash, height, tx.inputs);
+        }
 
         // Add outputs
-        push_outputs(tx_hash, height, tx.outputs);
+        {
+            const block_trace::span span("outputs");
+            push_outputs(tx_hash, height, tx.outputs);
+        }
 
         // Add stealth outputs
-        push_stealth(tx_hash, height, tx.outputs);
+        {
+            const block_trace::span span("stealth");
+            push_stealth(tx_hash, height, tx.outputs);
+        }
 
         // Add transaction
+        const block_trace::span span("transactions");
         transactions.store(height, index, tx);
     }
 
     // Add block itself.
-    blocks.store(block, height);
+    {
+        const block_trace::span span("blocks");
+        blocks.store(block, height);
+    }
+
+    // Add block signer (slot number and public key of dpos blocks).
+    {
+        const block_trace::span span("witness_signers");
+        witness_signers.store(block, height);
+    }
 
     // Synchronise everything that was added.
+    const block_trace::span span("synchronize");
     synchronize();
 }
 
+// The key of address_asset, address_did and address_mit rows.
+static short_hash address_key(const std::string& encoded)
+{
+    return ripemd160_hash(data_chunk(encoded.begin(), encoded.end()));
+}
+
+// Blocks are pruned in height order and the height of the last one is kept
+// in a file of the store. The space of the pruned rows is punched out of the
+// files by a call at least reclaim_delay later, however often prune runs.
+bool data_base::prune(size_t count)
+{
+    const auto before = asio::steady_clock::now() - reclaim_delay;
+    const auto reclaimed =
+        transactions.reclaim(before) +
+        spends.reclaim(before) +
+        history.reclaim(before) +
+        address_assets.reclaim(before);
+
+    if (reclaimed != 0)
+        log::debug(LOG_DATABASE)
+            << "Reclaimed " << reclaimed << " bytes of pruned data.";
+
+    size_t top;
+    if (prune_depth_ == 0 || !blocks.top(top) || top <= prune_depth_)
+        return false;
+
+    const auto target = top - prune_depth_;
+    auto height = pruned_height_.load();
+    if (height >= target)
+        return false;
+
+    const auto end = std::min(target, height + count);
+    while (height < end)
+        prune_block(++height);
+
+    synchronize();
+    write_pruned_height(height);
+    pruned_height_ = height;
+    return height < target;
+}
+
+size_t data_base::pruned_height() const
+{
+    return pruned_height_;
+}
+
+size_t data_base::prune_depth() const
+{
+    return prune_depth_;
+}
+
+void data_base::write_pruned_height(size_t height)
+{
+    bc::ofstream file(pruned_height_path_.string(), std::ios::trunc);
+    file << height << std::endl;
+}
+
+// Spends of the block are buried beyond any reorganization, drop them from
+// the history with the outputs they spend, and drop the transactions of which
+// all outputs are spent at or below height. Unspent outputs are kept.
+void data_base::prune_block(size_t height)
+{
+    const auto block_result = blocks.get(height);
+    if (!block_result)
+        return;
+
+    const auto count = block_result.transaction_count();
+    for (size_t index = 0; index < count; ++index)
+    {
+        const auto tx_hash = block_result.transaction_hash(index);
+        const auto tx_result = transactions.get(tx_hash);
+        if (!tx_result)
+            continue;
+
+        const auto tx = tx_result.transaction();
+        if (!tx.is_coinbase())
+        {
+            for (uint32_t input_index = 0; input_index < tx.inputs.size();
+                ++input_index)
+            {
+                const auto& input = tx.inputs[input_index];
+                const chain::input_point point{ tx_hash, input_index };
+
+                if (height >= history_height_)
+                {
+                    const auto address = payment_address::extract(input.script);
+                    if (address)
+                    {
+                        history.prune_spend(address.hash(), point,
+                            input.previous_output);
+                        address_assets.prune_spend(
+                            address_key(address.encoded()), point,
+                            input.previous_output);
+                    }
+                }
+
+                prune_transaction(input.previous_output.hash, height);
+            }
+        }
+
+        prune_transaction(tx_hash, height);
+    }
+}
+
+bool data_base::prune_transaction(const hash_digest& tx_hash, size_t height)
+{
+    const auto tx_result = transactions.get(tx_hash);
+    if (!tx_result || tx_result.height() > height)
+        return false;
+
+    const auto tx = tx_result.transaction();
+    for (uint32_t index = 0; index < tx.outputs.size(); ++index)
+    {
+        const auto spend = spends.get({ tx_hash, index });
+        if (!spend.valid)
+            return false;
+
+        // A missing spender has been pruned, so it is below height.
+        const auto spender = transactions.get(spend.hash);
+        if (spender && spender.height() > height)
+            return false;
+    }
+
+    for (uint32_t index = 0; index < tx.outputs.size(); ++index)
+        spends.prune({ tx_hash, index });
+
+    transactions.prune(tx_hash);
+    return true;
+}
+
 void data_base::push_inputs(const hash_digest& tx_hash, size_t height,
     const input::list& inputs)
 {
@@ -1055,20 +1575,17 @@ void data_base::push_stealth(const hash_digest& tx_hash, size_t height,
     }
 }
 
-bool data_base::pop(chain::block& block)
+bool data_base::read_block(chain::block& block, size_t height) const
 {
-    size_t height;
-    auto result = blocks.top(height);
-    BITCOIN_ASSERT_MSG(result, "Pop on empty database.");
-    if (!result) {
+    const auto block_result = blocks.get(height);
+    if (!block_result)
         return false;
-    }
 
-    const auto block_result = blocks.get(height);
     const auto count = block_result.transaction_count();
 
     // Build the block for return.
     block.header = block_result.header();
+    block.transactions.clear();
     block.transactions.reserve(count);
     auto& txs = block.transactions;
 
@@ -1091,148 +1608,361 @@ bool data_base::pop(chain::block& block)
         txs.emplace_back(tx_result.transaction());
     }
 
-    // Loop txs backwards, the reverse of how they are added.
-    // Remove txs, then outputs, then inputs (also reverse order).
-    for (auto tx = txs.rbegin(); tx != txs.rend(); ++tx)
+    return true;
+}
+
+bool data_base::pop(chain::block& block)
+{
+    size_t height;
+    auto result = blocks.top(height);
+    BITCOIN_ASSERT_MSG(result, "Pop on empty database.");
+    if (!result) {
+        return false;
+    }
+
+    block::list popped;
+    if (!pop_from(popped, height))
+        return false;
+
+    block = std::move(popped.front());
+    return true;
+}
+
+// Visit transactions in the reverse of the order they were pushed.
+template <typename Visitor>
+static void reverse_transactions(const block::list& blocks, size_t top,
+    Visitor visit)
+{
+    for (size_t index = 0; index < blocks.size(); ++index)
+    {
+        const auto& txs = blocks[index].transactions;
+        for (auto tx = txs.rbegin(); tx != txs.rend(); ++tx)
+            visit(*tx, top - index);
+    }
+}
+
+static hash_digest symbol_key(const std::string& symbol)
+{
+    return sha256_hash(data_chunk(symbol.begin(), symbol.end()));
+}
+
+// Run the parts on the pool and wait for all of them. The calling thread
+// takes parts too, so it completes them itself if it is one of the pool's
+// own threads and the others are busy. The first exception thrown by a part
+// is rethrown once every part has finished.
+static void run_parallel(threadpool& pool,
+    const std::vector<std::function<void()>>& parts)
+{
+    struct progress
+    {
+        std::atomic<size_t> next;
+        size_t count;
+        size_t finished;
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::condition_variable done;
+    };
+
+    const auto state = std::make_shared<progress>();
+    state->next = 0;
+    state->count = parts.size();
+    state->finished = 0;
+
+    // Parts are only read while unfinished, so while this frame is waiting.
+    const auto work = [state, &parts]()
+    {
+        for (auto index = state->next++; index < state->count;
+            index = state->next++)
+        {
+            std::exception_ptr error;
+
+            try
+            {
+                parts[index]();
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(state->mutex);
+
+            if (error && !state->error)
+                state->error = error;
+
+            if (++state->finished == state->count)
+                state->done.notify_all();
+        }
+    };
+
+    for (size_t helper = 1; helper < parts.size(); ++helper)
+        pool.service().post(work);
+
+    work();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->done.wait(lock, [&state]
     {
-        transactions.remove(tx->hash());
-        pop_outputs(tx->outputs, height);
+        return state->finished == state->count;
+    });
+
+    if (state->error)
+        std::rethrow_exception(state->error);
+}
 
-        if (!tx->is_coinbase())
-            pop_inputs(tx->inputs, height);
+bool data_base::pop_from(chain::block::list& out_blocks, size_t height,
+    threadpool* pool)
+{
+    size_t top;
+    if (!blocks.top(top) || height > top)
+        return false;
+
+    // Read the whole range first, an inconsistent store fails before
+    // anything is rolled back.
+    block::list popped(top - height + 1);
+    for (size_t index = 0; index < popped.size(); ++index)
+        if (!read_block(popped[index], top - index))
+            return false;
+
+    // Each database is rolled back in the reverse order of its pushes, the
+    // databases are independent of each other and roll back in parallel.
+    const std::vector<std::function<void()>> rollbacks
+    {
+        [&] { pop_transactions(popped, top); },
+        [&] { pop_spends(popped, top); },
+        [&] { pop_history(popped, top); },
+        [&] { pop_address_assets(popped, top); },
+        [&] { pop_assets(popped, top); },
+        [&] { pop_dids(popped, top); },
+        [&] { pop_certs(popped, top); },
+        [&] { pop_mits(popped, top); }
+    };
+
+    // A single block is not worth the handoff.
+    if (pool == nullptr || popped.size() == 1)
+    {
+        for (const auto& rollback : rollbacks)
+            rollback();
+    }
+    else
+    {
+        run_parallel(*pool, rollbacks);
     }
 
     // Stealth unlink is not implemented.
     stealth.unlink(height);
     blocks.unlink(height);
-    blocks.remove(block.header.hash()); // wdy remove block from block hash table
+    witness_signers.unlink(height);
+
+    for (const auto& block : popped)
+        blocks.remove(block.header.hash()); // wdy remove block from block hash table
 
-    // Synchronise everything that was changed.
+    static auto& popped_blocks = metrics::instance().make_counter(
+        "mvs_database_pops_total", "Blocks removed by reorganization.");
+    static auto& top_height = metrics::instance().make_gauge(
+        "mvs_database_height", "Height of the top stored block.");
+
+    popped_blocks.increment(popped.size());
+    top_height.set(height == 0 ? 0 : height - 1);
+
+    // Synchronise everything that was changed, once for the whole range.
     synchronize();
 
+    out_blocks = std::move(popped);
     return true;
 }
 
-void data_base::pop_inputs(const input::list& inputs, size_t height)
+void data_base::pop_transactions(const block::list& popped, size_t top)
 {
-    // Loop in reverse.
-    for (auto input = inputs.rbegin(); input != inputs.rend(); ++input)
+    reverse_transactions(popped, top, [this](const transaction& tx, size_t)
     {
-        spends.remove(input->previous_output);
+        transactions.remove(tx.hash());
+    });
+}
 
+void data_base::pop_spends(const block::list& popped, size_t top)
+{
+    reverse_transactions(popped, top, [this](const transaction& tx, size_t)
+    {
+        if (tx.is_coinbase())
+            return;
+
+        for (auto input = tx.inputs.rbegin(); input != tx.inputs.rend(); ++input)
+            spends.remove(input->previous_output);
+    });
+}
+
+void data_base::pop_history(const block::list& popped, size_t top)
+{
+    reverse_transactions(popped, top, [this](const transaction& tx,
+        size_t height)
+    {
         if (height < history_height_)
-            continue;
+            return;
 
-        // Try to extract an address.
-        const auto address = payment_address::extract(input->script);
-
-        if (address) {
-            history.delete_last_row(address.hash());
-            // delete address asset record
-            auto address_str = address.encoded();
-            data_chunk data(address_str.begin(), address_str.end());
-            short_hash hash = ripemd160_hash(data);
-            address_assets.delete_last_row(hash);
+        for (auto output = tx.outputs.rbegin(); output != tx.outputs.rend(); ++output)
+        {
+            const auto address = payment_address::extract(output->script);
+            if (address)
+                history.delete_last_row(address.hash());
         }
-    }
+
+        if (tx.is_coinbase())
+            return;
+
+        for (auto input = tx.inputs.rbegin(); input != tx.inputs.rend(); ++input)
+        {
+            const auto address = payment_address::extract(input->script);
+            if (address)
+                history.delete_last_row(address.hash());
+        }
+    });
 }
 
-void data_base::pop_outputs(const output::list& outputs, size_t height)
+void data_base::pop_address_assets(const block::list& popped, size_t top)
 {
-    if (height < history_height_)
-        return;
-
-    // Loop in reverse.
-    for (auto output = outputs.rbegin(); output != outputs.rend(); ++output)
+    reverse_transactions(popped, top, [this](const transaction& tx,
+        size_t height)
     {
-        // Try to extract an address.
-        const auto address = payment_address::extract(output->script);
-
-        if (address) {
-            history.delete_last_row(address.hash());
-            // delete address asset record
-            auto address_str = address.encoded();
-            data_chunk data(address_str.begin(), address_str.end());
-            short_hash hash = ripemd160_hash(data);
-            bc::chain::output op = *output;
+        if (height < history_height_)
+            return;
+
+        for (auto output = tx.outputs.rbegin(); output != tx.outputs.rend(); ++output)
+        {
             // NOTICE: pop only the pushed row, at present did and mit is
             // not stored in address_asset, but stored separately
             // in address_did and address_did
-            if (!op.is_did() && !op.is_asset_mit()) {
-                address_assets.delete_last_row(hash);
-            }
-            // remove asset or did from database
-            if (op.is_asset_issue() || op.is_asset_secondaryissue()) {
-                auto symbol = op.get_asset_symbol();
-                const data_chunk& symbol_data = data_chunk(symbol.begin(), symbol.end());
-                const auto symbol_hash = sha256_hash(symbol_data);
-                assets.remove(symbol_hash);
-            }
-            else if (op.is_did()) {
-                auto symbol = op.get_did_symbol();
-                const data_chunk& symbol_data = data_chunk(symbol.begin(), symbol.end());
-                const auto symbol_hash = sha256_hash(symbol_data);
+            const auto address = payment_address::extract(output->script);
+            if (address && !output->is_did() && !output->is_asset_mit())
+                address_assets.delete_last_row(address_key(address.encoded()));
+        }
 
-                if(op.is_did_register())
-                {
-                    address_dids.delete_last_row(hash);
-                    address_dids.sync();
-                    dids.remove(symbol_hash);
-                    dids.sync();
-                }
-                else if(op.is_did_transfer() )
-                {
-                    std::shared_ptr<blockchain_did> blockchain_did_=  dids.pop_did_transfer(symbol_hash);
-                    dids.sync();
+        if (tx.is_coinbase())
+            return;
 
-                    if(blockchain_did_)
-                    {
-                        auto old_address = blockchain_did_->get_did().get_address();
-                        data_chunk data_old(old_address.begin(), old_address.end());
-                        short_hash old_hash = ripemd160_hash(data_old);
+        for (auto input = tx.inputs.rbegin(); input != tx.inputs.rend(); ++input)
+        {
+            const auto address = payment_address::extract(input->script);
+            if (address)
+                address_assets.delete_last_row(address_key(address.encoded()));
+        }
+    });
+}
 
-                        address_dids.delete_last_row(old_hash);
-                        address_dids.delete_last_row(hash);
+void data_base::pop_assets(const block::list& popped, size_t top)
+{
+    reverse_transactions(popped, top, [this](const transaction& tx,
+        size_t height)
+    {
+        if (height < history_height_)
+            return;
 
-                        address_dids.store_output(old_hash, blockchain_did_->get_tx_point(), blockchain_did_->get_height(), 0,
-                            static_cast<typename std::underlying_type<business_kind>::type>(business_kind::did_register),
-                            timestamp_, blockchain_did_->get_did());
-                        address_dids.sync();
+        for (auto output = tx.outputs.rbegin(); output != tx.outputs.rend(); ++output)
+        {
+            if (!payment_address::extract(output->script))
+                continue;
 
-                    }
-                }
+            if (output->is_asset_issue() || output->is_asset_secondaryissue())
+                assets.remove(symbol_key(output->get_asset_symbol()));
+        }
+    });
+}
+
+void data_base::pop_dids(const block::list& popped, size_t top)
+{
+    reverse_transactions(popped, top, [this](const transaction& tx,
+        size_t height)
+    {
+        if (height < history_height_)
+            return;
+
+        for (auto output = tx.outputs.rbegin(); output != tx.outputs.rend(); ++output)
+        {
+            const auto address = payment_address::extract(output->script);
+            if (!address || !output->is_did())
+                continue;
+
+            const auto hash = address_key(address.encoded());
+            const auto symbol_hash = symbol_key(output->get_did_symbol());
 
+            if (output->is_did_register())
+            {
+                address_dids.delete_last_row(hash);
+                dids.remove(symbol_hash);
             }
-            else if (op.is_asset_cert()) {
-                const auto asset_cert = op.get_asset_cert();
-                if (asset_cert.is_newly_generated()) {
-                    const auto key_str = asset_cert.get_key();
-                    const data_chunk& data = data_chunk(key_str.begin(), key_str.end());
-                    const auto key_hash = sha256_hash(data);
-                    certs.remove(key_hash);
-
-                    if (asset_cert.get_type() == asset_cert_ns::witness) {
-                        witness_certs.remove(key_hash);
-                    }
-                }
+            else if (output->is_did_transfer())
+            {
+                const auto blockchain_did_ = dids.pop_did_transfer(symbol_hash);
+                if (!blockchain_did_)
+                    continue;
+
+                // Restore the row of the address the did was transferred from.
+                const auto old_hash = address_key(
+                    blockchain_did_->get_did().get_address());
+
+                address_dids.delete_last_row(old_hash);
+                address_dids.delete_last_row(hash);
+
+                address_dids.store_output(old_hash, blockchain_did_->get_tx_point(), blockchain_did_->get_height(), 0,
+                    static_cast<typename std::underlying_type<business_kind>::type>(business_kind::did_register),
+                    timestamp_, blockchain_did_->get_did());
             }
-            else if (op.is_asset_mit()) {
-                address_mits.delete_last_row(hash);
+        }
+    });
+}
+
+void data_base::pop_certs(const block::list& popped, size_t top)
+{
+    reverse_transactions(popped, top, [this](const transaction& tx,
+        size_t height)
+    {
+        if (height < history_height_)
+            return;
+
+        for (auto output = tx.outputs.rbegin(); output != tx.outputs.rend(); ++output)
+        {
+            if (!output->is_asset_cert() ||
+                !payment_address::extract(output->script))
+                continue;
 
-                const auto mit = op.get_asset_mit();
-                auto symbol = mit.get_symbol();
-                const data_chunk& symbol_data = data_chunk(symbol.begin(), symbol.end());
+            const auto asset_cert = output->get_asset_cert();
+            if (!asset_cert.is_newly_generated())
+                continue;
 
-                const auto symbol_short_hash = ripemd160_hash(symbol_data);
-                mit_history.delete_last_row(symbol_short_hash);
+            const auto key_hash = symbol_key(asset_cert.get_key());
+            certs.remove(key_hash);
 
-                if (mit.is_register_status()) {
-                    const auto symbol_hash = sha256_hash(symbol_data);
-                    mits.remove(symbol_hash);
-                }
-            }
+            if (asset_cert.get_type() == asset_cert_ns::witness)
+                witness_certs.remove(key_hash);
         }
-    }
+    });
+}
+
+void data_base::pop_mits(const block::list& popped, size_t top)
+{
+    reverse_transactions(popped, top, [this](const transaction& tx,
+        size_t height)
+    {
+        if (height < history_height_)
+            return;
+
+        for (auto output = tx.outputs.rbegin(); output != tx.outputs.rend(); ++output)
+        {
+            const auto address = payment_address::extract(output->script);
+            if (!address || !output->is_asset_mit())
+                continue;
+
+            address_mits.delete_last_row(address_key(address.encoded()));
+
+            const auto mit = output->get_asset_mit();
+            const auto symbol = mit.get_symbol();
+            const data_chunk symbol_data(symbol.begin(), symbol.end());
+            mit_history.delete_last_row(ripemd160_hash(symbol_data));
+
+            if (mit.is_register_status())
+                mits.remove(sha256_hash(symbol_data));
+        }
+    });
 }
 
 /* begin store asset related info into database */
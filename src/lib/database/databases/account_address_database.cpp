@@ -20,9 +20,12 @@
 #include <metaverse/database/databases/account_address_database.hpp>
 #include <metaverse/bitcoin/chain/attachment/account/account_address.hpp>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstddef>
 #include <memory>
+#include <string>
+#include <vector>
 #include <boost/filesystem.hpp>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/database/memory/memory.hpp>
@@ -85,6 +88,9 @@ bool account_address_database::create()
         !rows_manager_.create())
         return false;
 
+    index_.clear();
+    owners_.clear();
+
     // Should not call start after create, already started.
     return
         lookup_header_.start() &&
@@ -97,12 +103,17 @@ bool account_address_database::create()
 
 bool account_address_database::start()
 {
-    return
+    const auto started =
         lookup_file_.start() &&
         rows_file_.start() &&
         lookup_header_.start() &&
         lookup_manager_.start() &&
         rows_manager_.start();
+
+    if (started)
+        load_index();
+
+    return started;
 }
 
 bool account_address_database::stop()
@@ -119,43 +130,118 @@ bool account_address_database::close()
         rows_file_.close();
 }
 
+// Index.
 // ----------------------------------------------------------------------------
 
-void account_address_database::store(const short_hash& key, const account_address& address)
+account_address account_address_database::read_row(array_index row) const
 {
-    const auto address_data = address.to_data();
+    // This obtains a remap safe address pointer against the rows file.
+    const auto record = rows_list_.get(row);
+    const auto address = REMAP_ADDRESS(record);
+    auto deserial = make_deserializer_unsafe(address);
+    return account_address::factory_from_data(deserial);
+}
 
-    const auto check_store = [this, &key, &address, &address_data]() {
-        auto address_vec = get(key);
-        auto pos = std::find_if(address_vec.begin(), address_vec.end(),
-                [&address](const account_address& elem){
-                    return (elem.get_address() == address.get_address());
-                });
+// Rows of a key are read newest first, the newest row of an address wins.
+void account_address_database::load_index()
+{
+    unique_lock lock(index_mutex_);
+    index_.clear();
+    owners_.clear();
 
-        if (pos == address_vec.end()) { // new item
-            return true;
+    for (size_t bucket = 0; bucket < lookup_header_.size(); ++bucket)
+    {
+        const auto starts = rows_multimap_.lookup(static_cast<array_index>(bucket));
+        for (const auto start: *starts)
+        {
+            for (const auto row: record_multimap_iterable(rows_list_, start))
+            {
+                const auto address = read_row(row);
+                const auto& name = address.get_name();
+                const auto key = ripemd160_hash(data_chunk(name.begin(), name.end()));
+
+                if (index_[key].count(address.get_address()) == 0)
+                    index_row(key, address, row);
+            }
         }
+    }
+}
 
-        if (pos->to_data() == address_data) {
-            // don't store duplicate data
-            return false;
-        }
+// The caller must hold index_mutex_ exclusively.
+void account_address_database::index_row(const short_hash& key,
+    const account_address& address, array_index row)
+{
+    index_[key][address.get_address()] = row;
 
-        // remove old record
-        delete_last_row(key);
-        sync();
-        return true;
+    auto& owners = owners_[address.get_address()];
+    if (std::find(owners.begin(), owners.end(), address.get_name()) == owners.end())
+        owners.push_back(address.get_name());
+}
+
+// The caller must hold index_mutex_ exclusively.
+void account_address_database::unindex_row(const short_hash& key,
+    const std::string& address, array_index row)
+{
+    const auto rows = index_.find(key);
+    if (rows == index_.end())
+        return;
+
+    const auto it = rows->second.find(address);
+    if (it == rows->second.end() || it->second != row)
+        return;
+
+    rows->second.erase(it);
+    if (rows->second.empty())
+        index_.erase(rows);
+
+    // Rows of one key all belong to one account.
+    const auto owners = owners_.find(address);
+    if (owners == owners_.end())
+        return;
+
+    const auto name = read_row(row).get_name();
+    auto& names = owners->second;
+    names.erase(std::remove(names.begin(), names.end(), name), names.end());
+    if (names.empty())
+        owners_.erase(owners);
+}
+
+// ----------------------------------------------------------------------------
+
+void account_address_database::store(const short_hash& key, const account_address& address)
+{
+    const auto address_data = address.to_data();
+
+    auto write = [&address_data](memory_ptr data)
+    {
+        auto serial = make_serializer(REMAP_ADDRESS(data));
+        serial.write_data(address_data);
     };
 
-    if (check_store()) {
-        // actually store address
-        auto write = [&address_data](memory_ptr data)
+    unique_lock lock(index_mutex_);
+
+    const auto rows = index_.find(key);
+    if (rows != index_.end())
+    {
+        const auto it = rows->second.find(address.get_address());
+        if (it != rows->second.end())
         {
-            auto serial = make_serializer(REMAP_ADDRESS(data));
-            serial.write_data(address_data);
-        };
-        rows_multimap_.add_row(key, write);
+            const auto record = rows_list_.get(it->second);
+            const auto memory = REMAP_ADDRESS(record);
+
+            // don't store duplicate data
+            if (std::equal(address_data.begin(), address_data.end(), memory))
+                return;
+
+            // Rows are fixed size, the changed address replaces its own row.
+            write(record);
+            return;
+        }
     }
+
+    // actually store address
+    rows_multimap_.add_row(key, write);
+    index_row(key, address, rows_multimap_.lookup(key));
 }
 
 void account_address_database::safe_store(const short_hash& key, const account_address& address)
@@ -166,12 +252,44 @@ void account_address_database::safe_store(const short_hash& key, const account_a
         auto serial = make_serializer(REMAP_ADDRESS(data));
         serial.write_data(address.to_data());
     };
+
+    unique_lock lock(index_mutex_);
     rows_multimap_.add_row(key, write);
+    index_row(key, address, rows_multimap_.lookup(key));
 }
 
 void account_address_database::delete_last_row(const short_hash& key)
 {
+    unique_lock lock(index_mutex_);
+
+    const auto row = rows_multimap_.lookup(key);
+    if (row == rows_list_.empty)
+        return;
+
+    const auto popped = read_row(row).get_address();
+    unindex_row(key, popped, row);
     rows_multimap_.delete_last_row(key);
+
+    // safe_store may have left an older row of the same address.
+    const auto start = rows_multimap_.lookup(key);
+    for (const auto older: record_multimap_iterable(rows_list_, start))
+    {
+        const auto address = read_row(older);
+        if (address.get_address() == popped)
+        {
+            index_row(key, address, older);
+            break;
+        }
+    }
+}
+
+std::vector<std::string> account_address_database::get_address_owners(
+    const std::string& address) const
+{
+    shared_lock lock(index_mutex_);
+
+    const auto it = owners_.find(address);
+    return it == owners_.end() ? std::vector<std::string>{} : it->second;
 }
 
 account_address::list account_address_database::get(const short_hash& key) const
@@ -202,19 +320,19 @@ account_address::list account_address_database::get(const short_hash& key) const
 
 std::shared_ptr<account_address> account_address_database::get(const short_hash& key, const std::string& address) const
 {
-    std::shared_ptr<account_address> addr(nullptr);
-    account_address::list result = get(key);
-    for (auto element: result)
-    {
-        if(element.get_address() == address)
-        {
-            addr = std::make_shared<account_address>(element);
-            break;
-        }
-    }
+    shared_lock lock(index_mutex_);
 
-    return addr;
+    const auto rows = index_.find(key);
+    if (rows == index_.end())
+        return nullptr;
+
+    const auto it = rows->second.find(address);
+    if (it == rows->second.end())
+        return nullptr;
+
+    return std::make_shared<account_address>(read_row(it->second));
 }
+
 void account_address_database::sync()
 {
     lookup_manager_.sync();
@@ -26,6 +26,7 @@
 #include <boost/filesystem.hpp>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/database/memory/memory.hpp>
+#include <metaverse/database/primitives/fixed_rows.hpp>
 #include <metaverse/database/primitives/record_multimap_iterable.hpp>
 #include <metaverse/database/primitives/record_multimap_iterator.hpp>
 
@@ -41,12 +42,21 @@ BC_CONSTEXPR size_t initial_lookup_file_size = header_size + minimum_records_siz
 
 BC_CONSTEXPR size_t record_size = hash_table_multimap_record_size<short_hash>();
 
-BC_CONSTEXPR size_t asset_transfer_record_size = 1 + 36 + 4 + 8 + 2 + ASSET_DETAIL_FIX_SIZE; // ASSET_DETAIL_FIX_SIZE is the biggest one
-//      + std::max({ETP_FIX_SIZE, ASSET_DETAIL_FIX_SIZE, ASSET_TRANSFER_FIX_SIZE});
-BC_CONSTEXPR size_t row_record_size = hash_table_record_size<short_hash>(asset_transfer_record_size);
+// Row format:
+//  [ payload:8      ] (position of the asset detail in the payload file)
+// Payload format:
+//  [ asset_detail   ] (variable size)
+BC_CONSTEXPR size_t row_size = 8;
+BC_CONSTEXPR size_t row_record_size = record_list_offset + row_size;
+
+// Rows of database version 0.6.5 and before were padded to the biggest
+// asset detail, only used to upgrade existing rows files.
+BC_CONSTEXPR size_t fixed_row_size = 1 + 36 + 4 + 8 + 2 + ASSET_DETAIL_FIX_SIZE;
+BC_CONSTEXPR size_t fixed_row_record_size = hash_table_record_size<short_hash>(fixed_row_size);
 
 account_asset_database::account_asset_database(const path& lookup_filename,
-    const path& rows_filename, std::shared_ptr<shared_mutex> mutex)
+    const path& rows_filename, const path& payload_filename,
+    std::shared_ptr<shared_mutex> mutex)
     : lookup_file_(lookup_filename, mutex),
     lookup_header_(lookup_file_, number_buckets),
     lookup_manager_(lookup_file_, header_size, record_size),
@@ -54,7 +64,9 @@ account_asset_database::account_asset_database(const path& lookup_filename,
     rows_file_(rows_filename, mutex),
     rows_manager_(rows_file_, 0, row_record_size),
     rows_list_(rows_manager_),
-    rows_multimap_(lookup_map_, rows_list_)
+    rows_multimap_(lookup_map_, rows_list_),
+    payload_file_(payload_filename, mutex),
+    payload_manager_(payload_file_, 0)
 {
 }
 
@@ -72,23 +84,27 @@ bool account_asset_database::create()
 {
     // Resize and create require a started file.
     if (!lookup_file_.start() ||
-        !rows_file_.start())
+        !rows_file_.start() ||
+        !payload_file_.start())
         return false;
 
     // These will throw if insufficient disk space.
     lookup_file_.resize(initial_lookup_file_size);
     rows_file_.resize(minimum_records_size);
+    payload_file_.resize(minimum_slabs_size);
 
     if (!lookup_header_.create() ||
         !lookup_manager_.create() ||
-        !rows_manager_.create())
+        !rows_manager_.create() ||
+        !payload_manager_.create())
         return false;
 
     // Should not call start after create, already started.
     return
         lookup_header_.start() &&
         lookup_manager_.start() &&
-        rows_manager_.start();
+        rows_manager_.start() &&
+        payload_manager_.start();
 }
 
 // Startup and shutdown.
@@ -99,23 +115,27 @@ bool account_asset_database::start()
     return
         lookup_file_.start() &&
         rows_file_.start() &&
+        payload_file_.start() &&
         lookup_header_.start() &&
         lookup_manager_.start() &&
-        rows_manager_.start();
+        rows_manager_.start() &&
+        payload_manager_.start();
 }
 
 bool account_asset_database::stop()
 {
     return
         lookup_file_.stop() &&
-        rows_file_.stop();
+        rows_file_.stop() &&
+        payload_file_.stop();
 }
 
 bool account_asset_database::close()
 {
     return
         lookup_file_.close() &&
-        rows_file_.close();
+        rows_file_.close() &&
+        payload_file_.close();
 }
 
 // ----------------------------------------------------------------------------
@@ -148,10 +168,15 @@ void account_asset_database::store(const short_hash& key, const asset_detail& de
 
     if (check_store()) {
         // actually store asset
-        auto write = [&detail_data](memory_ptr data)
+        const auto payload = payload_manager_.new_slab(detail_data.size());
+        const auto memory = payload_manager_.get(payload);
+        auto payload_serial = make_serializer(REMAP_ADDRESS(memory));
+        payload_serial.write_data(detail_data);
+
+        auto write = [payload](memory_ptr data)
         {
             auto serial = make_serializer(REMAP_ADDRESS(data));
-            serial.write_data(detail_data);
+            serial.write_8_bytes_little_endian(payload);
         };
         rows_multimap_.add_row(key, write);
     }
@@ -159,18 +184,77 @@ void account_asset_database::store(const short_hash& key, const asset_detail& de
 
 void account_asset_database::delete_last_row(const short_hash& key)
 {
+    const auto start = rows_multimap_.lookup(key);
+    if (start == record_list::empty)
+        return;
+
+    file_offset payload;
+    size_t size;
+    {
+        // This obtains a remap safe address pointer against the rows file.
+        const auto record = rows_list_.get(start);
+        payload = from_little_endian_unsafe<file_offset>(REMAP_ADDRESS(record));
+
+        const auto memory = payload_manager_.get(payload);
+        const auto begin = REMAP_ADDRESS(memory);
+        auto deserial = make_deserializer_unsafe(begin);
+        asset_detail::factory_from_data(deserial);
+        size = static_cast<size_t>(deserial.iterator() - begin);
+    }
+
     rows_multimap_.delete_last_row(key);
+
+    // A replaced detail is normally the last slab, its space is reused.
+    payload_manager_.release_slab(payload, size);
 }
 
-asset_detail::list account_asset_database::get(const short_hash& key) const
+// Read a row and its asset detail from the payload file.
+asset_detail account_asset_database::read_row(uint8_t* data) const
+{
+    auto deserial = make_deserializer_unsafe(data);
+    const auto payload = deserial.read_8_bytes_little_endian();
+    const auto memory = payload_manager_.get(payload);
+    auto payload_deserial = make_deserializer_unsafe(REMAP_ADDRESS(memory));
+    return asset_detail::factory_from_data(payload_deserial);
+}
+
+// Convert the fixed size rows of an existing database, see convert_fixed_rows.
+bool account_asset_database::upgrade_rows(const path& fixed_rows_filename)
 {
-    // Read a row from the data for the account_asset list.
-    const auto read_row = [](uint8_t* data)
+    // The lookup table is kept, rows and payload files are created.
+    if (!lookup_file_.start() ||
+        !rows_file_.start() ||
+        !payload_file_.start())
+        return false;
+
+    // These will throw if insufficient disk space.
+    rows_file_.resize(minimum_records_size);
+    payload_file_.resize(minimum_slabs_size);
+
+    if (!lookup_header_.start() ||
+        !lookup_manager_.start() ||
+        !rows_manager_.create() ||
+        !payload_manager_.create() ||
+        !rows_manager_.start() ||
+        !payload_manager_.start())
+        return false;
+
+    // The asset detail moves to the payload file.
+    const auto serialize = [](deserializer<uint8_t*, false>& deserial)
     {
-        auto deserial = make_deserializer_unsafe(data);
-        return asset_detail::factory_from_data(deserial);
+        return asset_detail::factory_from_data(deserial).to_data();
     };
 
+    if (!convert_fixed_rows(fixed_rows_filename, fixed_row_record_size,
+        0, rows_manager_, payload_manager_, serialize))
+        return false;
+
+    sync();
+    return true;
+}
+
+asset_detail::list account_asset_database::get(const short_hash& key) const
+{
     asset_detail::list result;
     const auto start = rows_multimap_.lookup(key);
     const auto records = record_multimap_iterable(rows_list_, start);
@@ -230,6 +314,7 @@ void account_asset_database::sync()
 {
     lookup_manager_.sync();
     rows_manager_.sync();
+    payload_manager_.sync();
 }
 
 account_asset_statinfo account_asset_database::statinfo() const
@@ -20,13 +20,17 @@
 #include <metaverse/database/databases/address_asset_database.hpp>
 //#include <metaverse/bitcoin/chain/attachment/account/address_asset.hpp>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstddef>
 #include <memory>
+#include <utility>
+#include <vector>
 #include <boost/filesystem.hpp>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/bitcoin/chain/output_point.hpp>
 #include <metaverse/database/memory/memory.hpp>
+#include <metaverse/database/primitives/fixed_rows.hpp>
 #include <metaverse/database/primitives/record_multimap_iterable.hpp>
 #include <metaverse/database/primitives/record_multimap_iterator.hpp>
 
@@ -44,12 +48,27 @@ BC_CONSTEXPR size_t initial_lookup_file_size = header_size + minimum_records_siz
 
 BC_CONSTEXPR size_t record_size = hash_table_multimap_record_size<short_hash>();
 
-BC_CONSTEXPR size_t asset_transfer_record_size = 1 + 36 + 4 + 8 + 2 + 4 + ASSET_DETAIL_FIX_SIZE; // ASSET_DETAIL_FIX_SIZE is the biggest one
-//      + std::max({ETP_FIX_SIZE, ASSET_DETAIL_FIX_SIZE, ASSET_TRANSFER_FIX_SIZE});
-BC_CONSTEXPR size_t row_record_size = hash_table_record_size<hash_digest>(asset_transfer_record_size);
+// Row format:
+//  [ kind:1         ]
+//  [ point:36       ]
+//  [ height:4       ]
+//  [ value:8        ] (checksum of the previous output for spends)
+//  [ payload:8      ] (position of the business data in the payload file)
+// Payload format:
+//  [ business_kd:2  ]
+//  [ timestamp:4    ]
+//  [ business_data  ] (variable size, empty for spends and etp)
+BC_CONSTEXPR size_t row_size = 1 + 36 + 4 + 8 + 8;
+BC_CONSTEXPR size_t row_record_size = record_list_offset + row_size;
+
+// Rows of database version 0.6.5 and before were padded to the biggest
+// business data (ASSET_DETAIL_FIX_SIZE), only used to upgrade existing rows files.
+BC_CONSTEXPR size_t fixed_row_size = 1 + 36 + 4 + 8 + 2 + 4 + ASSET_DETAIL_FIX_SIZE;
+BC_CONSTEXPR size_t fixed_row_record_size = hash_table_record_size<hash_digest>(fixed_row_size);
 
 address_asset_database::address_asset_database(const path& lookup_filename,
-    const path& rows_filename, std::shared_ptr<shared_mutex> mutex)
+    const path& rows_filename, const path& payload_filename,
+    std::shared_ptr<shared_mutex> mutex)
     : lookup_file_(lookup_filename, mutex),
     lookup_header_(lookup_file_, number_buckets),
     lookup_manager_(lookup_file_, header_size, record_size),
@@ -57,7 +76,9 @@ address_asset_database::address_asset_database(const path& lookup_filename,
     rows_file_(rows_filename, mutex),
     rows_manager_(rows_file_, 0, row_record_size),
     rows_list_(rows_manager_),
-    rows_multimap_(lookup_map_, rows_list_)
+    rows_multimap_(lookup_map_, rows_list_),
+    payload_file_(payload_filename, mutex),
+    payload_manager_(payload_file_, 0)
 {
 }
 
@@ -75,23 +96,27 @@ bool address_asset_database::create()
 {
     // Resize and create require a started file.
     if (!lookup_file_.start() ||
-        !rows_file_.start())
+        !rows_file_.start() ||
+        !payload_file_.start())
         return false;
 
     // These will throw if insufficient disk space.
     lookup_file_.resize(initial_lookup_file_size);
     rows_file_.resize(minimum_records_size);
+    payload_file_.resize(minimum_slabs_size);
 
     if (!lookup_header_.create() ||
         !lookup_manager_.create() ||
-        !rows_manager_.create())
+        !rows_manager_.create() ||
+        !payload_manager_.create())
         return false;
 
     // Should not call start after create, already started.
     return
         lookup_header_.start() &&
         lookup_manager_.start() &&
-        rows_manager_.start();
+        rows_manager_.start() &&
+        payload_manager_.start();
 }
 
 // Startup and shutdown.
@@ -102,23 +127,27 @@ bool address_asset_database::start()
     return
         lookup_file_.start() &&
         rows_file_.start() &&
+        payload_file_.start() &&
         lookup_header_.start() &&
         lookup_manager_.start() &&
-        rows_manager_.start();
+        rows_manager_.start() &&
+        payload_manager_.start();
 }
 
 bool address_asset_database::stop()
 {
     return
         lookup_file_.stop() &&
-        rows_file_.stop();
+        rows_file_.stop() &&
+        payload_file_.stop();
 }
 
 bool address_asset_database::close()
 {
     return
         lookup_file_.close() &&
-        rows_file_.close();
+        rows_file_.close() &&
+        payload_file_.close();
 }
 
 // ----------------------------------------------------------------------------
@@ -126,6 +155,8 @@ void address_asset_database::store_input(const short_hash& key,
     const output_point& inpoint, uint32_t input_height,
     const input_point& previous, uint32_t timestamp)
 {
+    // use etp type fill incase invalid when deser, input has no business data.
+    const auto payload = store_payload(0, timestamp, {});
     auto write = [&](memory_ptr data)
     {
         auto serial = make_serializer(REMAP_ADDRESS(data));
@@ -133,17 +164,160 @@ void address_asset_database::store_input(const short_hash& key,
         serial.write_data(inpoint.to_data()); // 36
         serial.write_4_bytes_little_endian(input_height); // 4
         serial.write_8_bytes_little_endian(previous.checksum()); // 8
-
-        serial.write_2_bytes_little_endian(0); // 2 use etp type fill incase invalid when deser
-        serial.write_4_bytes_little_endian(timestamp); // 4
-        // asset data should be here but input has no these data
+        serial.write_8_bytes_little_endian(payload); // 8
     };
     rows_multimap_.add_row(key, write);
 }
 
 void address_asset_database::delete_last_row(const short_hash& key)
 {
+    const auto start = rows_multimap_.lookup(key);
+    if (start == record_list::empty)
+        return;
+
+    file_offset payload;
+    size_t size;
+    {
+        // This obtains a remap safe address pointer against the rows file.
+        const auto record = rows_list_.get(start);
+        const auto address = REMAP_ADDRESS(record);
+        const auto kind = static_cast<point_kind>(address[0]);
+        payload = from_little_endian_unsafe<file_offset>(
+            address + row_size - sizeof(file_offset));
+        size = payload_size(payload, kind);
+    }
+
     rows_multimap_.delete_last_row(key);
+
+    // Rows are popped in the reverse order of their pushes, so the payload
+    // is normally the last slab and the next push reuses its space.
+    payload_manager_.release_slab(payload, size);
+}
+
+void address_asset_database::prune_spend(const short_hash& key,
+    const input_point& inpoint, const output_point& previous)
+{
+    const auto spend = inpoint.to_data();
+    const auto output = previous.to_data();
+    std::vector<std::pair<file_offset, size_t>> payloads;
+
+    // Match the kind and point of the row, keeping its payload slab.
+    const auto filter = [&](memory_ptr data)
+    {
+        const auto address = REMAP_ADDRESS(data);
+        const auto kind = static_cast<point_kind>(*address);
+        const auto& point = kind == point_kind::spend ? spend : output;
+        if (!std::equal(point.begin(), point.end(), address + 1))
+            return false;
+
+        const auto payload = from_little_endian_unsafe<file_offset>(
+            address + row_size - sizeof(file_offset));
+        payloads.emplace_back(payload, payload_size(payload, kind));
+        return true;
+    };
+
+    rows_multimap_.delete_rows(key, filter, 2);
+
+    for (const auto& payload: payloads)
+        payload_manager_.discard_slab(payload.first, payload.second);
+}
+
+size_t address_asset_database::reclaim(const asio::time_point& before)
+{
+    return lookup_file_.reclaim(before) + rows_file_.reclaim(before) +
+        payload_file_.reclaim(before);
+}
+
+size_t address_asset_database::payload_size(file_offset position,
+    point_kind kind) const
+{
+    // Spends store the business kind and timestamp only.
+    if (kind == point_kind::spend)
+        return 2 + 4;
+
+    const auto memory = payload_manager_.get(position);
+    const auto begin = REMAP_ADDRESS(memory);
+    auto deserial = make_deserializer_unsafe(begin);
+    business_data::factory_from_data(deserial);
+    return static_cast<size_t>(deserial.iterator() - begin);
+}
+
+file_offset address_asset_database::store_payload(uint16_t business_kd,
+    uint32_t timestamp, const data_chunk& business_data)
+{
+    const auto position = payload_manager_.new_slab(2 + 4 + business_data.size());
+    const auto memory = payload_manager_.get(position);
+    auto serial = make_serializer(REMAP_ADDRESS(memory));
+    serial.write_2_bytes_little_endian(business_kd); // 2
+    serial.write_4_bytes_little_endian(timestamp); // 4
+    serial.write_data(business_data);
+    return position;
+}
+
+// Read a row from the data for the history list.
+business_record address_asset_database::read_row(uint8_t* data) const
+{
+    auto deserial = make_deserializer_unsafe(data);
+    business_record row;
+
+    // output or spend?
+    row.kind = static_cast<point_kind>(deserial.read_byte());
+
+    // point
+    row.point = point::factory_from_data(deserial);
+
+    // height
+    row.height = deserial.read_4_bytes_little_endian();
+
+    // value or checksum
+    row.val_chk_sum.value = deserial.read_8_bytes_little_endian();
+
+    // business_kd, timestamp and business data are in the payload file.
+    const auto payload = deserial.read_8_bytes_little_endian();
+    const auto memory = payload_manager_.get(payload);
+    auto payload_deserial = make_deserializer_unsafe(REMAP_ADDRESS(memory));
+    row.data = business_data::factory_from_data(payload_deserial);
+    return row;
+}
+
+// Convert the fixed size rows of an existing database, see convert_fixed_rows.
+bool address_asset_database::upgrade_rows(const path& fixed_rows_filename)
+{
+    // The lookup table is kept, rows and payload files are created.
+    if (!lookup_file_.start() ||
+        !rows_file_.start() ||
+        !payload_file_.start())
+        return false;
+
+    // These will throw if insufficient disk space.
+    rows_file_.resize(minimum_records_size);
+    payload_file_.resize(minimum_slabs_size);
+
+    if (!lookup_header_.start() ||
+        !lookup_manager_.start() ||
+        !rows_manager_.create() ||
+        !payload_manager_.create() ||
+        !rows_manager_.start() ||
+        !payload_manager_.start())
+        return false;
+
+    // kind, point, height and value stay in the row, business_kd, timestamp
+    // and business data move to the payload file.
+    const auto serialize = [](deserializer<uint8_t*, false>& deserial)
+    {
+        auto business = business_data::factory_from_data(deserial);
+        data_chunk data(business.serialized_size());
+        auto serial = make_serializer(data.begin());
+        business.to_data_t(serial);
+        return data;
+    };
+
+    if (!convert_fixed_rows(fixed_rows_filename, fixed_row_record_size,
+        1 + 36 + 4 + 8, rows_manager_, payload_manager_, serialize))
+        return false;
+
+    sync();
+    return true;
 }
 
 /// get all record of key from database
@@ -158,33 +332,6 @@ business_record::list address_asset_database::get(const short_hash& key,
         return from_little_endian_unsafe<uint32_t>(height_address);
     };
 
-    // Read a row from the data for the history list.
-    const auto read_row = [](uint8_t* data)
-    {
-        auto deserial = make_deserializer_unsafe(data);
-        return business_record
-        {
-            // output or spend?
-            static_cast<point_kind>(deserial.read_byte()),
-
-            // point
-            point::factory_from_data(deserial),
-
-            // height
-            deserial.read_4_bytes_little_endian(),
-
-            // value or checksum
-            { deserial.read_8_bytes_little_endian() },
-
-            // business_kd;
-            //deserial.read_2_bytes_little_endian(),
-            // timestamp;
-            //deserial.read_4_bytes_little_endian(),
-
-            business_data::factory_from_data(deserial) // 2 + 4 are in this class
-        };
-    };
-
     business_record::list result;
     const auto start = rows_multimap_.lookup(key);
     const auto records = record_multimap_iterable(rows_list_, start);
@@ -224,33 +371,6 @@ std::shared_ptr<business_record::list> address_asset_database::get(
         return from_little_endian_unsafe<uint32_t>(height_address);
     };
 
-    // Read a row from the data for the history list.
-    const auto read_row = [](uint8_t* data)
-    {
-        auto deserial = make_deserializer_unsafe(data);
-        return business_record
-        {
-            // output or spend?
-            static_cast<point_kind>(deserial.read_byte()),
-
-            // point
-            point::factory_from_data(deserial),
-
-            // height
-            deserial.read_4_bytes_little_endian(),
-
-            // value or checksum
-            { deserial.read_8_bytes_little_endian() },
-
-            // business_kd;
-            //deserial.read_2_bytes_little_endian(),
-            // timestamp;
-            //deserial.read_4_bytes_little_endian(),
-
-            business_data::factory_from_data(deserial) // 2 + 4 are in this class
-        };
-    };
-
     auto result = std::make_shared<business_record::list>();
     const auto start = rows_multimap_.lookup(key);
     const auto records = record_multimap_iterable(rows_list_, start);
@@ -326,33 +446,6 @@ std::shared_ptr<business_record::list> address_asset_database::get(const std::st
         return from_little_endian_unsafe<uint32_t>(height_address);
     };
 
-    // Read a row from the data for the history list.
-    const auto read_row = [](uint8_t* data)
-    {
-        auto deserial = make_deserializer_unsafe(data);
-        return business_record
-        {
-            // output or spend?
-            static_cast<point_kind>(deserial.read_byte()),
-
-            // point
-            point::factory_from_data(deserial),
-
-            // height
-            deserial.read_4_bytes_little_endian(),
-
-            // value or checksum
-            { deserial.read_8_bytes_little_endian() },
-
-            // business_kd;
-            //deserial.read_2_bytes_little_endian(),
-            // timestamp;
-            //deserial.read_4_bytes_little_endian(),
-
-            business_data::factory_from_data(deserial) // 2 + 4 are in this class
-        };
-    };
-
     auto result = std::make_shared<business_record::list>();
     const auto start = rows_multimap_.lookup(key);
     const auto records = record_multimap_iterable(rows_list_, start);
@@ -377,33 +470,6 @@ std::shared_ptr<business_record::list> address_asset_database::get(const std::st
 /// get all record of key from database
 std::shared_ptr<business_record::list> address_asset_database::get(size_t idx) const
 {
-    // Read a row from the data for the history list.
-    const auto read_row = [](uint8_t* data)
-    {
-        auto deserial = make_deserializer_unsafe(data);
-        return business_record
-        {
-            // output or spend?
-            static_cast<point_kind>(deserial.read_byte()),
-
-            // point
-            point::factory_from_data(deserial),
-
-            // height
-            deserial.read_4_bytes_little_endian(),
-
-            // value or checksum
-            { deserial.read_8_bytes_little_endian() },
-
-            // business_kd;
-            //deserial.read_2_bytes_little_endian(),
-            // timestamp;
-            //deserial.read_4_bytes_little_endian(),
-
-            business_data::factory_from_data(deserial) // 2 + 4 are in this class
-        };
-    };
-
     auto result = std::make_shared<business_record::list>();
     auto sh_idx_vec = rows_multimap_.lookup(idx);
 
@@ -425,33 +491,6 @@ std::shared_ptr<business_record::list> address_asset_database::get(size_t idx) c
 /// get one record by index from row_list
 business_record address_asset_database::get_record(size_t idx) const
 {
-    // Read a row from the data for the history list.
-    const auto read_row = [](uint8_t* data)
-    {
-        auto deserial = make_deserializer_unsafe(data);
-        return business_record
-        {
-            // output or spend?
-            static_cast<point_kind>(deserial.read_byte()),
-
-            // point
-            point::factory_from_data(deserial),
-
-            // height
-            deserial.read_4_bytes_little_endian(),
-
-            // value or checksum
-            { deserial.read_8_bytes_little_endian() },
-
-            // business_kd;
-            //deserial.read_2_bytes_little_endian(),
-            // timestamp;
-            //deserial.read_4_bytes_little_endian(),
-
-            business_data::factory_from_data(deserial) // 2 + 4 are in this class
-        };
-    };
-
     // This obtains a remap safe address pointer against the rows file.
     const auto record = rows_list_.get(idx);
     const auto address = REMAP_ADDRESS(record);
@@ -818,6 +857,7 @@ void address_asset_database::sync()
 {
     lookup_manager_.sync();
     rows_manager_.sync();
+    payload_manager_.sync();
 }
 
 address_asset_statinfo address_asset_database::statinfo() const
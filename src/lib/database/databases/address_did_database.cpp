@@ -26,6 +26,7 @@
 #include <boost/filesystem.hpp>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/database/memory/memory.hpp>
+#include <metaverse/database/primitives/fixed_rows.hpp>
 #include <metaverse/database/primitives/record_multimap_iterable.hpp>
 #include <metaverse/database/primitives/record_multimap_iterator.hpp>
 
@@ -43,12 +44,27 @@ BC_CONSTEXPR size_t initial_lookup_file_size = header_size + minimum_records_siz
 
 BC_CONSTEXPR size_t record_size = hash_table_multimap_record_size<short_hash>();
 
-BC_CONSTEXPR size_t did_transfer_record_size = 1 + 36 + 4 + 8 + 2 + 4 + DID_DETAIL_FIX_SIZE; // DID_DETAIL_FIX_SIZE is the biggest one
-//        + std::max({ETP_FIX_SIZE, DID_DETAIL_FIX_SIZE, DID_TRANSFER_FIX_SIZE});
-BC_CONSTEXPR size_t row_record_size = hash_table_record_size<hash_digest>(did_transfer_record_size);
+// Row format:
+//  [ kind:1         ]
+//  [ point:36       ]
+//  [ height:4       ]
+//  [ value:8        ] (checksum of the previous output for spends)
+//  [ payload:8      ] (position of the business data in the payload file)
+// Payload format:
+//  [ business_kd:2  ]
+//  [ timestamp:4    ]
+//  [ business_data  ] (variable size, empty for spends and etp)
+BC_CONSTEXPR size_t row_size = 1 + 36 + 4 + 8 + 8;
+BC_CONSTEXPR size_t row_record_size = record_list_offset + row_size;
+
+// Rows of database version 0.6.5 and before were padded to the biggest
+// business data (DID_DETAIL_FIX_SIZE), only used to upgrade existing rows files.
+BC_CONSTEXPR size_t fixed_row_size = 1 + 36 + 4 + 8 + 2 + 4 + DID_DETAIL_FIX_SIZE;
+BC_CONSTEXPR size_t fixed_row_record_size = hash_table_record_size<hash_digest>(fixed_row_size);
 
 address_did_database::address_did_database(const path& lookup_filename,
-    const path& rows_filename, std::shared_ptr<shared_mutex> mutex)
+    const path& rows_filename, const path& payload_filename,
+    std::shared_ptr<shared_mutex> mutex)
   : lookup_file_(lookup_filename, mutex),
     lookup_header_(lookup_file_, number_buckets),
     lookup_manager_(lookup_file_, header_size, record_size),
@@ -56,7 +72,9 @@ address_did_database::address_did_database(const path& lookup_filename,
     rows_file_(rows_filename, mutex),
     rows_manager_(rows_file_, 0, row_record_size),
     rows_list_(rows_manager_),
-    rows_multimap_(lookup_map_, rows_list_)
+    rows_multimap_(lookup_map_, rows_list_),
+    payload_file_(payload_filename, mutex),
+    payload_manager_(payload_file_, 0)
 {
 }
 
@@ -74,23 +92,27 @@ bool address_did_database::create()
 {
     // Resize and create require a started file.
     if (!lookup_file_.start() ||
-        !rows_file_.start())
+        !rows_file_.start() ||
+        !payload_file_.start())
         return false;
 
     // These will throw if insufficient disk space.
     lookup_file_.resize(initial_lookup_file_size);
     rows_file_.resize(minimum_records_size);
+    payload_file_.resize(minimum_slabs_size);
 
     if (!lookup_header_.create() ||
         !lookup_manager_.create() ||
-        !rows_manager_.create())
+        !rows_manager_.create() ||
+        !payload_manager_.create())
         return false;
 
     // Should not call start after create, already started.
     return
         lookup_header_.start() &&
         lookup_manager_.start() &&
-        rows_manager_.start();
+        rows_manager_.start() &&
+        payload_manager_.start();
 }
 
 // Startup and shutdown.
@@ -101,23 +123,27 @@ bool address_did_database::start()
     return
         lookup_file_.start() &&
         rows_file_.start() &&
+        payload_file_.start() &&
         lookup_header_.start() &&
         lookup_manager_.start() &&
-        rows_manager_.start();
+        rows_manager_.start() &&
+        payload_manager_.start();
 }
 
 bool address_did_database::stop()
 {
     return
         lookup_file_.stop() &&
-        rows_file_.stop();
+        rows_file_.stop() &&
+        payload_file_.stop();
 }
 
 bool address_did_database::close()
 {
     return
         lookup_file_.close() &&
-        rows_file_.close();
+        rows_file_.close() &&
+        payload_file_.close();
 }
 
 // ----------------------------------------------------------------------------
@@ -125,6 +151,8 @@ void address_did_database::store_input(const short_hash& key,
     const output_point& inpoint, uint32_t input_height,
     const input_point& previous, uint32_t timestamp)
 {
+    // use etp type fill incase invalid when deser, input has no business data.
+    const auto payload = store_payload(0, timestamp, {});
     auto write = [&](memory_ptr data)
     {
         auto serial = make_serializer(REMAP_ADDRESS(data));
@@ -132,10 +160,7 @@ void address_did_database::store_input(const short_hash& key,
         serial.write_data(inpoint.to_data()); // 36
         serial.write_4_bytes_little_endian(input_height); // 4
         serial.write_8_bytes_little_endian(previous.checksum()); // 8
-
-        serial.write_2_bytes_little_endian(0); // 2 use etp type fill incase invalid when deser
-        serial.write_4_bytes_little_endian(timestamp); // 4
-        // did data should be here but input has no these data
+        serial.write_8_bytes_little_endian(payload); // 8
     };
     rows_multimap_.add_row(key, write);
 }
@@ -147,7 +172,119 @@ void address_did_database::delete_old_did(const short_hash& key)
 
 void address_did_database::delete_last_row(const short_hash& key)
 {
+    const auto start = rows_multimap_.lookup(key);
+    if (start == record_list::empty)
+        return;
+
+    file_offset payload;
+    size_t size;
+    {
+        // This obtains a remap safe address pointer against the rows file.
+        const auto record = rows_list_.get(start);
+        const auto address = REMAP_ADDRESS(record);
+        const auto kind = static_cast<point_kind>(address[0]);
+        payload = from_little_endian_unsafe<file_offset>(
+            address + row_size - sizeof(file_offset));
+        size = payload_size(payload, kind);
+    }
+
     rows_multimap_.delete_last_row(key);
+
+    // Rows are popped in the reverse order of their pushes, so the payload
+    // is normally the last slab and the next push reuses its space.
+    payload_manager_.release_slab(payload, size);
+}
+
+size_t address_did_database::payload_size(file_offset position,
+    point_kind kind) const
+{
+    // Spends store the business kind and timestamp only.
+    if (kind == point_kind::spend)
+        return 2 + 4;
+
+    const auto memory = payload_manager_.get(position);
+    const auto begin = REMAP_ADDRESS(memory);
+    auto deserial = make_deserializer_unsafe(begin);
+    business_data::factory_from_data(deserial);
+    return static_cast<size_t>(deserial.iterator() - begin);
+}
+
+file_offset address_did_database::store_payload(uint16_t business_kd,
+    uint32_t timestamp, const data_chunk& business_data)
+{
+    const auto position = payload_manager_.new_slab(2 + 4 + business_data.size());
+    const auto memory = payload_manager_.get(position);
+    auto serial = make_serializer(REMAP_ADDRESS(memory));
+    serial.write_2_bytes_little_endian(business_kd); // 2
+    serial.write_4_bytes_little_endian(timestamp); // 4
+    serial.write_data(business_data);
+    return position;
+}
+
+// Read a row from the data for the history list.
+business_record address_did_database::read_row(uint8_t* data) const
+{
+    auto deserial = make_deserializer_unsafe(data);
+    business_record row;
+
+    // output or spend?
+    row.kind = static_cast<point_kind>(deserial.read_byte());
+
+    // point
+    row.point = point::factory_from_data(deserial);
+
+    // height
+    row.height = deserial.read_4_bytes_little_endian();
+
+    // value or checksum
+    row.val_chk_sum.value = deserial.read_8_bytes_little_endian();
+
+    // business_kd, timestamp and business data are in the payload file.
+    const auto payload = deserial.read_8_bytes_little_endian();
+    const auto memory = payload_manager_.get(payload);
+    auto payload_deserial = make_deserializer_unsafe(REMAP_ADDRESS(memory));
+    row.data = business_data::factory_from_data(payload_deserial);
+    return row;
+}
+
+// Convert the fixed size rows of an existing database, see convert_fixed_rows.
+bool address_did_database::upgrade_rows(const path& fixed_rows_filename)
+{
+    // The lookup table is kept, rows and payload files are created.
+    if (!lookup_file_.start() ||
+        !rows_file_.start() ||
+        !payload_file_.start())
+        return false;
+
+    // These will throw if insufficient disk space.
+    rows_file_.resize(minimum_records_size);
+    payload_file_.resize(minimum_slabs_size);
+
+    if (!lookup_header_.start() ||
+        !lookup_manager_.start() ||
+        !rows_manager_.create() ||
+        !payload_manager_.create() ||
+        !rows_manager_.start() ||
+        !payload_manager_.start())
+        return false;
+
+    // kind, point, height and value stay in the row, business_kd, timestamp
+    // and business data move to the payload file.
+    const auto serialize = [](deserializer<uint8_t*, false>& deserial)
+    {
+        auto business = business_data::factory_from_data(deserial);
+        data_chunk data(business.serialized_size());
+        auto serial = make_serializer(data.begin());
+        business.to_data_t(serial);
+        return data;
+    };
+
+    if (!convert_fixed_rows(fixed_rows_filename, fixed_row_record_size,
+        1 + 36 + 4 + 8, rows_manager_, payload_manager_, serialize))
+        return false;
+
+    sync();
+    return true;
 }
 /// get all record of key from database
 business_record::list address_did_database::get(const short_hash& key,
@@ -161,33 +298,6 @@ business_record::list address_did_database::get(const short_hash& key,
         return from_little_endian_unsafe<uint32_t>(height_address);
     };
 
-    // Read a row from the data for the history list.
-    const auto read_row = [](uint8_t* data)
-    {
-        auto deserial = make_deserializer_unsafe(data);
-        return business_record
-        {
-            // output or spend?
-            static_cast<point_kind>(deserial.read_byte()),
-
-            // point
-            point::factory_from_data(deserial),
-
-            // height
-            deserial.read_4_bytes_little_endian(),
-
-            // value or checksum
-            { deserial.read_8_bytes_little_endian() },
-
-            // business_kd;
-            //deserial.read_2_bytes_little_endian(),
-            // timestamp;
-            //deserial.read_4_bytes_little_endian(),
-
-            business_data::factory_from_data(deserial) // 2 + 4 are in this class
-        };
-    };
-
     business_record::list result;
     const auto start = rows_multimap_.lookup(key);
     const auto records = record_multimap_iterable(rows_list_, start);
@@ -225,33 +335,6 @@ std::shared_ptr<std::vector<business_record>> address_did_database::get(const st
         return from_little_endian_unsafe<uint32_t>(height_address);
     };
 
-    // Read a row from the data for the history list.
-    const auto read_row = [](uint8_t* data)
-    {
-        auto deserial = make_deserializer_unsafe(data);
-        return business_record
-        {
-            // output or spend?
-            static_cast<point_kind>(deserial.read_byte()),
-
-            // point
-            point::factory_from_data(deserial),
-
-            // height
-            deserial.read_4_bytes_little_endian(),
-
-            // value or checksum
-            { deserial.read_8_bytes_little_endian() },
-
-            // business_kd;
-            //deserial.read_2_bytes_little_endian(),
-            // timestamp;
-            //deserial.read_4_bytes_little_endian(),
-
-            business_data::factory_from_data(deserial) // 2 + 4 are in this class
-        };
-    };
-
     auto result = std::make_shared<std::vector<business_record>>();
     const auto start = rows_multimap_.lookup(key);
     const auto records = record_multimap_iterable(rows_list_, start);
@@ -319,33 +402,6 @@ std::shared_ptr<std::vector<business_record>> address_did_database::get(const st
         return from_little_endian_unsafe<uint32_t>(height_address);
     };
 
-    // Read a row from the data for the history list.
-    const auto read_row = [](uint8_t* data)
-    {
-        auto deserial = make_deserializer_unsafe(data);
-        return business_record
-        {
-            // output or spend?
-            static_cast<point_kind>(deserial.read_byte()),
-
-            // point
-            point::factory_from_data(deserial),
-
-            // height
-            deserial.read_4_bytes_little_endian(),
-
-            // value or checksum
-            { deserial.read_8_bytes_little_endian() },
-
-            // business_kd;
-            //deserial.read_2_bytes_little_endian(),
-            // timestamp;
-            //deserial.read_4_bytes_little_endian(),
-
-            business_data::factory_from_data(deserial) // 2 + 4 are in this class
-        };
-    };
-
     auto result = std::make_shared<std::vector<business_record>>();
     const auto start = rows_multimap_.lookup(key);
     const auto records = record_multimap_iterable(rows_list_, start);
@@ -370,33 +426,6 @@ std::shared_ptr<std::vector<business_record>> address_did_database::get(const st
 /// get all record of key from database
 std::shared_ptr<std::vector<business_record>> address_did_database::get(size_t idx) const
 {
-    // Read a row from the data for the history list.
-    const auto read_row = [](uint8_t* data)
-    {
-        auto deserial = make_deserializer_unsafe(data);
-        return business_record
-        {
-            // output or spend?
-            static_cast<point_kind>(deserial.read_byte()),
-
-            // point
-            point::factory_from_data(deserial),
-
-            // height
-            deserial.read_4_bytes_little_endian(),
-
-            // value or checksum
-            { deserial.read_8_bytes_little_endian() },
-
-            // business_kd;
-            //deserial.read_2_bytes_little_endian(),
-            // timestamp;
-            //deserial.read_4_bytes_little_endian(),
-
-            business_data::factory_from_data(deserial) // 2 + 4 are in this class
-        };
-    };
-
     auto result = std::make_shared<std::vector<business_record>>();
     auto sh_idx_vec = rows_multimap_.lookup(idx);
 
@@ -419,33 +448,6 @@ std::shared_ptr<std::vector<business_record>> address_did_database::get(size_t i
 /// get one record by index from row_list
 business_record address_did_database::get_record(size_t idx) const
 {
-    // Read a row from the data for the history list.
-    const auto read_row = [](uint8_t* data)
-    {
-        auto deserial = make_deserializer_unsafe(data);
-        return business_record
-        {
-            // output or spend?
-            static_cast<point_kind>(deserial.read_byte()),
-
-            // point
-            point::factory_from_data(deserial),
-
-            // height
-            deserial.read_4_bytes_little_endian(),
-
-            // value or checksum
-            { deserial.read_8_bytes_little_endian() },
-
-            // business_kd;
-            //deserial.read_2_bytes_little_endian(),
-            // timestamp;
-            //deserial.read_4_bytes_little_endian(),
-
-            business_data::factory_from_data(deserial) // 2 + 4 are in this class
-        };
-    };
-
     // This obtains a remap safe address pointer against the rows file.
     const auto record = rows_list_.get(idx);
     const auto address = REMAP_ADDRESS(record);
@@ -755,6 +757,7 @@ void address_did_database::sync()
 {
     lookup_manager_.sync();
     rows_manager_.sync();
+    payload_manager_.sync();
 }
 
 address_did_statinfo address_did_database::statinfo() const
@@ -20,6 +20,7 @@
  */
 #include <metaverse/database/databases/block_database.hpp>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstddef>
 #include <memory>
@@ -38,6 +39,9 @@ BC_CONSTEXPR size_t number_buckets = 600000;
 BC_CONSTEXPR size_t header_size = slab_hash_table_header_size(number_buckets);
 BC_CONSTEXPR size_t initial_map_file_size = header_size + minimum_slabs_size;
 
+// Recent headers kept in memory, several dpos epochs on mainnet.
+BC_CONSTEXPR size_t recent_header_depth = 65536;
+
 // Valid file offsets should never be zero.
 const file_offset block_database::empty = 0;
 
@@ -58,7 +62,8 @@ block_database::block_database(const path& map_filename,
     lookup_manager_(lookup_file_, header_size),
     lookup_map_(lookup_header_, lookup_manager_),
     index_file_(index_filename, mutex),
-    index_manager_(index_file_, 0, sizeof(file_offset))
+    index_manager_(index_file_, 0, sizeof(file_offset)),
+    recent_first_(0)
 {
 }
 
@@ -88,6 +93,8 @@ bool block_database::create()
         !index_manager_.create())
         return false;
 
+    uncache_headers(0);
+
     // Should not call start after create, already started.
     return
         lookup_header_.start() &&
@@ -101,12 +108,17 @@ bool block_database::create()
 // Start files and primitives.
 bool block_database::start()
 {
-    return
+    const auto started =
         lookup_file_.start() &&
         index_file_.start() &&
         lookup_header_.start() &&
         lookup_manager_.start() &&
         index_manager_.start();
+
+    if (started)
+        load_recent_headers();
+
+    return started;
 }
 
 // Stop files.
@@ -132,7 +144,11 @@ block_result block_database::get(size_t height) const
     if (height >= index_manager_.count())
         return block_result(nullptr);
 
+    // Parallel import leaves gaps in the index.
     const auto position = read_position(height);
+    if (position == empty)
+        return block_result(nullptr);
+
     const auto memory = lookup_manager_.get(position);
     return block_result(memory);
 }
@@ -143,6 +159,114 @@ block_result block_database::get(const hash_digest& hash) const
     return block_result(memory);
 }
 
+bool block_database::get_header(chain::header& out_header, size_t height,
+    bool with_transaction_count) const
+{
+    {
+        shared_lock lock(recent_mutex_);
+        const auto entry = find_recent(height);
+        if (entry != nullptr)
+        {
+            auto deserial = make_deserializer_unsafe(entry->header.begin());
+            out_header.from_data(deserial, false);
+            if (with_transaction_count)
+                out_header.transaction_count = entry->transaction_count;
+            return true;
+        }
+    }
+
+    const auto result = get(height);
+    if (!result)
+        return false;
+
+    out_header = result.header();
+    if (with_transaction_count)
+        out_header.transaction_count = result.transaction_count();
+    return true;
+}
+
+bool block_database::get_header(chain::header& out_header,
+    const hash_digest& hash, bool with_transaction_count) const
+{
+    size_t height;
+    if (get_height(height, hash))
+        return get_header(out_header, height, with_transaction_count);
+
+    return false;
+}
+
+chain::header::list block_database::get_headers(size_t from_height,
+    size_t to_height) const
+{
+    chain::header::list headers;
+    if (from_height >= to_height)
+        return headers;
+
+    headers.reserve(to_height - from_height);
+    for (auto height = from_height; height < to_height; ++height)
+    {
+        chain::header header;
+        if (!get_header(header, height))
+            break;
+
+        headers.push_back(std::move(header));
+    }
+
+    return headers;
+}
+
+bool block_database::get_height(size_t& out_height,
+    const hash_digest& hash) const
+{
+    {
+        shared_lock lock(recent_mutex_);
+        const auto it = recent_heights_.find(hash);
+        if (it != recent_heights_.end())
+        {
+            out_height = it->second;
+            return true;
+        }
+    }
+
+    const auto result = get(hash);
+    if (!result)
+        return false;
+
+    out_height = result.height();
+    return true;
+}
+
+bool block_database::get_public_key(ec_compressed& out_key,
+    size_t height) const
+{
+    {
+        shared_lock lock(recent_mutex_);
+        const auto entry = find_recent(height);
+        if (entry != nullptr)
+        {
+            out_key = entry->public_key;
+            return out_key != ec_compressed();
+        }
+    }
+
+    const auto result = get(height);
+    if (!result || !result.header().is_proof_of_dpos())
+        return false;
+
+    out_key = result.public_key();
+    return true;
+}
+
+bool block_database::get_public_key(ec_compressed& out_key,
+    const hash_digest& hash) const
+{
+    size_t height;
+    if (get_height(height, hash))
+        return get_public_key(out_key, height);
+
+    return false;
+}
+
 void block_database::store(const block& block)
 {
     store(block, index_manager_.count());
@@ -157,11 +281,12 @@ void block_database::store(const block& block, size_t height)
     BITCOIN_ASSERT(tx_count <= max_uint32);
     const auto tx_count32 = static_cast<uint32_t>(tx_count);
 
+    const auto header_data = block.header.to_data(false);
+
     // Write block data.
     const auto write = [&](memory_ptr data)
     {
         auto serial = make_serializer(REMAP_ADDRESS(data));
-        const auto header_data = block.header.to_data(false);
         serial.write_data(header_data);
         serial.write_4_bytes_little_endian(height32);
         serial.write_4_bytes_little_endian(tx_count32);
@@ -192,19 +317,140 @@ void block_database::store(const block& block, size_t height)
 
     // Write block height to hash table position mapping to block index.
     write_position(position, height32);
+
+    recent_header entry;
+    BITCOIN_ASSERT(header_data.size() == entry.header.size());
+    std::copy_n(header_data.begin(), entry.header.size(), entry.header.begin());
+    entry.hash = key;
+    entry.public_key = block.header.is_proof_of_dpos() ?
+        block.public_key : ec_compressed();
+    entry.transaction_count = tx_count32;
+    cache_header(entry, height);
 }
 
 void block_database::unlink(size_t from_height)
 {
     if (index_manager_.count() > from_height)
         index_manager_.set_count(from_height);
+
+    uncache_headers(from_height);
 }
 void block_database::remove(const hash_digest& hash)
 {
+    {
+        unique_lock lock(recent_mutex_);
+        recent_heights_.erase(hash);
+    }
+
+
     DEBUG_ONLY(bool success =) lookup_map_.unlink(hash);
     BITCOIN_ASSERT(success);
 }
 
+// Recent headers.
+// ----------------------------------------------------------------------------
+
+void block_database::cache_header(const recent_header& entry, size_t height)
+{
+    unique_lock lock(recent_mutex_);
+
+    // Older than the window, read from the table when asked for.
+    if (!recent_.empty() && height < recent_first_)
+        return;
+
+    const auto end = recent_first_ + recent_.size();
+    if (recent_.empty() || height >= end + recent_header_depth)
+    {
+        recent_.clear();
+        recent_heights_.clear();
+        recent_first_ = height;
+    }
+    else if (height < end)
+    {
+        // Replaced at the same height.
+        auto& slot = recent_[height - recent_first_];
+        if (slot.transaction_count != 0)
+            recent_heights_.erase(slot.hash);
+        slot.transaction_count = 0;
+    }
+
+    // Parallel import leaves gaps below the new block.
+    recent_header gap;
+    gap.transaction_count = 0;
+    while (recent_first_ + recent_.size() <= height)
+        recent_.push_back(gap);
+
+    recent_[height - recent_first_] = entry;
+    recent_heights_[entry.hash] = height;
+
+    while (recent_.size() > recent_header_depth)
+    {
+        if (recent_.front().transaction_count != 0)
+            recent_heights_.erase(recent_.front().hash);
+        recent_.pop_front();
+        ++recent_first_;
+    }
+}
+
+void block_database::uncache_headers(size_t from_height)
+{
+    unique_lock lock(recent_mutex_);
+    while (!recent_.empty() && recent_first_ + recent_.size() > from_height)
+    {
+        if (recent_.back().transaction_count != 0)
+            recent_heights_.erase(recent_.back().hash);
+        recent_.pop_back();
+    }
+
+    if (recent_.empty())
+        recent_first_ = 0;
+}
+
+void block_database::load_recent_headers()
+{
+    uncache_headers(0);
+
+    size_t top_height;
+    if (!top(top_height))
+        return;
+
+    const auto first = top_height >= recent_header_depth ?
+        top_height - recent_header_depth + 1 : 0;
+
+    for (auto height = first; height <= top_height; ++height)
+    {
+        if (read_position(height) == empty)
+            continue;
+
+        const auto result = get(height);
+        if (!result)
+            continue;
+
+        const auto header = result.header();
+        const auto header_data = header.to_data(false);
+
+        recent_header entry;
+        BITCOIN_ASSERT(header_data.size() == entry.header.size());
+        std::copy_n(header_data.begin(), entry.header.size(),
+            entry.header.begin());
+        entry.hash = header.hash();
+        entry.public_key = result.public_key();
+        entry.transaction_count = static_cast<uint32_t>(
+            result.transaction_count());
+        cache_header(entry, height);
+    }
+}
+
+const block_database::recent_header* block_database::find_recent(
+    size_t height) const
+{
+    if (height < recent_first_ || height >= recent_first_ + recent_.size())
+        return nullptr;
+
+    const auto& entry = recent_[height - recent_first_];
+    return entry.transaction_count == 0 ? nullptr : &entry;
+}
+
 void block_database::sync()
 {
     lookup_manager_.sync();
@@ -23,6 +23,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <string>
 #include <boost/filesystem.hpp>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/database/memory/memory.hpp>
@@ -69,6 +70,9 @@ bool blockchain_asset_cert_database::create()
         !lookup_manager_.create())
         return false;
 
+    address_index_.clear();
+    type_index_.clear();
+
     // Should not call start after create, already started.
     return
         lookup_header_.start() &&
@@ -81,10 +85,15 @@ bool blockchain_asset_cert_database::create()
 // Start files and primitives.
 bool blockchain_asset_cert_database::start()
 {
-    return
+    const auto started =
         lookup_file_.start() &&
         lookup_header_.start() &&
         lookup_manager_.start();
+
+    if (started)
+        load_index();
+
+    return started;
 }
 
 // Stop files.
@@ -101,10 +110,66 @@ bool blockchain_asset_cert_database::close()
 
 // ----------------------------------------------------------------------------
 
+void blockchain_asset_cert_database::load_index()
+{
+    unique_lock lock(index_mutex_);
+    address_index_.clear();
+    type_index_.clear();
+
+    // The scan also returns records shadowed by a newer one of the same
+    // key, only the newest is indexed, as store does.
+    const auto certs = get_blockchain_asset_certs();
+    for (const auto& cert : *certs) {
+        const auto& key_str = cert.get_key();
+        const auto key = sha256_hash(data_chunk(key_str.begin(), key_str.end()));
+        const auto newest = get(key);
+        if (newest)
+            index(key, *newest);
+    }
+}
+
+// The caller must hold index_mutex_ exclusively.
+void blockchain_asset_cert_database::index(const hash_digest& key,
+    const chain::asset_cert& cert)
+{
+    address_index_[cert.get_address()].insert(key);
+    type_index_[cert.get_type()].insert(key);
+}
+
+// The caller must hold index_mutex_ exclusively.
+void blockchain_asset_cert_database::unindex(const hash_digest& key,
+    const chain::asset_cert& cert)
+{
+    const auto address = address_index_.find(cert.get_address());
+    if (address != address_index_.end()) {
+        address->second.erase(key);
+        if (address->second.empty())
+            address_index_.erase(address);
+    }
+
+    const auto type = type_index_.find(cert.get_type());
+    if (type != type_index_.end()) {
+        type->second.erase(key);
+        if (type->second.empty())
+            type_index_.erase(type);
+    }
+}
+
 void blockchain_asset_cert_database::remove(const hash_digest& hash)
 {
+    unique_lock lock(index_mutex_);
+
+    const auto cert = get(hash);
+    if (cert)
+        unindex(hash, *cert);
+
     DEBUG_ONLY(bool success =) lookup_map_.unlink(hash);
     BITCOIN_ASSERT(success);
+
+    // A key stored twice is still found after the newer record is unlinked.
+    const auto previous = get(hash);
+    if (previous)
+        index(hash, *previous);
 }
 
 void blockchain_asset_cert_database::sync()
@@ -145,6 +210,45 @@ std::shared_ptr<std::vector<chain::asset_cert>> blockchain_asset_cert_database::
     return vec_acc;
 }
 
+std::shared_ptr<std::vector<chain::asset_cert>> blockchain_asset_cert_database::get_blockchain_asset_certs(
+    const std::string& address, chain::asset_cert_type cert_type) const
+{
+    if (address.empty() && cert_type == asset_cert_ns::none)
+        return get_blockchain_asset_certs();
+
+    auto vec_acc = std::make_shared<std::vector<chain::asset_cert>>();
+
+    shared_lock lock(index_mutex_);
+
+    const key_set* keys = nullptr;
+    if (!address.empty()) {
+        const auto it = address_index_.find(address);
+        keys = it == address_index_.end() ? nullptr : &it->second;
+    }
+    else {
+        const auto it = type_index_.find(cert_type);
+        keys = it == type_index_.end() ? nullptr : &it->second;
+    }
+
+    if (keys == nullptr)
+        return vec_acc;
+
+    for (const auto& key : *keys) {
+        const auto cert = get(key);
+        if (!cert)
+            continue;
+
+        if (!address.empty() && address != cert->get_address())
+            continue;
+
+        if (cert_type != asset_cert_ns::none && cert_type != cert->get_type())
+            continue;
+
+        vec_acc->push_back(std::move(*cert));
+    }
+
+    return vec_acc;
+}
 
 void blockchain_asset_cert_database::store(const chain::asset_cert& sp_cert)
 {
@@ -166,7 +270,16 @@ void blockchain_asset_cert_database::store(const chain::asset_cert& sp_cert)
         auto serial = make_serializer(REMAP_ADDRESS(data));
         serial.write_data(sp_cert.to_data());
     };
+
+    unique_lock lock(index_mutex_);
+
+    // A newer record of the same key shadows the older one.
+    const auto previous = get(key);
+    if (previous)
+        unindex(key, *previous);
+
     lookup_map_.store(key, write, value_size);
+    index(key, sp_cert);
 }
 
 
@@ -23,6 +23,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <string>
 #include <boost/filesystem.hpp>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/database/memory/memory.hpp>
@@ -69,6 +70,8 @@ bool blockchain_asset_database::create()
         !lookup_manager_.create())
         return false;
 
+    symbols_.clear();
+
     // Should not call start after create, already started.
     return
         lookup_header_.start() &&
@@ -81,10 +84,18 @@ bool blockchain_asset_database::create()
 // Start files and primitives.
 bool blockchain_asset_database::start()
 {
-    return
-        lookup_file_.start() &&
-        lookup_header_.start() &&
-        lookup_manager_.start();
+    if (!lookup_file_.start() ||
+        !lookup_header_.start() ||
+        !lookup_manager_.start())
+        return false;
+
+    symbol_index::list symbols;
+    for (const auto& record : *get_blockchain_assets())
+        if (listed(record.get_asset().get_symbol()))
+            symbols.push_back(record.get_asset().get_symbol());
+
+    symbols_.assign(std::move(symbols));
+    return true;
 }
 
 // Stop files.
@@ -103,8 +114,34 @@ bool blockchain_asset_database::close()
 
 void blockchain_asset_database::remove(const hash_digest& hash)
 {
+    const auto record = get(hash);
+
     DEBUG_ONLY(bool success =) lookup_map_.unlink(hash);
     BITCOIN_ASSERT(success);
+
+    // The symbol stays while an older record of it remains.
+    if (record && !lookup_map_.find(hash))
+        symbols_.erase(record->get_asset().get_symbol());
+}
+
+std::shared_ptr<std::vector<chain::blockchain_asset>> blockchain_asset_database::get_blockchain_assets(
+    const std::string& prefix, size_t offset, size_t limit) const
+{
+    auto vec_acc = std::make_shared<std::vector<chain::blockchain_asset>>();
+    // One record a symbol, the first issue, as get does; secondary issues
+    // are stored under the same key and would overfill the page.
+    for (const auto& symbol : symbols_.page(prefix, offset, limit)) {
+        const auto detail = get(sha256_hash(data_chunk(symbol.begin(), symbol.end())));
+        if (detail) {
+            vec_acc->push_back(*detail);
+        }
+    }
+    return vec_acc;
+}
+
+const symbol_index& blockchain_asset_database::get_symbol_index() const
+{
+    return symbols_;
 }
 
 void blockchain_asset_database::sync()
@@ -234,6 +271,15 @@ void blockchain_asset_database::store(const hash_digest& hash, const chain::bloc
         serial.write_data(sp_detail.to_data());
     };
     lookup_map_.store(key, write, value_size);
+
+    if (listed(sp_detail.get_asset().get_symbol()))
+        symbols_.insert(sp_detail.get_asset().get_symbol());
+}
+
+// Forbidden symbols are never listed, pages and counts skip them alike.
+bool blockchain_asset_database::listed(const std::string& symbol)
+{
+    return !wallet::symbol::is_forbidden(symbol);
 }
 
 
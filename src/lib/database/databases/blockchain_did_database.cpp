@@ -23,6 +23,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <string>
 #include <boost/filesystem.hpp>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/database/memory/memory.hpp>
@@ -69,6 +70,8 @@ bool blockchain_did_database::create()
         !lookup_manager_.create())
         return false;
 
+    symbols_.clear();
+
     // Should not call start after create, already started.
     return
         lookup_header_.start() &&
@@ -81,10 +84,18 @@ bool blockchain_did_database::create()
 // Start files and primitives.
 bool blockchain_did_database::start()
 {
-    return
-        lookup_file_.start() &&
-        lookup_header_.start() &&
-        lookup_manager_.start();
+    if (!lookup_file_.start() ||
+        !lookup_header_.start() ||
+        !lookup_manager_.start())
+        return false;
+
+    symbol_index::list symbols;
+    for (const auto& record : *get_blockchain_dids())
+        if (record.get_status() == chain::blockchain_did::address_current)
+            symbols.push_back(record.get_did().get_symbol());
+
+    symbols_.assign(std::move(symbols));
+    return true;
 }
 
 // Stop files.
@@ -103,8 +114,34 @@ bool blockchain_did_database::close()
 
 void blockchain_did_database::remove(const hash_digest& hash)
 {
+    const auto record = get(hash);
+
     DEBUG_ONLY(bool success =) lookup_map_.unlink(hash);
     BITCOIN_ASSERT(success);
+
+    // The symbol stays while an older current record of it remains.
+    const auto remaining = get(hash);
+    if (record && (!remaining ||
+        remaining->get_status() != chain::blockchain_did::address_current))
+        symbols_.erase(record->get_did().get_symbol());
+}
+
+std::shared_ptr<std::vector<chain::blockchain_did>> blockchain_did_database::get_blockchain_dids(
+    const std::string& prefix, size_t offset, size_t limit) const
+{
+    auto vec_acc = std::make_shared<std::vector<chain::blockchain_did>>();
+    for (const auto& symbol : symbols_.page(prefix, offset, limit)) {
+        const auto detail = get(sha256_hash(data_chunk(symbol.begin(), symbol.end())));
+        if (detail) {
+            vec_acc->push_back(*detail);
+        }
+    }
+    return vec_acc;
+}
+
+const symbol_index& blockchain_did_database::get_symbol_index() const
+{
+    return symbols_;
 }
 
 void blockchain_did_database::sync()
@@ -217,6 +254,9 @@ void blockchain_did_database::store(const hash_digest& hash, const chain::blockc
         serial.write_data(sp_detail.to_data());
     };
     lookup_map_.store(key, write, value_size);
+
+    if (sp_detail.get_status() == chain::blockchain_did::address_current)
+        symbols_.insert(sp_detail.get_did().get_symbol());
 }
 
 std::shared_ptr<chain::blockchain_did> blockchain_did_database::update_address_status(const hash_digest &hash,uint32_t status )
@@ -281,8 +321,18 @@ std::shared_ptr<std::vector<chain::blockchain_did> > blockchain_did_database::ge
 
 std::shared_ptr<chain::blockchain_did> blockchain_did_database::pop_did_transfer(const hash_digest &hash)
 {
+    const auto record = get(hash);
     lookup_map_.unlink(hash);
-    return update_address_status(hash, chain::blockchain_did::address_current);
+
+    const auto restored = update_address_status(hash,
+        chain::blockchain_did::address_current);
+
+    if (restored)
+        symbols_.insert(restored->get_did().get_symbol());
+    else if (record)
+        symbols_.erase(record->get_did().get_symbol());
+
+    return restored;
 }
 
 } // namespace database
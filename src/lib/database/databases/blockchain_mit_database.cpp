@@ -22,6 +22,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <string>
 #include <boost/filesystem.hpp>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/database/memory/memory.hpp>
@@ -67,6 +68,8 @@ bool blockchain_mit_database::create()
         !lookup_manager_.create())
         return false;
 
+    symbols_.clear();
+
     // Should not call start after create, already started.
     return
         lookup_header_.start() &&
@@ -79,10 +82,17 @@ bool blockchain_mit_database::create()
 // Start files and primitives.
 bool blockchain_mit_database::start()
 {
-    return
-        lookup_file_.start() &&
-        lookup_header_.start() &&
-        lookup_manager_.start();
+    if (!lookup_file_.start() ||
+        !lookup_header_.start() ||
+        !lookup_manager_.start())
+        return false;
+
+    symbol_index::list symbols;
+    for (const auto& record : *get_blockchain_mits())
+        symbols.push_back(record.mit.get_symbol());
+
+    symbols_.assign(std::move(symbols));
+    return true;
 }
 
 // Stop files.
@@ -101,8 +111,32 @@ bool blockchain_mit_database::close()
 
 void blockchain_mit_database::remove(const hash_digest& hash)
 {
+    const auto record = get(hash);
+
     DEBUG_ONLY(bool success =) lookup_map_.unlink(hash);
     BITCOIN_ASSERT(success);
+
+    // The symbol stays while an older record of it remains.
+    if (record && !lookup_map_.find(hash))
+        symbols_.erase(record->mit.get_symbol());
+}
+
+std::shared_ptr<chain::asset_mit_info::list> blockchain_mit_database::get_blockchain_mits(
+    const std::string& prefix, size_t offset, size_t limit) const
+{
+    auto vec_acc = std::make_shared<chain::asset_mit_info::list>();
+    for (const auto& symbol : symbols_.page(prefix, offset, limit)) {
+        const auto mit_info = get(sha256_hash(data_chunk(symbol.begin(), symbol.end())));
+        if (mit_info) {
+            vec_acc->push_back(*mit_info);
+        }
+    }
+    return vec_acc;
+}
+
+const symbol_index& blockchain_mit_database::get_symbol_index() const
+{
+    return symbols_;
 }
 
 void blockchain_mit_database::sync()
@@ -193,6 +227,7 @@ void blockchain_mit_database::store(const chain::asset_mit_info& mit_info)
         serial.write_data(mit_info.to_data());
     };
     lookup_map_.store(key, write, value_size);
+    symbols_.insert(mit_info.mit.get_symbol());
 }
 
 
@@ -0,0 +1,206 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/database/databases/blockchain_witness_signer_database.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/memory/memory.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+using namespace boost::filesystem;
+
+// Record format:
+//  [ slot_num:4     ]
+//  [ public_key:33  ]
+BC_CONSTEXPR size_t signer_record_size = 4 + ec_compressed_size;
+
+const uint32_t witness_signer::empty_slot = max_uint32;
+
+blockchain_witness_signer_database::blockchain_witness_signer_database(
+    const path& index_filename, std::shared_ptr<shared_mutex> mutex)
+  : index_file_(index_filename, mutex),
+    index_manager_(index_file_, 0, signer_record_size)
+{
+}
+
+// Close does not call stop because there is no way to detect thread join.
+blockchain_witness_signer_database::~blockchain_witness_signer_database()
+{
+    close();
+}
+
+// Create.
+// ----------------------------------------------------------------------------
+
+// Initialize files and start.
+bool blockchain_witness_signer_database::create()
+{
+    // Resize and create require a started file.
+    if (!index_file_.start())
+        return false;
+
+    // This will throw if insufficient disk space.
+    index_file_.resize(minimum_records_size);
+
+    if (!index_manager_.create())
+        return false;
+
+    // Should not call start after create, already started.
+    return index_manager_.start();
+}
+
+// Startup and shutdown.
+// ----------------------------------------------------------------------------
+
+// Start files and primitives.
+bool blockchain_witness_signer_database::start()
+{
+    return
+        index_file_.start() &&
+        index_manager_.start();
+}
+
+// Stop files.
+bool blockchain_witness_signer_database::stop()
+{
+    return index_file_.stop();
+}
+
+// Close files.
+bool blockchain_witness_signer_database::close()
+{
+    return index_file_.close();
+}
+
+// ----------------------------------------------------------------------------
+
+bool blockchain_witness_signer_database::get(witness_signer& out_signer,
+    size_t height) const
+{
+    if (height >= index_manager_.count())
+        return false;
+
+    const auto memory = index_manager_.get(height);
+    auto deserial = make_deserializer_unsafe(REMAP_ADDRESS(memory));
+    out_signer.slot_num = deserial.read_4_bytes_little_endian();
+    out_signer.public_key = deserial.read_bytes<ec_compressed_size>();
+    return true;
+}
+
+witness_signer::list blockchain_witness_signer_database::get(
+    size_t from_height, size_t to_height) const
+{
+    witness_signer::list signers;
+    const auto top = std::min<size_t>(to_height, index_manager_.count());
+    if (from_height >= top)
+        return signers;
+
+    signers.reserve(top - from_height);
+    witness_signer signer;
+    for (auto height = from_height; height < top; ++height)
+    {
+        if (!get(signer, height))
+            break;
+
+        signers.push_back(signer);
+    }
+
+    return signers;
+}
+
+void blockchain_witness_signer_database::store(const chain::block& block,
+    size_t height)
+{
+    store(block.header, block.public_key, height);
+}
+
+void blockchain_witness_signer_database::store(const chain::header& header,
+    const ec_compressed& public_key, size_t height)
+{
+    BITCOIN_ASSERT(height < max_uint32);
+    const auto new_count = static_cast<array_index>(height) + 1;
+
+    const auto is_dpos = header.is_proof_of_dpos();
+    const auto slot_num = is_dpos ?
+        static_cast<uint32_t>(header.nonce) : witness_signer::empty_slot;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_upgrade();
+
+    // Guard index_manager to prevent interim count increase.
+    const auto initial_count = index_manager_.count();
+
+    //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    mutex_.unlock_upgrade_and_lock();
+
+    // Guard write to prevent overwriting preceding height write.
+    if (new_count > initial_count)
+    {
+        const auto create_count = new_count - initial_count;
+        index_manager_.new_records(create_count);
+        zeroize(initial_count, create_count - 1);
+    }
+
+    const auto memory = index_manager_.get(height);
+    auto serial = make_serializer(REMAP_ADDRESS(memory));
+    serial.write_4_bytes_little_endian(slot_num);
+    serial.write_data(is_dpos ? public_key : null_compressed_point);
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void blockchain_witness_signer_database::zeroize(array_index first,
+    array_index count)
+{
+    for (auto index = first; index < (first + count); ++index)
+    {
+        const auto memory = index_manager_.get(index);
+        auto serial = make_serializer(REMAP_ADDRESS(memory));
+        serial.write_4_bytes_little_endian(witness_signer::empty_slot);
+        serial.write_data(null_compressed_point);
+    }
+}
+
+void blockchain_witness_signer_database::unlink(size_t from_height)
+{
+    if (index_manager_.count() > from_height)
+        index_manager_.set_count(from_height);
+}
+
+size_t blockchain_witness_signer_database::count() const
+{
+    return index_manager_.count();
+}
+
+void blockchain_witness_signer_database::sync()
+{
+    index_manager_.sync();
+}
+
+} // namespace database
+} // namespace libbitcoin
@@ -153,6 +153,29 @@ void history_database::delete_last_row(const short_hash& key)
     rows_multimap_.delete_last_row(key);
 }
 
+void history_database::prune_spend(const short_hash& key,
+    const input_point& inpoint, const output_point& previous)
+{
+    const auto spend = inpoint.to_data();
+    const auto output = previous.to_data();
+
+    // Match the kind and point of the row.
+    const auto filter = [&](memory_ptr data)
+    {
+        const auto address = REMAP_ADDRESS(data);
+        const auto kind = static_cast<point_kind>(*address);
+        const auto& point = kind == point_kind::spend ? spend : output;
+        return std::equal(point.begin(), point.end(), address + 1);
+    };
+
+    rows_multimap_.delete_rows(key, filter, 2);
+}
+
+size_t history_database::reclaim(const asio::time_point& before)
+{
+    return lookup_file_.reclaim(before) + rows_file_.reclaim(before);
+}
+
 history_compact::list history_database::get(const short_hash& key,
     size_t limit, size_t from_height) const
 {
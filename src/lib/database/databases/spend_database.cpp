@@ -138,6 +138,17 @@ void spend_database::remove(const output_point& outpoint)
     BITCOIN_ASSERT(success);
 }
 
+void spend_database::prune(const output_point& outpoint)
+{
+    DEBUG_ONLY(bool success =) lookup_map_.discard(outpoint);
+    BITCOIN_ASSERT(success);
+}
+
+size_t spend_database::reclaim(const asio::time_point& before)
+{
+    return lookup_file_.reclaim(before);
+}
+
 void spend_database::sync()
 {
     lookup_manager_.sync();
@@ -139,6 +139,29 @@ void transaction_database::remove(const hash_digest& hash)
     BITCOIN_ASSERT(success);
 }
 
+void transaction_database::prune(const hash_digest& hash)
+{
+    size_t value_size;
+    {
+        // The result holds the map, it is released before the unlink.
+        const auto result = get(hash);
+        if (!result)
+            return;
+
+        // The stored size of the value, see store.
+        value_size = 4 + 4 +
+            static_cast<size_t>(result.transaction().serialized_size());
+    }
+
+    DEBUG_ONLY(bool success =) lookup_map_.discard(hash, value_size);
+    BITCOIN_ASSERT(success);
+}
+
+size_t transaction_database::reclaim(const asio::time_point& before)
+{
+    return lookup_file_.reclaim(before);
+}
+
 void transaction_database::sync()
 {
     lookup_manager_.sync();
@@ -32,6 +32,7 @@
     #include <sys/mman.h>
     #define FILE_OPEN_PERMISSIONS S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH
 #endif
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <fcntl.h>
@@ -361,6 +362,76 @@ memory_ptr memory_map::reserve(size_t size, size_t expansion)
     ///////////////////////////////////////////////////////////////////////////
 }
 
+// Discarded bytes are counted by page. A page is queued with the time its
+// last byte was discarded, the caller picks how long a reader positioned on
+// an unlinked row may take to move on before the page reads as zeros.
+void memory_map::discard(file_offset position, size_t size)
+{
+    const auto page_size = page();
+    if (page_size == 0)
+        return;
+
+    const auto now = asio::steady_clock::now();
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(discard_mutex_);
+
+    while (size > 0)
+    {
+        const auto page = static_cast<size_t>(position / page_size);
+        const auto used = std::min(size,
+            page_size - static_cast<size_t>(position % page_size));
+
+        auto& discarded = discarded_[page];
+        discarded += used;
+        if (discarded >= page_size)
+        {
+            discarded_.erase(page);
+            discarded_pages_.emplace_back(now, page);
+        }
+
+        position += used;
+        size -= used;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t memory_map::reclaim(const asio::time_point& before)
+{
+    const auto page_size = page();
+    std::vector<size_t> pages;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    discard_mutex_.lock();
+    while (!discarded_pages_.empty() && discarded_pages_.front().first < before)
+    {
+        pages.push_back(discarded_pages_.front().second);
+        discarded_pages_.pop_front();
+    }
+    discard_mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Adjacent pages are punched out as one range.
+    std::sort(pages.begin(), pages.end());
+    size_t reclaimed = 0;
+    for (auto it = pages.begin(); it != pages.end();)
+    {
+        auto end = it + 1;
+        while (end != pages.end() && *end == *(end - 1) + 1)
+            ++end;
+
+        const auto count = static_cast<size_t>(end - it);
+        if (punch(*it * page_size, count * page_size))
+            reclaimed += count * page_size;
+
+        it = end;
+    }
+
+    return reclaimed;
+}
+
 // privates
 // ----------------------------------------------------------------------------
 
@@ -443,6 +514,17 @@ bool memory_map::truncate_mapped(size_t size)
     ///////////////////////////////////////////////////////////////////////////
 }
 
+// The file keeps its size, the punched pages read back as zeros.
+bool memory_map::punch(size_t position, size_t size)
+{
+#if defined(FALLOC_FL_PUNCH_HOLE) && defined(FALLOC_FL_KEEP_SIZE)
+    return fallocate(file_handle_, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+        position, size) != -1;
+#else
+    return false;
+#endif
+}
+
 bool memory_map::validate(size_t size)
 {
     if (data_ == MAP_FAILED)
@@ -0,0 +1,74 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/database/primitives/fixed_rows.hpp>
+
+#include <cstddef>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/memory/memory.hpp>
+#include <metaverse/database/memory/memory_map.hpp>
+#include <metaverse/database/primitives/record_manager.hpp>
+#include <metaverse/database/primitives/slab_manager.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+using namespace boost::filesystem;
+
+bool convert_fixed_rows(const path& fixed_filename, size_t fixed_record_size,
+    size_t fields_size, record_manager& rows, slab_manager& payload,
+    payload_serializer serialize)
+{
+    memory_map fixed_file(fixed_filename, nullptr);
+    record_manager fixed_manager(fixed_file, 0, fixed_record_size);
+
+    if (!fixed_file.start() ||
+        !fixed_manager.start())
+        return false;
+
+    const auto count = fixed_manager.count();
+    for (array_index index = 0; index < count; ++index)
+    {
+        const auto fixed_memory = fixed_manager.get(index);
+        auto deserial = make_deserializer_unsafe(REMAP_ADDRESS(fixed_memory));
+        const auto next = deserial.read_4_bytes_little_endian();
+        const auto fields = deserial.read_data(fields_size);
+        const auto payload_data = serialize(deserial);
+
+        const auto position = payload.new_slab(payload_data.size());
+        const auto payload_memory = payload.get(position);
+        auto payload_serial = make_serializer(REMAP_ADDRESS(payload_memory));
+        payload_serial.write_data(payload_data);
+
+        const auto new_index = rows.new_records(1);
+        BITCOIN_ASSERT(new_index == index);
+        const auto memory = rows.get(new_index);
+        auto serial = make_serializer(REMAP_ADDRESS(memory));
+        serial.write_4_bytes_little_endian(next);
+        serial.write_data(fields);
+        serial.write_8_bytes_little_endian(position);
+    }
+
+    return fixed_file.close();
+}
+
+} // namespace database
+} // namespace libbitcoin
@@ -64,6 +64,15 @@ array_index record_list::next(array_index index) const
     //*************************************************************************
 }
 
+void record_list::link(array_index index, array_index next)
+{
+    const auto memory = manager_.get(index);
+    auto serial = make_serializer(REMAP_ADDRESS(memory));
+    //*************************************************************************
+    serial.template write_little_endian<array_index>(next);
+    //*************************************************************************
+}
+
 const memory_ptr record_list::get(array_index index) const
 {
     auto memory = manager_.get(index);
@@ -71,5 +80,10 @@ const memory_ptr record_list::get(array_index index) const
     return memory;
 }
 
+void record_list::discard(array_index index)
+{
+    manager_.discard_record(index);
+}
+
 } // namespace database
 } // namespace libbitcoin
@@ -150,6 +150,11 @@ const memory_ptr record_manager::get(array_index record) const
     return memory;
 }
 
+void record_manager::discard_record(array_index record)
+{
+    file_.discard(header_size_ + record_to_position(record), record_size_);
+}
+
 // privates
 
 // Read the count value from the first 32 bits of the file after the header.
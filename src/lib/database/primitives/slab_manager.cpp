@@ -125,6 +125,26 @@ file_offset slab_manager::new_slab(size_t size)
     ///////////////////////////////////////////////////////////////////////////
 }
 
+bool slab_manager::release_slab(file_offset position, size_t size)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    ALLOCATE_WRITE(mutex_);
+
+    // Only the last slab can be given back, the file keeps its size.
+    if (position + size != payload_size_)
+        return false;
+
+    payload_size_ = position;
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void slab_manager::discard_slab(file_offset position, size_t size)
+{
+    file_.discard(header_size_ + position, size);
+}
+
 // Position is offset by header but not size storage (embedded in data files).
 const memory_ptr slab_manager::get(file_offset position) const
 {
@@ -0,0 +1,132 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/database/primitives/symbol_index.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <metaverse/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+void symbol_index::assign(list&& symbols)
+{
+    std::sort(symbols.begin(), symbols.end());
+    symbols.erase(std::unique(symbols.begin(), symbols.end()), symbols.end());
+
+    unique_lock lock(mutex_);
+    symbols_ = std::move(symbols);
+}
+
+void symbol_index::clear()
+{
+    unique_lock lock(mutex_);
+    symbols_.clear();
+}
+
+bool symbol_index::insert(const std::string& symbol)
+{
+    unique_lock lock(mutex_);
+
+    const auto it = std::lower_bound(symbols_.begin(), symbols_.end(), symbol);
+    if (it != symbols_.end() && *it == symbol)
+        return false;
+
+    symbols_.insert(it, symbol);
+    return true;
+}
+
+bool symbol_index::erase(const std::string& symbol)
+{
+    unique_lock lock(mutex_);
+
+    const auto it = std::lower_bound(symbols_.begin(), symbols_.end(), symbol);
+    if (it == symbols_.end() || *it != symbol)
+        return false;
+
+    symbols_.erase(it);
+    return true;
+}
+
+bool symbol_index::contains(const std::string& symbol) const
+{
+    shared_lock lock(mutex_);
+    return std::binary_search(symbols_.begin(), symbols_.end(), symbol);
+}
+
+size_t symbol_index::count(const std::string& prefix) const
+{
+    shared_lock lock(mutex_);
+    const auto symbols = range(prefix);
+    return static_cast<size_t>(std::distance(symbols.first, symbols.second));
+}
+
+symbol_index::list symbol_index::page(const std::string& prefix,
+    size_t offset, size_t limit) const
+{
+    shared_lock lock(mutex_);
+    const auto symbols = range(prefix);
+    const auto size = static_cast<size_t>(
+        std::distance(symbols.first, symbols.second));
+
+    if (offset >= size)
+        return {};
+
+    return copy(symbols.first + offset, symbols.second, limit);
+}
+
+symbol_index::list symbol_index::after(const std::string& prefix,
+    const std::string& cursor, size_t limit) const
+{
+    shared_lock lock(mutex_);
+    const auto symbols = range(prefix);
+    const auto begin = std::upper_bound(symbols.first, symbols.second, cursor);
+    return copy(begin, symbols.second, limit);
+}
+
+std::pair<symbol_index::iterator, symbol_index::iterator> symbol_index::range(
+    const std::string& prefix) const
+{
+    const auto begin = std::lower_bound(symbols_.begin(), symbols_.end(),
+        prefix);
+
+    // The symbols with the prefix are contiguous from its lower bound.
+    const auto end = std::partition_point(begin, symbols_.cend(),
+        [&prefix](const std::string& symbol)
+        {
+            return symbol.compare(0, prefix.size(), prefix) == 0;
+        });
+
+    return { begin, end };
+}
+
+symbol_index::list symbol_index::copy(iterator begin, iterator end,
+    size_t limit)
+{
+    const auto available = static_cast<size_t>(std::distance(begin, end));
+    const auto size = limit == 0 ? available : std::min(limit, available);
+    return list(begin, begin + size);
+}
+
+} // namespace database
+} // namespace libbitcoin
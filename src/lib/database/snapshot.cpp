@@ -0,0 +1,291 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/database/snapshot.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+using namespace boost::filesystem;
+
+static const std::string snapshot_magic = "mvs-snapshot";
+static BC_CONSTEXPR size_t chunk_size = 4 * 1024 * 1024;
+
+// Runs shorter than this are stored as literals.
+static BC_CONSTEXPR size_t minimum_run = 32;
+
+enum class token : uint8_t
+{
+    literal = 0,
+    run = 1
+};
+
+enum class entry : uint8_t
+{
+    end = 0,
+    file = 1
+};
+
+static hash_digest info_hash(const snapshot::info& state)
+{
+    data_chunk data;
+    data_sink ostream(data);
+    ostream_writer sink(ostream);
+    sink.write_string(state.version);
+    sink.write_8_bytes_little_endian(state.height);
+    sink.write_hash(state.block_hash);
+    ostream.flush();
+    return sha256_hash(data);
+}
+
+// Chained ahead of the chunks of a file, so a renamed or truncated entry
+// fails the checksum even when its chunks are intact.
+static hash_digest entry_hash(const std::string& name, uint64_t size)
+{
+    data_chunk data;
+    data_sink ostream(data);
+    ostream_writer sink(ostream);
+    sink.write_string(name);
+    sink.write_8_bytes_little_endian(size);
+    ostream.flush();
+    return sha256_hash(data);
+}
+
+data_chunk snapshot::compress(const data_chunk& data)
+{
+    data_chunk out;
+    data_sink ostream(out);
+    ostream_writer sink(ostream);
+
+    const auto write_literal = [&sink, &data](size_t begin, size_t end)
+    {
+        if (begin == end)
+            return;
+
+        sink.write_byte(static_cast<uint8_t>(token::literal));
+        sink.write_variable_uint_little_endian(end - begin);
+        sink.write_data(data.data() + begin, end - begin);
+    };
+
+    size_t literal = 0;
+    for (size_t position = 0; position < data.size();)
+    {
+        auto end = position + 1;
+        while (end < data.size() && data[end] == data[position])
+            ++end;
+
+        if (end - position >= minimum_run)
+        {
+            write_literal(literal, position);
+            sink.write_byte(static_cast<uint8_t>(token::run));
+            sink.write_variable_uint_little_endian(end - position);
+            sink.write_byte(data[position]);
+            literal = end;
+        }
+
+        position = end;
+    }
+
+    write_literal(literal, data.size());
+    ostream.flush();
+    return out;
+}
+
+bool snapshot::decompress(data_chunk& out, const data_chunk& data,
+    size_t size)
+{
+    out.clear();
+    out.reserve(size);
+    data_source istream(data);
+    istream_reader source(istream);
+
+    while (source && !source.is_exhausted())
+    {
+        const auto kind = static_cast<token>(source.read_byte());
+        const auto length = source.read_variable_uint_little_endian();
+        if (!source || length > size - out.size())
+            return false;
+
+        if (kind == token::run)
+        {
+            out.insert(out.end(), length, source.read_byte());
+        }
+        else if (kind == token::literal)
+        {
+            const auto literal = source.read_data(length);
+            out.insert(out.end(), literal.begin(), literal.end());
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return source && out.size() == size;
+}
+
+bool snapshot::write(const path& file, const path& prefix,
+    const std::vector<std::string>& names, const info& state)
+{
+    bc::ofstream stream(file.string(), std::ios::binary);
+    if (!stream.good())
+        return false;
+
+    ostream_writer sink(stream);
+    sink.write_string(snapshot_magic);
+    sink.write_string(state.version);
+    sink.write_8_bytes_little_endian(state.height);
+    sink.write_hash(state.block_hash);
+
+    auto checksum = info_hash(state);
+    data_chunk chunk(chunk_size);
+
+    for (const auto& name: names)
+    {
+        const auto source_path = prefix / name;
+        const auto size = file_size(source_path);
+        bc::ifstream source(source_path.string(), std::ios::binary);
+        if (!source.good())
+            return false;
+
+        sink.write_byte(static_cast<uint8_t>(entry::file));
+        sink.write_string(name);
+        sink.write_8_bytes_little_endian(size);
+        checksum = sha256_hash(checksum, entry_hash(name, size));
+
+        for (uint64_t remaining = size; remaining > 0;)
+        {
+            const auto length = static_cast<size_t>(
+                std::min<uint64_t>(remaining, chunk_size));
+            chunk.resize(length);
+            source.read(reinterpret_cast<char*>(chunk.data()), length);
+            if (!source.good())
+                return false;
+
+            const auto encoded = compress(chunk);
+            const auto chunk_hash = sha256_hash(chunk);
+            checksum = sha256_hash(checksum, chunk_hash);
+
+            sink.write_variable_uint_little_endian(encoded.size());
+            sink.write_data(encoded);
+            sink.write_hash(chunk_hash);
+            remaining -= length;
+        }
+
+        log::info(LOG_DATABASE)
+            << "Exported " << name << " (" << size << " bytes).";
+    }
+
+    sink.write_byte(static_cast<uint8_t>(entry::end));
+    sink.write_hash(checksum);
+    stream.flush();
+    return stream.good();
+}
+
+bool snapshot::read(const path& file, const path& prefix, info& out_state)
+{
+    bc::ifstream stream(file.string(), std::ios::binary);
+    if (!stream.good())
+        return false;
+
+    istream_reader source(stream);
+    if (source.read_string() != snapshot_magic || !source)
+    {
+        log::error(LOG_DATABASE) << "Not a snapshot archive: " << file;
+        return false;
+    }
+
+    out_state.version = source.read_string();
+    out_state.height = source.read_8_bytes_little_endian();
+    out_state.block_hash = source.read_hash();
+
+    auto checksum = info_hash(out_state);
+    data_chunk chunk;
+
+    while (source)
+    {
+        const auto kind = static_cast<entry>(source.read_byte());
+        if (kind == entry::end)
+            break;
+
+        const auto name = source.read_string();
+        const auto size = source.read_8_bytes_little_endian();
+
+        // Names are plain file names of the database directory.
+        if (!source || kind != entry::file || name.empty() ||
+            path(name).filename().string() != name || name == "." ||
+            name == "..")
+        {
+            log::error(LOG_DATABASE) << "Invalid snapshot entry: " << name;
+            return false;
+        }
+
+        checksum = sha256_hash(checksum, entry_hash(name, size));
+        bc::ofstream target((prefix / name).string(), std::ios::binary);
+        if (!target.good())
+            return false;
+
+        for (uint64_t remaining = size; remaining > 0;)
+        {
+            const auto length = static_cast<size_t>(
+                std::min<uint64_t>(remaining, chunk_size));
+            const auto encoded_size = source.read_variable_uint_little_endian();
+            if (!source || encoded_size > 2 * chunk_size)
+                return false;
+
+            const auto encoded = source.read_data(encoded_size);
+            const auto chunk_hash = source.read_hash();
+            if (!source || !decompress(chunk, encoded, length) ||
+                sha256_hash(chunk) != chunk_hash)
+            {
+                log::error(LOG_DATABASE) << "Corrupt snapshot chunk in " << name;
+                return false;
+            }
+
+            checksum = sha256_hash(checksum, chunk_hash);
+            target.write(reinterpret_cast<const char*>(chunk.data()), length);
+            if (!target.good())
+                return false;
+
+            remaining -= length;
+        }
+
+        log::info(LOG_DATABASE)
+            << "Imported " << name << " (" << size << " bytes).";
+    }
+
+    if (!source || source.read_hash() != checksum || !source)
+    {
+        log::error(LOG_DATABASE) << "Snapshot checksum mismatch: " << file;
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace database
+} // namespace libbitcoin
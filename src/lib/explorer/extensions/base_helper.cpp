@@ -209,6 +209,25 @@ void check_mining_subsidy_param(const std::string& param)
     }
 }
 
+uint64_t get_page_offset(uint64_t limit, uint64_t index)
+{
+    if (limit == 0) {
+        return 0;
+    }
+
+    if (index == 0) {
+        throw argument_legality_exception{"page index parameter cannot be zero"};
+    }
+    if (limit > 100) {
+        throw argument_legality_exception{"page record limit cannot be bigger than 100."};
+    }
+    if (index - 1 > max_uint64 / limit) {
+        throw argument_legality_exception{"page index parameter is too big"};
+    }
+
+    return (index - 1) * limit;
+}
+
 template <typename ElemT>
 struct HexTo {
     ElemT value;
@@ -1735,7 +1754,7 @@ void base_transfer_helper::populate_unspent_list()
             continue;
         }
 
-        const auto priv_key = each.get_prv_key(passwd_);
+        const auto priv_key = blockchain_.get_account_prv_key(name_, passwd_, each);
 
         if (from_.empty()) {
             sync_fetchutxo(priv_key, address);
@@ -1814,6 +1833,15 @@ std::string base_transfer_common::get_sign_tx_multisig_script(const address_asse
 
 void base_transfer_common::sign_tx_inputs()
 {
+    // inputs of one address share its key, parse it and derive the
+    // public key once per address rather than once per input.
+    struct signing_key
+    {
+        ec_secret secret;
+        data_chunk public_key;
+    };
+    std::map<std::string, signing_key> keys;
+
     uint32_t index = 0;
     for (auto& fromeach : from_list_)
     {
@@ -1823,8 +1851,13 @@ void base_transfer_common::sign_tx_inputs()
         explorer::config::hashtype sign_type;
         uint8_t hash_type = (signature_hash_algorithm)sign_type;
 
-        bc::explorer::config::ec_private config_private_key(fromeach.prikey);
-        const ec_secret& private_key = config_private_key;
+        auto key = keys.find(fromeach.prikey);
+        if (key == keys.end()) {
+            bc::explorer::config::ec_private config_private_key(fromeach.prikey);
+            key = keys.emplace(fromeach.prikey,
+                signing_key{ config_private_key, {} }).first;
+        }
+        const ec_secret& private_key = key->second.secret;
 
         std::string multisig_script = get_sign_tx_multisig_script(fromeach);
         if (!multisig_script.empty()) {
@@ -1861,10 +1894,11 @@ void base_transfer_common::sign_tx_inputs()
             }
 
             // do script
-            bc::wallet::ec_private ec_private_key(private_key, 0u, true);
-            auto&& public_key = ec_private_key.to_public();
-            data_chunk public_key_data;
-            public_key.to_data(public_key_data);
+            auto& public_key_data = key->second.public_key;
+            if (public_key_data.empty()) {
+                bc::wallet::ec_private ec_private_key(private_key, 0u, true);
+                ec_private_key.to_public().to_data(public_key_data);
+            }
 
             ss.operations.push_back({bc::chain::opcode::special, endorse});
             ss.operations.push_back({bc::chain::opcode::special, public_key_data});
@@ -1881,6 +1915,10 @@ void base_transfer_common::sign_tx_inputs()
         tx_.inputs[index].script = ss;
         index++;
     }
+
+    for (auto& each : keys) {
+        each.second.secret.fill(0);
+    }
 }
 
 void base_transfer_common::send_tx()
@@ -2286,13 +2324,13 @@ void sending_multisig_did::populate_unspent_list()
 
         if (fromfee == each.get_address()) {
             // pay fee
-            sync_fetchutxo(each.get_prv_key(passwd_), each.get_address(), FILTER_ETP);
+            sync_fetchutxo(blockchain_.get_account_prv_key(name_, passwd_, each), each.get_address(), FILTER_ETP);
             check_payment_satisfied(FILTER_ETP);
         }
 
         if (from_ == each.get_address()) {
             // pay did
-            sync_fetchutxo(each.get_prv_key(passwd_), each.get_address(), FILTER_DID);
+            sync_fetchutxo(blockchain_.get_account_prv_key(name_, passwd_, each), each.get_address(), FILTER_DID);
             check_payment_satisfied(FILTER_DID);
         }
 
@@ -2341,13 +2379,13 @@ void sending_did::populate_unspent_list()
 
         if (fromfee == each.get_address()) {
             // pay fee
-            sync_fetchutxo(each.get_prv_key(passwd_), each.get_address(), FILTER_ETP);
+            sync_fetchutxo(blockchain_.get_account_prv_key(name_, passwd_, each), each.get_address(), FILTER_ETP);
             check_payment_satisfied(FILTER_ETP);
         }
 
         if (from_ == each.get_address()) {
             // pay did
-            sync_fetchutxo(each.get_prv_key(passwd_), each.get_address(), FILTER_DID);
+            sync_fetchutxo(blockchain_.get_account_prv_key(name_, passwd_, each), each.get_address(), FILTER_DID);
             check_payment_satisfied(FILTER_DID);
         }
 
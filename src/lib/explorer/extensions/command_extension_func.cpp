@@ -29,10 +29,12 @@
 #include <metaverse/explorer/extensions/command_extension.hpp>
 #include <metaverse/explorer/extensions/command_extension_func.hpp>
 #include <metaverse/explorer/extensions/commands/shutdown.hpp>
+#include <metaverse/explorer/extensions/commands/exportsnapshot.hpp>
 #include <metaverse/explorer/extensions/commands/stopmining.hpp>
 #include <metaverse/explorer/extensions/commands/startmining.hpp>
 #include <metaverse/explorer/extensions/commands/getinfo.hpp>
 #include <metaverse/explorer/extensions/commands/getheight.hpp>
+#include <metaverse/explorer/extensions/commands/estimatefee.hpp>
 #include <metaverse/explorer/extensions/commands/getpeerinfo.hpp>
 #include <metaverse/explorer/extensions/commands/getrandom.hpp>
 #include <metaverse/explorer/extensions/commands/verifyrandom.hpp>
@@ -51,6 +53,8 @@
 #include <metaverse/explorer/extensions/commands/getnewaccount.hpp>
 #include <metaverse/explorer/extensions/commands/getaccount.hpp>
 #include <metaverse/explorer/extensions/commands/deleteaccount.hpp>
+#include <metaverse/explorer/extensions/commands/unlockaccount.hpp>
+#include <metaverse/explorer/extensions/commands/lockaccount.hpp>
 #include <metaverse/explorer/extensions/commands/listaddresses.hpp>
 #include <metaverse/explorer/extensions/commands/getnewaddress.hpp>
 #include <metaverse/explorer/extensions/commands/getblock.hpp>
@@ -121,6 +125,8 @@ void broadcast_extension(const function<void(shared_ptr<command>)> func, std::os
     func(make_shared<deleteaccount>());
     func(make_shared<importaccount>());
     func(make_shared<changepasswd>());
+    func(make_shared<unlockaccount>());
+    func(make_shared<lockaccount>());
     func(make_shared<getnewaddress>());
     func(make_shared<validateaddress>());
     func(make_shared<listaddresses>());
@@ -131,6 +137,7 @@ void broadcast_extension(const function<void(shared_ptr<command>)> func, std::os
     os <<"\r\n";
     // system
     func(make_shared<shutdown>());
+    func(make_shared<exportsnapshot>());
     func(make_shared<getinfo>());
     func(make_shared<addnode>());
     func(make_shared<getpeerinfo>());
@@ -146,6 +153,7 @@ void broadcast_extension(const function<void(shared_ptr<command>)> func, std::os
     func(make_shared<getwork>());
     func(make_shared<submitwork>());
     func(make_shared<getmemorypool>());
+    func(make_shared<estimatefee>());
     func(make_shared<registerwitness>());
 
     os <<"\r\n";
@@ -233,6 +241,10 @@ shared_ptr<command> find_extension(const string& symbol)
         return make_shared<deleteaccount>();
     if (symbol == changepasswd::symbol())
         return make_shared<changepasswd>();
+    if (symbol == unlockaccount::symbol())
+        return make_shared<unlockaccount>();
+    if (symbol == lockaccount::symbol())
+        return make_shared<lockaccount>();
     if (symbol == validateaddress::symbol())
         return make_shared<validateaddress>();
     if (symbol == getnewaddress::symbol())
@@ -251,6 +263,8 @@ shared_ptr<command> find_extension(const string& symbol)
     // system
     if (symbol == shutdown::symbol())
         return make_shared<shutdown>();
+    if (symbol == exportsnapshot::symbol())
+        return make_shared<exportsnapshot>();
     if (symbol == getinfo::symbol())
         return make_shared<getinfo>();
     if (symbol == addnode::symbol())
@@ -279,6 +293,8 @@ shared_ptr<command> find_extension(const string& symbol)
         return make_shared<submitwork>();
     if (symbol == getmemorypool::symbol())
         return make_shared<getmemorypool>();
+    if (symbol == estimatefee::symbol())
+        return make_shared<estimatefee>();
     if (symbol == registerwitness::symbol())
         return make_shared<registerwitness>();
 
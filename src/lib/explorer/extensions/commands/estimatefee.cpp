@@ -0,0 +1,67 @@
+/**
+ * Copyright (c) 2016-2018 mvs developers
+ *
+ * This file is part of metaverse-explorer.
+ *
+ * metaverse-explorer is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <metaverse/explorer/json_helper.hpp>
+#include <metaverse/explorer/extensions/commands/estimatefee.hpp>
+#include <metaverse/explorer/extensions/command_extension_func.hpp>
+#include <metaverse/explorer/extensions/exception.hpp>
+
+namespace libbitcoin {
+namespace explorer {
+namespace commands {
+using namespace bc::explorer::config;
+
+
+/************************ estimatefee *************************/
+
+console_result estimatefee::invoke(Json::Value& jv_output,
+    libbitcoin::server::server_node& node)
+{
+    if (option_.target == 0 || option_.target > blockchain::fee_estimator::max_target) {
+        throw argument_legality_exception{"target parameter must be from 1 to "
+            + std::to_string(blockchain::fee_estimator::max_target)};
+    }
+
+    auto& blockchain = node.chain_impl();
+
+    // fee rates are satoshi per kilobyte, a transaction also pays
+    // the minimum fee of 10000 satoshi whatever its size.
+    uint64_t fee_rate = 0;
+    const auto estimated = blockchain.pool().estimate_fee_rate(fee_rate,
+        option_.target);
+
+    jv_output["target"] = option_.target;
+    jv_output["estimated"] = estimated;
+    if (estimated) {
+        jv_output["fee_rate"] += fee_rate;
+    }
+    else {
+        jv_output["fee_rate"] = Json::nullValue;
+    }
+
+    return console_result::okay;
+}
+
+
+} // namespace commands
+} // namespace explorer
+} // namespace libbitcoin
+
@@ -0,0 +1,58 @@
+/**
+ * Copyright (c) 2016-2018 mvs developers
+ *
+ * This file is part of metaverse-explorer.
+ *
+ * metaverse-explorer is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <metaverse/explorer/extensions/commands/exportsnapshot.hpp>
+#include <metaverse/explorer/extensions/command_extension_func.hpp>
+#include <metaverse/explorer/extensions/exception.hpp>
+#include <metaverse/explorer/extensions/node_method_wrapper.hpp>
+
+namespace libbitcoin {
+namespace explorer {
+namespace commands {
+
+/************************ exportsnapshot *************************/
+
+console_result exportsnapshot::invoke(Json::Value& jv_output,
+    libbitcoin::server::server_node& node)
+{
+    auto& blockchain = node.chain_impl();
+
+    administrator_required_checker(node, auth_.name, auth_.auth);
+
+    const auto& file = argument_.file;
+    if (file.empty() || boost::filesystem::exists(file))
+        throw argument_legality_exception{file.string() + " exists or is empty."};
+
+    // Block writes pause until the archive is written.
+    uint64_t height = 0;
+    if (!blockchain.export_snapshot(file, height))
+        throw argument_legality_exception{"failed to export snapshot to " + file.string()};
+
+    jv_output["file"] = file.string();
+    jv_output["height"] = height;
+
+    return console_result::okay;
+}
+
+
+} // namespace commands
+} // namespace explorer
+} // namespace libbitcoin
+
@@ -63,6 +63,11 @@ console_result getblock::invoke(Json::Value& jv_output,
 
         auto result = p.get_future().get();
         if (result) {
+            if (result.value() == error::not_found
+                && block_height <= blockchain.get_pruned_height()) {
+                throw block_height_get_exception{"transactions of block "
+                    + std::to_string(block_height) + " have been pruned."};
+            }
             throw block_height_get_exception{ result.message() };
         }
     }
@@ -90,6 +95,13 @@ console_result getblock::invoke(Json::Value& jv_output,
 
         auto result = p.get_future().get();
         if (result) {
+            uint64_t block_height = 0;
+            if (result.value() == error::not_found
+                && blockchain.get_height(block_height, block_hash)
+                && block_height <= blockchain.get_pruned_height()) {
+                throw block_height_get_exception{"transactions of block "
+                    + std::to_string(block_height) + " have been pruned."};
+            }
             throw block_height_get_exception{ result.message() };
         }
     }
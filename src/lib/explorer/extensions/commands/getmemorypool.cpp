@@ -43,7 +43,8 @@ console_result getmemorypool::invoke(Json::Value& jv_output,
     using transaction_ptr = message::transaction_message::ptr ;
     auto& blockchain = node.chain_impl();
     std::promise<code> p;
-    blockchain.pool().fetch([&jv_output, &p, &json, this](const code & ec, const std::vector<transaction_ptr>& txs) {
+    // Listed in block order, the highest paying ancestor packages first.
+    blockchain.pool().fetch_by_fee_rate(0, [&jv_output, &p, &json, this](const code & ec, const std::vector<transaction_ptr>& txs) {
         if (ec) {
             p.set_value(ec);
             return;
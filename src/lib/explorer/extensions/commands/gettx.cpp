@@ -40,6 +40,12 @@ console_result gettx::invoke(Json::Value& jv_output,
     auto& blockchain = node.chain_impl();
     auto exist = blockchain.get_transaction_consider_pool(tx, tx_height, argument_.hash);
     if (!exist) {
+        const auto pruned_height = blockchain.get_pruned_height();
+        if (pruned_height > 0) {
+            throw tx_notfound_exception{"transaction does not exist or has been pruned, "
+                "spent transactions at and below height " + std::to_string(pruned_height)
+                + " are pruned."};
+        }
         throw tx_notfound_exception{"transaction does not exist!"};
     }
 
@@ -89,9 +89,10 @@ console_result listassets::invoke(Json::Value& jv_output,
     else {
         json_key = "assets";
 
-        if (auth_.name.empty()) { // no account -- list whole assets in blockchain
-            auto sh_vec = blockchain.get_issued_assets();
-            std::sort(sh_vec->begin(), sh_vec->end());
+        if (auth_.name.empty()) { // no account -- list assets in blockchain
+            // in symbol order, only the requested page is read through the symbol index
+            const auto offset = get_page_offset(option_.limit, option_.index);
+            auto sh_vec = blockchain.get_issued_assets("", offset, option_.limit);
             for (auto& elem: *sh_vec) {
                 Json::Value asset_data = json_helper.prop_list(elem, true);
                 asset_data["status"] = "issued";
@@ -49,25 +49,26 @@ console_result listdids::invoke(Json::Value& jv_output,
 
     auto& blockchain = node.chain_impl();
     std::shared_ptr<chain::did_detail::list> sh_vec;
+    uint64_t total_count = 0;
     if (auth_.name.empty()) {
-        // no account -- list all dids in blockchain
-        sh_vec = blockchain.get_registered_dids();
+        // no account -- list all dids in blockchain, the symbol index holds
+        // only current dids, so the count matches what the pages return
+        total_count = blockchain.get_registered_did_count();
     }
     else {
         // list dids owned by the account
         blockchain.is_account_passwd_valid(auth_.name, auth_.auth);
         sh_vec = blockchain.get_account_dids(auth_.name);
+        std::sort(sh_vec->begin(), sh_vec->end());
+        total_count = sh_vec->size();
     }
 
     uint64_t limit = argument_.limit;
     uint64_t index = argument_.index;
 
     std::vector<chain::did_detail> result;
-    uint64_t total_count = sh_vec-> size();
     uint64_t total_page = 0;
     if (total_count > 0) {
-        std::sort(sh_vec->begin(), sh_vec->end());
-
         uint64_t start = 0, end = 0, tx_count = 0;
         if (index && limit) {
             total_page = (total_count % limit) ? (total_count / limit + 1) : (total_count / limit);
@@ -87,8 +88,13 @@ console_result listdids::invoke(Json::Value& jv_output,
         }
 
         if (start < total_count && tx_count > 0) {
-            result.resize(tx_count);
-            std::copy(sh_vec->begin() + start, sh_vec->begin() + start + tx_count, result.begin());
+            if (sh_vec) {
+                result.resize(tx_count);
+                std::copy(sh_vec->begin() + start, sh_vec->begin() + start + tx_count, result.begin());
+            }
+            else {
+                result = std::move(*blockchain.get_registered_dids("", start, tx_count));
+            }
         }
     }
 
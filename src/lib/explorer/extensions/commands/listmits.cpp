@@ -41,10 +41,11 @@ console_result listmits::invoke(Json::Value& jv_output,
     auto json_helper = config::json_helper(get_api_version());
 
     if (auth_.name.empty()) {
-        // no account -- list whole assets in blockchain
-        auto sh_vec = blockchain.get_registered_mits();
+        // no account -- list mits in blockchain in symbol order,
+        // only the requested page is read through the symbol index
+        const auto offset = get_page_offset(option_.limit, option_.index);
+        auto sh_vec = blockchain.get_registered_mits("", offset, option_.limit);
         if (nullptr != sh_vec) {
-            std::sort(sh_vec->begin(), sh_vec->end());
             for (auto& elem : *sh_vec) {
                 Json::Value asset_data = json_helper.prop_list(elem);
                 json_value.append(asset_data);
@@ -44,6 +44,7 @@ console_result popblock::invoke (Json::Value& jv_output,
     blockchain.set_sync_disabled(true);
 
     // lock database writing while poping
+    unique_lock organize_lock(blockchain.get_organize_mutex());
     unique_lock lock(blockchain.get_mutex());
 
     uint64_t old_height = 0;
@@ -47,7 +47,7 @@ console_result signmultisigtx::invoke(
 
     auto get_prikey = [&](const std::string& publickey) -> std::string {
         for (auto& each : *pvaddr) {
-            auto prv_key = each.get_prv_key(auth_.auth);
+            auto prv_key = blockchain.get_account_prv_key(auth_.name, auth_.auth, each);
             auto pub_key = ec_to_xxx_impl("ec-to-public", prv_key);
             if (publickey == pub_key) {
                 return prv_key;
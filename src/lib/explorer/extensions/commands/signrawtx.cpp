@@ -135,7 +135,7 @@ console_result signrawtx::invoke(Json::Value& jv_output,
                             continue;
                         }
 
-                        std::string prv_key_str = acc_addr->get_prv_key(auth_.auth);;
+                        std::string prv_key_str = blockchain.get_account_prv_key(auth_.name, auth_.auth, *acc_addr);
 
                         data_chunk public_key_data;
                         bc::endorsement&& edsig = sign(prv_key_str, tx_, index, config_contract, public_key_data);
@@ -206,7 +206,7 @@ std::string signrawtx::get_private_key(blockchain::block_chain_impl& blockchain,
         throw argument_legality_exception{"Address " + address + " is not owned."};
     }
 
-    return acc_addr->get_prv_key(auth_.auth);
+    return blockchain.get_account_prv_key(auth_.name, auth_.auth, *acc_addr);
 }
 
 chain::script signrawtx::get_prev_output_script(
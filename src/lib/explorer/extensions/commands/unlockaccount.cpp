@@ -0,0 +1,57 @@
+/**
+ * Copyright (c) 2016-2018 mvs developers
+ *
+ * This file is part of metaverse-explorer.
+ *
+ * metaverse-explorer is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <metaverse/explorer/json_helper.hpp>
+#include <metaverse/explorer/extensions/commands/unlockaccount.hpp>
+#include <metaverse/explorer/extensions/command_extension_func.hpp>
+#include <metaverse/explorer/extensions/exception.hpp>
+
+namespace libbitcoin {
+namespace explorer {
+namespace commands {
+
+
+/************************ unlockaccount *************************/
+
+console_result unlockaccount::invoke(Json::Value& jv_output,
+    libbitcoin::server::server_node& node)
+{
+    auto& blockchain = node.chain_impl();
+
+    if (option_.duration == 0) {
+        throw argument_legality_exception{"duration parameter cannot be zero"};
+    }
+
+    // decrypts every address key once, signing reuses them until expiry.
+    const auto seconds = blockchain.unlock_account(auth_.name, auth_.auth,
+        option_.duration);
+
+    jv_output["name"] = auth_.name;
+    jv_output["unlocked_seconds"] = seconds;
+
+    return console_result::okay;
+}
+
+
+} // namespace commands
+} // namespace explorer
+} // namespace libbitcoin
+
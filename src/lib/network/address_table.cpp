@@ -0,0 +1,231 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/network/address_table.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <boost/functional/hash.hpp>
+#include <metaverse/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+const size_t address_table::bucket_size = 16;
+
+// Random draws before select falls back to a scan.
+static constexpr size_t max_draws = 64;
+
+// Failures beyond this no longer lower the selection chance.
+static constexpr uint32_t max_penalty = 8;
+
+bool address_table::key::operator==(const key& other) const
+{
+    return port == other.port && ip == other.ip;
+}
+
+size_t address_table::key_hash::operator()(const key& value) const
+{
+    auto seed = boost::hash_range(value.ip.begin(), value.ip.end());
+    boost::hash_combine(seed, value.port);
+    return seed;
+}
+
+address_table::address_table(size_t capacity)
+  : capacity_(std::max<size_t>(capacity, 1)),
+    salt_(pseudo_random::next()),
+    size_(0),
+    buckets_((capacity_ + bucket_size - 1) / bucket_size)
+{
+    index_.reserve(capacity_);
+}
+
+address_table::key address_table::to_key(const address& host)
+{
+    return { host.ip, host.port };
+}
+
+size_t address_table::bucket_of(const address& host) const
+{
+    // IPv4 mapped addresses carry the address in the last four bytes.
+    const auto begin = host.is_ipv4() ? host.ip.begin() + 12 : host.ip.begin();
+    const auto end = begin + (host.is_ipv4() ? 2 : 4);
+
+    size_t seed = static_cast<size_t>(salt_);
+    boost::hash_combine(seed, boost::hash_range(begin, end));
+    return seed % buckets_.size();
+}
+
+size_t address_table::size() const
+{
+    return size_;
+}
+
+size_t address_table::capacity() const
+{
+    return capacity_;
+}
+
+bool address_table::empty() const
+{
+    return size_ == 0;
+}
+
+bool address_table::full() const
+{
+    return size_ >= capacity_;
+}
+
+bool address_table::contains(const address& host) const
+{
+    return index_.find(to_key(host)) != index_.end();
+}
+
+address_table::entry* address_table::find(const address& host)
+{
+    const auto it = index_.find(to_key(host));
+    if (it == index_.end())
+        return nullptr;
+
+    return &buckets_[it->second.bucket][it->second.slot];
+}
+
+bool address_table::insert(const address& host)
+{
+    return insert(entry{ host, 0, 0, 0 });
+}
+
+bool address_table::insert(const entry& item)
+{
+    const auto host_key = to_key(item.host);
+    if (index_.find(host_key) != index_.end())
+        return false;
+
+    const auto bucket = bucket_of(item.host);
+    auto& slots = buckets_[bucket];
+
+    // A full bucket (or table) makes room from its own entries, so one
+    // network group cannot push out the others.
+    if (slots.size() >= bucket_size || full())
+    {
+        if (slots.empty())
+            return false;
+
+        const auto victim = static_cast<size_t>(
+            pseudo_random::next(0, slots.size() - 1));
+        erase({ bucket, victim });
+    }
+
+    index_[host_key] = { bucket, slots.size() };
+    slots.push_back(item);
+    ++size_;
+    return true;
+}
+
+void address_table::erase(const position& at)
+{
+    auto& slots = buckets_[at.bucket];
+    index_.erase(to_key(slots[at.slot].host));
+
+    // Swap with the last slot to keep removal constant time.
+    if (at.slot != slots.size() - 1)
+    {
+        slots[at.slot] = std::move(slots.back());
+        index_[to_key(slots[at.slot].host)] = at;
+    }
+
+    slots.pop_back();
+    --size_;
+}
+
+bool address_table::remove(const address& host)
+{
+    const auto it = index_.find(to_key(host));
+    if (it == index_.end())
+        return false;
+
+    erase(it->second);
+    return true;
+}
+
+void address_table::clear()
+{
+    for (auto& slots: buckets_)
+        slots.clear();
+
+    index_.clear();
+    size_ = 0;
+}
+
+address_table::entry* address_table::select(filter accept)
+{
+    if (empty())
+        return nullptr;
+
+    const auto last_bucket = buckets_.size() - 1;
+    for (size_t draw = 0; draw < max_draws; ++draw)
+    {
+        auto& slots = buckets_[pseudo_random::next(0, last_bucket)];
+        if (slots.empty())
+            continue;
+
+        auto& item = slots[pseudo_random::next(0, slots.size() - 1)];
+        if (!accept(item.host))
+            continue;
+
+        // After n failures since the last success the chance is 1/(n+1).
+        const auto penalty = std::min(item.attempts, max_penalty);
+        if (penalty != 0 && pseudo_random::next(0, penalty) != 0)
+            continue;
+
+        return &item;
+    }
+
+    // Sparse or mostly filtered tables, fall back to a scan. It starts at a
+    // random bucket and slot so that it does not keep returning the same
+    // acceptable entry.
+    const auto first_bucket = pseudo_random::next(0, last_bucket);
+    for (size_t step = 0; step < buckets_.size(); ++step)
+    {
+        auto& slots = buckets_[(first_bucket + step) % buckets_.size()];
+        if (slots.empty())
+            continue;
+
+        const auto first_slot = pseudo_random::next(0, slots.size() - 1);
+        for (size_t slot = 0; slot < slots.size(); ++slot)
+        {
+            auto& item = slots[(first_slot + slot) % slots.size()];
+            if (accept(item.host))
+                return &item;
+        }
+    }
+
+    return nullptr;
+}
+
+void address_table::for_each(std::function<void(const entry&)> visit) const
+{
+    for (const auto& slots: buckets_)
+        for (const auto& item: slots)
+            visit(item);
+}
+
+} // namespace network
+} // namespace libbitcoin
@@ -23,6 +23,7 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <ctime>
 #include <string>
 #include <vector>
 #include <metaverse/bitcoin.hpp>
@@ -36,6 +37,17 @@ namespace network {
 
 uint32_t timer_interval = 60 * 5; // 5 minutes
 
+// hosts.cache layout: magic, version, count, then per address its wire
+// serialization (with timestamp) and the attempts, last attempt and last
+// success counters.
+static constexpr uint32_t cache_magic = 0x4853564d; // "MVSH"
+static constexpr uint8_t cache_version = 1;
+static constexpr uint32_t cache_address_version = 0;
+
+static uint32_t now()
+{
+    return static_cast<uint32_t>(std::time(nullptr));
+}
 
 hosts::hosts(threadpool& pool, const settings& settings)
     : seed_count(settings.seeds.size())
@@ -45,28 +57,14 @@ hosts::hosts(threadpool& pool, const settings& settings)
     , inactive_(host_pool_capacity_ * 2)
     , seeds_()
     , stopped_(true)
-    , file_path_(default_data_path() / settings.hosts_file)
+    , file_path_(settings.hosts_file.is_absolute() ? settings.hosts_file :
+        default_data_path() / settings.hosts_file)
     , disabled_(settings.host_pool_capacity == 0)
     , pool_(pool)
     , self_(settings.self)
 {
 }
 
-// private
-hosts::iterator hosts::find(const address& host)
-{
-    return find(buffer_, host);
-}
-
-hosts::iterator hosts::find(list& buffer, const address& host)
-{
-    const auto found = [&host](const address & entry)
-    {
-        return entry.port == host.port && entry.ip == host.ip;
-    };
-    return std::find_if(buffer.begin(), buffer.end(), found);
-}
-
 size_t hosts::count() const
 {
     ///////////////////////////////////////////////////////////////////////////
@@ -79,46 +77,69 @@ size_t hosts::count() const
 
 code hosts::fetch_seed(address& out, const config::authority::list& excluded_list)
 {
-    return fetch(seeds_, out, excluded_list);
-}
+    if (disabled_) {
+        return error::not_found;
+    }
 
-code hosts::fetch(address& out, const config::authority::list& excluded_list)
-{
-    return fetch(buffer_, out, excluded_list);
+    // Critical Section
+    shared_lock lock(mutex_);
+
+    if (stopped_) {
+        return error::service_stopped;
+    }
+
+    // There are at most a few seeds, a copy is fine here.
+    auto match = [&excluded_list](const address& addr) {
+        auto auth = config::authority(addr);
+        return std::find(excluded_list.begin(), excluded_list.end(), auth) == excluded_list.end();
+    };
+
+    address::list vec;
+    std::copy_if(seeds_.begin(), seeds_.end(), std::back_inserter(vec), match);
+
+    if (vec.empty()) {
+        return error::not_found;
+    }
+
+    const auto index = pseudo_random(0, vec.size() - 1);
+    out = vec[static_cast<size_t>(index)];
+
+    return error::success;
 }
 
-template <typename T>
-code hosts::fetch(T& buffer, address& out, const config::authority::list& excluded_list)
+code hosts::fetch(address& out, const config::authority::list& excluded_list)
 {
     if (disabled_) {
         return error::not_found;
     }
 
     // Critical Section
-    shared_lock lock(mutex_);
+    upgrade_lock lock(mutex_);
 
     if (stopped_) {
         return error::service_stopped;
     }
 
-    if (buffer.empty()) {
+    if (buffer_.empty()) {
         return error::not_found;
     }
 
-    auto match = [&excluded_list](address& addr) {
+    auto match = [&excluded_list](const address& addr) {
         auto auth = config::authority(addr);
         return std::find(excluded_list.begin(), excluded_list.end(), auth) == excluded_list.end();
     };
 
-    std::vector<address> vec;
-    std::copy_if(buffer.begin(), buffer.end(), std::back_inserter(vec), match);
+    upgrade_to_unique_lock unq_lock(lock);
 
-    if (vec.empty()) {
+    auto entry = buffer_.select(match);
+    if (entry == nullptr) {
         return error::not_found;
     }
 
-    const auto index = pseudo_random(0, vec.size() - 1);
-    out = vec[static_cast<size_t>(index)];
+    // The caller connects to it, count the attempt until it succeeds.
+    ++entry->attempts;
+    entry->last_attempt = now();
+    out = entry->host;
 
     return error::success;
 }
@@ -137,7 +158,7 @@ hosts::address::list hosts::copy()
     if (disabled_)
         return address::list();
 
-    shared_lock lock{mutex_};
+    upgrade_lock lock{mutex_};
 
     if (stopped_ || buffer_.empty())
         return address::list();
@@ -146,42 +167,78 @@ hosts::address::list hosts::copy()
     const auto out_count = std::max<size_t>(1,
         std::min<size_t>(1000, buffer_.size()) / pseudo_random(5, 10));
 
-    const auto limit = buffer_.size();
-    auto index = pseudo_random(0, limit - 1);
+    const auto any = [](const address&) { return true; };
+
+    upgrade_to_unique_lock unq_lock(lock);
 
-    address::list copy(out_count);
+    address::list copy;
+    copy.reserve(out_count);
 
-    for (size_t count = 0; count < out_count; ++count)
-        copy.push_back(buffer_[index++ % limit]);
+    for (size_t count = 0; count < out_count; ++count) {
+        const auto entry = buffer_.select(any);
+        if (entry != nullptr) {
+            copy.push_back(entry->host);
+        }
+    }
 
-    pseudo_random::shuffle(copy);
     return copy;
 }
 
 bool hosts::store_cache(bool succeed_clear_buffer)
 {
     if (!buffer_.empty()) {
-        bc::ofstream file(file_path_.string());
-        const auto file_error = file.bad();
+        // Write aside and rename, a crash never leaves a torn cache.
+        const auto temp_path = file_path_.string() + ".tmp";
 
-        if (file_error) {
-            log::error(LOG_NETWORK) << "hosts file (" << file_path_.string() << ") open failed" ;
-            return false;
-        }
+        {
+            bc::ofstream file(temp_path, std::ofstream::binary | std::ofstream::trunc);
+            const auto file_error = file.bad();
 
-        log::debug(LOG_NETWORK)
-                << "sync hosts to file(" << file_path_.string()
-                << "), inactive size is " << inactive_.size()
-                << ", buffer size is " << buffer_.size();
+            if (file_error) {
+                log::error(LOG_NETWORK) << "hosts file (" << file_path_.string() << ") open failed" ;
+                return false;
+            }
+
+            log::debug(LOG_NETWORK)
+                    << "sync hosts to file(" << file_path_.string()
+                    << "), inactive size is " << inactive_.size()
+                    << ", buffer size is " << buffer_.size();
 
-        for (const auto& entry : buffer_) {
-            // TODO: create full space-delimited network_address serialization.
-            // Use to/from string format as opposed to wire serialization.
-            if (!(channel::blacklisted(entry) || channel::manualbanned(entry))) {
-                file << config::authority(entry) << std::endl;
+            address_table::list entries;
+            entries.reserve(buffer_.size());
+            buffer_.for_each([&entries](const address_table::entry& entry) {
+                if (!(channel::blacklisted(entry.host) || channel::manualbanned(entry.host))) {
+                    entries.push_back(entry);
+                }
+            });
+
+            ostream_writer sink(file);
+            sink.write_4_bytes_little_endian(cache_magic);
+            sink.write_byte(cache_version);
+            sink.write_variable_uint_little_endian(entries.size());
+
+            for (const auto& entry : entries) {
+                entry.host.to_data(cache_address_version, sink, true);
+                sink.write_4_bytes_little_endian(entry.attempts);
+                sink.write_4_bytes_little_endian(entry.last_attempt);
+                sink.write_4_bytes_little_endian(entry.last_success);
+            }
+
+            file.flush();
+            if (!sink || file.bad()) {
+                log::error(LOG_NETWORK) << "hosts file (" << temp_path << ") write failed" ;
+                return false;
             }
         }
 
+        boost::system::error_code ec;
+        boost::filesystem::rename(temp_path, file_path_, ec);
+        if (ec) {
+            log::error(LOG_NETWORK) << "hosts file (" << file_path_.string()
+                << ") replace failed, " << ec.message();
+            return false;
+        }
+
         if (succeed_clear_buffer) {
             buffer_.clear();
         }
@@ -195,6 +252,77 @@ bool hosts::store_cache(bool succeed_clear_buffer)
     return true;
 }
 
+bool hosts::load_cache()
+{
+    bc::ifstream file(file_path_.string(), std::ifstream::binary);
+    if (file.bad()) {
+        return false;
+    }
+
+    istream_reader source(file);
+    const auto magic = source.read_4_bytes_little_endian();
+    if (!source || magic != cache_magic) {
+        // Missing file or the former text format.
+        file.close();
+        return load_text_cache();
+    }
+
+    const auto version = source.read_byte();
+    if (version != cache_version) {
+        log::debug(LOG_NETWORK) << "hosts file version " << int(version)
+            << " is not supported, starting empty.";
+        return true;
+    }
+
+    const auto count = source.read_variable_uint_little_endian();
+    for (uint64_t index = 0; index < count && source && !buffer_.full(); ++index) {
+        address_table::entry entry;
+        const auto valid = entry.host.from_data(cache_address_version, source, true);
+        entry.attempts = source.read_4_bytes_little_endian();
+        entry.last_attempt = source.read_4_bytes_little_endian();
+        entry.last_success = source.read_4_bytes_little_endian();
+
+        if (!valid || !source) {
+            log::debug(LOG_NETWORK) << "hosts file is truncated at entry " << index;
+            break;
+        }
+
+        if (entry.host.port != 0 && entry.host.is_routable()) {
+            buffer_.insert(entry);
+        }
+    }
+
+    return true;
+}
+
+bool hosts::load_text_cache()
+{
+    bc::ifstream file(file_path_.string());
+    const auto file_error = file.bad();
+    if (!file_error) {
+        std::string line;
+        while (std::getline(file, line)) {
+            config::authority host(line);
+
+            if (host.port() != 0) {
+                auto network_address = host.to_network_address();
+                if (network_address.is_routable()) {
+                    buffer_.insert(network_address);
+                    if (buffer_.full()) {
+                        break;
+                    }
+                }
+                else {
+                    log::debug(LOG_NETWORK) << "host start is not routable,"
+                        << config::authority{network_address};
+                }
+            }
+        }
+    }
+
+    return !file_error;
+}
+
 void hosts::handle_timer(const code& ec)
 {
     if (disabled_) {
@@ -244,32 +372,9 @@ code hosts::start()
 
     stopped_ = false;
 
-    bc::ifstream file(file_path_.string());
-    const auto file_error = file.bad();
-    if (!file_error) {
-        std::string line;
-        while (std::getline(file, line)) {
-            config::authority host(line);
-
-            if (host.port() != 0) {
-                auto network_address = host.to_network_address();
-                if (network_address.is_routable()) {
-                    buffer_.push_back(network_address);
-                    if (buffer_.full()) {
-                        break;
-                    }
-                }
-                else {
-                    log::debug(LOG_NETWORK) << "host start is not routable,"
-                        << config::authority{network_address};
-                }
-            }
-        }
-    }
-
-    if (file_error) {
+    if (!load_cache()) {
         log::debug(LOG_NETWORK)
-                << "Failed to save hosts file.";
+                << "Failed to load hosts file.";
         return error::file_system;
     }
 
@@ -322,7 +427,9 @@ code hosts::clear()
 
     if (!buffer_.empty()) {
         backup_.clear();
-        std::copy(buffer_.begin(), buffer_.end(), std::back_inserter(backup_));
+        buffer_.for_each([this](const address_table::entry& entry) {
+            backup_.insert(entry);
+        });
         buffer_.clear();
     }
 
@@ -351,26 +458,17 @@ code hosts::after_reseeding()
                 << ", less than seed count: " << seed_count
                 << ", roll back the hosts cache.";
 
-        if (!buffer_.full()) {
-            for (auto& host : backup_) {
-                if (find(host) == buffer_.end()) {
-                    buffer_.push_back(host);
-
-                    if (buffer_.full()) {
-                        break;
-                    }
-                }
+        backup_.for_each([this](const address_table::entry& entry) {
+            if (!buffer_.full()) {
+                buffer_.insert(entry);
             }
-        }
+        });
     }
     else {
         // filter inactive hosts
-        for (auto &host : inactive_) {
-            auto iter = find(host);
-            if (iter != buffer_.end()) {
-                buffer_.erase(iter);
-            }
-        }
+        inactive_.for_each([this](const address_table::entry& entry) {
+            buffer_.remove(entry.host);
+        });
     }
 
     // clear the backup
@@ -397,14 +495,8 @@ code hosts::remove(const address& host)
 
     upgrade_to_unique_lock unq_lock(lock);
 
-    auto it = find(host);
-    if (it != buffer_.end()) {
-        buffer_.erase(it);
-    }
-
-    if (find(inactive_, host) == inactive_.end()) {
-        inactive_.push_back(host);
-    }
+    buffer_.remove(host);
+    inactive_.insert(host);
 
     return error::success;
 }
@@ -475,6 +567,16 @@ code hosts::remove_seed(const address& host)
 }
 
 code hosts::store(const address& host)
+{
+    return do_store(host, false);
+}
+
+code hosts::store_connected(const address& host)
+{
+    return do_store(host, true);
+}
+
+code hosts::do_store(const address& host, bool connected)
 {
     if (disabled_) {
         return error::success;
@@ -505,15 +607,20 @@ code hosts::store(const address& host)
 
     upgrade_to_unique_lock unq_lock(lock);
 
-    if (find(host) == buffer_.end()) {
-        buffer_.push_back(host);
+    // Only a completed connection counts as a success, addnode and seeds
+    // store addresses nobody has connected to yet.
+    const auto success = connected ? now() : 0;
+    auto entry = buffer_.find(host);
+    if (entry == nullptr) {
+        buffer_.insert(address_table::entry{ host, 0, 0, success });
     }
-
-    auto iter = find(inactive_, host);
-    if (iter != inactive_.end()) {
-        inactive_.erase(iter);
+    else if (connected) {
+        entry->attempts = 0;
+        entry->last_success = success;
     }
 
+    inactive_.remove(host);
+
     return error::success;
 }
 
@@ -570,10 +677,8 @@ void hosts::store(const address::list& hosts, result_handler handler)
             }
 
             // Do not allow duplicates in the host cache.
-            if (find(host) == buffer_.end()
-                    && find(inactive_, host) == inactive_.end()) {
+            if (!inactive_.contains(host) && buffer_.insert(host)) {
                 ++accepted;
-                buffer_.push_back(host);
             }
         }
 
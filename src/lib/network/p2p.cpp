@@ -449,6 +449,11 @@ void p2p::store(const address& address, result_handler handler)
     handler(hosts_->store(address));
 }
 
+void p2p::store_connected(const address& address, result_handler handler)
+{
+    handler(hosts_->store_connected(address));
+}
+
 void p2p::store(const address::list& addresses, result_handler handler)
 {
     // Store is invoked on a new thread.
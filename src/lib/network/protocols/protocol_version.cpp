@@ -57,7 +57,7 @@ message::version protocol_version::version_factory(
 
     // TODO: move services to authority member in base protocol (passed in).
     auto self = authority.to_network_address();
-    self.services = services::node_network;
+    self.services = settings.services;
 
     return
     {
@@ -36,50 +36,30 @@
 namespace libbitcoin {
 namespace network {
 
-#ifndef NDEBUG
-class traffic{
-public:
-    static traffic& instance();
-
-    void rx(uint64_t bytes){
-        rx_.fetch_add(bytes);
-    }
-
-    void tx(uint64_t bytes){
-        tx_.fetch_add(bytes);
-    }
-
-    ~traffic(){
-        auto now = std::chrono::system_clock::now();
-        std::cout << "it costs " << std::chrono::duration_cast<std::chrono::seconds>(now - start_time_).count() << " seconds, rx," << rx_.load() << ", tx," << tx_.load() << std::endl;
-    }
-private:
-    static boost::detail::spinlock spinlock_;
-    static std::shared_ptr<traffic> instance_;
-    traffic():rx_{0}, tx_{0}, start_time_{std::chrono::system_clock::now()}
-    {
-    }
+// Traffic of all channels, kept in every build for the metrics endpoint.
+static metrics::counter& received_bytes()
+{
+    static auto& counter = metrics::instance().make_counter(
+        "mvs_network_received_bytes_total", "Bytes read from peers.");
+    return counter;
+}
 
-private:
-    std::atomic<uint64_t> rx_;
-    std::atomic<uint64_t> tx_;
-    std::chrono::system_clock::time_point start_time_;
-};
-traffic& traffic::instance(){
-    if (instance_ == nullptr) {
-        boost::detail::spinlock::scoped_lock guard{spinlock_};
-        if (instance_ == nullptr) {
-            instance_.reset(new traffic{});
-        }
-    }
-    return *instance_;
+static metrics::counter& sent_bytes()
+{
+    static auto& counter = metrics::instance().make_counter(
+        "mvs_network_sent_bytes_total", "Bytes written to peers.");
+    return counter;
 }
-boost::detail::spinlock traffic::spinlock_;
-std::shared_ptr<traffic> traffic::instance_ = nullptr;
-#endif
 
 #define NAME "proxy"
 
+// Queued messages of both lanes beyond which a peer is dropped.
+static constexpr size_t max_send_backlog = 2000;
+
+// Upper bounds of a single gathered write.
+static constexpr size_t max_batch_messages = 64;
+static constexpr size_t max_batch_bytes = 4 * 1024 * 1024;
+
 using namespace message;
 using namespace std::placeholders;
 
@@ -96,7 +76,7 @@ proxy::proxy(threadpool& pool, socket::ptr socket, uint32_t protocol_magic,
     peer_protocol_version_(message::version::level::maximum),
     message_subscriber_(pool),
     stop_subscriber_(std::make_shared<stop_subscriber>(pool, NAME)),
-    has_sent_{true},
+    sending_(false),
     misbehaving_{0}
 {
 }
@@ -191,9 +171,8 @@ void proxy::handle_read_heading(const boost_code& ec, size_t)
         stop(ec);
         return;
     }
-#ifndef NDEBUG
-    traffic::instance().rx(heading_buffer_.size());
-#endif
+
+    received_bytes().increment(heading_buffer_.size());
     const auto head = heading::factory_from_data(heading_buffer_);
 
     if (!head.is_valid())
@@ -263,9 +242,7 @@ void proxy::handle_read_payload(const boost_code& ec, size_t payload_size,
         return;
     }
 
-#ifndef NDEBUG
-    traffic::instance().rx(payload_buffer_.size());
-#endif
+    received_bytes().increment(payload_buffer_.size());
 
     auto checksum = bitcoin_checksum(payload_buffer_);
     if (head.checksum != checksum)
@@ -328,6 +305,20 @@ void proxy::handle_request(data_chunk payload_buffer, uint32_t peer_protocol_ver
 // Message send sequence.
 // ----------------------------------------------------------------------------
 
+// Block and header replies (and the small control messages) go out ahead of
+// queued inventory, addresses and transactions.
+bool proxy::is_priority(const std::string& command)
+{
+    return command == block_message::command
+        || command == headers::command
+        || command == merkle_block::command
+        || command == not_found::command
+        || command == ping::command
+        || command == pong::command
+        || command == version::command
+        || command == verack::command;
+}
+
 void proxy::do_send(const std::string& command, const_buffer buffer,
     result_handler handler)
 {
@@ -337,111 +328,104 @@ void proxy::do_send(const std::string& command, const_buffer buffer,
         return;
     }
 
-    if (command == "headers") {
-        log::trace(LOG_NETWORK) << "";
-    }
-
     //thin log network
     log::trace(LOG_NETWORK)
         << "Sending " << command << " to [" << authority() << "] ("
         << buffer.size() << " bytes)";
 
-    // Critical Section (protect socket)
+    size_t backlog = 0;
+
+    // Critical Section (protect socket and lanes)
     ///////////////////////////////////////////////////////////////////////////
-    // The socket is locked until async_write returns.
-#define QUEUE_REQUEST
-#ifdef QUEUE_REQUEST
-    bool is_ok_to_send{false};
-    uint32_t outbound_size{0};
-    request_callback h{nullptr};
     {
-        auto pThis = shared_from_this();
-        auto f = [this, pThis, buffer, handler](){
-            if (stopped())
-            {
-                handler(error::channel_stopped);
-                return;
-            }
-            const auto socket = socket_->get_socket();
-            auto& native_socket = socket->get();
-            async_write(native_socket, buffer,
-                    std::bind(&proxy::handle_send,
-                            shared_from_this(), _1, buffer, handler));
-        };
         const auto socket = socket_->get_socket();
-        outbound_size = outbound_queue_.size();
-        bool is_empty{outbound_queue_.empty()};
-        bool in_sending{!has_sent_.load()};
-        is_ok_to_send = (is_empty && !in_sending);
-        if (is_ok_to_send)
-        {
-            h = std::move(f);
-            has_sent_.store(false);
-        }
-        else{
-            outbound_queue_.push(std::move(f));
-        }
+
+        auto& lane = is_priority(command) ? priority_lane_ : bulk_lane_;
+        lane.push_back({ buffer, handler });
+        backlog = priority_lane_.size() + bulk_lane_.size();
+
+        // A write in progress picks the message up when it completes.
+        if (!sending_ && backlog <= max_send_backlog)
+            write_batch(socket);
     }
+    ///////////////////////////////////////////////////////////////////////////
 
-    if (outbound_size > 500) {
+    // A peer that does not drain its sends is dropped, whichever lane the
+    // requests it keeps making land in.
+    if (backlog > max_send_backlog)
         stop(error::size_limits);
+}
+
+// The socket lock must be held by the caller.
+void proxy::write_batch(locked_socket::ptr socket)
+{
+    if (priority_lane_.empty() && bulk_lane_.empty())
+    {
+        sending_ = false;
         return;
     }
 
-    if (is_ok_to_send)
+    const auto batch = std::make_shared<send_batch>();
+    std::vector<asio::const_buffer> buffers;
+    size_t bytes = 0;
+
+    const auto take = [&](send_lane& lane)
     {
-        h();
-    }
-#else
-    const auto socket = socket_->get_socket();
+        while (!lane.empty() && batch->size() < max_batch_messages &&
+            (batch->empty() || bytes + lane.front().buffer.size() <=
+                max_batch_bytes))
+        {
+            bytes += lane.front().buffer.size();
+            buffers.insert(buffers.end(), lane.front().buffer.begin(),
+                lane.front().buffer.end());
+            batch->push_back(std::move(lane.front()));
+            lane.pop_front();
+        }
+    };
 
-    // The shared buffer is kept in scope until the handler is invoked.
-    using namespace boost::asio;
-    async_write(socket->get(), buffer,
+    take(priority_lane_);
+    take(bulk_lane_);
+    sending_ = true;
+
+    log::trace(LOG_NETWORK)
+        << "Writing " << batch->size() << " messages to [" << authority()
+        << "] (" << bytes << " bytes)";
+
+    // The batch holds the shared buffers until the handler is invoked.
+    async_write(socket->get(), buffers,
         std::bind(&proxy::handle_send,
-            shared_from_this(), _1, buffer, handler));
-#endif
-    // The shared buffer is kept in scope until the handler is invoked.
-    ///////////////////////////////////////////////////////////////////////////
+            shared_from_this(), _1, _2, batch));
 }
 
-void proxy::handle_send(const boost_code& ec, const_buffer buffer,
-    result_handler handler)
+void proxy::handle_send(const boost_code& ec, size_t bytes,
+    send_batch_ptr batch)
 {
     const auto error = code(error::boost_to_error_code(ec));
 
     if (error)
         log::trace(LOG_NETWORK)
-            << "Failure sending " << buffer.size() << " byte message to ["
+            << "Failure sending " << batch->size() << " messages to ["
             << authority() << "] " << error.message();
-    else{
-#ifndef NDEBUG
-        traffic::instance().tx(buffer.size());
-#endif
-    }
+    else
+        sent_bytes().increment(bytes);
 
-    handler(error);
-#ifdef QUEUE_REQUEST
-    if(error){
-        const auto socket = socket_->get_socket();
-        std::queue<request_callback>{}.swap(outbound_queue_);
-        return;
-    }
+    for (const auto& message: *batch)
+        message.handler(error);
 
-    has_sent_.store(true);
+    // Critical Section (protect socket and lanes)
+    ///////////////////////////////////////////////////////////////////////////
+    const auto socket = socket_->get_socket();
 
-    request_callback h{nullptr};
+    if (error || stopped())
     {
-        const auto socket = socket_->get_socket();
-        if(outbound_queue_.empty())
-            return;
-        log::trace(LOG_NETWORK) << "channel:" << reinterpret_cast<int64_t>(this) << " outbound size," << outbound_queue_.size();
-        h = std::move(outbound_queue_.front());
-        outbound_queue_.pop();
-        has_sent_.store(false);
+        priority_lane_.clear();
+        bulk_lane_.clear();
+        sending_ = false;
+        return;
     }
-    h();
-#endif
+
+    write_batch(socket);
+    ///////////////////////////////////////////////////////////////////////////
 }
 
 // Stop sequence.
@@ -469,7 +453,8 @@ void proxy::stop(const code& ec)
     handle_stopping();
     {
         const auto socket = socket_->get_socket();
-        std::queue<request_callback>{}.swap(outbound_queue_);
+        priority_lane_.clear();
+        bulk_lane_.clear();
     }
 
     // The socket_ is internally guarded against concurrent use.
@@ -40,6 +40,15 @@ namespace network {
 
 #define NAME "session"
 
+static metrics::gauge& channel_count(bool incoming)
+{
+    static auto& inbound = metrics::instance().make_gauge(
+        "mvs_network_inbound_channels", "Started inbound peer channels.");
+    static auto& outbound = metrics::instance().make_gauge(
+        "mvs_network_outbound_channels", "Started outbound peer channels.");
+    return incoming ? inbound : outbound;
+}
+
 // Base class binders.
 #define BIND_0(method) \
     base_bind(&session::method)
@@ -119,7 +128,7 @@ void session::remove(const message::network_address& address, result_handler han
 
 void session::store(const message::network_address& address)
 {
-    network_.store(address, [](const code&){});
+    network_.store_connected(address, [](const code&){});
 }
 
 // Socket creators.
@@ -276,6 +285,11 @@ void session::handle_handshake(const code& ec, channel::ptr channel,
 {
     if (ec)
     {
+        static auto& failures = metrics::instance().make_counter(
+            "mvs_network_handshake_failures_total",
+            "Peer handshakes that failed.");
+        failures.increment();
+
         log::trace(LOG_NETWORK)
             << "Failure in handshake with [" << channel->authority()
             << "] " << ec.message();
@@ -330,13 +344,22 @@ void session::handle_start(const code& ec, channel::ptr channel,
     }
     else
     {
-        channel->subscribe_stop(handle_stopped);
+        channel_count(incoming_).add(1);
+        channel->subscribe_stop(
+            BIND_2(handle_channel_stop, _1, handle_stopped));
     }
 
     // This is the end of the registration sequence.
     handle_started(ec);
 }
 
+void session::handle_channel_stop(const code& ec,
+    result_handler handle_stopped)
+{
+    channel_count(incoming_).add(-1);
+    handle_stopped(ec);
+}
+
 void session::do_unpend(const code& ec, channel::ptr channel,
     result_handler handle_started)
 {
@@ -42,6 +42,7 @@ settings::settings()
     channel_expiration_minutes(1440),
     channel_germination_seconds(30),
     host_pool_capacity(1000),
+    services(services::node_network),
     relay_transactions(true),
     enable_re_seeding(true),
     upnp_map_port(true),
@@ -52,6 +52,8 @@ configuration::configuration(const configuration& other)
     use_testnet_rules{other.use_testnet_rules},
     upnp_map_port{other.upnp_map_port},
     file(other.file),
+    export_snapshot(other.export_snapshot),
+    import_snapshot(other.import_snapshot),
     node(other.node),
     chain(other.chain),
     database(other.database),
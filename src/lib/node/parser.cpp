@@ -281,6 +281,11 @@ options_metadata parser::load_settings()
         value<uint32_t>(&configured.database.stealth_start_height),
         "The lower limit of stealth indexing, defaults to 500000."
     )
+    (
+        "database.prune_depth",
+        value<uint32_t>(&configured.database.prune_depth),
+        "The number of recent blocks for which spent history and transactions are kept, defaults to 0 (no pruning)."
+    )
     (
         "database.directory",
         value<path>(&configured.database.directory),
@@ -308,6 +313,16 @@ options_metadata parser::load_settings()
         value<bool>(&configured.chain.use_testnet_rules),
         "Use testnet rules for determination of work required, defaults to false."
     )
+    (
+        "blockchain.block_trace_threshold_ms",
+        value<uint32_t>(&configured.chain.block_trace_threshold_ms),
+        "Write a trace of any block that takes longer than this to process, defaults to 0 (disabled)."
+    )
+    (
+        "blockchain.block_trace_directory",
+        value<path>(&configured.chain.block_trace_directory),
+        "The directory for slow block traces, defaults to 'block-trace'."
+    )
     (
         "blockchain.checkpoint",
         value<config::checkpoint::list>(&configured.chain.checkpoints),
@@ -360,6 +375,11 @@ bool parser::parse(int argc, const char* argv[], std::ostream& error)
         // Update bound variables in metadata.settings.
         notify(variables);
 
+        // A pruned node does not serve the full block chain.
+        if (configured.database.prune_depth != 0)
+            configured.network.services &=
+                ~static_cast<uint64_t>(services::node_network);
+
         // Clear the config file path if it wasn't used.
         if (!file)
             configured.file.clear();
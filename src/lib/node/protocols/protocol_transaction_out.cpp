@@ -20,6 +20,7 @@
  */
 #include <metaverse/node/protocols/protocol_transaction_out.hpp>
 
+#include <algorithm>
 #include <cstddef>
 #include <functional>
 #include <memory>
@@ -36,9 +37,18 @@ using namespace bc::message;
 using namespace bc::network;
 using namespace std::placeholders;
 
+static constexpr auto perpetual_timer = true;
+
+// Each peer flushes at its own period, between half and all of this.
+static const auto trickle_interval = asio::seconds(2);
+
+// Announcements per inventory message, and hashes remembered per generation.
+static constexpr size_t max_announcements = 50000;
+static constexpr size_t max_known = 50000;
+
 protocol_transaction_out::protocol_transaction_out(p2p& network,
     channel::ptr channel, block_chain& blockchain, transaction_pool& pool)
-  : protocol_events(network, channel, NAME),
+  : protocol_timer(network, channel, perpetual_timer, NAME),
     blockchain_(blockchain),
     pool_(pool),
 
@@ -56,7 +66,9 @@ protocol_transaction_out::ptr protocol_transaction_out::do_subscribe()
     SUBSCRIBE2(memory_pool, handle_receive_memory_pool, _1, _2);
     SUBSCRIBE2(fee_filter, handle_receive_fee_filter, _1, _2);
     SUBSCRIBE2(get_data, handle_receive_get_data, _1, _2);
-    protocol_events::start(BIND1(handle_stop, _1));
+    SUBSCRIBE2(inventory, handle_receive_inventory, _1, _2);
+    protocol_timer::start(pseudo_randomize(trickle_interval),
+        BIND1(send_inventory, _1));
     return std::dynamic_pointer_cast<protocol_transaction_out>(protocol::shared_from_this());
 }
 
@@ -83,6 +95,104 @@ void protocol_transaction_out::start()
 
 }
 
+// Send inventory sequence.
+//-----------------------------------------------------------------------------
+
+// This is fired by the callback (i.e. base timer and stop handler).
+void protocol_transaction_out::send_inventory(const code& ec)
+{
+    if (stopped(ec))
+    {
+        log::trace(LOG_NETWORK)
+            << "Stopped transaction_out protocol";
+        pool_.fired();
+        return;
+    }
+
+    if (ec && ec.value() != error::channel_timeout)
+    {
+        log::trace(LOG_NODE)
+            << "Failure in transaction timer for [" << authority() << "] "
+            << ec.message();
+        stop(ec);
+        return;
+    }
+
+    hash_list hashes;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    // The peer may have announced a queued transaction since it was queued.
+    for (const auto& hash: queue_)
+    {
+        if (is_known(hash))
+            continue;
+
+        add_known(hash);
+        hashes.push_back(hash);
+    }
+
+    queue_.clear();
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    for (auto it = hashes.begin(); it != hashes.end();)
+    {
+        const auto count = std::min<size_t>(max_announcements,
+            std::distance(it, hashes.end()));
+        const inventory announcement{ hash_list(it, it + count),
+            inventory::type_id::transaction };
+        it += count;
+
+        log::trace(LOG_NODE)
+            << "Announce " << count << " transactions to [" << authority() << "]";
+        SEND2(announcement, handle_send, _1, announcement.command);
+    }
+}
+
+void protocol_transaction_out::add_known(const hash_digest& hash)
+{
+    if (known_.size() >= max_known)
+    {
+        previous_known_.swap(known_);
+        known_.clear();
+    }
+
+    known_.insert(hash);
+}
+
+bool protocol_transaction_out::is_known(const hash_digest& hash) const
+{
+    return known_.count(hash) != 0 || previous_known_.count(hash) != 0;
+}
+
+// Receive inventory sequence.
+//-----------------------------------------------------------------------------
+
+// The peer has what it announces, so we need not announce it back.
+bool protocol_transaction_out::handle_receive_inventory(const code& ec,
+    inventory_ptr message)
+{
+    if (stopped(ec) || ec)
+        return false;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    for (const auto& inv: message->inventories)
+        if (inv.type == inventory::type_id::transaction)
+            add_known(inv.hash);
+    ///////////////////////////////////////////////////////////////////////////
+
+    return true;
+}
+
 // Receive send_headers.
 //-----------------------------------------------------------------------------
 
@@ -135,6 +245,13 @@ bool protocol_transaction_out::handle_receive_memory_pool(const code& ec,
         for(auto& t:txs) {
             hashes.push_back(t->hash());
         }
+
+        {
+            unique_lock lock(mutex_);
+            for (const auto& hash: hashes)
+                add_known(hash);
+        }
+
         send<protocol_transaction_out>(inventory{hashes, inventory::type_id::transaction}, &protocol_transaction_out::handle_send, _1, inventory::command);
     });
     return false;
@@ -240,24 +357,24 @@ bool protocol_transaction_out::handle_floated(const code& ec,
     // TODO: implement fee computation.
     const uint64_t fee = 0;
 
-    // Transactions are discovered and announced individually.
+    // Transactions are discovered individually and announced in batches.
     if (message->originator() != nonce() && fee >= minimum_fee_.load())
     {
-        static const auto id = inventory::type_id::transaction;
-        const inventory announcement{ { id, message->hash() } };
-        log::trace(LOG_NODE) << "handle floated send transaction hash," << encode_hash(message->hash()) ;
-        SEND2(announcement, handle_send, _1, announcement.command);
+        const auto hash = message->hash();
+        log::trace(LOG_NODE) << "handle floated queue transaction hash," << encode_hash(hash) ;
+
+        ///////////////////////////////////////////////////////////////////////
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        unique_lock lock(mutex_);
+
+        if (!is_known(hash))
+            queue_.push_back(hash);
+        ///////////////////////////////////////////////////////////////////////
     }
 
     return true;
 }
 
-void protocol_transaction_out::handle_stop(const code&)
-{
-    log::trace(LOG_NETWORK)
-        << "Stopped transaction_out protocol";
-    pool_.fired();
-}
-
 } // namespace node
 } // namespace libbitcoin
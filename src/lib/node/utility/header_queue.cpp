@@ -35,7 +35,7 @@ using namespace bc::message;
 
 header_queue::header_queue(const config::checkpoint::list& checkpoints)
   : height_(0),
-    head_(list_.begin()),
+    head_(0),
     checkpoints_(checkpoints)
 {
 }
@@ -111,7 +111,7 @@ void header_queue::initialize(const hash_digest& hash, size_t height)
     list_.clear();
     list_.reserve(size);
     list_.emplace_back(hash);
-    head_ = list_.begin();
+    head_ = 0;
     height_ = height;
 
     mutex_.unlock();
@@ -138,7 +138,7 @@ void header_queue::invalidate(size_t first_height, size_t count)
     mutex_.unlock_upgrade_and_lock();
 
     for (size_t index = first; index < end; ++index)
-        list_[index] = null_hash;
+        list_[head_ + index] = null_hash;
 
     mutex_.unlock();
     ///////////////////////////////////////////////////////////////////////////
@@ -181,7 +181,7 @@ bool header_queue::dequeue(size_t count)
         height_ += size;
 
         list_.clear();
-        head_ = list_.begin();
+        head_ = 0;
 
         mutex_.unlock();
         //---------------------------------------------------------------------
@@ -194,8 +194,8 @@ bool header_queue::dequeue(size_t count)
     BITCOIN_ASSERT(count <= max_size_t - height_);
     height_ += count;
 
-    list_.erase(list_.begin(), head_ + count);
-    head_ = list_.begin();
+    head_ += count;
+    compact();
 
     mutex_.unlock();
     ///////////////////////////////////////////////////////////////////////////
@@ -222,9 +222,10 @@ bool header_queue::dequeue(hash_digest& out_hash, size_t& out_height)
     //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
     mutex_.unlock_upgrade_and_lock();
 
-    std::swap(out_hash, *head_);
+    std::swap(out_hash, list_[head_]);
     ++head_;
     ++height_;
+    compact();
 
     mutex_.unlock();
     ///////////////////////////////////////////////////////////////////////////
@@ -234,6 +235,10 @@ bool header_queue::dequeue(hash_digest& out_hash, size_t& out_height)
 
 bool header_queue::enqueue(headers::ptr message)
 {
+    // The batch is hashed and checked against itself before locking.
+    hash_list hashes;
+    const auto complete = link(hashes, message->elements);
+
     // Critical Section
     ///////////////////////////////////////////////////////////////////////////
     mutex_.lock_upgrade();
@@ -249,7 +254,11 @@ bool header_queue::enqueue(headers::ptr message)
     //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
     mutex_.unlock_upgrade_and_lock();
 
-    const auto result = merge(message->elements);
+    // A merge failure includes automatic rollback to last trust point.
+    const auto result = merge(message->elements, hashes) && complete;
+
+    if (!result)
+        rollback();
 
     mutex_.unlock();
     ///////////////////////////////////////////////////////////////////////////
@@ -260,40 +269,68 @@ bool header_queue::enqueue(headers::ptr message)
 // private
 //-----------------------------------------------------------------------------
 
-// TODO: add PoW validation to reduce importance of intermediate checkpoints.
-bool header_queue::merge(const header::list& headers)
+// static
+bool header_queue::link(hash_list& out_hashes, const header::list& headers)
 {
-    // If we exceed capacity the header pointer becomes invalid, so prevent.
-    const auto size = get_size();
-    list_.erase(list_.begin(), head_);
-    list_.reserve(size + headers.size());
-    head_ = list_.begin();
+    out_hashes.clear();
+    out_hashes.reserve(headers.size());
 
+    // Keep the hashes of the linked prefix, for merge up to the break.
     for (const auto& header: headers)
     {
-        const auto& new_hash = header.hash();
-        const auto next_height = last() + 1;
-        const auto& last_hash = is_empty() ? null_hash : list_.back();
+        if (!out_hashes.empty() &&
+            header.previous_block_hash != out_hashes.back())
+            return false;
 
-        if (!linked(header, last_hash) || !check(new_hash, next_height))
-        {
-            rollback();
+        out_hashes.push_back(header.hash());
+    }
+
+    return true;
+}
+
+// Proof of work is not checked here. PoS and DPoS headers carry no work to
+// check, and an ethash header can only be verified against the epoch dataset
+// and difficulty at its height, which come from the chain. Headers are
+// trusted up to the checkpoints and their blocks are validated on arrival.
+bool header_queue::merge(const header::list& headers, const hash_list& hashes)
+{
+    if (hashes.empty())
+        return true;
+
+    if (!linked(headers.front(), list_.back()))
+        return false;
+
+    compact();
+    list_.reserve(list_.size() + hashes.size());
+
+    for (const auto& hash: hashes)
+    {
+        if (!check(hash, last() + 1))
             return false;
-        }
 
-        list_.emplace_back(new_hash);
+        list_.emplace_back(hash);
     }
 
     return true;
 }
 
+void header_queue::compact()
+{
+    if (head_ == 0 || head_ < list_.size() / 2)
+        return;
+
+    list_.erase(list_.begin(), list_.begin() + head_);
+    head_ = 0;
+}
+
 void header_queue::rollback()
 {
     if (!checkpoints_.empty())
     {
         for (auto it = checkpoints_.rbegin(); it != checkpoints_.rend(); ++it)
         {
-            auto match = std::find(head_, list_.end(), it->hash());
+            auto match = std::find(list_.begin() + head_, list_.end(),
+                it->hash());
 
             if (match != list_.end())
             {
@@ -308,11 +345,11 @@ void header_queue::rollback()
     // the case depending on how the list has been initialized and/or used.
     if (!is_empty())
     {
-        list_.erase(head_ + 1, list_.end());
-        list_.erase(list_.begin(), head_);
+        list_.erase(list_.begin() + head_ + 1, list_.end());
+        list_.erase(list_.begin(), list_.begin() + head_);
     }
 
-    head_ = list_.begin();
+    head_ = 0;
 }
 
 bool header_queue::check(const hash_digest& hash, size_t height) const
@@ -333,9 +370,7 @@ bool header_queue::is_empty() const
 
 size_t header_queue::get_size() const
 {
-    hash_list::const_iterator it = head_;
-    const auto value = std::distance(it, list_.end());
-    return value;
+    return list_.size() - head_;
 }
 
 size_t header_queue::last() const
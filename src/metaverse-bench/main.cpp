@@ -0,0 +1,407 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <memory>
+#include <unordered_set>
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+#include <jsoncpp/json/json.h>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/bitcoin/utility/timer.hpp>
+#include <metaverse/blockchain.hpp>
+#include <metaverse/blockchain/validate_block_impl.hpp>
+#include <metaverse/consensus/miner.hpp>
+#include <metaverse/database.hpp>
+#include "synthetic_chain.hpp"
+
+BC_USE_MVS_MAIN
+
+using namespace bc;
+using namespace bc::bench;
+namespace po = boost::program_options;
+
+typedef timer<asio::microseconds> micro_timer;
+
+static double per_second(uint64_t count, uint64_t microseconds)
+{
+    return microseconds == 0 ? 0.0 : count * 1e6 / microseconds;
+}
+
+static Json::Value rate(uint64_t count, uint64_t microseconds)
+{
+    Json::Value result;
+    result["count"] = Json::UInt64(count);
+    result["microseconds"] = Json::UInt64(microseconds);
+    result["per_second"] = per_second(count, microseconds);
+    return result;
+}
+
+static Json::Value stage_error(const std::string& stage, const code& ec)
+{
+    Json::Value result;
+    result["stage"] = stage;
+    result["code"] = ec.value();
+    result["message"] = ec.message();
+    return result;
+}
+
+static database::settings database_settings(const boost::filesystem::path& directory)
+{
+    database::settings settings;
+    settings.directory = directory;
+    return settings;
+}
+
+static bool initialize(const boost::filesystem::path& directory, bool testnet)
+{
+    boost::system::error_code ec;
+    boost::filesystem::remove_all(directory, ec);
+    boost::filesystem::create_directories(directory, ec);
+    if (ec)
+        return false;
+
+    const auto genesis = consensus::miner::create_genesis_block(!testnet);
+    return database::data_base::initialize(directory, *genesis);
+}
+
+// Balance of the address as the unspent sum of its history.
+static uint64_t tally_balance(const chain::history_compact::list& history)
+{
+    std::unordered_set<uint64_t> spends;
+    for (const auto& row : history)
+        if (row.kind == chain::point_kind::spend)
+            spends.insert(row.previous_checksum);
+
+    uint64_t balance = 0;
+    for (const auto& row : history)
+        if (row.kind == chain::point_kind::output &&
+            spends.find(row.point.checksum()) == spends.end())
+            balance += row.value;
+
+    return balance;
+}
+
+/// Push, query and pop blocks carrying the full attachment mix directly
+/// against the store.
+static Json::Value bench_storage(const boost::filesystem::path& directory,
+    const workload& shape, uint32_t queries, bool testnet)
+{
+    Json::Value result;
+    if (!initialize(directory, testnet))
+    {
+        result["error"] = stage_error("initialize", error::operation_failed);
+        return result;
+    }
+
+    database::data_base store(database_settings(directory));
+    if (!store.start())
+    {
+        result["error"] = stage_error("start", error::operation_failed);
+        return result;
+    }
+
+    const auto genesis = store.blocks.get(0).header();
+    synthetic_chain generator(genesis, shape);
+    chain::block::list blocks{ generator.funding_block() };
+    for (uint32_t index = 0; index < shape.blocks; ++index)
+        blocks.push_back(generator.next_block(true));
+
+    uint64_t transactions = 0;
+    for (const auto& block : blocks)
+        transactions += block.transactions.size();
+
+    const auto push_time = micro_timer::execution([&]
+    {
+        for (const auto& block : blocks)
+            store.push(block);
+    });
+
+    auto push = rate(blocks.size(), push_time);
+    push["transactions_per_second"] = per_second(transactions, push_time);
+    result["push"] = push;
+
+    // History and balance lookups for the single address all outputs pay to.
+    const auto key = generator.address().hash();
+    const auto encoded = generator.address().encoded();
+    uint64_t rows = 0;
+    uint64_t balance = 0;
+    uint64_t business_rows = 0;
+
+    const auto history_time = micro_timer::execution([&]
+    {
+        for (uint32_t query = 0; query < queries; ++query)
+            rows = store.history.get(key, 0, 0).size();
+    });
+
+    const auto balance_time = micro_timer::execution([&]
+    {
+        for (uint32_t query = 0; query < queries; ++query)
+            balance = tally_balance(store.history.get(key, 0, 0));
+    });
+
+    const auto business_time = micro_timer::execution([&]
+    {
+        for (uint32_t query = 0; query < queries; ++query)
+            business_rows = store.address_assets.get_address_business_history(
+                encoded, 0)->size();
+    });
+
+    Json::Value query;
+    query["history"] = rate(queries, history_time);
+    query["history"]["rows"] = Json::UInt64(rows);
+    query["balance"] = rate(queries, balance_time);
+    query["balance"]["value"] = Json::UInt64(balance);
+    query["business_history"] = rate(queries, business_time);
+    query["business_history"]["rows"] = Json::UInt64(business_rows);
+    result["query"] = query;
+
+    // Count the transactions each pop actually removed, a failed pop
+    // removes nothing.
+    uint64_t popped = 0;
+    uint64_t popped_transactions = 0;
+    const auto pop_time = micro_timer::execution([&]
+    {
+        chain::block block;
+        for (size_t index = 0; index < blocks.size(); ++index)
+        {
+            if (!store.pop(block))
+                break;
+
+            ++popped;
+            popped_transactions += block.transactions.size();
+        }
+    });
+
+    auto pop = rate(popped, pop_time);
+    pop["transactions_per_second"] = per_second(popped_transactions,
+        pop_time);
+    result["pop"] = pop;
+
+    store.stop();
+    store.close();
+    return result;
+}
+
+/// Connect signed etp blocks through block validation, then admit loose
+/// transactions to the pool.
+static Json::Value bench_validation(const boost::filesystem::path& directory,
+    const workload& shape, bool testnet)
+{
+    Json::Value result;
+    if (!initialize(directory, testnet))
+    {
+        result["error"] = stage_error("initialize", error::operation_failed);
+        return result;
+    }
+
+    blockchain::settings chain_settings;
+    chain_settings.use_testnet_rules = testnet;
+    chain_settings.transaction_pool_capacity =
+        std::max(chain_settings.transaction_pool_capacity, shape.pool);
+
+    threadpool pool(2);
+    blockchain::block_chain_impl chain(pool, chain_settings,
+        database_settings(directory));
+
+    if (!chain.start())
+    {
+        result["error"] = stage_error("start", error::operation_failed);
+        pool.shutdown();
+        pool.join();
+        return result;
+    }
+
+    chain::header genesis;
+    chain.get_header(genesis, 0);
+
+    synthetic_chain generator(genesis, shape);
+    chain.push(std::make_shared<blockchain::block_detail>(
+        generator.funding_block()));
+
+    const auto stopped = []() { return false; };
+    const config::checkpoint::list checkpoints;
+    uint64_t inputs = 0;
+    uint64_t connected = 0;
+    uint64_t connect_time = 0;
+    code ec = error::success;
+
+    for (uint32_t index = 0; index < shape.blocks && !ec; ++index)
+    {
+        const auto detail = std::make_shared<blockchain::block_detail>(
+            generator.next_block(false));
+        const blockchain::block_detail::list orphan_chain{ detail };
+        const auto& block = *detail->actual();
+        const auto fork = generator.height() - 1;
+
+        blockchain::validate_block_impl validate(chain, fork, orphan_chain, 0,
+            generator.height(), block, testnet, checkpoints, stopped);
+
+        hash_digest err_tx;
+        connect_time += micro_timer::execution([&]
+        {
+            validate.initialize_context();
+            ec = validate.connect_block(err_tx, chain);
+        });
+
+        if (ec)
+        {
+            auto reason = stage_error("connect", ec);
+            reason["height"] = Json::UInt64(generator.height());
+            reason["transaction"] = encode_hash(err_tx);
+            result["error"] = reason;
+            break;
+        }
+
+        for (const auto& tx : block.transactions)
+            inputs += tx.is_coinbase() ? 0 : tx.inputs.size();
+
+        chain.push(detail);
+        ++connected;
+    }
+
+    auto connect = rate(connected, connect_time);
+    connect["inputs"] = Json::UInt64(inputs);
+    connect["inputs_per_second"] = per_second(inputs, connect_time);
+    result["connect"] = connect;
+
+    chain::transaction::list loose;
+    for (uint32_t index = 0; index < shape.pool; ++index)
+        loose.push_back(generator.loose_transaction());
+
+    uint64_t accepted = 0;
+    code first_rejection = error::success;
+    const auto admit_time = micro_timer::execution([&]
+    {
+        for (const auto& tx : loose)
+        {
+            const auto admitted = chain.broadcast_transaction(tx);
+            if (!admitted)
+                ++accepted;
+            else if (!first_rejection)
+                first_rejection = admitted;
+        }
+    });
+
+    auto admission = rate(accepted, admit_time);
+    admission["offered"] = Json::UInt64(loose.size());
+    if (first_rejection)
+        admission["error"] = stage_error("admission", first_rejection);
+    result["mempool"] = admission;
+
+    chain.stop();
+    pool.shutdown();
+    pool.join();
+    chain.close();
+    return result;
+}
+
+int bc::main(int argc, char* argv[])
+{
+    workload shape;
+    uint32_t queries;
+    std::string directory;
+    bool testnet = false;
+
+    po::options_description desc("metaverse-bench options");
+    desc.add_options()
+        ("help,h", "Show this help.")
+        ("directory,d", po::value<std::string>(&directory)->default_value(
+            (boost::filesystem::temp_directory_path() / "metaverse-bench").string()),
+            "Scratch directory, its contents are removed.")
+        ("blocks,b", po::value<uint32_t>(&shape.blocks)->default_value(200),
+            "Number of generated blocks.")
+        ("transactions,t", po::value<uint32_t>(&shape.transactions)->default_value(50),
+            "Transactions per block.")
+        ("inputs,i", po::value<uint32_t>(&shape.inputs)->default_value(2),
+            "Inputs per transaction.")
+        ("outputs,o", po::value<uint32_t>(&shape.outputs)->default_value(2),
+            "Outputs per transaction.")
+        ("assets", po::value<uint32_t>(&shape.asset_percent)->default_value(10),
+            "Percent of transactions issuing an asset.")
+        ("dids", po::value<uint32_t>(&shape.did_percent)->default_value(5),
+            "Percent of transactions registering a did.")
+        ("mits", po::value<uint32_t>(&shape.mit_percent)->default_value(5),
+            "Percent of transactions registering a mit.")
+        ("pool,p", po::value<uint32_t>(&shape.pool)->default_value(1000),
+            "Loose transactions offered to the memory pool.")
+        ("queries,q", po::value<uint32_t>(&queries)->default_value(100),
+            "Repetitions of each address query.")
+        ("testnet", po::bool_switch(&testnet), "Use testnet rules.");
+
+    po::variables_map vm;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        po::notify(vm);
+    }
+    catch (const std::exception& e)
+    {
+        bc::cerr << e.what() << std::endl << desc << std::endl;
+        return console_result::failure;
+    }
+
+    if (vm.count("help"))
+    {
+        bc::cout << desc << std::endl;
+        return console_result::okay;
+    }
+
+    if (shape.inputs == 0 || shape.outputs < shape.inputs ||
+        shape.asset_percent + shape.did_percent + shape.mit_percent > 100)
+    {
+        bc::cerr << "outputs must be at least inputs (> 0) and the attachment "
+            "mix must not exceed 100 percent." << std::endl;
+        return console_result::invalid;
+    }
+
+    const boost::filesystem::path root(directory);
+    Json::Value report;
+    Json::Value parameters;
+    parameters["blocks"] = shape.blocks;
+    parameters["transactions"] = shape.transactions;
+    parameters["inputs"] = shape.inputs;
+    parameters["outputs"] = shape.outputs;
+    parameters["assets"] = shape.asset_percent;
+    parameters["dids"] = shape.did_percent;
+    parameters["mits"] = shape.mit_percent;
+    parameters["pool"] = shape.pool;
+    parameters["queries"] = queries;
+    parameters["testnet"] = testnet;
+    report["parameters"] = parameters;
+
+    try
+    {
+        report["storage"] = bench_storage(root / "storage", shape, queries, testnet);
+        report["validation"] = bench_validation(root / "validation", shape, testnet);
+    }
+    catch (const std::exception& e)
+    {
+        report["exception"] = e.what();
+    }
+
+    boost::system::error_code ec;
+    boost::filesystem::remove_all(root, ec);
+
+    bc::cout << report.toStyledString();
+    const auto failed = report.isMember("exception") ||
+        report["storage"].isMember("error") ||
+        report["validation"].isMember("error");
+    return failed ? console_result::failure : console_result::okay;
+}
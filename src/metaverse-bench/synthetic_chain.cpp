@@ -0,0 +1,233 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "synthetic_chain.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+namespace libbitcoin {
+namespace bench {
+
+using namespace bc::chain;
+
+// Value of each funding output, large enough to absorb fees for long runs.
+static constexpr uint64_t funding_value = 100 * coin_price();
+static constexpr uint64_t transaction_fee = 10000;
+static constexpr uint32_t block_interval = 30;
+
+synthetic_chain::synthetic_chain(const header& genesis, const workload& shape)
+  : shape_(shape),
+    last_(genesis),
+    height_(0),
+    sequence_(0)
+{
+    const std::string seed("metaverse-bench");
+    secret_ = sha256_hash(data_chunk(seed.begin(), seed.end()));
+
+    ec_compressed point;
+    if (!secret_to_public(point, secret_))
+        throw std::runtime_error("invalid bench secret");
+
+    public_key_ = to_chunk(point);
+    const auto key_hash = bitcoin_short_hash(public_key_);
+    address_ = wallet::payment_address(key_hash);
+    pay_script_.operations = operation::to_pay_key_hash_pattern(key_hash);
+}
+
+const wallet::payment_address& synthetic_chain::address() const
+{
+    return address_;
+}
+
+uint64_t synthetic_chain::height() const
+{
+    return height_;
+}
+
+block synthetic_chain::funding_block()
+{
+    const auto fanout = uint64_t(shape_.transactions) * shape_.inputs * 2 +
+        uint64_t(shape_.pool) * shape_.inputs;
+
+    const std::string seed("metaverse-bench-funding");
+    transaction funding;
+    funding.version = transaction_version::first;
+    funding.locktime = 0;
+    funding.inputs.push_back({ output_point(sha256_hash(
+        data_chunk(seed.begin(), seed.end())), 0), {}, max_input_sequence });
+
+    for (uint64_t index = 0; index < fanout; ++index)
+        funding.outputs.push_back({ funding_value, pay_script_,
+            attachment(ETP_TYPE, ATTACH_INIT_VERSION, etp(funding_value)) });
+
+    transaction::list transactions{ make_coinbase(), std::move(funding) };
+    keep(transactions.back());
+    return make_block(std::move(transactions));
+}
+
+block synthetic_chain::next_block(bool business)
+{
+    transaction::list transactions{ make_coinbase() };
+    for (uint32_t index = 0; index < shape_.transactions; ++index)
+        transactions.push_back(make_transaction(business));
+
+    // Outputs become spendable only after the block that creates them, so
+    // they are queued behind everything already confirmed.
+    for (size_t index = 1; index < transactions.size(); ++index)
+        keep(transactions[index]);
+
+    return make_block(std::move(transactions));
+}
+
+transaction synthetic_chain::loose_transaction()
+{
+    return make_transaction(false);
+}
+
+transaction synthetic_chain::make_coinbase() const
+{
+    transaction coinbase;
+    coinbase.version = transaction_version::first;
+    coinbase.locktime = 0;
+
+    // The height makes the coinbase hash unique per block.
+    const script_number number(height_ + 1);
+    script input_script;
+    input_script.operations.push_back({ opcode::special, number.data() });
+    coinbase.inputs.push_back({ output_point(null_hash, max_uint32),
+        input_script, max_input_sequence });
+    coinbase.outputs.push_back({ 0, pay_script_,
+        attachment(ETP_TYPE, ATTACH_INIT_VERSION, etp(0)) });
+    return coinbase;
+}
+
+transaction synthetic_chain::make_transaction(bool business)
+{
+    if (unspent_.size() < shape_.inputs)
+        throw std::runtime_error("synthetic chain ran out of spendable outputs");
+
+    transaction tx;
+    tx.version = transaction_version::first;
+    tx.locktime = 0;
+
+    uint64_t value_in = 0;
+    for (uint32_t index = 0; index < shape_.inputs; ++index)
+    {
+        const auto& prevout = unspent_.front();
+        tx.inputs.push_back({ prevout.point, {}, max_input_sequence });
+        value_in += prevout.value;
+        unspent_.pop_front();
+    }
+
+    if (value_in <= transaction_fee + shape_.outputs)
+        throw std::runtime_error("synthetic chain outputs exhausted by fees");
+
+    const auto value_out = value_in - transaction_fee;
+    const auto share = value_out / shape_.outputs;
+    for (uint32_t index = 0; index < shape_.outputs; ++index)
+    {
+        // The first output absorbs the rounding remainder.
+        const auto value = index == 0 ?
+            value_out - share * (shape_.outputs - 1) : share;
+        tx.outputs.push_back({ value, pay_script_,
+            make_attachment(business && index == 0, value) });
+    }
+
+    sign(tx);
+    return tx;
+}
+
+attachment synthetic_chain::make_attachment(bool business, uint64_t value)
+{
+    if (!business)
+        return attachment(ETP_TYPE, ATTACH_INIT_VERSION, etp(value));
+
+    const auto number = ++sequence_;
+    const auto roll = number % 100;
+    const auto address = address_.encoded();
+    const auto suffix = std::to_string(number);
+
+    if (roll < shape_.asset_percent)
+    {
+        const asset_detail detail("BENCH.A" + suffix, 1000000000, 0, 0,
+            "metaverse-bench", address, "synthetic asset");
+        return attachment(ASSET_TYPE, ATTACH_INIT_VERSION,
+            asset(ASSET_DETAIL_TYPE, detail));
+    }
+
+    if (roll < shape_.asset_percent + shape_.did_percent)
+    {
+        const did_detail detail("BENCH.D" + suffix, address);
+        return attachment(DID_TYPE, ATTACH_INIT_VERSION,
+            did(DID_DETAIL_TYPE, detail));
+    }
+
+    if (roll < shape_.asset_percent + shape_.did_percent + shape_.mit_percent)
+    {
+        asset_mit mit("BENCH.M" + suffix, address, "synthetic mit");
+        mit.set_status(MIT_STATUS_REGISTER);
+        return attachment(ASSET_MIT_TYPE, ATTACH_INIT_VERSION, mit);
+    }
+
+    return attachment(ETP_TYPE, ATTACH_INIT_VERSION, etp(value));
+}
+
+block synthetic_chain::make_block(transaction::list&& transactions)
+{
+    block result;
+    result.header.version = block_version_pow;
+    result.header.previous_block_hash = last_.hash();
+    result.header.timestamp = last_.timestamp + block_interval;
+    result.header.bits = last_.bits;
+    result.header.nonce = 0;
+    result.header.number = static_cast<uint32_t>(++height_);
+    result.header.transaction_count = transactions.size();
+    result.header.merkle = block::generate_merkle_root(transactions);
+    result.transactions = std::move(transactions);
+
+    last_ = result.header;
+    return result;
+}
+
+void synthetic_chain::sign(transaction& tx) const
+{
+    for (uint32_t index = 0; index < tx.inputs.size(); ++index)
+    {
+        endorsement endorse;
+        if (!script::create_endorsement(endorse, secret_, pay_script_, tx,
+            index, signature_hash_algorithm::all))
+            throw std::runtime_error("failed to sign synthetic transaction");
+
+        auto& input_script = tx.inputs[index].script;
+        input_script.operations.clear();
+        input_script.operations.push_back({ opcode::special, endorse });
+        input_script.operations.push_back({ opcode::special, public_key_ });
+    }
+}
+
+void synthetic_chain::keep(const transaction& tx)
+{
+    const auto hash = tx.hash();
+    for (uint32_t index = 0; index < tx.outputs.size(); ++index)
+        unspent_.push_back({ output_point(hash, index), tx.outputs[index].value });
+}
+
+} // namespace bench
+} // namespace libbitcoin
@@ -0,0 +1,102 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_BENCH_SYNTHETIC_CHAIN_HPP
+#define MVS_BENCH_SYNTHETIC_CHAIN_HPP
+
+#include <deque>
+#include <string>
+#include <metaverse/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace bench {
+
+/// Shape of the generated workload.
+struct workload
+{
+    uint32_t blocks;
+    uint32_t transactions;
+    uint32_t inputs;
+    uint32_t outputs;
+
+    /// Number of loose transactions reserved for pool admission.
+    uint32_t pool;
+
+    /// Percentages of transactions that carry business attachments,
+    /// the remainder carry plain etp attachments.
+    uint32_t asset_percent;
+    uint32_t did_percent;
+    uint32_t mit_percent;
+};
+
+/// Deterministic generator of a spendable synthetic chain on top of genesis.
+/// All outputs pay to a single key so every input can be properly signed.
+/// This class is not thread safe.
+class synthetic_chain
+{
+public:
+    synthetic_chain(const chain::header& genesis, const workload& shape);
+
+    /// The block that fans out enough funding outputs for the workload.
+    /// Its single input spends a fabricated previous output, so the block
+    /// can be stored but not connected.
+    chain::block funding_block();
+
+    /// The next block, optionally carrying business attachments.
+    chain::block next_block(bool business);
+
+    /// A signed transaction spending confirmed outputs, for pool admission.
+    /// Its outputs are not made available to later blocks.
+    chain::transaction loose_transaction();
+
+    /// Address all generated outputs pay to.
+    const wallet::payment_address& address() const;
+
+    /// Height of the most recently generated block.
+    uint64_t height() const;
+
+private:
+    struct spendable
+    {
+        chain::output_point point;
+        uint64_t value;
+    };
+
+    chain::transaction make_coinbase() const;
+    chain::transaction make_transaction(bool business);
+    chain::attachment make_attachment(bool business, uint64_t value);
+    chain::block make_block(chain::transaction::list&& transactions);
+    void sign(chain::transaction& tx) const;
+    void keep(const chain::transaction& tx);
+
+    const workload shape_;
+    ec_secret secret_;
+    data_chunk public_key_;
+    wallet::payment_address address_;
+    chain::script pay_script_;
+    chain::header last_;
+    uint64_t height_;
+    uint64_t sequence_;
+    std::deque<spendable> unspent_;
+};
+
+} // namespace bench
+} // namespace libbitcoin
+
+#endif
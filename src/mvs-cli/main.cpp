@@ -20,6 +20,8 @@
  */
 #include <metaverse/bitcoin/utility/path.hpp>
 #include <metaverse/bitcoin/unicode/ifstream.hpp>
+#include <algorithm>
+#include <boost/algorithm/string.hpp>
 #include <boost/program_options.hpp>
 #include <jsoncpp/json/json.h>
 #include <metaverse/mgbubble/MongooseCli.hpp>
@@ -37,23 +39,34 @@ BC_USE_MVS_MAIN
 using namespace mgbubble::cli;
 namespace po = boost::program_options;
 
+void print_reply(const Json::Value& root, const std::string& reply)
+{
+    if (root["error"]["code"].isInt() && root["error"]["code"].asInt() != 0) {
+        bc::cout << root["error"].toStyledString();
+    }
+    else if (root["result"].isString()) {
+        bc::cout << root["result"].asString() <<std::endl;
+    }
+    else if(root["result"].isArray() || root["result"].isObject()) {
+        bc::cout << root["result"].toStyledString();
+    }
+    else {
+        bc::cout << reply << std::endl;
+    }
+}
+
 void my_impl(const http_message* hm)
 {
     auto&& reply = std::string(hm->body.p, hm->body.len);
     Json::Reader reader;
     Json::Value root;
     if (reader.parse(reply, root) && root.isObject()) {
-        if (root["error"]["code"].isInt() && root["error"]["code"].asInt() != 0) {
-            bc::cout << root["error"].toStyledString();
-        }
-        else if (root["result"].isString()) {
-            bc::cout << root["result"].asString() <<std::endl;
-        }
-        else if(root["result"].isArray() || root["result"].isObject()) {
-            bc::cout << root["result"].toStyledString();
-        }
-        else {
-            bc::cout << reply << std::endl;
+        print_reply(root, reply);
+    }
+    else if (root.isArray()) {
+        // batch replies, one per command in request order
+        for (auto& item : root) {
+            print_reply(item, item.toStyledString());
         }
     }
     else {
@@ -61,6 +74,22 @@ void my_impl(const http_message* hm)
     }
 }
 
+Json::Value make_request(const std::vector<std::string>& args, int64_t id)
+{
+    Json::Value jsonvar;
+    jsonvar["jsonrpc"] = "2.0";
+    jsonvar["id"] = id;
+    jsonvar["method"] = args.empty() ? "help" : args[0];
+    jsonvar["params"] = Json::arrayValue;
+
+    for (size_t i = 1; i < args.size(); i++)
+    {
+        jsonvar["params"].append(args[i]);
+    }
+
+    return jsonvar;
+}
+
 int bc::main(int argc, char* argv[])
 {
     bc::set_utf8_stdout();
@@ -129,20 +158,30 @@ int bc::main(int argc, char* argv[])
     // HTTP request call commands
     HttpReq req(url, 3000, reply_handler(my_impl));
 
-    Json::Value jsonvar;
-    jsonvar["jsonrpc"] = "2.0";
-    jsonvar["id"] = 1;
-    jsonvar["method"] = (argc > 1) ? argv[1] : "help";
-    jsonvar["params"] = Json::arrayValue;
+    // '--batch' reads one command per line from stdin and sends them all
+    // as a single json-rpc batch over one connection.
+    if (argc > 1 && std::string(argv[1]) == "--batch") {
+        Json::Value batch(Json::arrayValue);
+        std::string line;
+        while (std::getline(bc::cin, line)) {
+            std::vector<std::string> args;
+            boost::split(args, line, boost::is_any_of(" \t\r"), boost::token_compress_on);
+            args.erase(std::remove(args.begin(), args.end(), ""), args.end());
+            if (!args.empty()) {
+                batch.append(make_request(args, batch.size() + 1));
+            }
+        }
 
-    if (argc > 2)
-    {
-        for (int i = 2; i < argc; i++)
-        {
-            jsonvar["params"].append(argv[i]);
+        if (batch.empty()) {
+            std::cout << "'--batch' expects one command per line on stdin." << std::endl;
+            return 0;
         }
+
+        req.post(batch.toStyledString());
+        return 0;
     }
 
-    req.post(jsonvar.toStyledString());
+    std::vector<std::string> args(argv + 1, argv + argc);
+    req.post(make_request(args, 1).toStyledString());
     return 0;
 }
@@ -63,6 +63,11 @@ executor::executor(parser& metadata, std::istream& input,
     handle_stop(initialize_stop);
 }
 
+executor::~executor()
+{
+    finalize_logging();
+}
+
 
 // Command line options.
 // ----------------------------------------------------------------------------
@@ -155,6 +160,18 @@ bool executor::do_initchain()
                 throw std::runtime_error{ " upgrade database to version 63 failed!" };
             }
         }
+
+        if (MVS_DATABASE_VERSION_NUMBER >= 65) {
+            if (!data_base::upgrade_version_65(data_path)) {
+                throw std::runtime_error{ " upgrade database to version 65 failed!" };
+            }
+        }
+
+        if (MVS_DATABASE_VERSION_NUMBER >= 66) {
+            if (!data_base::upgrade_version_66(data_path)) {
+                throw std::runtime_error{ " upgrade database to version 66 failed!" };
+            }
+        }
     }
 
     if (ec.value() == directory_exists)
@@ -167,6 +184,49 @@ bool executor::do_initchain()
     return false;
 }
 
+bool executor::do_export_snapshot()
+{
+    const auto& file = metadata_.configured.export_snapshot;
+    log::info(LOG_SERVER) << format(BS_SNAPSHOT_EXPORTING) % file;
+
+    data_base db(metadata_.configured.database);
+    const auto result = db.start() && db.export_snapshot(file);
+    db.stop();
+
+    if (!result)
+        log::error(LOG_SERVER) << format(BS_SNAPSHOT_EXPORT_FAIL) % file;
+
+    return result;
+}
+
+// The snapshot replaces initialization, so the directory must not exist.
+bool executor::do_import_snapshot()
+{
+    const auto& file = metadata_.configured.import_snapshot;
+    const auto& data_path = metadata_.configured.database.directory;
+
+    boost::system::error_code ec;
+    if (!create_directories(data_path, ec))
+    {
+        log::error(LOG_SERVER) << format(BS_SNAPSHOT_DIRECTORY_EXISTS) % data_path;
+        return false;
+    }
+
+    log::info(LOG_SERVER) << format(BS_SNAPSHOT_IMPORTING) % file % data_path;
+
+    if (!data_base::import_snapshot(file, data_path,
+        metadata_.configured.chain.checkpoints))
+    {
+        remove_all(data_path);
+        log::error(LOG_SERVER) << format(BS_SNAPSHOT_IMPORT_FAIL) % file;
+        return false;
+    }
+
+    // init admin account
+    set_admin();
+    return true;
+}
+
 // Menu selection.
 // ----------------------------------------------------------------------------
 
@@ -210,8 +270,23 @@ bool executor::menu()
             metadata_.configured.database.directory = directory / default_directory;
         }
 
+        auto& trace_directory = metadata_.configured.chain.block_trace_directory;
+        if (!trace_directory.is_absolute()) {
+            trace_directory = metadata_.configured.data_dir / trace_directory;
+        }
+
+        if (!config.import_snapshot.empty() && !do_import_snapshot())
+        {
+            return false;
+        }
+
         auto result = do_initchain(); // false means no need to initial chain
 
+        if (!config.export_snapshot.empty())
+        {
+            return do_export_snapshot();
+        }
+
         if (config.initchain)
         {
             return result;
@@ -34,6 +34,9 @@ public:
     executor(parser& metadata, std::istream&, std::ostream& output,
         std::ostream& error);
 
+    /// Writes out buffered log records before the log files close.
+    ~executor();
+
     /// This class is not copyable.
     executor(const executor&) = delete;
     void operator=(const executor&) = delete;
@@ -53,6 +56,8 @@ private:
     void do_settings();
     void do_version();
     bool do_initchain();
+    bool do_export_snapshot();
+    bool do_import_snapshot();
     void set_admin();
     void set_blackhole_did();
 
@@ -91,6 +96,16 @@ private:
     "Failed to test directory %1% with error, '%2%'."
 #define BS_INITCHAIN_COMPLETE \
     "Completed initialization."
+#define BS_SNAPSHOT_EXPORTING \
+    "Please wait while exporting snapshot to %1%..."
+#define BS_SNAPSHOT_EXPORT_FAIL \
+    "Failed to export snapshot to %1%, a running node exports with the exportsnapshot command."
+#define BS_SNAPSHOT_IMPORTING \
+    "Please wait while importing snapshot %1% into %2% directory..."
+#define BS_SNAPSHOT_IMPORT_FAIL \
+    "Failed to import snapshot %1%."
+#define BS_SNAPSHOT_DIRECTORY_EXISTS \
+    "Cannot import snapshot because the directory %1% already exists."
 
 #define BS_NODE_INTERRUPT \
     "Press CTRL-C to stop the server."
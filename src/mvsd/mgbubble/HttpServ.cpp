@@ -14,11 +14,15 @@
  * not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
  * 02110-1301, USA.
  */
+#include <cstring>
 #include <exception>
 #include <functional> //hash
+#include <iterator>
+#include <mutex>
 
 #include <metaverse/mgbubble/HttpServ.hpp>
 #include <metaverse/mgbubble/exception/Instances.hpp>
+#include <metaverse/mgbubble/utility/JsonRpcBatch.hpp>
 #include <metaverse/mgbubble/utility/Stream_buf.hpp>
 
 #include <metaverse/explorer/extensions/command_extension_func.hpp>
@@ -65,77 +69,261 @@ void HttpServ::reset(HttpMessage& data) noexcept
 
 void HttpServ::rpc_request(mg_connection& nc, HttpMessage data, uint8_t rpc_version)
 {
+    static auto& request_seconds = metrics::instance().make_histogram(
+        "mvs_rpc_request_seconds", "Time to answer a json-rpc request.");
+    static auto& requests = metrics::instance().make_counter(
+        "mvs_rpc_requests_total", "Json-rpc requests received.");
+
+    const metrics::stopwatch timer(request_seconds);
+    requests.increment();
+
     reset(data);
-    StreamBuf buf{ nc.send_mbuf };
-    out_.rdbuf(&buf);
-    out_.reset(200, "OK");
 
+    // Persistent connections spare pollers a connect per call.
+    const auto persistent = keep_alive(data);
+
+    if (rpc_version == 1) {
+        StreamBuf buf{ nc.send_mbuf };
+        out_.rdbuf(&buf);
+        out_.reset(200, "OK", "text/plain", "utf-8", persistent);
+        if (!persistent) {
+            nc.flags |= MG_F_SEND_AND_CLOSE;
+        }
+
+        rpc_request_v1(nc, data);
+        out_.setContentLength();
+        return;
+    }
+
+    Json::Value root;
+    auto response = parse_request(nc, data, root);
+    if (response.isNull()) {
+        if (!root.isArray()) {
+            response = rpc_call(root, rpc_version);
+        }
+        else {
+            response = jsonrpc_batch_error(root, max_batch_requests);
+            if (response.isNull()) {
+                rpc_batch(nc, std::move(root), rpc_version, persistent);
+                return;
+            }
+        }
+    }
+
+    rpc_respond(nc, response, persistent);
+}
+
+console_result HttpServ::dispatch(int argc, const char* argv[],
+    Json::Value& jv_output, uint8_t api_version)
+{
+    // Two sends from one account at once would pick the same outputs.
+    std::lock_guard<std::mutex> lock(dispatch_mutex_);
+    return explorer::dispatch_command(argc, argv, jv_output, node_, api_version);
+}
+
+void HttpServ::rpc_request_v1(mg_connection& nc, HttpMessage& data)
+{
     try {
         check_rpc_client_addresses(nc);
 
-        data.data_to_arg(rpc_version);
+        data.data_to_arg(1);
 
         Json::Value jv_output;
 
-        auto retcode = explorer::dispatch_command(data.argc(), const_cast<const char**>(data.argv()),
-                       jv_output, node_, rpc_version);
+        auto retcode = dispatch(data.argc(), const_cast<const char**>(data.argv()),
+                       jv_output, 1);
 
         if (retcode == console_result::failure) { // only orignal command
-            if (rpc_version == 1 && !jv_output.isObject() && !jv_output.isArray()) {
+            if (!jv_output.isObject() && !jv_output.isArray()) {
                 throw explorer::command_params_exception{ jv_output.asString() };
             }
             throw explorer::command_params_exception{ jv_output.toStyledString() };
         }
 
         if (retcode == console_result::okay) {
-            if (rpc_version == 1) {
-                if (jv_output.isObject() || jv_output.isArray())
-                    out_ << jv_output.toStyledString();
-                else
-                    out_ << jv_output.asString();
-            }
-            else {
-                Json::Value jv_root;
-                jv_root["jsonrpc"] = "2.0";
-                jv_root["id"] = data.jsonrpc_id();
-                jv_root["result"] = jv_output;
-
-                out_ << jv_root.toStyledString();
-            }
+            if (jv_output.isObject() || jv_output.isArray())
+                out_ << jv_output.toStyledString();
+            else
+                out_ << jv_output.asString();
         }
     }
     catch (const libbitcoin::explorer::explorer_exception& e) {
-        if (rpc_version == 1) {
-            out_ << e;
+        out_ << e;
+    }
+    catch (const std::exception& e) {
+        libbitcoin::explorer::explorer_exception ex(1000, e.what());
+        out_ << ex;
+    }
+}
+
+Json::Value HttpServ::parse_request(mg_connection& nc, HttpMessage& data, Json::Value& out_root)
+{
+    try {
+        check_rpc_client_addresses(nc);
+        out_root = data.parse_body();
+    }
+    catch (const libbitcoin::explorer::explorer_exception& e) {
+        return jsonrpc_error(data.jsonrpc_id(), e.code(), e.what());
+    }
+    catch (const std::exception& e) {
+        return jsonrpc_error(data.jsonrpc_id(), 1000, e.what());
+    }
+
+    return Json::Value();
+}
+
+Json::Value HttpServ::rpc_call(const Json::Value& request, uint8_t rpc_version)
+{
+    JsonRpcMessage data(request);
+    try {
+        data.data_to_arg(rpc_version);
+
+        Json::Value jv_output;
+
+        auto retcode = dispatch(data.argc(), const_cast<const char**>(data.argv()),
+                       jv_output, rpc_version);
+
+        if (retcode == console_result::failure) { // only orignal command
+            throw explorer::command_params_exception{ jv_output.toStyledString() };
         }
-        else {
-            Json::Value root;
-            root["jsonrpc"] = "2.0";
-            root["id"] = data.jsonrpc_id();
-            root["error"]["code"] = (int32_t)e.code();
-            root["error"]["message"] = e.what();
 
-            out_ << root.toStyledString();
+        if (retcode != console_result::okay) {
+            return Json::Value();
         }
+
+        Json::Value jv_root;
+        jv_root["jsonrpc"] = "2.0";
+        jv_root["id"] = data.jsonrpc_id();
+        jv_root["result"] = jv_output;
+        return jv_root;
+    }
+    catch (const libbitcoin::explorer::explorer_exception& e) {
+        return jsonrpc_error(data.jsonrpc_id(), e.code(), e.what());
     }
     catch (const std::exception& e) {
-        if (rpc_version == 1) {
-            libbitcoin::explorer::explorer_exception ex(1000, e.what());
-            out_ << ex;
+        return jsonrpc_error(data.jsonrpc_id(), 1000, e.what());
+    }
+}
+
+void HttpServ::rpc_batch(mg_connection& nc, Json::Value&& requests,
+    uint8_t rpc_version, bool persistent)
+{
+    // Entries run in order on the batch pool, the event loop keeps serving
+    // other connections and writes the answer once all have completed.
+    const auto id = ++batch_id_;
+    pending_batches_[&nc] = { id, {} };
+
+    const auto connection = &nc;
+    const auto batch = std::make_shared<Json::Value>(std::move(requests));
+    batch_pool_.service().post([this, connection, id, batch, rpc_version, persistent]() {
+        const auto responses = std::make_shared<Json::Value>(jsonrpc_batch(*batch,
+            [this, rpc_version](const Json::Value& request) {
+                return rpc_call(request, rpc_version);
+            }));
+
+        spawn_to_mongoose([this, connection, id, responses, persistent](uint64_t) {
+            // The connection may have closed, and its address been reused.
+            const auto pending = pending_batches_.find(connection);
+            if (pending == pending_batches_.end() || pending->second.id != id) {
+                return;
+            }
+
+            auto held = std::move(pending->second.held);
+            pending_batches_.erase(pending);
+            rpc_respond(*connection, *responses, persistent);
+            resume(*connection, std::move(held));
+        });
+    });
+}
+
+void HttpServ::rpc_respond(mg_connection& nc, const Json::Value& response, bool persistent)
+{
+    StreamBuf buf{ nc.send_mbuf };
+    out_.rdbuf(&buf);
+    out_.reset(200, "OK", "text/plain", "utf-8", persistent);
+    if (!persistent) {
+        nc.flags |= MG_F_SEND_AND_CLOSE;
+    }
+
+    if (!response.isNull()) {
+        out_ << response.toStyledString();
+    }
+
+    out_.setContentLength();
+}
+
+// Requests held behind a batch are answered in the order they arrived.
+void HttpServ::resume(mg_connection& nc, std::deque<std::string>&& held)
+{
+    while (!held.empty()) {
+        if (nc.flags & (MG_F_SEND_AND_CLOSE | MG_F_CLOSE_IMMEDIATELY)) {
+            return;
         }
-        else {
-            Json::Value root;
-            root["jsonrpc"] = "2.0";
-            root["id"] = data.jsonrpc_id();
-            root["error"]["code"] = 1000;
-            root["error"]["message"] = e.what();
 
-            out_ << root.toStyledString();
+        const auto raw = std::move(held.front());
+        held.pop_front();
+
+        http_message msg;
+        if (mg_parse_http(raw.data(), static_cast<int>(raw.size()), &msg, 1) <= 0) {
+            continue;
+        }
+        if (msg.body.len == (size_t)~0) {
+            msg.body.len = raw.data() + raw.size() - msg.body.p;
+            msg.message.len = raw.size();
+        }
+
+        on_http_req_handler(nc, msg);
+
+        // A held batch holds back the requests after it in turn.
+        const auto pending = pending_batches_.find(&nc);
+        if (pending != pending_batches_.end()) {
+            auto& behind = pending->second.held;
+            behind.insert(behind.end(), std::make_move_iterator(held.begin()),
+                std::make_move_iterator(held.end()));
+            return;
         }
     }
+}
+
+void HttpServ::metrics_request(mg_connection& nc, HttpMessage data)
+{
+    reset(data);
+    StreamBuf buf{ nc.send_mbuf };
+    out_.rdbuf(&buf);
+
+    const auto persistent = keep_alive(data);
+    if (!persistent) {
+        nc.flags |= MG_F_SEND_AND_CLOSE;
+    }
+
+    try {
+        check_rpc_client_addresses(nc);
+        out_.reset(200, "OK", "text/plain; version=0.0.4", "utf-8", persistent);
+        out_ << metrics::instance().to_text();
+    }
+    catch (const std::exception& e) {
+        out_.reset(403, "Forbidden", "text/plain", "utf-8", persistent);
+        out_ << e.what();
+    }
+
     out_.setContentLength();
 }
 
+bool HttpServ::keep_alive(const HttpMessage& data)
+{
+    const auto connection = data.header("Connection");
+    const auto is = [&connection](const char* value) {
+        return connection.size() == strlen(value)
+            && mg_ncasecmp(connection.data(), value, connection.size()) == 0;
+    };
+
+    // HTTP/1.1 is persistent unless closed, HTTP/1.0 only if asked for.
+    if (data.proto() == "HTTP/1.0") {
+        return is("keep-alive");
+    }
+    return !is("close");
+}
+
 void HttpServ::ws_request(mg_connection& nc, WebsocketMessage ws)
 {
     Json::Value jv_output;
@@ -145,7 +333,7 @@ void HttpServ::ws_request(mg_connection& nc, WebsocketMessage ws)
 
         ws.data_to_arg();
 
-        console_result retcode = explorer::dispatch_command(ws.argc(), const_cast<const char**>(ws.argv()), jv_output, node_);
+        console_result retcode = dispatch(ws.argc(), const_cast<const char**>(ws.argv()), jv_output, 1);
         if (retcode != console_result::okay) {
             throw explorer::command_params_exception(jv_output.asString());
         }
@@ -189,6 +377,13 @@ void HttpServ::run() {
 
 void HttpServ::on_http_req_handler(struct mg_connection& nc, http_message& msg)
 {
+    // A request pipelined behind a running batch waits to be answered after it.
+    const auto pending = pending_batches_.find(&nc);
+    if (pending != pending_batches_.end()) {
+        pending->second.held.emplace_back(msg.message.p, msg.message.len);
+        return;
+    }
+
     auto get_api_version = [&msg]() -> int {
         if ((msg.uri.len >= 6) && (mg_ncasecmp(msg.uri.p, "/rpc/v", 6) == 0)) {
             return std::max(1, std::atoi(msg.uri.p + 6));
@@ -201,10 +396,17 @@ void HttpServ::on_http_req_handler(struct mg_connection& nc, http_message& msg)
         return 0;
     };
 
+    auto is_metrics = [&msg]() -> bool {
+        return (msg.uri.len == 8) && (mg_ncasecmp(msg.uri.p, "/metrics", 8) == 0);
+    };
+
     auto api_version = get_api_version();
     if (api_version > 0) {
         rpc_request(nc, HttpMessage(&msg), api_version);
     }
+    else if (is_metrics()) {
+        metrics_request(nc, HttpMessage(&msg));
+    }
     else {
         std::shared_ptr<struct mg_connection> con(&nc, [](struct mg_connection * ptr) { (void)(ptr); });
         serve_http_static(nc, msg);
@@ -222,6 +424,12 @@ void HttpServ::on_notify_handler(struct mg_connection& nc, struct mg_event& ev)
     msg(++api_call_counter);
 }
 
+void HttpServ::on_close_handler(struct mg_connection& nc)
+{
+    // A batch still running for the connection is dropped when it completes.
+    pending_batches_.erase(&nc);
+}
+
 void HttpServ::on_ws_handshake_done_handler(struct mg_connection& nc)
 {
     std::shared_ptr<struct mg_connection> con(&nc, [](struct mg_connection * ptr) { (void)(ptr); });
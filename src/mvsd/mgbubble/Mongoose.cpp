@@ -22,28 +22,37 @@
 
 namespace mgbubble {
 
-void HttpMessage::data_to_arg(uint8_t rpc_version) {
-
-    auto vargv_to_argv = [this]() {
-        // convert to char** argv
-        int i = 0;
-        for(auto& iter : this->vargv_){
-            if (i >= max_paramters){
-                break;
-            }
-            this->argv_[i++] = iter.c_str();
-        }
-        argc_ = i;
-    };
-
+Json::Value HttpMessage::parse_body() const {
     Json::Reader reader;
     Json::Value root;
     const char* begin = body().data();
     const char* end = body().data() + body().size();
-    if (!reader.parse(begin, end, root) || !root.isObject()) {
+    if (!reader.parse(begin, end, root)) {
+        throw libbitcoin::explorer::jsonrpc_parse_error();
+    }
+    return root;
+}
+
+void HttpMessage::data_to_arg(uint8_t rpc_version) {
+    const auto root = parse_body();
+    if (!root.isObject()) {
         throw libbitcoin::explorer::jsonrpc_parse_error();
     }
 
+    JsonRpcMessage request(root);
+    request.data_to_arg(rpc_version);
+    jsonrpc_id_ = request.jsonrpc_id();
+    vargv_ = request.args();
+    vargv_to_argv();
+}
+
+void JsonRpcMessage::data_to_arg(uint8_t rpc_version) {
+
+    const auto& root = root_;
+    if (!root.isObject()) {
+        throw libbitcoin::explorer::jsonrpc_invalid_request();
+    }
+
     if (root["method"].isString()) {
         vargv_.emplace_back(root["method"].asString());
     }
@@ -150,7 +159,11 @@ void WebsocketMessage::data_to_arg(uint8_t api_version) {
         }
     }while(!args.empty());
 
-    // convert to char** argv
+    vargv_to_argv();
+}
+
+void ToCommandArg::vargv_to_argv()
+{
     int i = 0;
     for(auto& iter : vargv_){
         if (i >= max_paramters){
@@ -23,7 +23,7 @@ using namespace std;
 
 namespace mgbubble {
 
-StreamBuf::StreamBuf(mbuf& buf) : buf_(buf)
+StreamBuf::StreamBuf(mbuf& buf) : buf_(buf), begin_(buf.len)
 {
   if (!buf_.buf) {
     // Pre-allocate buffer.
@@ -36,9 +36,10 @@ StreamBuf::StreamBuf(mbuf& buf) : buf_(buf)
 
 StreamBuf::~StreamBuf() noexcept = default;
 
+// Bytes of earlier responses not yet sent stay in the buffer.
 void StreamBuf::reset() noexcept
 {
-  buf_.len = 0;
+  buf_.len = begin_;
 }
 
 void StreamBuf::setContentLength(size_t pos, size_t len) noexcept
@@ -73,7 +74,7 @@ OStream::OStream() : ostream{nullptr}
 
 OStream::~OStream() noexcept = default;
 
-void OStream::reset(int status, const char* reason,const char *content_type,const char *charset) noexcept
+void OStream::reset(int status, const char* reason,const char *content_type,const char *charset, bool keep_alive) noexcept
 {
   rdbuf()->reset();
   mgbubble::reset(*this);
@@ -81,7 +82,8 @@ void OStream::reset(int status, const char* reason,const char *content_type,cons
   // Status-Line = HTTP-Version SP Status-Code SP Reason-Phrase CRLF. Use 10 space place-holder for
   // content length. RFC2616 states that field value MAY be preceded by any amount of LWS, though a
   // single SP is preferred.
-  *this << "HTTP/1.1 " << status << ' ' << reason << "\r\nContent-Type: "<< content_type<<";charset="<<charset<<"\r\nContent-Length:           \r\n\r\n";
+  *this << "HTTP/1.1 " << status << ' ' << reason << "\r\nContent-Type: "<< content_type<<";charset="<<charset
+    << "\r\nConnection: " << (keep_alive ? "keep-alive" : "close") << "\r\nContent-Length:           \r\n\r\n";
   headSize_ = size();
   lengthAt_ = headSize_ - 4;
 }
@@ -75,6 +75,16 @@ options_metadata parser::load_options()
             default_value(false)->zero_tokens(),
         "Initialize blockchain in the configured directory."
     )
+    (
+        "export-snapshot",
+        value<path>(&configured.export_snapshot),
+        "Write a snapshot archive of the blockchain database of a stopped node to the given file and exit, a running node exports with the exportsnapshot command."
+    )
+    (
+        "import-snapshot",
+        value<path>(&configured.import_snapshot),
+        "Initialize the blockchain database from the given snapshot archive, then start the node."
+    )
     (
         BS_SETTINGS_VARIABLE ",s",
         value<bool>(&configured.settings)->
@@ -298,6 +308,11 @@ options_metadata parser::load_settings()
         value<uint32_t>(&configured.database.stealth_start_height),
         "The lower limit of stealth indexing, defaults to 350000."
     )
+    (
+        "database.prune_depth",
+        value<uint32_t>(&configured.database.prune_depth),
+        "The number of recent blocks for which spent history and transactions are kept, defaults to 0 (no pruning)."
+    )
     (
         "database.directory",
         value<path>(&configured.database.directory),
@@ -325,6 +340,16 @@ options_metadata parser::load_settings()
         value<bool>(&configured.chain.use_testnet_rules),
         "Use testnet rules for determination of work required, defaults to false."
     )
+    (
+        "blockchain.block_trace_threshold_ms",
+        value<uint32_t>(&configured.chain.block_trace_threshold_ms),
+        "Write a trace of any block that takes longer than this to process, defaults to 0 (disabled)."
+    )
+    (
+        "blockchain.block_trace_directory",
+        value<path>(&configured.chain.block_trace_directory),
+        "The directory for slow block traces, defaults to 'block-trace'."
+    )
     (
         "blockchain.checkpoint",
         value<config::checkpoint::list>(&configured.chain.checkpoints),
@@ -548,6 +573,11 @@ bool parser::parse(int argc, const char* argv[], std::ostream& error)
         // Update bound variables in metadata.settings.
         notify(variables);
 
+        // A pruned node does not serve the full block chain.
+        if (configured.database.prune_depth != 0)
+            configured.network.services &=
+                ~static_cast<uint64_t>(services::node_network);
+
         // Clear the config file path if it wasn't used.
         if (!file)
             configured.file.clear();
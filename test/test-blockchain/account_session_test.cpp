@@ -0,0 +1,155 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef ACCOUNT_SESSION_TESTS
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/blockchain/account_session.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::blockchain;
+
+static ec_secret make_secret(uint8_t fill)
+{
+    ec_secret secret;
+    secret.fill(fill);
+    return secret;
+}
+
+static hash_digest make_passwd(const std::string& passwd)
+{
+    return sha256_hash(data_chunk(passwd.begin(), passwd.end()));
+}
+
+static const account_session::address_key_list keys
+{
+    { "MAddress1", make_secret(0x11) },
+    { "MAddress2", make_secret(0x22) }
+};
+
+BOOST_AUTO_TEST_SUITE(account_session_tests)
+
+BOOST_AUTO_TEST_CASE(account_session__find__unlocked__returns_key)
+{
+    account_session sessions;
+    const auto passwd = make_passwd("secret");
+    sessions.unlock("alice", passwd, keys, 60);
+
+    ec_secret out;
+    BOOST_REQUIRE(sessions.find(out, "alice", passwd, "MAddress2"));
+    BOOST_REQUIRE(out == make_secret(0x22));
+    BOOST_REQUIRE(sessions.find(out, "alice", passwd, "MAddress1"));
+    BOOST_REQUIRE(out == make_secret(0x11));
+
+    BOOST_REQUIRE(!sessions.find(out, "alice", passwd, "MOther"));
+    BOOST_REQUIRE(!sessions.find(out, "bob", passwd, "MAddress1"));
+
+    const auto left = sessions.remaining("alice");
+    BOOST_REQUIRE_GT(left, 0u);
+    BOOST_REQUIRE_LE(left, 60u);
+    BOOST_REQUIRE_EQUAL(sessions.remaining("bob"), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(account_session__find__wrong_passwd__refused)
+{
+    account_session sessions;
+    sessions.unlock("alice", make_passwd("secret"), keys, 60);
+
+    ec_secret out;
+    BOOST_REQUIRE(!sessions.find(out, "alice", make_passwd("guess"), "MAddress1"));
+}
+
+BOOST_AUTO_TEST_CASE(account_session__unlock__clamps_to_max)
+{
+    account_session sessions;
+    sessions.unlock("alice", make_passwd("secret"), keys, max_uint32);
+    BOOST_REQUIRE_LE(sessions.remaining("alice"),
+        account_session::max_unlock_seconds);
+    BOOST_REQUIRE_GT(sessions.remaining("alice"),
+        account_session::max_unlock_seconds - 60);
+}
+
+BOOST_AUTO_TEST_CASE(account_session__find__expired__wiped)
+{
+    account_session sessions;
+    const auto passwd = make_passwd("secret");
+    sessions.unlock("alice", passwd, keys, 0);
+    sessions.unlock("bob", passwd, keys, 1);
+
+    ec_secret out;
+    BOOST_REQUIRE(!sessions.find(out, "alice", passwd, "MAddress1"));
+    BOOST_REQUIRE_EQUAL(sessions.remaining("alice"), 0u);
+    BOOST_REQUIRE(sessions.find(out, "bob", passwd, "MAddress1"));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    BOOST_REQUIRE(!sessions.find(out, "bob", passwd, "MAddress1"));
+    BOOST_REQUIRE_EQUAL(sessions.remaining("bob"), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(account_session__lock__wipes_only_that_account)
+{
+    account_session sessions;
+    const auto passwd = make_passwd("secret");
+    sessions.unlock("alice", passwd, keys, 60);
+    sessions.unlock("bob", passwd, keys, 60);
+
+    sessions.lock("alice");
+    ec_secret out;
+    BOOST_REQUIRE(!sessions.find(out, "alice", passwd, "MAddress1"));
+    BOOST_REQUIRE_EQUAL(sessions.remaining("alice"), 0u);
+    BOOST_REQUIRE(sessions.find(out, "bob", passwd, "MAddress1"));
+
+    // Locking again, or an account never unlocked, is harmless.
+    sessions.lock("alice");
+    sessions.lock("carol");
+    BOOST_REQUIRE(sessions.find(out, "bob", passwd, "MAddress1"));
+}
+
+BOOST_AUTO_TEST_CASE(account_session__unlock__replaces_earlier_keys)
+{
+    account_session sessions;
+    sessions.unlock("alice", make_passwd("old"), keys, 60);
+
+    // A password change unlocks again with the new hash and keys.
+    const auto passwd = make_passwd("new");
+    sessions.unlock("alice", passwd, { { "MAddress1", make_secret(0x33) } }, 60);
+
+    ec_secret out;
+    BOOST_REQUIRE(!sessions.find(out, "alice", make_passwd("old"), "MAddress1"));
+    BOOST_REQUIRE(!sessions.find(out, "alice", passwd, "MAddress2"));
+    BOOST_REQUIRE(sessions.find(out, "alice", passwd, "MAddress1"));
+    BOOST_REQUIRE(out == make_secret(0x33));
+}
+
+BOOST_AUTO_TEST_CASE(account_session__unlock__no_keys)
+{
+    account_session sessions;
+    const auto passwd = make_passwd("secret");
+    sessions.unlock("alice", passwd, {}, 60);
+
+    ec_secret out;
+    BOOST_REQUIRE_GT(sessions.remaining("alice"), 0u);
+    BOOST_REQUIRE(!sessions.find(out, "alice", passwd, "MAddress1"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
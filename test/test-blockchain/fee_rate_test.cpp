@@ -0,0 +1,179 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef FEE_RATE_TESTS
+#include <algorithm>
+#include <boost/test/unit_test.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/blockchain/fee_estimator.hpp>
+#include <metaverse/blockchain/fee_rate_index.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::blockchain;
+
+// Transactions of equal size, distinct by lock time, spending the given
+// parents (or a null point).
+static chain::transaction make_tx(uint32_t id, const hash_list& parents={})
+{
+    chain::transaction tx;
+    tx.version = 1;
+    tx.locktime = id;
+
+    if (parents.empty())
+        tx.inputs.push_back({ { null_hash, 0 }, {}, max_input_sequence });
+
+    for (const auto& parent: parents)
+        tx.inputs.push_back({ { parent, 0 }, {}, max_input_sequence });
+
+    chain::output output;
+    output.value = 1;
+    tx.outputs.push_back(output);
+    return tx;
+}
+
+BOOST_AUTO_TEST_SUITE(fee_rate_tests)
+
+BOOST_AUTO_TEST_CASE(fee_rate_index__ranked__highest_rate_first)
+{
+    fee_rate_index index;
+    const auto low = make_tx(1);
+    const auto high = make_tx(2);
+    BOOST_REQUIRE(index.add(low, 10000));
+    BOOST_REQUIRE(index.add(high, 50000));
+    BOOST_REQUIRE(!index.add(high, 50000));
+
+    const auto ranked = index.ranked();
+    BOOST_REQUIRE_EQUAL(ranked.size(), 2u);
+    BOOST_REQUIRE(ranked[0] == high.hash());
+    BOOST_REQUIRE(ranked[1] == low.hash());
+    BOOST_REQUIRE_EQUAL(index.ranked(1).size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(fee_rate_index__child__pays_for_parent)
+{
+    fee_rate_index index;
+    const auto parent = make_tx(1);
+    const auto other = make_tx(2);
+    const auto child = make_tx(3, { parent.hash() });
+    const auto size = parent.serialized_size() + child.serialized_size();
+
+    BOOST_REQUIRE(index.add(parent, 0));
+    BOOST_REQUIRE(index.add(other, 20000));
+    BOOST_REQUIRE(index.add(child, 100000));
+
+    uint64_t rate;
+    BOOST_REQUIRE(index.package_fee_rate(rate, child.hash()));
+    BOOST_REQUIRE_EQUAL(rate, fee_rate_index::to_fee_rate(100000, size));
+    BOOST_REQUIRE(index.package_fee_rate(rate, parent.hash()));
+    BOOST_REQUIRE_EQUAL(rate, 0u);
+
+    // The child's package goes first, its parent ahead of it.
+    auto ranked = index.ranked();
+    BOOST_REQUIRE_EQUAL(ranked.size(), 3u);
+    BOOST_REQUIRE(ranked[0] == parent.hash());
+    BOOST_REQUIRE(ranked[1] == child.hash());
+    BOOST_REQUIRE(ranked[2] == other.hash());
+
+    // A limited ranking is still a prefix that never leaves out a parent.
+    ranked = index.ranked(1);
+    BOOST_REQUIRE_EQUAL(ranked.size(), 1u);
+    BOOST_REQUIRE(ranked[0] == parent.hash());
+
+    // A confirmed parent leaves the child's package.
+    BOOST_REQUIRE(index.remove(parent.hash()));
+    BOOST_REQUIRE(!index.remove(parent.hash()));
+    BOOST_REQUIRE(index.package_fee_rate(rate, child.hash()));
+    BOOST_REQUIRE_EQUAL(rate, fee_rate_index::to_fee_rate(100000,
+        child.serialized_size()));
+    BOOST_REQUIRE_EQUAL(index.ranked().size(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE(fee_rate_index__diamond__counts_ancestor_once)
+{
+    fee_rate_index index;
+    const auto root = make_tx(1);
+    const auto left = make_tx(2, { root.hash() });
+    const auto right = make_tx(3, { root.hash() });
+    const auto join = make_tx(4, { left.hash(), right.hash() });
+
+    BOOST_REQUIRE(index.add(root, 1000));
+    BOOST_REQUIRE(index.add(left, 2000));
+    BOOST_REQUIRE(index.add(right, 3000));
+    BOOST_REQUIRE(index.add(join, 4000));
+
+    const auto size = root.serialized_size() + left.serialized_size() +
+        right.serialized_size() + join.serialized_size();
+
+    uint64_t rate;
+    BOOST_REQUIRE(index.package_fee_rate(rate, join.hash()));
+    BOOST_REQUIRE_EQUAL(rate, fee_rate_index::to_fee_rate(10000, size));
+
+    // Every transaction follows all of its parents exactly once.
+    const auto ranked = index.ranked();
+    BOOST_REQUIRE_EQUAL(ranked.size(), 4u);
+    const auto position = [&ranked](const chain::transaction& tx)
+    {
+        return std::find(ranked.begin(), ranked.end(), tx.hash()) -
+            ranked.begin();
+    };
+
+    BOOST_REQUIRE_LT(position(root), position(left));
+    BOOST_REQUIRE_LT(position(root), position(right));
+    BOOST_REQUIRE_LT(position(left), position(join));
+    BOOST_REQUIRE_LT(position(right), position(join));
+}
+
+BOOST_AUTO_TEST_CASE(fee_estimator__estimate__follows_confirmations)
+{
+    fee_estimator estimator;
+    uint64_t rate;
+    BOOST_REQUIRE(!estimator.estimate(rate, 1));
+
+    estimator.set_height(100);
+
+    chain::block block;
+    for (uint32_t id = 0; id < 10; ++id)
+    {
+        block.transactions.push_back(make_tx(id));
+        estimator.track(block.transactions.back().hash(), 100000);
+    }
+
+    estimator.confirm(block, 101);
+    BOOST_REQUIRE(estimator.estimate(rate, 1));
+    BOOST_REQUIRE_LE(rate, 100000u);
+    BOOST_REQUIRE(!estimator.estimate(rate, 0));
+    BOOST_REQUIRE(!estimator.estimate(rate, fee_estimator::max_target + 1));
+
+    // Cheap transactions waiting past the target do not meet it.
+    for (uint32_t id = 100; id < 110; ++id)
+        estimator.track(make_tx(id).hash(), 5000);
+
+    estimator.confirm({}, 102);
+    estimator.confirm({}, 103);
+    BOOST_REQUIRE(estimator.estimate(rate, 1));
+    BOOST_REQUIRE_GT(rate, 5000u);
+
+    // Once they leave the pool they are no longer counted.
+    estimator.untrack_all();
+    BOOST_REQUIRE(estimator.estimate(rate, 1));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
@@ -0,0 +1,344 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef SCRIPT_FAST_PATH_TESTS
+#include <boost/test/unit_test.hpp>
+#include <random>
+#include <string>
+#include <vector>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/blockchain/validate_transaction.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::chain;
+using namespace libbitcoin::blockchain;
+
+// Differential corpus for validate_transaction::check_standard: every case
+// must give the interpreter's answer, whether or not the fast path claims it.
+
+static const std::vector<uint32_t> flag_sets
+{
+    script_context::none_enabled,
+    script_context::bip66_enabled,
+    script_context::bip16_enabled | script_context::bip66_enabled |
+        script_context::bip65_enabled | script_context::attenuation_enabled |
+        script_context::bip112_enabled
+};
+
+static ec_secret make_secret(const std::string& seed)
+{
+    return sha256_hash(data_chunk(seed.begin(), seed.end()));
+}
+
+static data_chunk compressed_key(const ec_secret& secret)
+{
+    ec_compressed point;
+    BOOST_REQUIRE(secret_to_public(point, secret));
+    return to_chunk(point);
+}
+
+static data_chunk uncompressed_key(const ec_secret& secret)
+{
+    ec_uncompressed point;
+    BOOST_REQUIRE(secret_to_public(point, secret));
+    return to_chunk(point);
+}
+
+static script make_script(const operation::stack& ops)
+{
+    script out;
+    out.operations = ops;
+    return out;
+}
+
+static transaction make_transaction(size_t outputs)
+{
+    transaction tx;
+    tx.version = transaction_version::first;
+    tx.locktime = 0;
+
+    for (uint32_t index = 0; index < 2; ++index)
+    {
+        const std::string seed("fast-path-prevout-" + std::to_string(index));
+        tx.inputs.push_back({ output_point(make_secret(seed), index), {},
+            max_input_sequence });
+    }
+
+    for (size_t index = 0; index < outputs; ++index)
+    {
+        const auto value = 1000 + index;
+        tx.outputs.push_back({ value,
+            make_script(operation::to_pay_key_hash_pattern(null_short_hash)),
+            attachment(ETP_TYPE, ATTACH_INIT_VERSION, etp(value)) });
+    }
+
+    return tx;
+}
+
+static endorsement sign(const ec_secret& secret, const script& prevout,
+    const transaction& tx, uint32_t index, uint8_t sighash_type)
+{
+    endorsement endorse;
+    BOOST_REQUIRE(script::create_endorsement(endorse, secret, prevout, tx,
+        index, sighash_type));
+    return endorse;
+}
+
+// Pad R with a redundant zero byte: lax DER still parses it, strict does not.
+static endorsement pad_r(const endorsement& endorse)
+{
+    auto padded = endorse;
+    padded.insert(padded.begin() + 4, 0x00);
+    padded[1] += 1;
+    padded[3] += 1;
+    return padded;
+}
+
+static void set_input(transaction& tx, uint32_t index,
+    const operation::stack& ops)
+{
+    tx.inputs[index].script.operations = ops;
+}
+
+static void check_case(const std::string& name, const script& prevout,
+    const transaction& tx, uint32_t index, bool expect_standard)
+{
+    for (const auto flags: flag_sets)
+    {
+        const auto expected = validate_transaction::check_interpreter(prevout,
+            tx, index, flags);
+        const auto actual = validate_transaction::check_consensus(prevout, tx,
+            index, flags);
+
+        bool fast = false;
+        const auto standard = validate_transaction::check_standard(prevout, tx,
+            index, flags, fast);
+
+        BOOST_CHECK_MESSAGE(expected == actual, name << " flags " << flags);
+        BOOST_CHECK_MESSAGE(standard == expect_standard, name << " template");
+        if (standard)
+            BOOST_CHECK_MESSAGE(fast == expected, name << " fast path " << flags);
+    }
+}
+
+static const auto secret = make_secret("fast-path-key");
+static const auto other_secret = make_secret("fast-path-other-key");
+
+BOOST_AUTO_TEST_SUITE(script_fast_path_tests)
+
+BOOST_AUTO_TEST_CASE(pay_key_hash_corpus)
+{
+    const auto public_key = compressed_key(secret);
+    const auto prevout = make_script(operation::to_pay_key_hash_pattern(
+        bitcoin_short_hash(public_key)));
+
+    const std::vector<uint8_t> sighash_types
+    {
+        signature_hash_algorithm::all,
+        signature_hash_algorithm::none,
+        signature_hash_algorithm::single,
+        signature_hash_algorithm::all | signature_hash_algorithm::anyone_can_pay,
+        signature_hash_algorithm::single | signature_hash_algorithm::anyone_can_pay
+    };
+
+    for (const auto outputs: { 1, 2 })
+    {
+        for (const auto type: sighash_types)
+        {
+            for (uint32_t index = 0; index < 2; ++index)
+            {
+                auto tx = make_transaction(outputs);
+                const auto name = "p2pkh outputs " + std::to_string(outputs) +
+                    " type " + std::to_string(type) + " input " +
+                    std::to_string(index);
+
+                const auto endorse = sign(secret, prevout, tx, index, type);
+                set_input(tx, index, { { opcode::special, endorse },
+                    { opcode::special, public_key } });
+                check_case(name + " valid", prevout, tx, index, true);
+
+                set_input(tx, index, { { opcode::pushdata1, endorse },
+                    { opcode::pushdata2, public_key } });
+                check_case(name + " long pushes", prevout, tx, index, true);
+
+                set_input(tx, index, { { opcode::special, pad_r(endorse) },
+                    { opcode::special, public_key } });
+                check_case(name + " padded der", prevout, tx, index, true);
+
+                auto flipped = endorse;
+                flipped[flipped.size() / 2] ^= 0x01;
+                set_input(tx, index, { { opcode::special, flipped },
+                    { opcode::special, public_key } });
+                check_case(name + " flipped", prevout, tx, index, true);
+
+                auto retyped = endorse;
+                retyped.back() ^= signature_hash_algorithm::anyone_can_pay;
+                set_input(tx, index, { { opcode::special, retyped },
+                    { opcode::special, public_key } });
+                check_case(name + " retyped", prevout, tx, index, true);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(pay_key_hash_malformed_inputs)
+{
+    const auto public_key = compressed_key(secret);
+    const auto hash = bitcoin_short_hash(public_key);
+    const auto prevout = make_script(operation::to_pay_key_hash_pattern(hash));
+    auto tx = make_transaction(1);
+    const auto endorse = sign(secret, prevout, tx, 0,
+        signature_hash_algorithm::all);
+
+    set_input(tx, 0, { { opcode::zero, {} }, { opcode::special, public_key } });
+    check_case("empty signature", prevout, tx, 0, true);
+
+    set_input(tx, 0, { { opcode::special, { endorse.back() } },
+        { opcode::special, public_key } });
+    check_case("sighash byte only", prevout, tx, 0, true);
+
+    set_input(tx, 0, { { opcode::special, endorse },
+        { opcode::special, compressed_key(other_secret) } });
+    check_case("other key", prevout, tx, 0, true);
+
+    auto bad_key = public_key;
+    bad_key[0] = 0x05;
+    set_input(tx, 0, { { opcode::special, endorse },
+        { opcode::special, bad_key } });
+    check_case("bad key header", prevout, tx, 0, true);
+
+    set_input(tx, 0, { { opcode::special, endorse } });
+    check_case("missing key", prevout, tx, 0, false);
+
+    set_input(tx, 0, { { opcode::special, endorse },
+        { opcode::special, public_key }, { opcode::special, public_key } });
+    check_case("extra push", prevout, tx, 0, false);
+
+    set_input(tx, 0, { { opcode::special, endorse },
+        { opcode::special, public_key }, { opcode::drop, {} } });
+    check_case("non push", prevout, tx, 0, false);
+
+    set_input(tx, 0, { { opcode::special, to_chunk(hash) },
+        { opcode::special, public_key } });
+    check_case("signature equals script push", prevout, tx, 0, false);
+}
+
+BOOST_AUTO_TEST_CASE(pay_key_hash_uncompressed_key)
+{
+    const auto public_key = uncompressed_key(secret);
+    const auto prevout = make_script(operation::to_pay_key_hash_pattern(
+        bitcoin_short_hash(public_key)));
+    auto tx = make_transaction(2);
+
+    const auto endorse = sign(secret, prevout, tx, 1,
+        signature_hash_algorithm::all);
+    set_input(tx, 1, { { opcode::special, endorse },
+        { opcode::special, public_key } });
+    check_case("uncompressed", prevout, tx, 1, true);
+
+    set_input(tx, 1, { { opcode::special, endorse },
+        { opcode::special, compressed_key(secret) } });
+    check_case("compressed against uncompressed hash", prevout, tx, 1, true);
+}
+
+BOOST_AUTO_TEST_CASE(pay_key_hash_with_lock_height_corpus)
+{
+    const auto public_key = compressed_key(secret);
+    const auto hash = bitcoin_short_hash(public_key);
+
+    for (const uint32_t height: { 1u, 127u, 128u, 255u, 1000u, 65536u, 0x7fffffffu })
+    {
+        const auto prevout = make_script(operation::to_pay_key_hash_with_lock_height_pattern(
+            hash, height));
+        auto tx = make_transaction(1);
+        const auto endorse = sign(secret, prevout, tx, 0,
+            signature_hash_algorithm::all);
+        const auto number = prevout.operations[0].data;
+        const auto name = "lock height " + std::to_string(height);
+
+        set_input(tx, 0, { { opcode::special, endorse },
+            { opcode::special, public_key }, { opcode::special, number } });
+        check_case(name + " valid", prevout, tx, 0, true);
+
+        auto padded = number;
+        padded.push_back(0x00);
+        set_input(tx, 0, { { opcode::special, endorse },
+            { opcode::special, public_key }, { opcode::special, padded } });
+        check_case(name + " non minimal number", prevout, tx, 0, true);
+
+        auto negative = number;
+        negative.back() |= 0x80;
+        set_input(tx, 0, { { opcode::special, endorse },
+            { opcode::special, public_key }, { opcode::special, negative } });
+        check_case(name + " negated number", prevout, tx, 0, true);
+
+        set_input(tx, 0, { { opcode::special, endorse },
+            { opcode::special, public_key },
+            { opcode::special, { 0x01, 0x00, 0x00, 0x00, 0x00 } } });
+        check_case(name + " oversized number", prevout, tx, 0, true);
+
+        set_input(tx, 0, { { opcode::special, endorse },
+            { opcode::special, public_key } });
+        check_case(name + " missing number", prevout, tx, 0, false);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(other_templates_use_interpreter)
+{
+    const auto public_key = compressed_key(secret);
+    const auto hash = bitcoin_short_hash(public_key);
+    const auto prevout = make_script(operation::to_pay_key_hash_with_sequence_lock_pattern(
+        hash, 10));
+    auto tx = make_transaction(1);
+    const auto endorse = sign(secret, prevout, tx, 0,
+        signature_hash_algorithm::all);
+
+    set_input(tx, 0, { { opcode::special, endorse },
+        { opcode::special, public_key } });
+    check_case("sequence lock", prevout, tx, 0, false);
+}
+
+BOOST_AUTO_TEST_CASE(pay_key_hash_random_mutations)
+{
+    const auto public_key = compressed_key(secret);
+    const auto prevout = make_script(operation::to_pay_key_hash_pattern(
+        bitcoin_short_hash(public_key)));
+    const auto base = make_transaction(2);
+
+    // Deterministic so a failure can be replayed.
+    std::mt19937 random(42);
+    for (size_t round = 0; round < 200; ++round)
+    {
+        auto tx = base;
+        auto endorse = sign(secret, prevout, tx, 0,
+            signature_hash_algorithm::all);
+        auto key = public_key;
+
+        auto& target = (round % 3 == 0) ? key : endorse;
+        const auto position = random() % target.size();
+        target[position] ^= static_cast<uint8_t>(1u << (random() % 8));
+
+        set_input(tx, 0, { { opcode::special, endorse },
+            { opcode::special, key } });
+        check_case("mutation " + std::to_string(round), prevout, tx, 0, true);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
@@ -0,0 +1,151 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef SHA256_TESTS
+#include <boost/test/unit_test.hpp>
+#include <functional>
+#include <string>
+#include <metaverse/bitcoin.hpp>
+
+using namespace libbitcoin;
+
+// Known answers and differential checks for every sha256 implementation
+// this cpu can run; the scalar transform is the reference.
+
+static const std::vector<sha256_implementation> implementations
+{
+    sha256_implementation::scalar,
+    sha256_implementation::sse41,
+    sha256_implementation::avx2,
+    sha256_implementation::shani
+};
+
+static void for_each_implementation(
+    std::function<void(sha256_implementation)> check)
+{
+    for (const auto implementation: implementations)
+    {
+        if (!sha256_select(implementation))
+            continue;
+
+        BOOST_TEST_MESSAGE("sha256 implementation "
+            << static_cast<int>(implementation));
+        check(implementation);
+    }
+
+    // Leave the widest lanes in place for the other tests.
+    for (auto it = implementations.rbegin(); it != implementations.rend(); ++it)
+        if (*it != sha256_implementation::shani && sha256_select(*it))
+            break;
+}
+
+static data_chunk pattern(size_t size, uint8_t seed)
+{
+    data_chunk data(size);
+    for (size_t i = 0; i < size; ++i)
+        data[i] = static_cast<uint8_t>(i * 7 + seed);
+
+    return data;
+}
+
+BOOST_AUTO_TEST_SUITE(sha256_tests)
+
+BOOST_AUTO_TEST_CASE(sha256_known_answers)
+{
+    const std::string abc = "abc";
+    const std::string two_blocks =
+        "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    const data_chunk million(1000000, 'a');
+
+    for_each_implementation([&](sha256_implementation)
+    {
+        BOOST_REQUIRE_EQUAL(encode_base16(sha256_hash(to_chunk(abc))),
+            "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+        BOOST_REQUIRE_EQUAL(encode_base16(sha256_hash(to_chunk(two_blocks))),
+            "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+        BOOST_REQUIRE_EQUAL(encode_base16(sha256_hash(million)),
+            "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+    });
+}
+
+BOOST_AUTO_TEST_CASE(bitcoin_hash_pairs_known_answers)
+{
+    for_each_implementation([](sha256_implementation)
+    {
+        hash_list zeros{ null_hash, null_hash };
+        bitcoin_hash_pairs(zeros);
+        BOOST_REQUIRE_EQUAL(zeros.size(), 1u);
+        BOOST_REQUIRE_EQUAL(encode_base16(zeros.front()),
+            "e2f61c3f71d1defd3fa999dfa36953755c690689799962b48bebd836974e8cf9");
+    });
+}
+
+BOOST_AUTO_TEST_CASE(bitcoin_hash_pairs_matches_scalar)
+{
+    // Counts around the 4 and 8 lane widths exercise every tail.
+    for (size_t pairs = 0; pairs <= 33; ++pairs)
+    {
+        const auto data = pattern(pairs * 2 * hash_size,
+            static_cast<uint8_t>(pairs));
+
+        hash_list expected;
+        for (size_t i = 0; i < pairs; ++i)
+        {
+            const auto begin = data.begin() + i * 2 * hash_size;
+            expected.push_back(bitcoin_hash(
+                data_chunk(begin, begin + 2 * hash_size)));
+        }
+
+        for_each_implementation([&](sha256_implementation)
+        {
+            hash_list hashes(pairs * 2);
+            for (size_t i = 0; i < hashes.size(); ++i)
+                std::copy_n(data.begin() + i * hash_size, hash_size,
+                    hashes[i].begin());
+
+            bitcoin_hash_pairs(hashes);
+            BOOST_REQUIRE(hashes == expected);
+        });
+    }
+}
+
+BOOST_AUTO_TEST_CASE(merkle_root_known_answer)
+{
+    // Bitcoin block 100000.
+    for_each_implementation([](sha256_implementation)
+    {
+        hash_list level
+        {
+            hash_literal("8c14f0db3df150123e6f3dbbf30f8b955a8249b62ac1d1ff16284aefa3d06d87"),
+            hash_literal("fff2525b8931402dd09222c50775608f75787bd2b87e56995a7bdd30f79702c4"),
+            hash_literal("6359f0868171b1d194cbee1af2f16ea598ae8fad666d9b012c8ed2b79a236ec4"),
+            hash_literal("e9a66845e05d5abc0ad04ec80f774a7e585c6e8db975962d069a522137b80c1d")
+        };
+
+        while (level.size() > 1)
+            bitcoin_hash_pairs(level);
+
+        BOOST_REQUIRE(level.front() == hash_literal(
+            "f3e94742aca4b5ef85488dc37c06c3282295ffec960994b2c0d5ac2a25a95766"));
+    });
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
@@ -0,0 +1,126 @@
+#ifdef  DATABASE_TESTS
+#include <string>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/data_base.hpp>
+#include <boost/test/unit_test.hpp>
+#include "store_fixture.hpp"
+
+using namespace libbitcoin;
+using namespace libbitcoin::chain;
+using namespace libbitcoin::database;
+using test::store_fixture;
+
+static short_hash account_key(const std::string& name)
+{
+    return ripemd160_hash(data_chunk(name.begin(), name.end()));
+}
+
+static account_address make_address(const std::string& name,
+    const std::string& address, uint64_t balance=0)
+{
+    return account_address(name, "", "", 0, balance, "", address, 0);
+}
+
+BOOST_AUTO_TEST_SUITE(account_address_index_tests)
+
+BOOST_AUTO_TEST_CASE(account_address_database__store__point_lookup_and_owners)
+{
+    store_fixture fixture;
+    auto& addresses = fixture.store->account_addresses;
+    addresses.store(account_key("alice"), make_address("alice", "MAlice1"));
+    addresses.store(account_key("alice"), make_address("alice", "MAlice2"));
+    addresses.store(account_key("bob"), make_address("bob", "MAlice2"));
+
+    // A duplicate is not stored again.
+    addresses.store(account_key("alice"), make_address("alice", "MAlice1"));
+    BOOST_REQUIRE_EQUAL(addresses.get(account_key("alice")).size(), 2u);
+
+    // Changed data replaces the row of the address.
+    addresses.store(account_key("alice"), make_address("alice", "MAlice1", 7));
+    BOOST_REQUIRE_EQUAL(addresses.get(account_key("alice")).size(), 2u);
+
+    const auto found = addresses.get(account_key("alice"), "MAlice1");
+    BOOST_REQUIRE(found);
+    BOOST_REQUIRE_EQUAL(found->get_balance(), 7u);
+    BOOST_REQUIRE(!addresses.get(account_key("bob"), "MAlice1"));
+
+    const auto owners = addresses.get_address_owners("MAlice2");
+    BOOST_REQUIRE_EQUAL(owners.size(), 2u);
+    BOOST_REQUIRE_EQUAL(owners[0], "alice");
+    BOOST_REQUIRE_EQUAL(owners[1], "bob");
+    BOOST_REQUIRE(addresses.get_address_owners("MNobody").empty());
+}
+
+BOOST_AUTO_TEST_CASE(account_address_database__start__rebuilds_index)
+{
+    store_fixture fixture;
+    fixture.store->account_addresses.store(account_key("alice"),
+        make_address("alice", "MAlice1"));
+    fixture.store->account_addresses.store(account_key("alice"),
+        make_address("alice", "MAlice2", 5));
+    fixture.store->account_addresses.store(account_key("bob"),
+        make_address("bob", "MBob1"));
+    fixture.store->account_addresses.sync();
+
+    fixture.close();
+    fixture.open();
+
+    const auto& addresses = fixture.store->account_addresses;
+    const auto found = addresses.get(account_key("alice"), "MAlice2");
+    BOOST_REQUIRE(found);
+    BOOST_REQUIRE_EQUAL(found->get_balance(), 5u);
+    BOOST_REQUIRE(addresses.get(account_key("alice"), "MAlice1"));
+    BOOST_REQUIRE(addresses.get(account_key("bob"), "MBob1"));
+    BOOST_REQUIRE(!addresses.get(account_key("bob"), "MAlice1"));
+    BOOST_REQUIRE_EQUAL(addresses.get_address_owners("MBob1").size(), 1u);
+    BOOST_REQUIRE_EQUAL(addresses.get_address_owners("MBob1").front(), "bob");
+}
+
+BOOST_AUTO_TEST_CASE(account_address_database__delete_last_row__updates_index)
+{
+    store_fixture fixture;
+    auto& addresses = fixture.store->account_addresses;
+    addresses.store(account_key("alice"), make_address("alice", "MAlice1"));
+    addresses.store(account_key("alice"), make_address("alice", "MAlice2"));
+
+    addresses.delete_last_row(account_key("alice"));
+    BOOST_REQUIRE(!addresses.get(account_key("alice"), "MAlice2"));
+    BOOST_REQUIRE(addresses.get_address_owners("MAlice2").empty());
+    BOOST_REQUIRE(addresses.get(account_key("alice"), "MAlice1"));
+
+    // The address can be stored again after it is gone.
+    addresses.store(account_key("alice"), make_address("alice", "MAlice2"));
+    BOOST_REQUIRE(addresses.get(account_key("alice"), "MAlice2"));
+    BOOST_REQUIRE_EQUAL(addresses.get(account_key("alice")).size(), 2u);
+
+    addresses.delete_last_row(account_key("alice"));
+    addresses.delete_last_row(account_key("alice"));
+    BOOST_REQUIRE(addresses.get(account_key("alice")).empty());
+    BOOST_REQUIRE(!addresses.get(account_key("alice"), "MAlice1"));
+    BOOST_REQUIRE(addresses.get_address_owners("MAlice1").empty());
+
+    // Popping an empty key is harmless.
+    addresses.delete_last_row(account_key("alice"));
+}
+
+BOOST_AUTO_TEST_CASE(account_address_database__delete_last_row__safe_store_duplicate__keeps_older_row)
+{
+    store_fixture fixture;
+    auto& addresses = fixture.store->account_addresses;
+    addresses.safe_store(account_key("alice"), make_address("alice", "MAlice1", 1));
+    addresses.safe_store(account_key("alice"), make_address("alice", "MAlice1", 2));
+
+    const auto newest = addresses.get(account_key("alice"), "MAlice1");
+    BOOST_REQUIRE(newest);
+    BOOST_REQUIRE_EQUAL(newest->get_balance(), 2u);
+
+    // Popping the newer row finds the older one again.
+    addresses.delete_last_row(account_key("alice"));
+    const auto older = addresses.get(account_key("alice"), "MAlice1");
+    BOOST_REQUIRE(older);
+    BOOST_REQUIRE_EQUAL(older->get_balance(), 1u);
+    BOOST_REQUIRE_EQUAL(addresses.get_address_owners("MAlice1").size(), 1u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
@@ -0,0 +1,127 @@
+#ifdef  DATABASE_TESTS
+#include <set>
+#include <string>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/data_base.hpp>
+#include <boost/test/unit_test.hpp>
+#include "store_fixture.hpp"
+
+using namespace libbitcoin;
+using namespace libbitcoin::chain;
+using namespace libbitcoin::database;
+using test::store_fixture;
+
+static hash_digest cert_key(const asset_cert& cert)
+{
+    const auto key = cert.get_key();
+    return sha256_hash(data_chunk(key.begin(), key.end()));
+}
+
+static std::set<std::string> symbols(
+    const std::shared_ptr<std::vector<asset_cert>>& certs)
+{
+    std::set<std::string> result;
+    for (const auto& cert: *certs)
+        result.insert(cert.get_symbol() + "/" + cert.get_type_name());
+
+    return result;
+}
+
+BOOST_AUTO_TEST_SUITE(asset_cert_index_tests)
+
+BOOST_AUTO_TEST_CASE(blockchain_asset_cert_database__get__by_address_and_type)
+{
+    store_fixture fixture;
+    auto& certs = fixture.store->certs;
+    certs.store(asset_cert("CERT.ONE", "alice", "MAlice", asset_cert_ns::issue));
+    certs.store(asset_cert("CERT.ONE", "alice", "MAlice", asset_cert_ns::domain));
+    certs.store(asset_cert("CERT.TWO", "bob", "MBob", asset_cert_ns::issue));
+
+    BOOST_REQUIRE_EQUAL(certs.get_blockchain_asset_certs("", asset_cert_ns::none)->size(), 3u);
+    BOOST_REQUIRE_EQUAL(certs.get_blockchain_asset_certs("MAlice", asset_cert_ns::none)->size(), 2u);
+    BOOST_REQUIRE(certs.get_blockchain_asset_certs("MNobody", asset_cert_ns::none)->empty());
+
+    const auto issued = certs.get_blockchain_asset_certs("", asset_cert_ns::issue);
+    BOOST_REQUIRE((symbols(issued) == std::set<std::string>{
+        "CERT.ONE/" + asset_cert::get_type_name(asset_cert_ns::issue),
+        "CERT.TWO/" + asset_cert::get_type_name(asset_cert_ns::issue) }));
+
+    const auto both = certs.get_blockchain_asset_certs("MBob", asset_cert_ns::issue);
+    BOOST_REQUIRE_EQUAL(both->size(), 1u);
+    BOOST_REQUIRE_EQUAL(both->front().get_symbol(), "CERT.TWO");
+    BOOST_REQUIRE(certs.get_blockchain_asset_certs("MBob", asset_cert_ns::domain)->empty());
+}
+
+BOOST_AUTO_TEST_CASE(blockchain_asset_cert_database__store__transfer_moves_address)
+{
+    store_fixture fixture;
+    auto& certs = fixture.store->certs;
+    const asset_cert issued("CERT.ONE", "alice", "MAlice", asset_cert_ns::issue);
+    certs.store(issued);
+
+    // A transfer stores the same key under a new address.
+    certs.store(asset_cert("CERT.ONE", "bob", "MBob", asset_cert_ns::issue));
+    BOOST_REQUIRE(certs.get_blockchain_asset_certs("MAlice", asset_cert_ns::none)->empty());
+    BOOST_REQUIRE_EQUAL(certs.get_blockchain_asset_certs("MBob", asset_cert_ns::issue)->size(), 1u);
+
+    // Popping the transfer gives the cert back to the earlier address.
+    certs.remove(cert_key(issued));
+    BOOST_REQUIRE(certs.get_blockchain_asset_certs("MBob", asset_cert_ns::none)->empty());
+    const auto back = certs.get_blockchain_asset_certs("MAlice", asset_cert_ns::issue);
+    BOOST_REQUIRE_EQUAL(back->size(), 1u);
+    BOOST_REQUIRE_EQUAL(back->front().get_owner(), "alice");
+
+    certs.remove(cert_key(issued));
+    BOOST_REQUIRE(certs.get_blockchain_asset_certs("MAlice", asset_cert_ns::none)->empty());
+    BOOST_REQUIRE(certs.get_blockchain_asset_certs("", asset_cert_ns::issue)->empty());
+}
+
+BOOST_AUTO_TEST_CASE(blockchain_asset_cert_database__start__rebuilds_index)
+{
+    store_fixture fixture;
+    fixture.store->certs.store(asset_cert("CERT.ONE", "alice", "MAlice", asset_cert_ns::issue));
+    fixture.store->certs.store(asset_cert("CERT.TWO", "bob", "MBob", asset_cert_ns::domain));
+    fixture.store->certs.sync();
+
+    fixture.close();
+    fixture.open();
+
+    const auto& certs = fixture.store->certs;
+    const auto alice = certs.get_blockchain_asset_certs("MAlice", asset_cert_ns::none);
+    BOOST_REQUIRE_EQUAL(alice->size(), 1u);
+    BOOST_REQUIRE_EQUAL(alice->front().get_symbol(), "CERT.ONE");
+
+    const auto domains = certs.get_blockchain_asset_certs("", asset_cert_ns::domain);
+    BOOST_REQUIRE_EQUAL(domains->size(), 1u);
+    BOOST_REQUIRE_EQUAL(domains->front().get_address(), "MBob");
+}
+
+BOOST_AUTO_TEST_CASE(blockchain_asset_cert_database__start__indexes_newest_record_of_key)
+{
+    store_fixture fixture;
+    const asset_cert issued("CERT.ONE", "alice", "MAlice", asset_cert_ns::issue);
+    fixture.store->certs.store(issued);
+    fixture.store->certs.store(asset_cert("CERT.ONE", "bob", "MBob", asset_cert_ns::issue));
+    fixture.store->certs.sync();
+
+    fixture.close();
+    fixture.open();
+
+    // The older record of the key no longer belongs to its address.
+    auto& certs = fixture.store->certs;
+    BOOST_REQUIRE(certs.get_blockchain_asset_certs("MAlice", asset_cert_ns::none)->empty());
+    BOOST_REQUIRE(certs.get_blockchain_asset_certs("MAlice", asset_cert_ns::issue)->empty());
+
+    const auto bob = certs.get_blockchain_asset_certs("MBob", asset_cert_ns::none);
+    BOOST_REQUIRE_EQUAL(bob->size(), 1u);
+    BOOST_REQUIRE_EQUAL(bob->front().get_owner(), "bob");
+    BOOST_REQUIRE_EQUAL(certs.get_blockchain_asset_certs("", asset_cert_ns::issue)->size(), 1u);
+
+    // Popping the transfer after the restart gives the cert back.
+    certs.remove(cert_key(issued));
+    BOOST_REQUIRE(certs.get_blockchain_asset_certs("MBob", asset_cert_ns::none)->empty());
+    BOOST_REQUIRE_EQUAL(certs.get_blockchain_asset_certs("MAlice", asset_cert_ns::none)->size(), 1u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
@@ -0,0 +1,215 @@
+#ifdef  DATABASE_TESTS
+#include <string>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/data_base.hpp>
+#include <boost/test/unit_test.hpp>
+#include "store_fixture.hpp"
+
+using namespace libbitcoin;
+using namespace libbitcoin::chain;
+using namespace libbitcoin::database;
+using test::store_fixture;
+
+// More heights than the header window holds.
+static const size_t window_jump = 65536 + 10;
+
+// A block at height, unique by its coinbase and by salt.
+static block make_block(size_t height, uint32_t salt=0)
+{
+    block result;
+    result.header.version = 1;
+    result.header.timestamp = 1486796400 + 30 * height + salt;
+    result.header.bits = 1;
+    result.header.number = height;
+    result.transactions.push_back(store_fixture::coinbase(height));
+    result.header.transaction_count = 1;
+    result.header.merkle = block::generate_merkle_root(result.transactions);
+    return result;
+}
+
+static block make_dpos_block(size_t height)
+{
+    auto result = make_block(height);
+    result.header.version = block_version_dpos;
+    result.blocksig.fill(0x30);
+    result.public_key.fill(0x02);
+    return result;
+}
+
+// The window answers for the block at height as the hash table does.
+static void require_stored(const block_database& blocks, const block& block,
+    size_t height)
+{
+    const auto hash = block.header.hash();
+    const auto by_height = blocks.get(height);
+    const auto by_hash = blocks.get(hash);
+    BOOST_REQUIRE(by_height);
+    BOOST_REQUIRE(by_hash);
+    BOOST_REQUIRE(by_height.header().hash() == hash);
+    BOOST_REQUIRE_EQUAL(by_hash.height(), height);
+
+    header cached;
+    BOOST_REQUIRE(blocks.get_header(cached, height, true));
+    BOOST_REQUIRE(cached.hash() == hash);
+    BOOST_REQUIRE_EQUAL(cached.transaction_count, by_height.transaction_count());
+
+    BOOST_REQUIRE(blocks.get_header(cached, hash));
+    BOOST_REQUIRE(cached.hash() == hash);
+
+    size_t found;
+    BOOST_REQUIRE(blocks.get_height(found, hash));
+    BOOST_REQUIRE_EQUAL(found, height);
+
+    ec_compressed key;
+    const auto dpos = block.header.is_proof_of_dpos();
+    BOOST_REQUIRE_EQUAL(blocks.get_public_key(key, height), dpos);
+    BOOST_REQUIRE_EQUAL(blocks.get_public_key(key, hash), dpos);
+    if (dpos)
+    {
+        BOOST_REQUIRE(key == block.public_key);
+        BOOST_REQUIRE(key == by_height.public_key());
+    }
+}
+
+// Nothing is stored at height, in the window or in the index.
+static void require_empty(const block_database& blocks, size_t height)
+{
+    BOOST_REQUIRE(!blocks.get(height));
+
+    header cached;
+    BOOST_REQUIRE(!blocks.get_header(cached, height));
+
+    ec_compressed key;
+    BOOST_REQUIRE(!blocks.get_public_key(key, height));
+}
+
+// The hash is not found, in the window or in the hash table.
+static void require_unknown(const block_database& blocks, const hash_digest& hash)
+{
+    BOOST_REQUIRE(!blocks.get(hash));
+
+    size_t height;
+    BOOST_REQUIRE(!blocks.get_height(height, hash));
+
+    header cached;
+    BOOST_REQUIRE(!blocks.get_header(cached, hash));
+}
+
+BOOST_AUTO_TEST_SUITE(header_window_tests)
+
+BOOST_AUTO_TEST_CASE(block_database__store__gaps_from_parallel_import)
+{
+    store_fixture fixture;
+    auto& blocks = fixture.store->blocks;
+    const auto fourth = make_dpos_block(4);
+    const auto second = make_block(2);
+    blocks.store(fourth, 4);
+    blocks.store(second, 2);
+
+    require_stored(blocks, fourth, 4);
+    require_stored(blocks, second, 2);
+    require_empty(blocks, 1);
+    require_empty(blocks, 3);
+    BOOST_REQUIRE_EQUAL(blocks.get_headers(0, 5).size(), 1u);
+
+    const auto first = make_block(1);
+    const auto third = make_dpos_block(3);
+    blocks.store(first, 1);
+    blocks.store(third, 3);
+    require_stored(blocks, first, 1);
+    require_stored(blocks, third, 3);
+    BOOST_REQUIRE_EQUAL(blocks.get_headers(0, 5).size(), 5u);
+}
+
+BOOST_AUTO_TEST_CASE(block_database__store__replaces_at_same_height)
+{
+    store_fixture fixture;
+    auto& blocks = fixture.store->blocks;
+    const auto replaced = make_dpos_block(1);
+    const auto replacement = make_block(1, 1);
+    blocks.store(replaced, 1);
+    blocks.store(replacement, 1);
+    require_stored(blocks, replacement, 1);
+
+    // The replaced block is only left in the hash table, until removed.
+    size_t height;
+    BOOST_REQUIRE(blocks.get_height(height, replaced.header.hash()));
+    BOOST_REQUIRE_EQUAL(height, blocks.get(replaced.header.hash()).height());
+
+    blocks.remove(replaced.header.hash());
+    require_unknown(blocks, replaced.header.hash());
+    require_stored(blocks, replacement, 1);
+}
+
+BOOST_AUTO_TEST_CASE(block_database__store__jump_past_window_resets)
+{
+    store_fixture fixture;
+    auto& blocks = fixture.store->blocks;
+    const auto near = make_dpos_block(1);
+    const auto far = make_dpos_block(1 + window_jump);
+    blocks.store(near, 1);
+    blocks.store(far, 1 + window_jump);
+
+    // The near block left the window, it is read from the table.
+    require_stored(blocks, far, 1 + window_jump);
+    require_stored(blocks, near, 1);
+    require_empty(blocks, window_jump);
+
+    // Blocks below the window are not cached, they are still found.
+    const auto below = make_block(2);
+    blocks.store(below, 2);
+    require_stored(blocks, below, 2);
+}
+
+BOOST_AUTO_TEST_CASE(block_database__unlink_remove__drops_headers)
+{
+    store_fixture fixture;
+    auto& blocks = fixture.store->blocks;
+    const auto first = make_block(1);
+    const auto second = make_dpos_block(2);
+    const auto third = make_block(3);
+    blocks.store(first, 1);
+    blocks.store(second, 2);
+    blocks.store(third, 3);
+
+    blocks.unlink(2);
+    require_stored(blocks, first, 1);
+    require_empty(blocks, 2);
+    require_empty(blocks, 3);
+
+    blocks.remove(third.header.hash());
+    blocks.remove(second.header.hash());
+    require_unknown(blocks, second.header.hash());
+    require_unknown(blocks, third.header.hash());
+
+    // The heights are reused by another branch.
+    const auto other = make_block(2, 1);
+    blocks.store(other, 2);
+    require_stored(blocks, other, 2);
+    require_empty(blocks, 3);
+}
+
+BOOST_AUTO_TEST_CASE(block_database__start__reloads_window)
+{
+    store_fixture fixture;
+    const auto first = make_dpos_block(1);
+    const auto third = make_block(3);
+    const auto fourth = make_dpos_block(4);
+    fixture.store->blocks.store(first, 1);
+    fixture.store->blocks.store(third, 3);
+    fixture.store->blocks.store(fourth, 4);
+    fixture.store->blocks.sync();
+
+    fixture.close();
+    fixture.open();
+
+    const auto& blocks = fixture.store->blocks;
+    require_stored(blocks, first, 1);
+    require_empty(blocks, 2);
+    require_stored(blocks, third, 3);
+    require_stored(blocks, fourth, 4);
+    require_stored(blocks, store_fixture::genesis(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
@@ -0,0 +1,263 @@
+#ifdef  DATABASE_TESTS
+#include <string>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/data_base.hpp>
+#include <metaverse/database/memory/memory_map.hpp>
+#include <metaverse/database/primitives/fixed_rows.hpp>
+#include <metaverse/database/primitives/record_manager.hpp>
+#include <metaverse/database/primitives/slab_manager.hpp>
+#include <boost/test/unit_test.hpp>
+#include "store_fixture.hpp"
+
+using namespace libbitcoin;
+using namespace libbitcoin::chain;
+using namespace libbitcoin::database;
+using test::store_fixture;
+
+static short_hash row_key(const std::string& text)
+{
+    return ripemd160_hash(data_chunk(text.begin(), text.end()));
+}
+
+static uintmax_t file_size(const store_fixture& fixture, const std::string& name)
+{
+    return boost::filesystem::file_size(fixture.directory / name);
+}
+
+// An etp output, an asset transfer output and a spend for the key.
+static void push_rows(address_asset_database& rows, const short_hash& key,
+    uint32_t height)
+{
+    const output_point point(sha256_hash(to_chunk(to_little_endian(height))), 0);
+    etp value(1000);
+    rows.store_output(key, point, height, 1000,
+        static_cast<uint16_t>(business_kind::etp), height, value);
+
+    asset_transfer transfer("SLAB.ASSET", 10);
+    rows.store_output(key, { point.hash, 1 }, height, 0,
+        static_cast<uint16_t>(business_kind::asset_transfer), height, transfer);
+
+    rows.store_input(key, { point.hash, 2 }, height, point, height);
+}
+
+BOOST_AUTO_TEST_SUITE(payload_slab_tests)
+
+BOOST_AUTO_TEST_CASE(slab_manager__release_slab__last_only)
+{
+    store_fixture fixture;
+    const auto path = fixture.directory / "slabs";
+    BOOST_REQUIRE(data_base::touch_file(path));
+
+    memory_map file(path, nullptr);
+    slab_manager slabs(file, 0);
+    BOOST_REQUIRE(file.start());
+    file.resize(minimum_slabs_size);
+    BOOST_REQUIRE(slabs.create());
+    BOOST_REQUIRE(slabs.start());
+
+    const auto empty = slabs.payload_size();
+    const auto first = slabs.new_slab(10);
+    const auto second = slabs.new_slab(20);
+    BOOST_REQUIRE_EQUAL(second, first + 10);
+
+    // Only the last slab can be given back.
+    BOOST_REQUIRE(!slabs.release_slab(first, 10));
+    BOOST_REQUIRE(!slabs.release_slab(second, 19));
+    BOOST_REQUIRE(slabs.release_slab(second, 20));
+    BOOST_REQUIRE_EQUAL(slabs.payload_size(), second);
+    BOOST_REQUIRE(slabs.release_slab(first, 10));
+    BOOST_REQUIRE_EQUAL(slabs.payload_size(), empty);
+
+    // The space is reused.
+    BOOST_REQUIRE_EQUAL(slabs.new_slab(5), first);
+    BOOST_REQUIRE(file.stop());
+    BOOST_REQUIRE(file.close());
+}
+
+BOOST_AUTO_TEST_CASE(convert_fixed_rows__keeps_indexes_fields_and_payload)
+{
+    store_fixture fixture;
+    const auto fixed_path = fixture.directory / "fixed";
+    const auto rows_path = fixture.directory / "rows";
+    const auto payload_path = fixture.directory / "payload";
+    BOOST_REQUIRE(data_base::touch_file(fixed_path));
+    BOOST_REQUIRE(data_base::touch_file(rows_path));
+    BOOST_REQUIRE(data_base::touch_file(payload_path));
+
+    // Fixed rows: [ next:4 ][ fields:2 ][ size:1 ][ payload padded to 8 ]
+    static const size_t fixed_record_size = 4 + 2 + 1 + 8;
+    {
+        memory_map file(fixed_path, nullptr);
+        record_manager fixed(file, 0, fixed_record_size);
+        BOOST_REQUIRE(file.start());
+        file.resize(minimum_records_size);
+        BOOST_REQUIRE(fixed.create());
+        BOOST_REQUIRE(fixed.start());
+
+        for (const auto& text: { std::string("ab"), std::string("padded") })
+        {
+            const auto index = fixed.new_records(1);
+            const auto memory = fixed.get(index);
+            auto serial = make_serializer(REMAP_ADDRESS(memory));
+            serial.write_4_bytes_little_endian(index == 0 ? 1 : 7);
+            serial.write_byte(0xf0 + index);
+            serial.write_byte(0x0f);
+            serial.write_byte(static_cast<uint8_t>(text.size()));
+            serial.write_data(to_chunk(text));
+        }
+
+        fixed.sync();
+        BOOST_REQUIRE(file.stop());
+        BOOST_REQUIRE(file.close());
+    }
+
+    memory_map rows_file(rows_path, nullptr);
+    memory_map payload_file(payload_path, nullptr);
+    record_manager rows(rows_file, 0, 4 + 2 + 8);
+    slab_manager payload(payload_file, 0);
+    BOOST_REQUIRE(rows_file.start());
+    BOOST_REQUIRE(payload_file.start());
+    rows_file.resize(minimum_records_size);
+    payload_file.resize(minimum_slabs_size);
+    BOOST_REQUIRE(rows.create());
+    BOOST_REQUIRE(payload.create());
+    BOOST_REQUIRE(rows.start());
+    BOOST_REQUIRE(payload.start());
+
+    // Only the meaningful bytes of the padded payload are kept.
+    const auto serialize = [](deserializer<uint8_t*, false>& deserial)
+    {
+        return deserial.read_data(deserial.read_byte());
+    };
+
+    BOOST_REQUIRE(convert_fixed_rows(fixed_path, fixed_record_size, 2, rows,
+        payload, serialize));
+    BOOST_REQUIRE_EQUAL(rows.count(), 2u);
+
+    // Return the payload position of the row after checking its fields.
+    const auto read_row = [&](array_index index, uint32_t next, uint8_t field)
+    {
+        const auto memory = rows.get(index);
+        auto deserial = make_deserializer_unsafe(REMAP_ADDRESS(memory));
+        BOOST_REQUIRE_EQUAL(deserial.read_4_bytes_little_endian(), next);
+        BOOST_REQUIRE_EQUAL(deserial.read_byte(), field);
+        BOOST_REQUIRE_EQUAL(deserial.read_byte(), 0x0f);
+        return deserial.read_8_bytes_little_endian();
+    };
+
+    const auto read_payload = [&](file_offset position, size_t size)
+    {
+        const auto memory = payload.get(position);
+        const auto data = REMAP_ADDRESS(memory);
+        return std::string(data, data + size);
+    };
+
+    const auto first = read_row(0, 1, 0xf0);
+    const auto second = read_row(1, 7, 0xf1);
+    BOOST_REQUIRE_EQUAL(second, first + 2);
+    BOOST_REQUIRE_EQUAL(read_payload(first, 2), "ab");
+    BOOST_REQUIRE_EQUAL(read_payload(second, 6), "padded");
+
+    BOOST_REQUIRE(rows_file.stop());
+    BOOST_REQUIRE(payload_file.stop());
+    BOOST_REQUIRE(rows_file.close());
+    BOOST_REQUIRE(payload_file.close());
+}
+
+BOOST_AUTO_TEST_CASE(address_asset_database__push_pop__reuses_payload)
+{
+    store_fixture fixture;
+    auto& rows = fixture.store->address_assets;
+    const auto kept = row_key("kept");
+    const auto key = row_key("popped");
+
+    push_rows(rows, kept, 1);
+    push_rows(rows, key, 2);
+    for (size_t pop = 0; pop < 3; ++pop)
+        rows.delete_last_row(key);
+
+    rows.sync();
+    const auto size = file_size(fixture, "address_asset_payload");
+
+    // Each block pushes its rows and a reorganization pops them in reverse.
+    for (uint32_t height = 2; height < 2000; ++height)
+    {
+        push_rows(rows, key, height);
+        BOOST_REQUIRE_EQUAL(rows.get(key, 0, 0).size(), 3u);
+
+        for (size_t pop = 0; pop < 3; ++pop)
+            rows.delete_last_row(key);
+    }
+
+    rows.sync();
+    BOOST_REQUIRE_EQUAL(file_size(fixture, "address_asset_payload"), size);
+    BOOST_REQUIRE(rows.get(key, 0, 0).empty());
+
+    // Rows pushed on reused space read back intact.
+    push_rows(rows, key, 7);
+    const auto records = rows.get(key, 0, 0);
+    BOOST_REQUIRE_EQUAL(records.size(), 3u);
+    BOOST_REQUIRE(records[0].kind == point_kind::spend);
+    BOOST_REQUIRE(records[1].kind == point_kind::output);
+    BOOST_REQUIRE(records[1].data.get_kind_value() == business_kind::asset_transfer);
+    BOOST_REQUIRE(records[2].data.get_kind_value() == business_kind::etp);
+    BOOST_REQUIRE_EQUAL(records[2].val_chk_sum.value, 1000u);
+    BOOST_REQUIRE_EQUAL(records[2].height, 7u);
+
+    const auto others = rows.get(kept, 0, 0);
+    BOOST_REQUIRE_EQUAL(others.size(), 3u);
+    BOOST_REQUIRE(others[1].data.get_kind_value() == business_kind::asset_transfer);
+    BOOST_REQUIRE_EQUAL(others[2].height, 1u);
+}
+
+BOOST_AUTO_TEST_CASE(address_asset_database__pop_out_of_order__keeps_payload)
+{
+    store_fixture fixture;
+    auto& rows = fixture.store->address_assets;
+    const auto first = row_key("first");
+    const auto second = row_key("second");
+
+    push_rows(rows, first, 1);
+    push_rows(rows, second, 2);
+
+    // The payload of first is not the last slab, it stays in place.
+    rows.delete_last_row(first);
+    push_rows(rows, first, 3);
+
+    const auto records = rows.get(second, 0, 0);
+    BOOST_REQUIRE_EQUAL(records.size(), 3u);
+    BOOST_REQUIRE(records[1].data.get_kind_value() == business_kind::asset_transfer);
+    BOOST_REQUIRE(records[2].data.get_kind_value() == business_kind::etp);
+    BOOST_REQUIRE_EQUAL(records[2].height, 2u);
+    BOOST_REQUIRE_EQUAL(rows.get(first, 0, 0).size(), 5u);
+}
+
+BOOST_AUTO_TEST_CASE(account_asset_database__replace__reuses_payload)
+{
+    store_fixture fixture;
+    auto& assets = fixture.store->account_assets;
+    const auto key = row_key("account");
+
+    asset_detail detail("SLAB.ASSET", 100, 0, 0, "issuer", "address", "first");
+    assets.store(key, detail);
+    assets.sync();
+    const auto size = file_size(fixture, "account_asset_payload");
+
+    // Each change of the detail replaces the stored row.
+    for (size_t change = 0; change < 2000; ++change)
+    {
+        detail.set_description(change % 2 ? "first" : "second");
+        assets.store(key, detail);
+    }
+
+    assets.sync();
+    BOOST_REQUIRE_EQUAL(file_size(fixture, "account_asset_payload"), size);
+
+    const auto stored = assets.get(key);
+    BOOST_REQUIRE_EQUAL(stored.size(), 1u);
+    BOOST_REQUIRE_EQUAL(stored.front().get_description(), "first");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
@@ -0,0 +1,191 @@
+#ifdef  DATABASE_TESTS
+#include <sstream>
+#include <string>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/data_base.hpp>
+#include <boost/test/unit_test.hpp>
+#include "store_fixture.hpp"
+
+using namespace libbitcoin;
+using namespace libbitcoin::chain;
+using namespace libbitcoin::database;
+using test::store_fixture;
+
+static const std::string did_symbol("POPDID");
+static const std::string asset_symbol("POP.ASSET");
+static const std::string mit_symbol("POP.MIT");
+
+static hash_digest symbol_key(const std::string& symbol)
+{
+    return sha256_hash(data_chunk(symbol.begin(), symbol.end()));
+}
+
+static short_hash row_key(const std::string& text)
+{
+    return ripemd160_hash(data_chunk(text.begin(), text.end()));
+}
+
+static asset_cert issue_cert()
+{
+    asset_cert cert(asset_symbol, did_symbol,
+        store_fixture::address().encoded(), asset_cert_ns::issue);
+    cert.set_status(ASSET_CERT_ISSUE_TYPE);
+    return cert;
+}
+
+// Four blocks on genesis: funding, then did, asset and cert registration,
+// then a mit and an in-chain spend, then spends of both.
+static block::list make_chain(const block& genesis)
+{
+    const auto address = store_fixture::address().encoded();
+
+    transaction funding;
+    funding.version = 1;
+    funding.locktime = 0;
+    funding.inputs.push_back(store_fixture::spend({ symbol_key("funding"), 0 }));
+    for (size_t index = 0; index < 4; ++index)
+        funding.outputs.push_back(store_fixture::pay(1000000));
+
+    const auto first = store_fixture::next(genesis, { funding });
+    const auto funded = funding.hash();
+
+    transaction registrar;
+    registrar.version = 1;
+    registrar.locktime = 0;
+    registrar.inputs.push_back(store_fixture::spend({ funded, 0 }));
+    registrar.outputs.push_back(store_fixture::pay(0, attachment(DID_TYPE,
+        ATTACH_INIT_VERSION, did(DID_DETAIL_TYPE,
+            did_detail(did_symbol, address)))));
+    registrar.outputs.push_back(store_fixture::pay(0, attachment(ASSET_TYPE,
+        ATTACH_INIT_VERSION, asset(ASSET_DETAIL_TYPE, asset_detail(
+            asset_symbol, 1000, 0, 0, did_symbol, address, "pop")))));
+    registrar.outputs.push_back(store_fixture::pay(0, attachment(
+        ASSET_CERT_TYPE, ATTACH_INIT_VERSION, issue_cert())));
+    registrar.outputs.push_back(store_fixture::pay(900000));
+
+    const auto second = store_fixture::next(first, { registrar });
+
+    asset_mit mit(mit_symbol, address, "pop");
+    mit.set_status(MIT_STATUS_REGISTER);
+
+    transaction minter;
+    minter.version = 1;
+    minter.locktime = 0;
+    minter.inputs.push_back(store_fixture::spend({ funded, 1 }));
+    minter.inputs.push_back(store_fixture::spend({ registrar.hash(), 3 }));
+    minter.outputs.push_back(store_fixture::pay(0, attachment(ASSET_MIT_TYPE,
+        ATTACH_INIT_VERSION, mit)));
+    minter.outputs.push_back(store_fixture::pay(1800000));
+
+    const auto third = store_fixture::next(second, { minter });
+
+    transaction spender;
+    spender.version = 1;
+    spender.locktime = 0;
+    spender.inputs.push_back(store_fixture::spend({ minter.hash(), 1 }));
+    spender.inputs.push_back(store_fixture::spend({ funded, 2 }));
+    spender.outputs.push_back(store_fixture::pay(2700000));
+
+    const auto fourth = store_fixture::next(third, { spender });
+    return { first, second, third, fourth };
+}
+
+// Everything the chain touched, as seen through the store's lookups.
+static std::string describe(data_base& store, const block::list& chain)
+{
+    std::ostringstream out;
+    size_t top = 0;
+    out << "top " << (store.blocks.top(top) ? top : max_size_t) << '\n';
+
+    for (const auto& block : chain)
+    {
+        out << "block " << bool(store.blocks.get(block.header.hash())) << '\n';
+
+        for (const auto& tx : block.transactions)
+        {
+            out << "tx " << bool(store.transactions.get(tx.hash()));
+
+            if (!tx.is_coinbase())
+                for (const auto& input : tx.inputs)
+                    out << " spend " << store.spends.get(input.previous_output).valid;
+
+            out << '\n';
+        }
+    }
+
+    const auto address = store_fixture::address();
+    const auto key = row_key(address.encoded());
+    out << "history " << store.history.get(address.hash(), 0, 0).size() << '\n'
+        << "address_assets " << store.address_assets.get(key, 0, 0).size() << '\n'
+        << "address_dids " << store.address_dids.get(key, 0, 0).size() << '\n'
+        << "address_mits " << store.address_mits.get(key, 0, 0).size() << '\n'
+        << "did " << bool(store.dids.get(symbol_key(did_symbol))) << '\n'
+        << "asset " << bool(store.assets.get(symbol_key(asset_symbol))) << '\n'
+        << "cert " << bool(store.certs.get(symbol_key(issue_cert().get_key()))) << '\n'
+        << "mit " << bool(store.mits.get(symbol_key(mit_symbol))) << '\n'
+        << "mit_history " << bool(store.mit_history.get(row_key(mit_symbol))) << '\n';
+
+    return out.str();
+}
+
+BOOST_AUTO_TEST_SUITE(pop_from_tests)
+
+BOOST_AUTO_TEST_CASE(data_base__pop_from__equals_sequential_pops)
+{
+    store_fixture batch;
+    store_fixture sequential;
+    const auto chain = make_chain(store_fixture::genesis());
+    const auto before = describe(*batch.store, chain);
+
+    for (const auto& block : chain)
+    {
+        batch.store->push(block);
+        sequential.store->push(block);
+    }
+
+    const auto pushed = describe(*batch.store, chain);
+    BOOST_REQUIRE(pushed != before);
+    BOOST_REQUIRE_EQUAL(describe(*sequential.store, chain), pushed);
+
+    threadpool pool(2);
+    block::list popped;
+    BOOST_REQUIRE(batch.store->pop_from(popped, 1, &pool));
+    BOOST_REQUIRE_EQUAL(popped.size(), chain.size());
+
+    for (size_t index = 0; index < chain.size(); ++index)
+    {
+        block block;
+        BOOST_REQUIRE(sequential.store->pop(block));
+        BOOST_REQUIRE(block.header.hash() == popped[index].header.hash());
+        BOOST_REQUIRE(block.header.hash() ==
+            chain[chain.size() - 1 - index].header.hash());
+        BOOST_REQUIRE_EQUAL(block.transactions.size(),
+            popped[index].transactions.size());
+    }
+
+    BOOST_REQUIRE_EQUAL(describe(*batch.store, chain), before);
+    BOOST_REQUIRE_EQUAL(describe(*sequential.store, chain), before);
+
+    pool.shutdown();
+    pool.join();
+}
+
+BOOST_AUTO_TEST_CASE(data_base__pop_from__range_above_top__fails)
+{
+    store_fixture fixture;
+    const auto chain = make_chain(store_fixture::genesis());
+    for (const auto& block : chain)
+        fixture.store->push(block);
+
+    block::list popped;
+    BOOST_REQUIRE(!fixture.store->pop_from(popped, chain.size() + 1));
+    BOOST_REQUIRE(popped.empty());
+
+    // A single block is popped without a pool.
+    BOOST_REQUIRE(fixture.store->pop_from(popped, chain.size()));
+    BOOST_REQUIRE_EQUAL(popped.size(), 1u);
+    BOOST_REQUIRE(popped.front().header.hash() == chain.back().header.hash());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
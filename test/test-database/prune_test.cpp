@@ -0,0 +1,197 @@
+#ifdef  DATABASE_TESTS
+#include <algorithm>
+#include <string>
+#include <unistd.h>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/data_base.hpp>
+#include <metaverse/database/memory/memory.hpp>
+#include <metaverse/database/memory/memory_map.hpp>
+#include <boost/test/unit_test.hpp>
+#include "store_fixture.hpp"
+
+using namespace libbitcoin;
+using namespace libbitcoin::chain;
+using namespace libbitcoin::database;
+using test::store_fixture;
+
+static const size_t depth = 2;
+
+static transaction make_tx(const output_point& previous, size_t outputs)
+{
+    transaction tx;
+    tx.version = 1;
+    tx.locktime = 0;
+    tx.inputs.push_back(store_fixture::spend(previous));
+    for (size_t index = 0; index < outputs; ++index)
+        tx.outputs.push_back(store_fixture::pay(1000));
+
+    return tx;
+}
+
+// Funding at height 1, its outputs are spent at heights 2 and 3, the
+// spenders stay unspent, then two empty blocks bury height 3 at the depth.
+struct prune_fixture
+  : store_fixture
+{
+    prune_fixture()
+      : store_fixture(depth),
+        funding(make_tx({ sha256_hash(to_chunk(std::string("funding"))), 0 }, 2)),
+        first(make_tx({ funding.hash(), 0 }, 1)),
+        second(make_tx({ funding.hash(), 1 }, 1))
+    {
+        auto top = genesis();
+        for (const auto& txs: { transaction::list{ funding },
+            transaction::list{ first }, transaction::list{ second },
+            transaction::list{}, transaction::list{} })
+        {
+            top = next(top, txs);
+            store->push(top);
+        }
+    }
+
+    bool stored(const hash_digest& tx_hash) const
+    {
+        return bool(store->transactions.get(tx_hash));
+    }
+
+    // Rows of the address that mention the point or spend anything.
+    size_t history_rows(const hash_digest& tx_hash) const
+    {
+        const auto rows = store->history.get(address().hash(), 0, 0);
+        return std::count_if(rows.begin(), rows.end(),
+            [&](const history_compact& row)
+            {
+                return row.kind == point_kind::spend || row.point.hash == tx_hash;
+            });
+    }
+
+    size_t asset_rows(const hash_digest& tx_hash) const
+    {
+        const auto encoded = address().encoded();
+        const auto key = ripemd160_hash(data_chunk(encoded.begin(), encoded.end()));
+        const auto rows = store->address_assets.get(key, 0, 0);
+        return std::count_if(rows.begin(), rows.end(),
+            [&](const business_record& row)
+            {
+                return row.kind == point_kind::spend || row.point.hash == tx_hash;
+            });
+    }
+
+    transaction funding;
+    transaction first;
+    transaction second;
+};
+
+BOOST_AUTO_TEST_SUITE(prune_tests)
+
+BOOST_AUTO_TEST_CASE(data_base__prune__keeps_transaction_until_spenders_pruned)
+{
+    prune_fixture fixture;
+    auto& store = *fixture.store;
+    const auto funding = fixture.funding.hash();
+    BOOST_REQUIRE_EQUAL(store.pruned_height(), 0u);
+    BOOST_REQUIRE_EQUAL(fixture.history_rows(funding), 5u);
+    BOOST_REQUIRE_EQUAL(fixture.asset_rows(funding), 5u);
+
+    // Heights up to 3 are at the depth, a pass prunes up to count of them.
+    BOOST_REQUIRE(store.prune(1));
+    BOOST_REQUIRE_EQUAL(store.pruned_height(), 1u);
+    BOOST_REQUIRE(fixture.stored(funding));
+
+    // The first spender is pruned, funding still has an unpruned spender.
+    BOOST_REQUIRE(store.prune(1));
+    BOOST_REQUIRE_EQUAL(store.pruned_height(), 2u);
+    BOOST_REQUIRE(fixture.stored(funding));
+    BOOST_REQUIRE(store.spends.get({ funding, 1 }).valid);
+    BOOST_REQUIRE_EQUAL(fixture.history_rows(funding), 2u);
+
+    BOOST_REQUIRE(!store.prune(10));
+    BOOST_REQUIRE_EQUAL(store.pruned_height(), 3u);
+    BOOST_REQUIRE(!fixture.stored(funding));
+
+    // Unspent transactions are kept whatever their height.
+    BOOST_REQUIRE(fixture.stored(fixture.first.hash()));
+    BOOST_REQUIRE(fixture.stored(fixture.second.hash()));
+    BOOST_REQUIRE(fixture.stored(store_fixture::coinbase(1).hash()));
+
+    // Nothing more until the chain grows.
+    BOOST_REQUIRE(!store.prune(10));
+    BOOST_REQUIRE_EQUAL(store.pruned_height(), 3u);
+
+    fixture.close();
+    fixture.open();
+    BOOST_REQUIRE_EQUAL(fixture.store->pruned_height(), 3u);
+    BOOST_REQUIRE(!fixture.store->prune(10));
+}
+
+BOOST_AUTO_TEST_CASE(data_base__prune__pruned_data_not_found)
+{
+    prune_fixture fixture;
+    auto& store = *fixture.store;
+    const auto funding = fixture.funding.hash();
+    BOOST_REQUIRE(!store.prune(10));
+
+    BOOST_REQUIRE(!store.transactions.get(funding));
+    BOOST_REQUIRE(!store.spends.get({ funding, 0 }).valid);
+    BOOST_REQUIRE(!store.spends.get({ funding, 1 }).valid);
+    BOOST_REQUIRE_EQUAL(fixture.history_rows(funding), 0u);
+    BOOST_REQUIRE_EQUAL(fixture.asset_rows(funding), 0u);
+
+    // The outputs of the spenders are unspent and stay.
+    BOOST_REQUIRE_EQUAL(fixture.history_rows(fixture.first.hash()), 1u);
+    BOOST_REQUIRE_EQUAL(fixture.asset_rows(fixture.second.hash()), 1u);
+
+    // Blocks keep their headers and transaction hashes.
+    {
+        const auto block = store.blocks.get(1);
+        BOOST_REQUIRE(block);
+        BOOST_REQUIRE_EQUAL(block.transaction_count(), 2u);
+        BOOST_REQUIRE(block.transaction_hash(1) == funding);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(memory_map__reclaim__punches_whole_pages_discarded_before)
+{
+    store_fixture fixture;
+    const auto path = fixture.directory / "pages";
+    BOOST_REQUIRE(data_base::touch_file(path));
+
+    const size_t page = sysconf(_SC_PAGESIZE);
+    memory_map file(path, nullptr);
+    BOOST_REQUIRE(file.start());
+    file.resize(4 * page);
+    {
+        const auto memory = file.access();
+        std::fill_n(REMAP_ADDRESS(memory), 4 * page, 0xaa);
+    }
+
+    // The first page is only half discarded, the second is discarded.
+    const auto start = asio::steady_clock::now();
+    file.discard(0, page / 2);
+    file.discard(page, page);
+    BOOST_REQUIRE_EQUAL(file.reclaim(start), 0u);
+
+    // However often reclaim runs, a page waits until it is old enough.
+    file.discard(page / 2, page / 2);
+    const auto discarded = asio::steady_clock::now();
+    BOOST_REQUIRE_EQUAL(file.reclaim(start), 0u);
+    BOOST_REQUIRE_EQUAL(file.reclaim(start), 0u);
+
+    BOOST_REQUIRE_EQUAL(file.reclaim(discarded + std::chrono::seconds(1)), 2 * page);
+    BOOST_REQUIRE_EQUAL(file.reclaim(discarded + std::chrono::seconds(1)), 0u);
+    {
+        const auto memory = file.access();
+        const auto data = REMAP_ADDRESS(memory);
+        BOOST_REQUIRE(std::all_of(data, data + 2 * page,
+            [](uint8_t byte) { return byte == 0x00; }));
+        BOOST_REQUIRE(std::all_of(data + 2 * page, data + 4 * page,
+            [](uint8_t byte) { return byte == 0xaa; }));
+    }
+
+    BOOST_REQUIRE_EQUAL(file.size(), 4 * page);
+    BOOST_REQUIRE(file.stop());
+    BOOST_REQUIRE(file.close());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
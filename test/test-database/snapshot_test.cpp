@@ -0,0 +1,181 @@
+#ifdef  DATABASE_TESTS
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/data_base.hpp>
+#include <metaverse/database/snapshot.hpp>
+#include <boost/test/unit_test.hpp>
+#include "store_fixture.hpp"
+
+using namespace libbitcoin;
+using namespace libbitcoin::chain;
+using namespace libbitcoin::database;
+using test::store_fixture;
+
+static short_hash account_key(const std::string& name)
+{
+    return ripemd160_hash(data_chunk(name.begin(), name.end()));
+}
+
+// Three blocks on genesis, each with a transaction paying the next.
+static block::list make_chain(const block& genesis)
+{
+    block::list chain;
+    auto previous = genesis;
+    auto funding = output_point(sha256_hash(to_chunk(std::string("snapshot"))), 0);
+    for (size_t index = 0; index < 3; ++index)
+    {
+        transaction tx;
+        tx.version = 1;
+        tx.locktime = 0;
+        tx.inputs.push_back(store_fixture::spend(funding));
+        tx.outputs.push_back(store_fixture::pay(1000000 - index));
+        funding = output_point(tx.hash(), 0);
+
+        previous = store_fixture::next(previous, { tx });
+        chain.push_back(previous);
+    }
+
+    return chain;
+}
+
+// The archive with the first occurrence of find replaced.
+static void patch(const boost::filesystem::path& file, const std::string& find,
+    const std::string& replace)
+{
+    std::string data;
+    {
+        std::ifstream in(file.string(), std::ios::binary);
+        data.assign(std::istreambuf_iterator<char>(in), {});
+    }
+
+    const auto position = data.find(find);
+    BOOST_REQUIRE(position != std::string::npos);
+    data.replace(position, replace.size(), replace);
+
+    std::ofstream out(file.string(), std::ios::binary | std::ios::trunc);
+    out.write(data.data(), data.size());
+}
+
+// Write a small file of the given text into the directory.
+static void write_file(const boost::filesystem::path& file,
+    const std::string& text)
+{
+    std::ofstream out(file.string(), std::ios::binary);
+    out << text;
+}
+
+static std::string read_file(const boost::filesystem::path& file)
+{
+    std::ifstream in(file.string(), std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), {});
+}
+
+// A fresh directory next to the fixture for the imported store.
+struct import_fixture
+{
+    import_fixture(const store_fixture& source)
+      : directory(source.directory.string() + "-import")
+    {
+        boost::filesystem::create_directories(directory);
+        settings = source.settings;
+        settings.directory = directory;
+    }
+
+    ~import_fixture()
+    {
+        boost::system::error_code ec;
+        boost::filesystem::remove_all(directory, ec);
+    }
+
+    boost::filesystem::path directory;
+    database::settings settings;
+};
+
+BOOST_AUTO_TEST_SUITE(snapshot_tests)
+
+BOOST_AUTO_TEST_CASE(data_base__export_snapshot__open_store__round_trips)
+{
+    store_fixture fixture;
+    const auto chain = make_chain(store_fixture::genesis());
+    for (const auto& block: chain)
+        fixture.store->push(block);
+
+    fixture.store->account_addresses.store(account_key("alice"),
+        account_address("alice", "", "", 0, 0, "", "MAlice", 0));
+
+    // The source store stays open, as on a running node.
+    const auto file = fixture.directory / "chain.snapshot";
+    BOOST_REQUIRE(fixture.store->export_snapshot(file));
+
+    // A block pushed after the export is not part of it.
+    fixture.store->push(store_fixture::next(chain.back(), {}));
+
+    import_fixture target(fixture);
+    const config::checkpoint bad(chain[0].header.hash(), 2);
+    BOOST_REQUIRE(!data_base::import_snapshot(file, target.directory, { bad }));
+
+    boost::filesystem::remove_all(target.directory);
+    boost::filesystem::create_directories(target.directory);
+    const config::checkpoint good(chain[1].header.hash(), 2);
+    BOOST_REQUIRE(data_base::import_snapshot(file, target.directory, { good }));
+
+    data_base imported(target.settings);
+    BOOST_REQUIRE(imported.start());
+
+    size_t top;
+    BOOST_REQUIRE(imported.blocks.top(top));
+    BOOST_REQUIRE_EQUAL(top, chain.size());
+    for (size_t height = 1; height <= chain.size(); ++height)
+    {
+        const auto result = imported.blocks.get(height);
+        BOOST_REQUIRE(result);
+        BOOST_REQUIRE(result.header().hash() == chain[height - 1].header.hash());
+
+        const auto& tx = chain[height - 1].transactions.back();
+        const auto stored = imported.transactions.get(tx.hash());
+        BOOST_REQUIRE(stored);
+        BOOST_REQUIRE_EQUAL(stored.height(), height);
+    }
+
+    // Local account tables are not exported.
+    BOOST_REQUIRE(imported.account_addresses.get(account_key("alice")).empty());
+    BOOST_REQUIRE(imported.stop());
+    BOOST_REQUIRE(imported.close());
+}
+
+BOOST_AUTO_TEST_CASE(snapshot__read__renamed_file__checksum_mismatch)
+{
+    store_fixture fixture;
+    const auto source = fixture.directory / "source";
+    boost::filesystem::create_directories(source);
+    write_file(source / "first_rows", std::string(3000, 'a') + "first");
+    write_file(source / "second_rows", "second");
+
+    const snapshot::info state{ "test", 3, null_hash };
+    const auto file = fixture.directory / "files.snapshot";
+    BOOST_REQUIRE(snapshot::write(file, source, { "first_rows", "second_rows" },
+        state));
+
+    const auto intact = fixture.directory / "intact";
+    boost::filesystem::create_directories(intact);
+    snapshot::info read_state;
+    BOOST_REQUIRE(snapshot::read(file, intact, read_state));
+    BOOST_REQUIRE_EQUAL(read_state.height, 3u);
+    BOOST_REQUIRE_EQUAL(read_file(intact / "first_rows"),
+        read_file(source / "first_rows"));
+    BOOST_REQUIRE_EQUAL(read_file(intact / "second_rows"), "second");
+
+    // The chunks are intact, only the entry name changes.
+    patch(file, "second_rows", "second_rowz");
+
+    const auto renamed = fixture.directory / "renamed";
+    boost::filesystem::create_directories(renamed);
+    BOOST_REQUIRE(!snapshot::read(file, renamed, read_state));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
@@ -0,0 +1,160 @@
+#ifndef MVS_DATABASE_TEST_STORE_FIXTURE_HPP
+#define MVS_DATABASE_TEST_STORE_FIXTURE_HPP
+
+#include <memory>
+#include <string>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/data_base.hpp>
+#include <metaverse/database/settings.hpp>
+
+namespace test {
+
+using namespace libbitcoin;
+using namespace libbitcoin::chain;
+
+// The settings raise a prune depth to the minimum, tests prune short chains.
+struct test_store
+  : database::data_base
+{
+    test_store(const database::settings& settings)
+      : data_base(settings.directory, settings.history_start_height,
+            settings.stealth_start_height, settings.prune_depth)
+    {
+    }
+};
+
+// A store created from a synthetic genesis block in its own directory,
+// removed again when the fixture goes away.
+struct store_fixture
+{
+    store_fixture(size_t prune_depth=0)
+      : directory(boost::filesystem::temp_directory_path() /
+            boost::filesystem::unique_path("mvs-database-test-%%%%-%%%%"))
+    {
+        boost::filesystem::create_directories(directory);
+        settings.directory = directory;
+        settings.prune_depth = prune_depth;
+        database::data_base::initialize(directory, genesis());
+        open();
+    }
+
+    ~store_fixture()
+    {
+        close();
+        boost::system::error_code ec;
+        boost::filesystem::remove_all(directory, ec);
+    }
+
+    void open()
+    {
+        store = std::make_shared<test_store>(settings);
+        store->start();
+    }
+
+    void close()
+    {
+        if (!store)
+            return;
+
+        store->stop();
+        store->close();
+        store.reset();
+    }
+
+    static block genesis()
+    {
+        block result;
+        result.header.version = 1;
+        result.header.timestamp = 1486796400;
+        result.header.bits = 1;
+        result.header.number = 0;
+        result.transactions.push_back(coinbase(0));
+        result.header.transaction_count = 1;
+        result.header.merkle = block::generate_merkle_root(result.transactions);
+        return result;
+    }
+
+    // The coinbase of a height, unique by its input script.
+    static transaction coinbase(uint64_t height)
+    {
+        transaction tx;
+        tx.version = 1;
+        tx.locktime = 0;
+
+        script input_script;
+        input_script.operations.push_back({ opcode::special,
+            script_number(height + 1).data() });
+        tx.inputs.push_back({ output_point(null_hash, max_uint32),
+            input_script, max_input_sequence });
+        tx.outputs.push_back({ 0, pay_script(),
+            attachment(ETP_TYPE, ATTACH_INIT_VERSION, etp(0)) });
+        return tx;
+    }
+
+    // Every output pays one key, its inputs sign with that key's public
+    // point, the store does not check signatures.
+    static const data_chunk& public_key()
+    {
+        static const data_chunk key(ec_compressed_size, 0x02);
+        return key;
+    }
+
+    static wallet::payment_address address()
+    {
+        return wallet::payment_address(bitcoin_short_hash(public_key()));
+    }
+
+    static script pay_script()
+    {
+        script result;
+        result.operations = operation::to_pay_key_hash_pattern(
+            bitcoin_short_hash(public_key()));
+        return result;
+    }
+
+    static input spend(const output_point& point)
+    {
+        script input_script;
+        input_script.operations.push_back({ opcode::special,
+            data_chunk(72, 0x30) });
+        input_script.operations.push_back({ opcode::special, public_key() });
+        return { point, input_script, max_input_sequence };
+    }
+
+    static output pay(uint64_t value, const attachment& attach)
+    {
+        return { value, pay_script(), attach };
+    }
+
+    static output pay(uint64_t value)
+    {
+        return pay(value, attachment(ETP_TYPE, ATTACH_INIT_VERSION,
+            etp(value)));
+    }
+
+    // A block on top of previous holding the coinbase and transactions.
+    static block next(const block& previous, transaction::list transactions)
+    {
+        block result;
+        result.header.version = 1;
+        result.header.previous_block_hash = previous.header.hash();
+        result.header.timestamp = previous.header.timestamp + 30;
+        result.header.bits = previous.header.bits;
+        result.header.number = previous.header.number + 1;
+        transactions.insert(transactions.begin(),
+            coinbase(result.header.number));
+        result.header.transaction_count = transactions.size();
+        result.header.merkle = block::generate_merkle_root(transactions);
+        result.transactions = std::move(transactions);
+        return result;
+    }
+
+    boost::filesystem::path directory;
+    database::settings settings;
+    std::shared_ptr<database::data_base> store;
+};
+
+} // namespace test
+
+#endif
@@ -0,0 +1,77 @@
+#ifdef  DATABASE_TESTS
+#include <string>
+#include <metaverse/database/primitives/symbol_index.hpp>
+#include <boost/test/unit_test.hpp>
+
+using namespace libbitcoin::database;
+
+BOOST_AUTO_TEST_SUITE(symbol_index_tests)
+
+static void fill(symbol_index& index)
+{
+    index.assign({ "MVS.ZGC", "ABC", "MVS.HUG", "A", "MVS.ZGC", "MVSX", "B" });
+}
+
+BOOST_AUTO_TEST_CASE(symbol_index__assign__sorts_and_dedupes)
+{
+    symbol_index index;
+    fill(index);
+    BOOST_REQUIRE_EQUAL(index.count(), 6u);
+
+    const symbol_index::list expected{ "A", "ABC", "B", "MVS.HUG", "MVS.ZGC", "MVSX" };
+    const auto all = index.page("", 0, 0);
+    BOOST_REQUIRE(all == expected);
+}
+
+BOOST_AUTO_TEST_CASE(symbol_index__insert_erase__keeps_order)
+{
+    symbol_index index;
+    fill(index);
+    BOOST_REQUIRE(index.insert("AA"));
+    BOOST_REQUIRE(!index.insert("AA"));
+    BOOST_REQUIRE(index.contains("AA"));
+    BOOST_REQUIRE(index.erase("B"));
+    BOOST_REQUIRE(!index.erase("B"));
+    BOOST_REQUIRE(!index.contains("B"));
+
+    const symbol_index::list expected{ "A", "AA", "ABC" };
+    BOOST_REQUIRE(index.page("", 0, 3) == expected);
+}
+
+BOOST_AUTO_TEST_CASE(symbol_index__count__prefix)
+{
+    symbol_index index;
+    fill(index);
+    BOOST_REQUIRE_EQUAL(index.count("MVS"), 3u);
+    BOOST_REQUIRE_EQUAL(index.count("MVS."), 2u);
+    BOOST_REQUIRE_EQUAL(index.count("A"), 2u);
+    BOOST_REQUIRE_EQUAL(index.count("Z"), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(symbol_index__page__offset_and_limit)
+{
+    symbol_index index;
+    fill(index);
+    const symbol_index::list expected{ "MVS.ZGC", "MVSX" };
+    BOOST_REQUIRE(index.page("MVS", 1, 5) == expected);
+    BOOST_REQUIRE(index.page("MVS", 3, 5).empty());
+    BOOST_REQUIRE_EQUAL(index.page("", 2, 2).front(), "B");
+}
+
+BOOST_AUTO_TEST_CASE(symbol_index__after__cursor)
+{
+    symbol_index index;
+    fill(index);
+    const symbol_index::list first{ "A", "ABC" };
+    BOOST_REQUIRE(index.after("", "", 2) == first);
+
+    const symbol_index::list next{ "B", "MVS.HUG" };
+    BOOST_REQUIRE(index.after("", "ABC", 2) == next);
+
+    const symbol_index::list prefixed{ "MVSX" };
+    BOOST_REQUIRE(index.after("MVS", "MVS.ZGC", 0) == prefixed);
+    BOOST_REQUIRE(index.after("MVS", "MVSX", 0).empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
@@ -0,0 +1,135 @@
+#ifdef  DATABASE_TESTS
+#include <string>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/data_base.hpp>
+#include <boost/test/unit_test.hpp>
+#include "store_fixture.hpp"
+
+using namespace libbitcoin;
+using namespace libbitcoin::chain;
+using namespace libbitcoin::database;
+using test::store_fixture;
+
+static hash_digest symbol_key(const std::string& symbol)
+{
+    return sha256_hash(data_chunk(symbol.begin(), symbol.end()));
+}
+
+static blockchain_asset make_asset(const std::string& symbol, uint64_t supply,
+    uint64_t height)
+{
+    return blockchain_asset(0, { symbol_key(symbol), 0 }, height,
+        asset_detail(symbol, supply, 0, 0, "", "", ""));
+}
+
+static blockchain_did make_did(const std::string& symbol,
+    const std::string& address, uint64_t height)
+{
+    return blockchain_did(0, { symbol_key(address), 0 }, height,
+        blockchain_did::address_current, did_detail(symbol, address));
+}
+
+BOOST_AUTO_TEST_SUITE(symbol_listing_tests)
+
+BOOST_AUTO_TEST_CASE(blockchain_asset_database__page__one_issue_record_a_symbol)
+{
+    store_fixture fixture;
+    auto& assets = fixture.store->assets;
+    assets.store(symbol_key("LIST.ONE"), make_asset("LIST.ONE", 100, 1));
+    assets.store(symbol_key("LIST.TWO"), make_asset("LIST.TWO", 200, 2));
+
+    // A secondary issue is stored under the key of the first.
+    assets.store(symbol_key("LIST.ONE"), make_asset("LIST.ONE", 50, 3));
+
+    BOOST_REQUIRE_EQUAL(assets.get_symbol_index().count(), 2u);
+    BOOST_REQUIRE_EQUAL(assets.get_asset_history("LIST.ONE")->size(), 2u);
+
+    const auto all = assets.get_blockchain_assets("", 0, 0);
+    BOOST_REQUIRE_EQUAL(all->size(), 2u);
+    BOOST_REQUIRE_EQUAL(all->front().get_asset().get_symbol(), "LIST.ONE");
+    BOOST_REQUIRE_EQUAL(all->front().get_asset().get_maximum_supply(), 100u);
+    BOOST_REQUIRE_EQUAL(all->back().get_asset().get_symbol(), "LIST.TWO");
+
+    const auto first = assets.get_blockchain_assets("", 0, 1);
+    BOOST_REQUIRE_EQUAL(first->size(), 1u);
+    BOOST_REQUIRE_EQUAL(first->front().get_asset().get_symbol(), "LIST.ONE");
+}
+
+BOOST_AUTO_TEST_CASE(blockchain_asset_database__page__skips_forbidden_symbols)
+{
+    store_fixture fixture;
+    auto& assets = fixture.store->assets;
+    assets.store(symbol_key("ETP"), make_asset("ETP", 1, 1));
+    assets.store(symbol_key("EA"), make_asset("EA", 100, 2));
+    assets.store(symbol_key("EZ"), make_asset("EZ", 200, 3));
+
+    // Counts and pages agree, a forbidden symbol takes no place in either.
+    BOOST_REQUIRE_EQUAL(assets.get_symbol_index().count(), 2u);
+    BOOST_REQUIRE_EQUAL(assets.get_symbol_index().count("E"), 2u);
+    const auto first = assets.get_blockchain_assets("E", 0, 1);
+    const auto second = assets.get_blockchain_assets("E", 1, 1);
+    BOOST_REQUIRE_EQUAL(first->size(), 1u);
+    BOOST_REQUIRE_EQUAL(first->front().get_asset().get_symbol(), "EA");
+    BOOST_REQUIRE_EQUAL(second->size(), 1u);
+    BOOST_REQUIRE_EQUAL(second->front().get_asset().get_symbol(), "EZ");
+
+    // The record is still stored, and not listed after a restart.
+    assets.sync();
+    fixture.close();
+    fixture.open();
+    BOOST_REQUIRE(fixture.store->assets.get(symbol_key("ETP")));
+    BOOST_REQUIRE_EQUAL(fixture.store->assets.get_symbol_index().count(), 2u);
+    BOOST_REQUIRE_EQUAL(fixture.store->assets.get_blockchain_assets("", 0, 0)->size(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE(blockchain_did_database__count__matches_current_page)
+{
+    store_fixture fixture;
+    auto& dids = fixture.store->dids;
+    dids.store(symbol_key("LISTA"), make_did("LISTA", "first", 1));
+    dids.store(symbol_key("LISTB"), make_did("LISTB", "second", 2));
+
+    // A transfer leaves the earlier record as history.
+    dids.store(symbol_key("LISTA"), make_did("LISTA", "third", 3));
+
+    BOOST_REQUIRE_EQUAL(dids.get_symbol_index().count(), 2u);
+    auto page = dids.get_blockchain_dids("", 0, 0);
+    BOOST_REQUIRE_EQUAL(page->size(), 2u);
+    BOOST_REQUIRE_EQUAL(page->front().get_did().get_address(), "third");
+    BOOST_REQUIRE_EQUAL(page->front().get_status(), blockchain_did::address_current);
+
+    const auto restored = dids.pop_did_transfer(symbol_key("LISTA"));
+    BOOST_REQUIRE(restored);
+    BOOST_REQUIRE_EQUAL(restored->get_did().get_address(), "first");
+    BOOST_REQUIRE_EQUAL(dids.get_symbol_index().count(), 2u);
+
+    page = dids.get_blockchain_dids("", 0, 0);
+    BOOST_REQUIRE_EQUAL(page->front().get_did().get_address(), "first");
+    BOOST_REQUIRE_EQUAL(page->front().get_status(), blockchain_did::address_current);
+
+    dids.remove(symbol_key("LISTB"));
+    BOOST_REQUIRE_EQUAL(dids.get_symbol_index().count(), 1u);
+    BOOST_REQUIRE_EQUAL(dids.get_blockchain_dids("", 0, 0)->size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(blockchain_did_database__start__indexes_current_symbols_once)
+{
+    store_fixture fixture;
+    fixture.store->dids.store(symbol_key("LISTA"), make_did("LISTA", "first", 1));
+    fixture.store->dids.store(symbol_key("LISTA"), make_did("LISTA", "second", 2));
+    fixture.store->dids.store(symbol_key("LISTB"), make_did("LISTB", "third", 3));
+    fixture.store->dids.sync();
+
+    fixture.close();
+    fixture.open();
+
+    const auto& dids = fixture.store->dids;
+    BOOST_REQUIRE_EQUAL(dids.get_symbol_index().count(), 2u);
+
+    const auto page = dids.get_blockchain_dids("", 0, 0);
+    BOOST_REQUIRE_EQUAL(page->size(), 2u);
+    BOOST_REQUIRE_EQUAL(page->front().get_did().get_address(), "second");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
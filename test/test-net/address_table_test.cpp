@@ -0,0 +1,195 @@
+#include <boost/test/unit_test.hpp>
+#include <cstdint>
+#include <map>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/network/address_table.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::network;
+
+namespace {
+
+// An IPv4 mapped address a.b.c.d:port.
+static message::network_address make_address(uint8_t a, uint8_t b,
+    uint8_t c, uint8_t d, uint16_t port=5251)
+{
+    message::network_address host{ 0, 0, message::ip_address{}, port };
+    host.ip[10] = 0xff;
+    host.ip[11] = 0xff;
+    host.ip[12] = a;
+    host.ip[13] = b;
+    host.ip[14] = c;
+    host.ip[15] = d;
+    return host;
+}
+
+// The table identifies an address by its ip and port.
+static bool same(const message::network_address& left,
+    const message::network_address& right)
+{
+    return left.ip == right.ip && left.port == right.port;
+}
+
+static bool accept_all(const message::network_address&)
+{
+    return true;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(address_table_tests)
+
+BOOST_AUTO_TEST_CASE(address_table__insert__duplicate__rejected)
+{
+    address_table table(64);
+    const auto host = make_address(1, 2, 3, 4);
+    BOOST_REQUIRE(table.insert(host));
+    BOOST_REQUIRE(!table.insert(host));
+    BOOST_REQUIRE(table.contains(host));
+    BOOST_REQUIRE_EQUAL(table.size(), 1u);
+
+    // The port is part of the address.
+    BOOST_REQUIRE(table.insert(make_address(1, 2, 3, 4, 5252)));
+    BOOST_REQUIRE_EQUAL(table.size(), 2u);
+
+    BOOST_REQUIRE(table.remove(host));
+    BOOST_REQUIRE(!table.remove(host));
+    BOOST_REQUIRE(!table.contains(host));
+    BOOST_REQUIRE_EQUAL(table.size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(address_table__insert__one_network_group__fills_one_bucket)
+{
+    address_table table(16 * address_table::bucket_size);
+
+    // A single /16 evicts its own entries once its bucket is full.
+    for (size_t index = 0; index < 200; ++index)
+        table.insert(make_address(7, 7, index / 256, index % 256));
+
+    BOOST_REQUIRE_EQUAL(table.size(), address_table::bucket_size);
+
+    // The newest address always gets in.
+    const auto newest = make_address(7, 7, 99, 99);
+    BOOST_REQUIRE(table.insert(newest));
+    BOOST_REQUIRE(table.contains(newest));
+    BOOST_REQUIRE_EQUAL(table.size(), address_table::bucket_size);
+}
+
+BOOST_AUTO_TEST_CASE(address_table__insert__flood__keeps_other_groups)
+{
+    address_table table(16 * address_table::bucket_size);
+    const auto other = make_address(9, 9, 9, 9);
+    BOOST_REQUIRE(table.insert(other));
+
+    for (size_t index = 0; index < 1000; ++index)
+        table.insert(make_address(8, 8, index / 256, index % 256));
+
+    // The flood can only share a bucket with other, never push it out of
+    // its own.
+    BOOST_REQUIRE_LE(table.size(), address_table::bucket_size + 1);
+    BOOST_REQUIRE(table.contains(other) ||
+        table.size() == address_table::bucket_size);
+}
+
+BOOST_AUTO_TEST_CASE(address_table__insert__full_table__evicts_in_bucket)
+{
+    address_table table(4);
+    for (uint8_t index = 0; index < 10; ++index)
+        table.insert(make_address(10, index, 0, 1));
+
+    BOOST_REQUIRE(table.full());
+    BOOST_REQUIRE_EQUAL(table.size(), 4u);
+
+    size_t visited = 0;
+    table.for_each([&visited](const address_table::entry&) { ++visited; });
+    BOOST_REQUIRE_EQUAL(visited, 4u);
+}
+
+BOOST_AUTO_TEST_CASE(address_table__find__tracks_counters)
+{
+    address_table table(64);
+    const auto host = make_address(1, 2, 3, 4);
+    BOOST_REQUIRE(table.find(host) == nullptr);
+    BOOST_REQUIRE(table.insert(address_table::entry{ host, 3, 10, 20 }));
+
+    const auto entry = table.find(host);
+    BOOST_REQUIRE(entry != nullptr);
+    BOOST_REQUIRE_EQUAL(entry->attempts, 3u);
+    BOOST_REQUIRE_EQUAL(entry->last_attempt, 10u);
+    BOOST_REQUIRE_EQUAL(entry->last_success, 20u);
+}
+
+BOOST_AUTO_TEST_CASE(address_table__select__filter)
+{
+    address_table table(64);
+    BOOST_REQUIRE(table.select(accept_all) == nullptr);
+
+    const auto wanted = make_address(1, 1, 1, 1);
+    BOOST_REQUIRE(table.insert(wanted));
+    BOOST_REQUIRE(table.insert(make_address(2, 2, 2, 2)));
+    BOOST_REQUIRE(table.insert(make_address(3, 3, 3, 3)));
+
+    const auto none = [](const message::network_address&) { return false; };
+    BOOST_REQUIRE(table.select(none) == nullptr);
+
+    const auto only = [&wanted](const message::network_address& host)
+    {
+        return same(host, wanted);
+    };
+
+    for (size_t draw = 0; draw < 20; ++draw)
+    {
+        const auto entry = table.select(only);
+        BOOST_REQUIRE(entry != nullptr);
+        BOOST_REQUIRE(same(entry->host, wanted));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(address_table__select__penalizes_failures)
+{
+    address_table table(address_table::bucket_size);
+    const auto fresh = make_address(1, 1, 1, 1);
+    const auto failing = make_address(2, 2, 2, 2);
+    BOOST_REQUIRE(table.insert(address_table::entry{ fresh, 0, 0, 0 }));
+    BOOST_REQUIRE(table.insert(address_table::entry{ failing, 100, 0, 0 }));
+
+    size_t fresh_count = 0;
+    size_t failing_count = 0;
+    for (size_t draw = 0; draw < 2000; ++draw)
+    {
+        const auto entry = table.select(accept_all);
+        BOOST_REQUIRE(entry != nullptr);
+        if (same(entry->host, fresh))
+            ++fresh_count;
+        else
+            ++failing_count;
+    }
+
+    // The failing entry is drawn at a ninth of the rate of the fresh one.
+    BOOST_REQUIRE_GT(fresh_count, 4 * failing_count);
+    BOOST_REQUIRE_GT(failing_count, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(address_table__select__sparse_table__spreads_scan)
+{
+    // Far more buckets than entries, most selects miss every draw and scan.
+    // One network group puts all entries in the same bucket.
+    address_table table(10000 * address_table::bucket_size);
+    for (uint8_t index = 1; index <= 4; ++index)
+        BOOST_REQUIRE(table.insert(make_address(5, 5, index, index)));
+
+    std::map<uint8_t, size_t> seen;
+    for (size_t draw = 0; draw < 400; ++draw)
+    {
+        const auto entry = table.select(accept_all);
+        BOOST_REQUIRE(entry != nullptr);
+        ++seen[entry->host.ip[15]];
+    }
+
+    // A scan from a fixed start would return one entry nearly every time.
+    BOOST_REQUIRE_EQUAL(seen.size(), 4u);
+    for (const auto& count: seen)
+        BOOST_REQUIRE_LT(count.second, 200u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
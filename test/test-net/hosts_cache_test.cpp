@@ -0,0 +1,193 @@
+#include <boost/test/unit_test.hpp>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/network/hosts.hpp>
+#include <metaverse/network/settings.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::network;
+
+namespace {
+
+// Cache entries by address, as hosts writes them.
+typedef std::map<std::string, address_table::entry> cache_entries;
+
+static message::network_address make_address(const std::string& authority)
+{
+    return config::authority(authority).to_network_address();
+}
+
+// Hosts identifies an address by its ip and port.
+static bool same(const message::network_address& left,
+    const message::network_address& right)
+{
+    return left.ip == right.ip && left.port == right.port;
+}
+
+// A hosts instance over a cache file in its own directory.
+struct hosts_fixture
+{
+    hosts_fixture()
+      : pool(1),
+        directory(boost::filesystem::temp_directory_path() /
+            boost::filesystem::unique_path("mvs-hosts-test-%%%%-%%%%"))
+    {
+        boost::filesystem::create_directories(directory);
+        settings.host_pool_capacity = 100;
+        settings.hosts_file = directory / "hosts.cache";
+    }
+
+    ~hosts_fixture()
+    {
+        if (instance)
+            instance->stop();
+
+        pool.shutdown();
+        pool.join();
+        boost::system::error_code ec;
+        boost::filesystem::remove_all(directory, ec);
+    }
+
+    hosts::ptr start()
+    {
+        instance = std::make_shared<hosts>(pool, settings);
+        BOOST_REQUIRE_EQUAL(instance->start().value(), error::success);
+        return instance;
+    }
+
+    void stop()
+    {
+        BOOST_REQUIRE_EQUAL(instance->stop().value(), error::success);
+        instance.reset();
+    }
+
+    // Parse the binary cache, false if it is not one.
+    bool read(cache_entries& out) const
+    {
+        std::ifstream file(settings.hosts_file.string(), std::ifstream::binary);
+        istream_reader source(file);
+        if (source.read_4_bytes_little_endian() != 0x4853564d ||
+            source.read_byte() != 1)
+            return false;
+
+        const auto count = source.read_variable_uint_little_endian();
+        for (uint64_t index = 0; index < count; ++index)
+        {
+            address_table::entry entry;
+            if (!entry.host.from_data(0, source, true))
+                return false;
+
+            entry.attempts = source.read_4_bytes_little_endian();
+            entry.last_attempt = source.read_4_bytes_little_endian();
+            entry.last_success = source.read_4_bytes_little_endian();
+            out[config::authority(entry.host).to_string()] = entry;
+        }
+
+        return bool(source);
+    }
+
+    threadpool pool;
+    boost::filesystem::path directory;
+    network::settings settings;
+    hosts::ptr instance;
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(hosts_cache_tests)
+
+BOOST_AUTO_TEST_CASE(hosts__start__text_cache__loads_and_saves_binary)
+{
+    hosts_fixture fixture;
+    {
+        std::ofstream file(fixture.settings.hosts_file.string());
+        file << "1.2.3.4:5251\n" << "5.6.7.8:5251\n" << "9.9.9.9:0\n";
+    }
+
+    BOOST_REQUIRE_EQUAL(fixture.start()->count(), 2u);
+    fixture.stop();
+
+    cache_entries entries;
+    BOOST_REQUIRE(fixture.read(entries));
+    BOOST_REQUIRE_EQUAL(entries.size(), 2u);
+    BOOST_REQUIRE_EQUAL(entries.count("1.2.3.4:5251"), 1u);
+    BOOST_REQUIRE_EQUAL(entries.count("5.6.7.8:5251"), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(hosts__stop__binary_cache__round_trips_counters)
+{
+    hosts_fixture fixture;
+    const auto first = make_address("1.2.3.4:5251");
+    const auto second = make_address("5.6.7.8:5251");
+    const auto connected = make_address("9.8.7.6:5251");
+
+    auto instance = fixture.start();
+    BOOST_REQUIRE_EQUAL(instance->store(first).value(), error::success);
+    BOOST_REQUIRE_EQUAL(instance->store(second).value(), error::success);
+
+    message::network_address fetched;
+    BOOST_REQUIRE_EQUAL(instance->fetch(fetched, {}).value(), error::success);
+    BOOST_REQUIRE(same(fetched, first) || same(fetched, second));
+
+    BOOST_REQUIRE_EQUAL(instance->store_connected(connected).value(), error::success);
+    BOOST_REQUIRE_EQUAL(instance->count(), 3u);
+    fixture.stop();
+
+    cache_entries saved;
+    BOOST_REQUIRE(fixture.read(saved));
+    BOOST_REQUIRE_EQUAL(saved.size(), 3u);
+
+    const auto& tried = saved[config::authority(fetched).to_string()];
+    BOOST_REQUIRE_EQUAL(tried.attempts, 1u);
+    BOOST_REQUIRE_NE(tried.last_attempt, 0u);
+    BOOST_REQUIRE_EQUAL(tried.last_success, 0u);
+
+    const auto& good = saved["9.8.7.6:5251"];
+    BOOST_REQUIRE_EQUAL(good.attempts, 0u);
+    BOOST_REQUIRE_NE(good.last_success, 0u);
+
+    // Loading and saving again keeps the counters.
+    BOOST_REQUIRE_EQUAL(fixture.start()->count(), 3u);
+    fixture.stop();
+
+    cache_entries reloaded;
+    BOOST_REQUIRE(fixture.read(reloaded));
+    BOOST_REQUIRE_EQUAL(reloaded.size(), 3u);
+    for (const auto& entry: saved)
+    {
+        const auto& other = reloaded[entry.first];
+        BOOST_REQUIRE_EQUAL(other.attempts, entry.second.attempts);
+        BOOST_REQUIRE_EQUAL(other.last_attempt, entry.second.last_attempt);
+        BOOST_REQUIRE_EQUAL(other.last_success, entry.second.last_success);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(hosts__store__unconnected_address__no_success)
+{
+    hosts_fixture fixture;
+    const auto added = make_address("1.2.3.4:5251");
+    const auto connected = make_address("9.8.7.6:5251");
+
+    auto instance = fixture.start();
+
+    // addnode and seeds store addresses nobody has connected to.
+    BOOST_REQUIRE_EQUAL(instance->store(added).value(), error::success);
+    BOOST_REQUIRE_EQUAL(instance->store_connected(connected).value(), error::success);
+
+    // Storing a connected address again does not forget the success.
+    BOOST_REQUIRE_EQUAL(instance->store(connected).value(), error::success);
+    fixture.stop();
+
+    cache_entries saved;
+    BOOST_REQUIRE(fixture.read(saved));
+    BOOST_REQUIRE_EQUAL(saved.size(), 2u);
+    BOOST_REQUIRE_EQUAL(saved["1.2.3.4:5251"].last_success, 0u);
+    BOOST_REQUIRE_NE(saved["9.8.7.6:5251"].last_success, 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
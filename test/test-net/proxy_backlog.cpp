@@ -0,0 +1,142 @@
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/network/proxy.hpp>
+#include <metaverse/network/socket.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::network;
+using boost::asio::ip::tcp;
+
+namespace {
+
+class silent_proxy
+  : public proxy
+{
+public:
+    silent_proxy(threadpool& pool, socket::ptr socket)
+      : proxy(pool, socket, 0x4d56534d, message::version::level::maximum)
+    {
+    }
+
+protected:
+    void handle_activity() override {}
+    void handle_stopping() override {}
+};
+
+// A proxy connected over loopback to a peer that never reads, with small
+// socket buffers so that writes stall after a few kilobytes.
+struct stalled_peer
+{
+    stalled_peer()
+      : pool(2),
+        acceptor(pool.service()),
+        peer(pool.service()),
+        connection(std::make_shared<network::socket>(pool)),
+        stopped(false)
+    {
+        const tcp::endpoint loopback(boost::asio::ip::address_v4::loopback(), 0);
+        acceptor.open(loopback.protocol());
+        acceptor.set_option(tcp::socket::receive_buffer_size(4096));
+        acceptor.bind(loopback);
+        acceptor.listen();
+
+        {
+            const auto locked = connection->get_socket();
+            locked->get().connect(acceptor.local_endpoint());
+            locked->get().set_option(tcp::socket::send_buffer_size(4096));
+        }
+
+        acceptor.accept(peer);
+        channel = std::make_shared<silent_proxy>(pool, connection);
+        channel->start([](const code&) {});
+        channel->subscribe_stop([this](const code& ec)
+        {
+            if (!stopped.exchange(true))
+                reason.set_value(ec);
+        });
+    }
+
+    ~stalled_peer()
+    {
+        channel->stop(error::channel_stopped);
+        boost::system::error_code ignore;
+        peer.close(ignore);
+        acceptor.close(ignore);
+        pool.shutdown();
+        pool.join();
+    }
+
+    // Send until the channel stops, at most limit messages.
+    template <typename Message>
+    void flood(const Message& message, size_t limit)
+    {
+        for (size_t count = 0; count < limit && !stopped; ++count)
+            channel->send(message, [](const code&) {});
+    }
+
+    code wait()
+    {
+        auto result = reason.get_future();
+        if (result.wait_for(std::chrono::seconds(10)) !=
+            std::future_status::ready)
+            return error::success;
+
+        return result.get();
+    }
+
+    threadpool pool;
+    tcp::acceptor acceptor;
+    tcp::socket peer;
+    network::socket::ptr connection;
+    std::shared_ptr<silent_proxy> channel;
+    std::atomic<bool> stopped;
+    std::promise<code> reason;
+};
+
+// About eight kilobytes a message.
+static message::headers make_headers()
+{
+    message::headers headers;
+    headers.elements.resize(50);
+    return headers;
+}
+
+static message::inventory make_inventory()
+{
+    return message::inventory(hash_list(250, null_hash),
+        message::inventory::type_id::transaction);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(proxy_backlog_tests)
+
+BOOST_AUTO_TEST_CASE(proxy__send__priority_flood_to_stalled_peer__stops)
+{
+    stalled_peer fixture;
+    fixture.flood(make_headers(), 10000);
+    BOOST_REQUIRE_EQUAL(fixture.wait().value(), error::size_limits);
+    BOOST_REQUIRE(fixture.channel->stopped());
+}
+
+BOOST_AUTO_TEST_CASE(proxy__send__bulk_flood_to_stalled_peer__stops)
+{
+    stalled_peer fixture;
+    fixture.flood(make_inventory(), 10000);
+    BOOST_REQUIRE_EQUAL(fixture.wait().value(), error::size_limits);
+    BOOST_REQUIRE(fixture.channel->stopped());
+}
+
+BOOST_AUTO_TEST_CASE(proxy__send__within_backlog__keeps_channel)
+{
+    stalled_peer fixture;
+    fixture.flood(make_headers(), 100);
+    BOOST_REQUIRE(!fixture.stopped);
+    BOOST_REQUIRE(!fixture.channel->stopped());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
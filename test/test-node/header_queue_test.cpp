@@ -0,0 +1,176 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef HEADER_QUEUE_TESTS
+#include <boost/test/unit_test.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/node/utility/header_queue.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::node;
+
+// Count headers from the first height up, each linked to the one before it
+// and the first to the given hash.
+static chain::header::list make_headers(const hash_digest& root, size_t first,
+    size_t count)
+{
+    chain::header::list headers;
+    auto previous = root;
+
+    for (size_t height = first; height < first + count; ++height)
+    {
+        chain::header header;
+        header.version = 1;
+        header.previous_block_hash = previous;
+        header.timestamp = static_cast<uint32_t>(height);
+        header.number = height;
+        previous = header.hash();
+        headers.push_back(header);
+    }
+
+    return headers;
+}
+
+static message::headers::ptr to_message(const chain::header::list& headers)
+{
+    return std::make_shared<message::headers>(headers);
+}
+
+static const hash_digest root{ { 42 } };
+
+BOOST_AUTO_TEST_SUITE(header_queue_tests)
+
+BOOST_AUTO_TEST_CASE(header_queue__dequeue_then_enqueue__keeps_heights)
+{
+    const config::checkpoint::list checkpoints;
+    header_queue queue(checkpoints);
+    queue.initialize(root, 0);
+
+    const auto first = make_headers(root, 1, 10);
+    BOOST_REQUIRE(queue.enqueue(to_message(first)));
+    BOOST_REQUIRE_EQUAL(queue.size(), 11u);
+    BOOST_REQUIRE_EQUAL(queue.last_height(), 10u);
+
+    BOOST_REQUIRE(queue.dequeue(4));
+    BOOST_REQUIRE_EQUAL(queue.first_height(), 4u);
+    BOOST_REQUIRE_EQUAL(queue.size(), 7u);
+
+    hash_digest hash;
+    size_t height;
+    BOOST_REQUIRE(queue.dequeue(hash, height));
+    BOOST_REQUIRE_EQUAL(height, 4u);
+    BOOST_REQUIRE(hash == first[3].hash());
+
+    // Enough dequeued to compact the front away.
+    BOOST_REQUIRE(queue.dequeue(3));
+    BOOST_REQUIRE_EQUAL(queue.first_height(), 8u);
+
+    const auto second = make_headers(first.back().hash(), 11, 5);
+    BOOST_REQUIRE(queue.enqueue(to_message(second)));
+    BOOST_REQUIRE_EQUAL(queue.first_height(), 8u);
+    BOOST_REQUIRE_EQUAL(queue.last_height(), 15u);
+    BOOST_REQUIRE(queue.last_hash() == second.back().hash());
+
+    for (size_t expected = 8; expected <= 15; ++expected)
+    {
+        BOOST_REQUIRE(queue.dequeue(hash, height));
+        BOOST_REQUIRE_EQUAL(height, expected);
+        BOOST_REQUIRE(hash == (expected <= 10 ? first[expected - 1] :
+            second[expected - 11]).hash());
+    }
+
+    BOOST_REQUIRE(queue.empty());
+    BOOST_REQUIRE(!queue.dequeue(1));
+    BOOST_REQUIRE(!queue.enqueue(to_message(make_headers(hash, 16, 1))));
+}
+
+BOOST_AUTO_TEST_CASE(header_queue__invalidate_after_partial_dequeue__marks_heights)
+{
+    const config::checkpoint::list checkpoints;
+    header_queue queue(checkpoints);
+    queue.initialize(root, 0);
+
+    const auto headers = make_headers(root, 1, 8);
+    BOOST_REQUIRE(queue.enqueue(to_message(headers)));
+    BOOST_REQUIRE(queue.dequeue(3));
+
+    // Heights below the first are gone and are not marked.
+    queue.invalidate(1, 2);
+    queue.invalidate(5, 2);
+
+    hash_digest hash;
+    size_t height;
+    for (size_t expected = 3; expected <= 8; ++expected)
+    {
+        BOOST_REQUIRE(queue.dequeue(hash, height));
+        BOOST_REQUIRE_EQUAL(height, expected);
+
+        const auto marked = expected == 5 || expected == 6;
+        BOOST_REQUIRE_EQUAL(header_queue::valid(hash), !marked);
+
+        if (!marked)
+            BOOST_REQUIRE(hash == headers[expected - 1].hash());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(header_queue__break_in_batch__rolls_back_to_checkpoint)
+{
+    auto headers = make_headers(root, 1, 8);
+    const config::checkpoint::list checkpoints
+    {
+        { root, 0 },
+        { headers[2].hash(), 3 }
+    };
+
+    header_queue queue(checkpoints);
+    queue.initialize(root, 0);
+
+    // The sixth header does not follow the fifth.
+    headers[5].previous_block_hash = null_hash;
+    BOOST_REQUIRE(!queue.enqueue(to_message(headers)));
+    BOOST_REQUIRE_EQUAL(queue.first_height(), 0u);
+    BOOST_REQUIRE_EQUAL(queue.last_height(), 3u);
+    BOOST_REQUIRE(queue.last_hash() == headers[2].hash());
+
+    // The queue continues from the checkpoint.
+    const auto resumed = make_headers(headers[2].hash(), 4, 3);
+    BOOST_REQUIRE(queue.enqueue(to_message(resumed)));
+    BOOST_REQUIRE_EQUAL(queue.last_height(), 6u);
+    BOOST_REQUIRE(queue.last_hash() == resumed.back().hash());
+}
+
+BOOST_AUTO_TEST_CASE(header_queue__checkpoint_mismatch__rolls_back)
+{
+    const auto headers = make_headers(root, 1, 4);
+    const config::checkpoint::list checkpoints
+    {
+        { null_hash, 3 }
+    };
+
+    header_queue queue(checkpoints);
+    queue.initialize(root, 0);
+
+    BOOST_REQUIRE(!queue.enqueue(to_message(headers)));
+    BOOST_REQUIRE_EQUAL(queue.size(), 1u);
+    BOOST_REQUIRE(queue.last_hash() == root);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
@@ -0,0 +1,128 @@
+#ifdef  JSONRPC_BATCH_TESTS
+#include <stdexcept>
+#include <string>
+#include <boost/test/unit_test.hpp>
+#include <metaverse/mgbubble/utility/JsonRpcBatch.hpp>
+
+using namespace mgbubble;
+
+namespace {
+
+Json::Value make_request(int64_t id, const std::string& method)
+{
+    Json::Value request;
+    request["jsonrpc"] = "2.0";
+    request["id"] = static_cast<Json::Int64>(id);
+    request["method"] = method;
+    return request;
+}
+
+// Echo the id, fail on "fail" and answer nothing on "notify".
+Json::Value echo(const Json::Value& request)
+{
+    const auto method = request["method"].asString();
+    if (method == "fail") {
+        throw std::runtime_error("failed");
+    }
+
+    if (method == "notify") {
+        return Json::Value();
+    }
+
+    Json::Value response;
+    response["jsonrpc"] = "2.0";
+    response["id"] = request["id"];
+    response["result"] = method;
+    return response;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(jsonrpc_batch_tests)
+
+BOOST_AUTO_TEST_CASE(jsonrpc_batch_error__empty__invalid_request)
+{
+    const auto error = jsonrpc_batch_error(Json::Value(Json::arrayValue), 10);
+    BOOST_REQUIRE(error.isObject());
+    BOOST_REQUIRE_EQUAL(error["jsonrpc"].asString(), "2.0");
+    BOOST_REQUIRE_EQUAL(error["id"].asInt64(), -1);
+    BOOST_REQUIRE_EQUAL(error["error"]["code"].asInt(), -32600);
+}
+
+BOOST_AUTO_TEST_CASE(jsonrpc_batch_error__oversized__invalid_request)
+{
+    Json::Value requests(Json::arrayValue);
+    for (int64_t id = 0; id < 3; ++id) {
+        requests.append(make_request(id, "getheight"));
+    }
+
+    BOOST_REQUIRE(jsonrpc_batch_error(requests, 3).isNull());
+
+    const auto error = jsonrpc_batch_error(requests, 2);
+    BOOST_REQUIRE_EQUAL(error["error"]["code"].asInt(), -32600);
+    BOOST_REQUIRE(error["error"]["message"].asString().find("2 requests") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(jsonrpc_batch__responses_in_request_order)
+{
+    Json::Value requests(Json::arrayValue);
+    std::vector<std::string> order;
+    for (int64_t id = 10; id > 0; --id) {
+        requests.append(make_request(id, "call" + std::to_string(id)));
+    }
+
+    const auto responses = jsonrpc_batch(requests,
+        [&order](const Json::Value& request) {
+            order.push_back(request["method"].asString());
+            return echo(request);
+        });
+
+    BOOST_REQUIRE(responses.isArray());
+    BOOST_REQUIRE_EQUAL(responses.size(), 10u);
+    for (Json::ArrayIndex index = 0; index < responses.size(); ++index) {
+        const auto id = static_cast<int64_t>(10 - index);
+        BOOST_REQUIRE_EQUAL(responses[index]["id"].asInt64(), id);
+        BOOST_REQUIRE_EQUAL(responses[index]["result"].asString(), "call" + std::to_string(id));
+        BOOST_REQUIRE_EQUAL(order[index], "call" + std::to_string(id));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(jsonrpc_batch__failed_entry__own_error)
+{
+    Json::Value requests(Json::arrayValue);
+    requests.append(make_request(1, "first"));
+    requests.append(make_request(2, "fail"));
+    requests.append("not an object");
+    requests.append(make_request(4, "notify"));
+    requests.append(make_request(5, "last"));
+
+    const auto responses = jsonrpc_batch(requests, echo);
+    BOOST_REQUIRE_EQUAL(responses.size(), 4u);
+
+    BOOST_REQUIRE_EQUAL(responses[0]["id"].asInt64(), 1);
+    BOOST_REQUIRE_EQUAL(responses[0]["result"].asString(), "first");
+
+    BOOST_REQUIRE_EQUAL(responses[1]["id"].asInt64(), 2);
+    BOOST_REQUIRE_EQUAL(responses[1]["error"]["code"].asInt(), 1000);
+    BOOST_REQUIRE_EQUAL(responses[1]["error"]["message"].asString(), "failed");
+
+    BOOST_REQUIRE_EQUAL(responses[2]["id"].asInt64(), -1);
+    BOOST_REQUIRE_EQUAL(responses[2]["error"]["code"].asInt(), -32600);
+
+    // The notification is left out, the entry after it still runs.
+    BOOST_REQUIRE_EQUAL(responses[3]["id"].asInt64(), 5);
+    BOOST_REQUIRE_EQUAL(responses[3]["result"].asString(), "last");
+}
+
+BOOST_AUTO_TEST_CASE(jsonrpc_batch__only_notifications__empty_array)
+{
+    Json::Value requests(Json::arrayValue);
+    requests.append(make_request(1, "notify"));
+
+    const auto responses = jsonrpc_batch(requests, echo);
+    BOOST_REQUIRE(responses.isArray());
+    BOOST_REQUIRE(responses.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
@@ -1,3 +1,4 @@
+#ifdef  MGSERVER_TESTS
 
 #include <iostream>
 #include <boost/test/unit_test.hpp>